@@ -52,6 +52,80 @@ QT_BEGIN_NAMESPACE
 
 namespace Qt3DCore {
 
+namespace {
+
+// Large enough for the creation of the nodes to outweigh the cost of a job
+const int BackendNodeBatchSize = 512;
+
+class BackendNodeCreationJob : public QAspectJob
+{
+public:
+    BackendNodeCreationJob(const QAbstractAspectPrivate *aspect,
+                           const QBackendNodeMapperPtr &mapper,
+                           QConcurrentBackendNodeMapper *concurrentMapper,
+                           const QVector<QNodeCreatedChangeBasePtr> &changes,
+                           bool registerBackendNodes)
+        : m_aspect(aspect)
+        , m_mapper(mapper)
+        , m_concurrentMapper(concurrentMapper)
+        , m_changes(changes)
+        , m_registerBackendNodes(registerBackendNodes)
+    {
+    }
+
+    // The nodes created by the job when it was asked not to register them
+    // with the arbiter
+    QVector<QBackendNode *> unregisteredBackendNodes() const { return m_unregisteredBackendNodes; }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        if (m_concurrentMapper != nullptr) {
+            // All the changes of the batch share the mapper. Nodes which
+            // already exist are skipped before the storage of the others is
+            // prepared, as they would be found by the mapper afterwards
+            QVector<QNodeCreatedChangeBasePtr> newChanges;
+            QVector<QNodeId> ids;
+            newChanges.reserve(m_changes.size());
+            ids.reserve(m_changes.size());
+            for (const auto &change : qAsConst(m_changes)) {
+                if (m_mapper->get(change->subjectId()) == nullptr) {
+                    newChanges.push_back(change);
+                    ids.push_back(change->subjectId());
+                }
+            }
+            m_concurrentMapper->prepareBackendNodes(ids);
+            for (const auto &change : qAsConst(newChanges))
+                backendNodeCreated(m_aspect->instantiateBackendNode(change, m_mapper));
+        } else {
+            for (const auto &change : qAsConst(m_changes)) {
+                const QBackendNodeMapperPtr mapper = m_aspect->backendNodeMapper(change->metaObject());
+                if (mapper && mapper->get(change->subjectId()) == nullptr)
+                    backendNodeCreated(m_aspect->instantiateBackendNode(change, mapper));
+            }
+        }
+    }
+
+private:
+    void backendNodeCreated(QBackendNode *backend)
+    {
+        if (backend == nullptr)
+            return;
+        if (m_registerBackendNodes)
+            m_aspect->registerBackendNode(backend);
+        else
+            m_unregisteredBackendNodes.push_back(backend);
+    }
+
+    const QAbstractAspectPrivate *m_aspect;
+    QBackendNodeMapperPtr m_mapper;
+    QConcurrentBackendNodeMapper *m_concurrentMapper;
+    QVector<QNodeCreatedChangeBasePtr> m_changes;
+    QVector<QBackendNode *> m_unregisteredBackendNodes;
+    bool m_registerBackendNodes;
+};
+
+} // anonymous
+
 QAbstractAspectPrivate::QAbstractAspectPrivate()
     : QObjectPrivate()
     , m_root(nullptr)
@@ -79,10 +153,36 @@ void QAbstractAspectPrivate::onEngineAboutToShutdown()
 {
 }
 
+/*!
+ * \internal
+ * Called in the context of the aspect thread once the changes of the frame
+ * have been distributed. Returns true when the aspect has no work to do
+ * until the next change or input event, in which case the QAspectManager
+ * doesn't schedule any job. Aspects with time dependent work must return
+ * false, which is the default.
+ */
+bool QAbstractAspectPrivate::isIdle()
+{
+    return false;
+}
+
 /*! \internal */
 void QAbstractAspectPrivate::unregisterBackendType(const QMetaObject &mo)
 {
-    m_backendCreatorFunctors.remove(&mo);
+    const QBackendNodeMapperPtr functor = m_backendCreatorFunctors.take(&mo);
+    m_concurrentBackendCreators.remove(functor.data());
+}
+
+/*!
+ * \internal
+ * Registers backend with \a mo and \a functor. The nodes of the type are
+ * created from the job pool, by batches, as \a functor supports being called
+ * from several threads at once.
+ */
+void QAbstractAspectPrivate::registerConcurrentBackendType(const QMetaObject &mo, const QConcurrentBackendNodeMapperPtr &functor)
+{
+    m_backendCreatorFunctors.insert(&mo, functor);
+    m_concurrentBackendCreators.insert(functor.data(), functor.data());
 }
 
 /*!
@@ -162,6 +262,15 @@ void QAbstractAspectPrivate::sceneNodeAdded(QSceneChangePtr &change)
     createBackendNode(creationChange);
 }
 
+void QAbstractAspectPrivate::sceneNodesAdded(QVector<QSceneChangePtr> &changes)
+{
+    QVector<QNodeCreatedChangeBasePtr> creationChanges;
+    creationChanges.reserve(changes.size());
+    for (const QSceneChangePtr &change : qAsConst(changes))
+        creationChanges.push_back(qSharedPointerCast<QNodeCreatedChangeBase>(change));
+    createBackendNodes(creationChanges);
+}
+
 void QAbstractAspectPrivate::sceneNodeRemoved(QSceneChangePtr &change)
 {
     QNodeDestroyedChangePtr destructionChange = qSharedPointerCast<QNodeDestroyedChange>(change);
@@ -180,22 +289,42 @@ QVector<QAspectJobPtr> QAbstractAspect::jobsToExecute(qint64 time)
     return QVector<QAspectJobPtr>();
 }
 
-QBackendNode *QAbstractAspectPrivate::createBackendNode(const QNodeCreatedChangeBasePtr &change) const
+QBackendNodeMapperPtr QAbstractAspectPrivate::backendNodeMapper(const QMetaObject *metaObj) const
 {
-    const QMetaObject *metaObj = change->metaObject();
     QBackendNodeMapperPtr backendNodeMapper;
     while (metaObj != nullptr && backendNodeMapper.isNull()) {
         backendNodeMapper = m_backendCreatorFunctors.value(metaObj);
         metaObj = metaObj->superClass();
     }
+    return backendNodeMapper;
+}
+
+QBackendNode *QAbstractAspectPrivate::createBackendNode(const QNodeCreatedChangeBasePtr &change) const
+{
+    return createBackendNode(change, backendNodeMapper(change->metaObject()));
+}
 
+// May be called from several threads at once for the mappers registered as
+// concurrent, the arbiter and the scene lock themselves
+QBackendNode *QAbstractAspectPrivate::createBackendNode(const QNodeCreatedChangeBasePtr &change,
+                                                        const QBackendNodeMapperPtr &backendNodeMapper) const
+{
     if (!backendNodeMapper)
         return nullptr;
 
     QBackendNode *backend = backendNodeMapper->get(change->subjectId());
     if (backend != nullptr)
         return backend;
-    backend = backendNodeMapper->create(change);
+    backend = instantiateBackendNode(change, backendNodeMapper);
+    if (backend != nullptr)
+        registerBackendNode(backend);
+    return backend;
+}
+
+QBackendNode *QAbstractAspectPrivate::instantiateBackendNode(const QNodeCreatedChangeBasePtr &change,
+                                                             const QBackendNodeMapperPtr &backendNodeMapper) const
+{
+    QBackendNode *backend = backendNodeMapper->create(change);
 
     if (!backend)
         return nullptr;
@@ -212,16 +341,24 @@ QBackendNode *QAbstractAspectPrivate::createBackendNode(const QNodeCreatedChange
 
     backend->initializeFromPeer(change);
 
+    qCDebug(Nodes) << q_func()->objectName() << "Creating backend node for node id"
+                   << change->subjectId() << "of type" << change->metaObject()->className();
+    return backend;
+}
+
+// Called once the backend node is created. This locks the arbiter, the nodes
+// created while the changes are distributed are registered from the thread
+// distributing them, which already holds the arbiter lock
+void QAbstractAspectPrivate::registerBackendNode(QBackendNode *backend) const
+{
     // TO DO: Find a way to specify the changes to observe
     // Register backendNode with QChangeArbiter
     if (m_arbiter != nullptr) { // Unit tests may not have the arbiter registered
-        qCDebug(Nodes) << q_func()->objectName() << "Creating backend node for node id"
-                       << change->subjectId() << "of type" << change->metaObject()->className();
+        QBackendNodePrivate *backendPriv = QBackendNodePrivate::get(backend);
         m_arbiter->registerObserver(backendPriv, backend->peerId(), AllChanges);
         if (backend->mode() == QBackendNode::ReadWrite)
             m_arbiter->scene()->addObservable(backendPriv, backend->peerId());
     }
-    return backend;
 }
 
 void QAbstractAspectPrivate::clearBackendNode(const QNodeDestroyedChangePtr &change) const
@@ -255,6 +392,82 @@ void QAbstractAspectPrivate::clearBackendNode(const QNodeDestroyedChangePtr &cha
     }
 }
 
+QVector<QAspectJobPtr> QAbstractAspectPrivate::createBackendNodesJobs(const QVector<QNodeCreatedChangeBasePtr> &changes,
+                                                                      bool registerBackendNodes) const
+{
+    QVector<QAspectJobPtr> jobs;
+    QVector<QNodeCreatedChangeBasePtr> orderedChanges;
+    QHash<QBackendNodeMapper *, QVector<QNodeCreatedChangeBasePtr>> concurrentChanges;
+    QHash<const QMetaObject *, QBackendNodeMapperPtr> mappers;
+
+    for (const auto &change : changes) {
+        const QMetaObject *metaObj = change->metaObject();
+        auto mapperIt = mappers.find(metaObj);
+        if (mapperIt == mappers.end())
+            mapperIt = mappers.insert(metaObj, backendNodeMapper(metaObj));
+        const QBackendNodeMapperPtr &mapper = mapperIt.value();
+        if (mapper.isNull())
+            continue;
+
+        if (m_concurrentBackendCreators.contains(mapper.data())) {
+            QVector<QNodeCreatedChangeBasePtr> &batch = concurrentChanges[mapper.data()];
+            batch.push_back(change);
+            if (batch.size() == BackendNodeBatchSize) {
+                jobs.push_back(QSharedPointer<BackendNodeCreationJob>::create(this, mapper, m_concurrentBackendCreators.value(mapper.data()),
+                                                                             batch, registerBackendNodes));
+                batch.clear();
+            }
+        } else {
+            orderedChanges.push_back(change);
+        }
+    }
+
+    for (const QBackendNodeMapperPtr &mapper : qAsConst(mappers)) {
+        const QVector<QNodeCreatedChangeBasePtr> batch = concurrentChanges.value(mapper.data());
+        if (!batch.isEmpty()) {
+            jobs.push_back(QSharedPointer<BackendNodeCreationJob>::create(this, mapper, m_concurrentBackendCreators.value(mapper.data()),
+                                                                         batch, registerBackendNodes));
+            concurrentChanges.remove(mapper.data());
+        }
+    }
+    if (!orderedChanges.isEmpty())
+        jobs.push_back(QSharedPointer<BackendNodeCreationJob>::create(this, QBackendNodeMapperPtr(), nullptr,
+                                                                     orderedChanges, registerBackendNodes));
+    return jobs;
+}
+
+// Called with the arbiter locked when a subtree is inserted. The jobs don't
+// register the nodes with the arbiter as they would wait for its lock, this
+// is done once they are all done
+void QAbstractAspectPrivate::createBackendNodes(const QVector<QNodeCreatedChangeBasePtr> &changes) const
+{
+    const QVector<QAspectJobPtr> jobs = createBackendNodesJobs(changes, false);
+    if (m_jobManager != nullptr && jobs.size() > 1) {
+        m_jobManager->enqueueJobs(jobs);
+        m_jobManager->waitForAllJobs();
+    } else {
+        for (const QAspectJobPtr &job : jobs)
+            job->run();
+    }
+    for (const QAspectJobPtr &job : jobs) {
+        const QVector<QBackendNode *> backendNodes = static_cast<BackendNodeCreationJob *>(job.data())->unregisteredBackendNodes();
+        for (QBackendNode *backend : backendNodes)
+            registerBackendNode(backend);
+    }
+}
+
+QVector<QAspectJobPtr> QAbstractAspectPrivate::setRootAndCreateNodesJobs(QEntity *rootObject, const QVector<QNodeCreatedChangeBasePtr> &changes)
+{
+    qCDebug(Aspects) << Q_FUNC_INFO << "rootObject =" << rootObject;
+    if (rootObject == m_root)
+        return QVector<QAspectJobPtr>();
+
+    m_root = rootObject;
+    m_rootId = rootObject->id();
+
+    return createBackendNodesJobs(changes);
+}
+
 void QAbstractAspectPrivate::setRootAndCreateNodes(QEntity *rootObject, const QVector<QNodeCreatedChangeBasePtr> &changes)
 {
     qCDebug(Aspects) << Q_FUNC_INFO << "rootObject =" << rootObject;
@@ -264,8 +477,7 @@ void QAbstractAspectPrivate::setRootAndCreateNodes(QEntity *rootObject, const QV
     m_root = rootObject;
     m_rootId = rootObject->id();
 
-    for (const auto &change : changes)
-        createBackendNode(change);
+    createBackendNodes(changes);
 }
 
 QServiceLocator *QAbstractAspectPrivate::services() const
@@ -109,6 +109,7 @@ public:
     ~QAbstractAspectPrivate();
 
     void setRootAndCreateNodes(QEntity *rootObject, const QVector<Qt3DCore::QNodeCreatedChangeBasePtr> &changes);
+    QVector<QAspectJobPtr> setRootAndCreateNodesJobs(QEntity *rootObject, const QVector<Qt3DCore::QNodeCreatedChangeBasePtr> &changes);
 
     QServiceLocator *services() const;
     QAbstractAspectJobManager *jobManager() const;
@@ -116,18 +117,34 @@ public:
     QVector<QAspectJobPtr> jobsToExecute(qint64 time) Q_DECL_OVERRIDE;
 
     QBackendNode *createBackendNode(const QNodeCreatedChangeBasePtr &change) const Q_DECL_OVERRIDE;
+    QBackendNode *createBackendNode(const QNodeCreatedChangeBasePtr &change, const QBackendNodeMapperPtr &backendNodeMapper) const;
+    QBackendNode *instantiateBackendNode(const QNodeCreatedChangeBasePtr &change, const QBackendNodeMapperPtr &backendNodeMapper) const;
+    void registerBackendNode(QBackendNode *backend) const;
     void clearBackendNode(const QNodeDestroyedChangePtr &change) const;
 
+    // Nodes of the mappers registered as concurrent are created by batches in
+    // jobs of their own, the other nodes in a single job and in order
+    QVector<QAspectJobPtr> createBackendNodesJobs(const QVector<QNodeCreatedChangeBasePtr> &changes,
+                                                  bool registerBackendNodes = true) const;
+    void createBackendNodes(const QVector<QNodeCreatedChangeBasePtr> &changes) const;
+    QBackendNodeMapperPtr backendNodeMapper(const QMetaObject *metaObj) const;
+
     void sceneNodeAdded(Qt3DCore::QSceneChangePtr &e) Q_DECL_OVERRIDE;
+    void sceneNodesAdded(QVector<Qt3DCore::QSceneChangePtr> &e) Q_DECL_OVERRIDE;
     void sceneNodeRemoved(Qt3DCore::QSceneChangePtr &e) Q_DECL_OVERRIDE;
 
     virtual void onEngineAboutToShutdown();
+    virtual bool isIdle();
 
     // TODO: Make these public in 5.8
     template<class Frontend>
     void unregisterBackendType();
     void unregisterBackendType(const QMetaObject &mo);
 
+    template<class Frontend>
+    void registerConcurrentBackendType(const QConcurrentBackendNodeMapperPtr &functor);
+    void registerConcurrentBackendType(const QMetaObject &mo, const QConcurrentBackendNodeMapperPtr &functor);
+
     Q_DECLARE_PUBLIC(QAbstractAspect)
 
     QEntity *m_root;
@@ -136,6 +153,7 @@ public:
     QAbstractAspectJobManager *m_jobManager;
     QChangeArbiter *m_arbiter;
     QHash<const QMetaObject*, QBackendNodeMapperPtr> m_backendCreatorFunctors;
+    QHash<const QBackendNodeMapper*, QConcurrentBackendNodeMapper*> m_concurrentBackendCreators;
 
     static QAbstractAspectPrivate *get(QAbstractAspect *aspect);
 };
@@ -146,6 +164,12 @@ void QAbstractAspectPrivate::unregisterBackendType()
     unregisterBackendType(Frontend::staticMetaObject);
 }
 
+template<class Frontend>
+void QAbstractAspectPrivate::registerConcurrentBackendType(const QConcurrentBackendNodeMapperPtr &functor)
+{
+    registerConcurrentBackendType(Frontend::staticMetaObject, functor);
+}
+
 } // Qt3DCore
 
 QT_END_NAMESPACE
@@ -101,7 +101,7 @@ QAspectEnginePrivate::~QAspectEnginePrivate()
 void QAspectEnginePrivate::initNode(QNode *node)
 {
     QNodePrivate::get(node)->setScene(m_scene);
-    m_scene->addObservable(node);
+    m_nodesToAdd.push_back(node);
 }
 
 void QAspectEnginePrivate::initEntity(QEntity *entity)
@@ -219,6 +219,9 @@ void QAspectEnginePrivate::initNodeTree(QNode *node)
 {
     QNodeVisitor visitor;
     visitor.traverse(node, this, &QAspectEnginePrivate::initNode, &QAspectEnginePrivate::initEntity);
+    // The whole tree is added to the scene at once
+    m_scene->addObservables(m_nodesToAdd);
+    m_nodesToAdd.clear();
 }
 
 void QAspectEnginePrivate::initialize()
@@ -102,6 +102,7 @@ public:
     void initNodeTree(QNode *node);
     void initNode(QNode *node);
     void initEntity(QEntity *entity);
+    QVector<QNode *> m_nodesToAdd;
 
     void generateCreationChanges(QNode *rootNode);
     QVector<QNodeCreatedChangeBasePtr> m_creationChanges;
@@ -53,19 +53,62 @@
 #include <Qt3DCore/private/qscheduler_p.h>
 #include <Qt3DCore/private/qtickclock_p.h>
 #include <Qt3DCore/private/qabstractframeadvanceservice_p.h>
+#include <Qt3DCore/private/qeventfilterservice_p.h>
+#include <QAbstractEventDispatcher>
+#include <QElapsedTimer>
 #include <QEventLoop>
 #include <QThread>
 #include <QWaitCondition>
 #include <QSurface>
 
-#if defined(QT3D_CORE_JOB_TIMING)
-#include <QElapsedTimer>
-#endif
+#include <limits>
 
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DCore {
 
+namespace {
+
+// Sees all the events of the event source before the filters of the aspects
+// and wakes up the aspect manager on user input. The events are not consumed
+class InputEventWakeUpFilter : public QObject
+{
+public:
+    explicit InputEventWakeUpFilter(QAspectManager *aspectManager)
+        : m_aspectManager(aspectManager)
+    {
+    }
+
+    bool eventFilter(QObject *obj, QEvent *e) Q_DECL_FINAL
+    {
+        Q_UNUSED(obj);
+        switch (e->type()) {
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease:
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::MouseMove:
+        case QEvent::HoverMove:
+        case QEvent::Wheel:
+        case QEvent::TouchBegin:
+        case QEvent::TouchUpdate:
+        case QEvent::TouchEnd:
+        case QEvent::TouchCancel:
+            m_aspectManager->wakeUp();
+            break;
+        default:
+            break;
+        }
+        return false;
+    }
+
+private:
+    QAspectManager *m_aspectManager;
+};
+
+} // anonymous
+
 QAspectManager::QAspectManager(QObject *parent)
     : QObject(parent)
     , m_root(nullptr)
@@ -80,6 +123,10 @@ QAspectManager::QAspectManager(QObject *parent)
     qRegisterMetaType<QSurface *>("QSurface*");
     m_runSimulationLoop.fetchAndStoreOrdered(0);
     m_runMainLoop.fetchAndStoreOrdered(1);
+    m_wakeUpRequested.fetchAndStoreOrdered(0);
+    m_idleEnabled = !qEnvironmentVariableIsSet("QT3D_DISABLE_IDLE_FRAMES");
+    m_wakeUpEventFilter.reset(new InputEventWakeUpFilter(this));
+    m_changeArbiter->setAspectManager(this);
     qCDebug(Aspects) << Q_FUNC_INFO;
 }
 
@@ -106,6 +153,9 @@ void QAspectManager::exitSimulationLoop()
         return;
     }
 
+    // The simulation loop may be idle, waiting for a change
+    wakeUp();
+
     QAbstractFrameAdvanceService *frameAdvanceService =
             m_serviceLocator->service<QAbstractFrameAdvanceService>(QServiceLocator::FrameAdvanceService);
     if (frameAdvanceService)
@@ -133,6 +183,39 @@ bool QAspectManager::isShuttingDown() const
     return !m_runSimulationLoop.load();
 }
 
+/*!
+    \internal
+
+    Wakes up the simulation loop if it is idle, waiting for a change to be
+    made to the scene or for an input event. Can be called from any thread.
+*/
+void QAspectManager::wakeUp()
+{
+    // Only the first call after the simulation loop went to sleep needs to
+    // wake up the event dispatcher of the aspect thread
+    if (m_wakeUpRequested.load() != 0 || !m_wakeUpRequested.testAndSetOrdered(0, 1))
+        return;
+    QAbstractEventDispatcher *eventDispatcher = thread()->eventDispatcher();
+    if (eventDispatcher != nullptr)
+        eventDispatcher->wakeUp();
+}
+
+/*!
+    \internal
+
+    Returns true if none of the aspects has any work to do for the next frame.
+*/
+bool QAspectManager::aspectsAreIdle() const
+{
+    if (!m_idleEnabled)
+        return false;
+    for (QAbstractAspect *aspect : qAsConst(m_aspects)) {
+        if (!aspect->d_func()->isIdle())
+            return false;
+    }
+    return true;
+}
+
 /*!
     \internal
 
@@ -145,6 +228,10 @@ void QAspectManager::initialize()
     m_jobManager->initialize();
     m_scheduler->setAspectManager(this);
     m_changeArbiter->initialize(m_jobManager);
+    // The filters of the aspects queue the input events, wake up the
+    // simulation loop only once all of them have been called
+    m_serviceLocator->eventFilterService()->registerEventFilter(m_wakeUpEventFilter.data(),
+                                                                std::numeric_limits<int>::min());
 }
 
 /*!
@@ -160,6 +247,8 @@ void QAspectManager::shutdown()
     for (QAbstractAspect *aspect : qAsConst(m_aspects))
         m_changeArbiter->unregisterSceneObserver(aspect->d_func());
 
+    m_serviceLocator->eventFilterService()->unregisterEventFilter(m_wakeUpEventFilter.data());
+
     // Aspects must be deleted in the Thread they were created in
 }
 
@@ -178,8 +267,13 @@ void QAspectManager::setRootEntity(Qt3DCore::QEntity *root, const QVector<Qt3DCo
     m_root = root;
 
     if (m_root) {
+        // The backend nodes of all the aspects are created at once by the
+        // thread pool
+        QVector<QAspectJobPtr> jobs;
         for (QAbstractAspect *aspect : qAsConst(m_aspects))
-            aspect->d_func()->setRootAndCreateNodes(m_root, changes);
+            jobs += aspect->d_func()->setRootAndCreateNodesJobs(m_root, changes);
+        m_jobManager->enqueueJobs(jobs);
+        m_jobManager->waitForAllJobs();
     }
 }
 
@@ -270,8 +364,28 @@ void QAspectManager::exec()
             //
             // Doing this as the first call in the new frame ensures the lock free approach works
             // without any such data race.
+            m_wakeUpRequested.fetchAndStoreOrdered(0);
             m_changeArbiter->syncChanges();
 
+            // If none of the aspects has anything to do, wait for a change or an
+            // input event instead of scheduling jobs that would result in the
+            // same frame. We keep the frame granted by the frame advance service
+            // for when we're woken up
+            if (aspectsAreIdle()) {
+                QElapsedTimer idleTimer;
+                idleTimer.start();
+                do {
+                    if (m_wakeUpRequested.fetchAndStoreOrdered(0) == 0)
+                        eventLoop.processEvents(QEventLoop::WaitForMoreEvents);
+                    m_changeArbiter->syncChanges();
+                } while (m_runSimulationLoop.load() && aspectsAreIdle());
+
+                if (!m_runSimulationLoop.load())
+                    break;
+                t += idleTimer.nsecsElapsed();
+                frameAdvanceService->resume();
+            }
+
             // For each Aspect
             // Ask them to launch set of jobs for the current frame
             // Updates matrices, bounding volumes, render bins ...
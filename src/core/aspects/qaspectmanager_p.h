@@ -86,6 +86,8 @@ public:
 
     bool isShuttingDown() const;
 
+    void wakeUp();
+
 public Q_SLOTS:
     void initialize();
     void shutdown();
@@ -103,6 +105,8 @@ public Q_SLOTS:
     QServiceLocator *serviceLocator() const;
 
 private:
+    bool aspectsAreIdle() const;
+
     QVector<QAbstractAspect *> m_aspects;
     QEntity *m_root;
     QVariantMap m_data;
@@ -111,6 +115,9 @@ private:
     QChangeArbiter *m_changeArbiter;
     QAtomicInt m_runSimulationLoop;
     QAtomicInt m_runMainLoop;
+    QAtomicInt m_wakeUpRequested;
+    bool m_idleEnabled;
+    QScopedPointer<QObject> m_wakeUpEventFilter;
     QScopedPointer<QServiceLocator> m_serviceLocator;
     QSemaphore m_waitForEndOfSimulationLoop;
     QSemaphore m_waitForEndOfExecLoop;
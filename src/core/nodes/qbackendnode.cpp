@@ -53,6 +53,11 @@ QBackendNodeMapper::~QBackendNodeMapper()
 {
 }
 
+void QConcurrentBackendNodeMapper::prepareBackendNodes(const QVector<QNodeId> &ids) const
+{
+    Q_UNUSED(ids);
+}
+
 QBackendNodePrivate::QBackendNodePrivate(QBackendNode::Mode mode)
     : q_ptr(nullptr)
     , m_mode(mode)
@@ -89,6 +89,19 @@ private:
     Q_DISABLE_COPY(QBackendNodePrivate)
 };
 
+// Mapper whose create() and get() can be called from several threads at
+// once. Aspects register it with registerConcurrentBackendType so that its
+// nodes are created by batches from the job pool
+class QT3DCORE_PRIVATE_EXPORT QConcurrentBackendNodeMapper : public QBackendNodeMapper
+{
+public:
+    // Called from the creating thread before the nodes of a batch are created,
+    // lets the mapper allocate their storage at once
+    virtual void prepareBackendNodes(const QVector<QNodeId> &ids) const;
+};
+
+typedef QSharedPointer<QConcurrentBackendNodeMapper> QConcurrentBackendNodeMapperPtr;
+
 } // Qt3D
 
 QT_END_NAMESPACE
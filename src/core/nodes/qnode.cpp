@@ -155,8 +155,18 @@ void QNodePrivate::notifyDestructionChangesAndRemoveFromScene()
     }
 
     // We unset the scene from the node as its backend node was/is about to be destroyed
+    QScene *scene = m_scene;
     QNodeVisitor visitor;
-    visitor.traverse(q, this, &QNodePrivate::unsetSceneHelper);
+    QVector<QNode *> nodes;
+    visitor.traverse(q, [this, &nodes] (QNode *node) {
+        unsetSceneHelper(node);
+        nodes.push_back(node);
+    });
+    // removeObservables unsets the QChangeArbiter, for the whole subtree at once
+    if (scene != nullptr)
+        scene->removeObservables(nodes);
+    for (QNode *node : qAsConst(nodes))
+        node->d_func()->setScene(nullptr);
 }
 
 /*!
@@ -297,7 +307,13 @@ void QNodePrivate::_q_setParentHelper(QNode *parent)
             // Set the scene helper / arbiter
             if (newParentPrivate->m_scene) {
                 QNodeVisitor visitor;
-                visitor.traverse(q, newParentNode->d_func(), &QNodePrivate::setSceneHelper);
+                QVector<QNode *> nodes;
+                visitor.traverse(q, [newParentPrivate, &nodes] (QNode *node) {
+                    newParentPrivate->setSceneHelper(node);
+                    nodes.push_back(node);
+                });
+                // addObservables sets the QChangeArbiter, for the whole subtree at once
+                newParentPrivate->m_scene->addObservables(nodes);
             }
 
             notifyCreationChange();
@@ -360,15 +376,14 @@ void QNodePrivate::propertyChanged(int propertyIndex)
 
 /*!
     \internal
-    Recursively sets and adds the nodes in the subtree of base node \a root to the scene.
+    Sets the scene of the node \a root of the subtree being added to the scene.
     Also takes care of connecting Components and Entities together in the scene.
+    The caller adds the nodes of the subtree to the scene afterwards.
  */
 void QNodePrivate::setSceneHelper(QNode *root)
 {
     // Sets the scene
     root->d_func()->setScene(m_scene);
-    // addObservable sets the QChangeArbiter
-    m_scene->addObservable(root);
 
     // We also need to handle QEntity <-> QComponent relationships
     if (QComponent *c = qobject_cast<QComponent *>(root)) {
@@ -386,8 +401,9 @@ void QNodePrivate::setSceneHelper(QNode *root)
 /*!
     \internal
 
-    Recursively unsets and remove nodes in the subtree of base node \a root from
-    the scene. Also takes care of removing Components and Entities connections.
+    Removes the Components and Entities connections of the node \a root of the
+    subtree being removed from the scene. The caller removes the nodes of the
+    subtree from the scene and unsets their scene afterwards.
  */
 void QNodePrivate::unsetSceneHelper(QNode *root)
 {
@@ -399,10 +415,6 @@ void QNodePrivate::unsetSceneHelper(QNode *root)
                 m_scene->removeEntityForComponent(c->id(), entity->id());
         }
     }
-
-    if (m_scene != nullptr)
-        m_scene->removeObservable(root);
-    root->d_func()->setScene(nullptr);
 }
 
 /*!
@@ -40,6 +40,7 @@
 #include "qchangearbiter_p.h"
 #include "qcomponent.h"
 #include "qabstractaspectjobmanager_p.h"
+#include "qaspectmanager_p.h"
 
 #include "qsceneobserverinterface_p.h"
 #include <Qt3DCore/private/qscene_p.h>
@@ -77,6 +78,7 @@ QChangeArbiter::QChangeArbiter(QObject *parent)
     : QObject(parent)
     , m_mutex(QMutex::Recursive)
     , m_jobManager(nullptr)
+    , m_aspectManager(nullptr)
     , m_postman(nullptr)
     , m_scene(nullptr)
 {
@@ -106,8 +108,21 @@ void QChangeArbiter::initialize(QAbstractAspectJobManager *jobManager)
     m_jobManager->waitForPerThreadFunction(QChangeArbiter::createThreadLocalChangeQueue, this);
 }
 
+// The aspect manager is woken up whenever a change is received so that
+// it resumes scheduling jobs if it was idle
+void QChangeArbiter::setAspectManager(QAspectManager *aspectManager)
+{
+    m_aspectManager = aspectManager;
+}
+
 void QChangeArbiter::distributeQueueChanges(QChangeQueue *changeQueue)
 {
+    const auto isNodeCreation = [changeQueue] (int i) {
+        const QSceneChangePtr &change = (*changeQueue)[i];
+        return !change.isNull() && change->type() == NodeCreated;
+    };
+
+    int createdEnd = 0;
     for (int i = 0, n = int(changeQueue->size()); i < n; i++) {
         QSceneChangePtr& change = (*changeQueue)[i];
         // Lookup which observers care about the subject this change came from
@@ -116,8 +131,20 @@ void QChangeArbiter::distributeQueueChanges(QChangeQueue *changeQueue)
             continue;
 
         if (change->type() == NodeCreated) {
-            for (QSceneObserverInterface *observer : qAsConst(m_sceneObservers))
-                observer->sceneNodeAdded(change);
+            // Consecutive creations, typically the nodes of a subtree being
+            // inserted, are handed over at once so that the aspects can create
+            // the backend nodes by batches
+            if (i >= createdEnd) {
+                createdEnd = i + 1;
+                while (createdEnd < n && isNodeCreation(createdEnd))
+                    ++createdEnd;
+                QVector<QSceneChangePtr> createdChanges;
+                createdChanges.reserve(createdEnd - i);
+                for (int j = i; j < createdEnd; ++j)
+                    createdChanges.push_back((*changeQueue)[j]);
+                for (QSceneObserverInterface *observer : qAsConst(m_sceneObservers))
+                    observer->sceneNodesAdded(createdChanges);
+            }
         } else if (change->type() == NodeDeleted) {
             for (QSceneObserverInterface *observer : qAsConst(m_sceneObservers))
                 observer->sceneNodeRemoved(change);
@@ -238,6 +265,9 @@ void QChangeArbiter::sceneChangeEvent(const QSceneChangePtr &e)
     QChangeQueue *localChangeQueue = m_tlsChangeQueue.localData();
     localChangeQueue->push_back(e);
 
+    if (m_aspectManager != nullptr)
+        m_aspectManager->wakeUp();
+
     //    qCDebug(ChangeArbiter) << "Change queue for thread" << QThread::currentThread() << "now contains" << localChangeQueue->count() << "items";
 }
 
@@ -253,6 +283,9 @@ void QChangeArbiter::sceneChangeEventWithLock(const QSceneChangeList &e)
     QChangeQueue *localChangeQueue = m_tlsChangeQueue.localData();
     qCDebug(ChangeArbiter) << Q_FUNC_INFO << "Handles " << e.size() << " changes at once";
     localChangeQueue->insert(localChangeQueue->end(), e.begin(), e.end());
+
+    if (m_aspectManager != nullptr)
+        m_aspectManager->wakeUp();
 }
 
 // Either we have the postman or we could make the QChangeArbiter agnostic to the postman
@@ -71,6 +71,7 @@ namespace Qt3DCore {
 class QNode;
 class QObservableInterface;
 class QAbstractAspectJobManager;
+class QAspectManager;
 class QSceneObserverInterface;
 class QAbstractPostman;
 class QScene;
@@ -92,6 +93,7 @@ public:
     ~QChangeArbiter();
 
     void initialize(Qt3DCore::QAbstractAspectJobManager *jobManager);
+    void setAspectManager(Qt3DCore::QAspectManager *aspectManager);
 
     void syncChanges();
 
@@ -135,6 +137,7 @@ protected:
 private:
     QMutex m_mutex;
     QAbstractAspectJobManager *m_jobManager;
+    QAspectManager *m_aspectManager;
 
     // The lists of observers indexed by observable. We maintain two
     // distinct hashes:
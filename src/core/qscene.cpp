@@ -40,6 +40,8 @@
 #include "qscene_p.h"
 #include <QHash>
 #include <QReadLocker>
+#include <QVarLengthArray>
+#include <algorithm>
 #include <Qt3DCore/qnode.h>
 #include <Qt3DCore/private/qlockableobserverinterface_p.h>
 #include <Qt3DCore/private/qobservableinterface_p.h>
@@ -49,24 +51,80 @@ QT_BEGIN_NAMESPACE
 
 namespace Qt3DCore {
 
+namespace {
+
+// Power of two, the shard of a key is picked by masking its hash
+const int ShardCount = 16;
+
+inline int shardIndex(uint hash)
+{
+    // Node ids are sequential and observables are aligned pointers, fold the
+    // higher bits in so that both spread over the shards
+    return int((hash ^ (hash >> 4) ^ (hash >> 8)) & (ShardCount - 1));
+}
+
+} // anonymous
+
 class QScenePrivate
 {
 public:
+    // The lookup tables are split in shards that each have their own lock.
+    // Looking a node up only locks the shard of its id, which keeps frontend
+    // lookups from waiting behind the insertion of other subtrees
+    struct NodeShard
+    {
+        mutable QReadWriteLock lock;
+        QHash<QNodeId, QNode *> nodeLookupTable;
+        QMultiHash<QNodeId, QNodeId> componentToEntities;
+        QMultiHash<QNodeId, QObservableInterface *> observablesLookupTable;
+    };
+
+    struct ObservableShard
+    {
+        mutable QReadWriteLock lock;
+        QHash<QObservableInterface *, QNodeId> observableToUuid;
+    };
+
     QScenePrivate(QAspectEngine *engine)
         : m_engine(engine)
         , m_arbiter(nullptr)
     {
     }
 
+    NodeShard &nodeShard(QNodeId id) { return m_nodeShards[shardIndex(qHash(id))]; }
+    const NodeShard &nodeShard(QNodeId id) const { return m_nodeShards[shardIndex(qHash(id))]; }
+    ObservableShard &observableShard(QObservableInterface *observable) { return m_observableShards[shardIndex(qHash(observable))]; }
+    const ObservableShard &observableShard(QObservableInterface *observable) const { return m_observableShards[shardIndex(qHash(observable))]; }
+
+    // Buckets the nodes by shard so that each shard is locked only once
+    static QVector<QNode *> nodesByShard(const QVector<QNode *> &nodes, int *shardStarts);
+
     QAspectEngine *m_engine;
-    QHash<QNodeId, QNode *> m_nodeLookupTable;
-    QMultiHash<QNodeId, QNodeId> m_componentToEntities;
-    QMultiHash<QNodeId, QObservableInterface *> m_observablesLookupTable;
-    QHash<QObservableInterface *, QNodeId> m_observableToUuid;
+    NodeShard m_nodeShards[ShardCount];
+    ObservableShard m_observableShards[ShardCount];
     QLockableObserverInterface *m_arbiter;
-    mutable QReadWriteLock m_lock;
 };
 
+QVector<QNode *> QScenePrivate::nodesByShard(const QVector<QNode *> &nodes, int *shardStarts)
+{
+    // Counting sort of the nodes on their shard, shardStarts holds
+    // ShardCount + 1 offsets into the returned vector
+    QVarLengthArray<int, 1024> shards(nodes.size());
+    std::fill(shardStarts, shardStarts + ShardCount + 1, 0);
+    for (int i = 0, m = nodes.size(); i < m; ++i) {
+        shards[i] = shardIndex(qHash(nodes.at(i)->id()));
+        ++shardStarts[shards[i] + 1];
+    }
+    for (int i = 0; i < ShardCount; ++i)
+        shardStarts[i + 1] += shardStarts[i];
+
+    int offsets[ShardCount];
+    std::copy(shardStarts, shardStarts + ShardCount, offsets);
+    QVector<QNode *> sortedNodes(nodes.size());
+    for (int i = 0, m = nodes.size(); i < m; ++i)
+        sortedNodes[offsets[shards[i]]++] = nodes.at(i);
+    return sortedNodes;
+}
 
 QScene::QScene(QAspectEngine *engine)
     : d_ptr(new QScenePrivate(engine))
@@ -87,9 +145,16 @@ QAspectEngine *QScene::engine() const
 void QScene::addObservable(QObservableInterface *observable, QNodeId id)
 {
     Q_D(QScene);
-    QWriteLocker lock(&d->m_lock);
-    d->m_observablesLookupTable.insert(id, observable);
-    d->m_observableToUuid.insert(observable, id);
+    {
+        QScenePrivate::NodeShard &shard = d->nodeShard(id);
+        QWriteLocker lock(&shard.lock);
+        shard.observablesLookupTable.insert(id, observable);
+    }
+    {
+        QScenePrivate::ObservableShard &shard = d->observableShard(observable);
+        QWriteLocker lock(&shard.lock);
+        shard.observableToUuid.insert(observable, id);
+    }
     if (d->m_arbiter != nullptr)
         observable->setArbiter(d->m_arbiter);
 }
@@ -99,20 +164,48 @@ void QScene::addObservable(QNode *observable)
 {
     Q_D(QScene);
     if (observable != nullptr) {
-        QWriteLocker lock(&d->m_lock);
-        d->m_nodeLookupTable.insert(observable->id(), observable);
+        QScenePrivate::NodeShard &shard = d->nodeShard(observable->id());
+        QWriteLocker lock(&shard.lock);
+        shard.nodeLookupTable.insert(observable->id(), observable);
         if (d->m_arbiter != nullptr)
             observable->d_func()->setArbiter(d->m_arbiter);
     }
 }
 
+// Called by main thread only
+void QScene::addObservables(const QVector<QNode *> &observables)
+{
+    Q_D(QScene);
+    int shardStarts[ShardCount + 1];
+    const QVector<QNode *> sortedObservables = QScenePrivate::nodesByShard(observables, shardStarts);
+    for (int i = 0; i < ShardCount; ++i) {
+        if (shardStarts[i] == shardStarts[i + 1])
+            continue;
+        QScenePrivate::NodeShard &shard = d->m_nodeShards[i];
+        QWriteLocker lock(&shard.lock);
+        for (int j = shardStarts[i]; j < shardStarts[i + 1]; ++j) {
+            QNode *observable = sortedObservables.at(j);
+            shard.nodeLookupTable.insert(observable->id(), observable);
+            if (d->m_arbiter != nullptr)
+                observable->d_func()->setArbiter(d->m_arbiter);
+        }
+    }
+}
+
 // Called by any thread
 void QScene::removeObservable(QObservableInterface *observable, QNodeId id)
 {
     Q_D(QScene);
-    QWriteLocker lock(&d->m_lock);
-    d->m_observablesLookupTable.remove(id, observable);
-    d->m_observableToUuid.remove(observable);
+    {
+        QScenePrivate::NodeShard &shard = d->nodeShard(id);
+        QWriteLocker lock(&shard.lock);
+        shard.observablesLookupTable.remove(id, observable);
+    }
+    {
+        QScenePrivate::ObservableShard &shard = d->observableShard(observable);
+        QWriteLocker lock(&shard.lock);
+        shard.observableToUuid.remove(observable);
+    }
     observable->setArbiter(nullptr);
 }
 
@@ -121,17 +214,61 @@ void QScene::removeObservable(QNode *observable)
 {
     Q_D(QScene);
     if (observable != nullptr) {
-        QWriteLocker lock(&d->m_lock);
-        QNodeId nodeUuid = observable->id();
-        const auto p = d->m_observablesLookupTable.equal_range(nodeUuid); // must be non-const equal_range to ensure p.second stays valid
-        auto it = p.first;
-        while (it != p.second) {
-            it.value()->setArbiter(nullptr);
-            d->m_observableToUuid.remove(it.value());
-            it = d->m_observablesLookupTable.erase(it);
+        const QNodeId nodeUuid = observable->id();
+        QVarLengthArray<QObservableInterface *, 8> removedObservables;
+        {
+            QScenePrivate::NodeShard &shard = d->nodeShard(nodeUuid);
+            QWriteLocker lock(&shard.lock);
+            const auto p = shard.observablesLookupTable.equal_range(nodeUuid); // must be non-const equal_range to ensure p.second stays valid
+            auto it = p.first;
+            while (it != p.second) {
+                it.value()->setArbiter(nullptr);
+                removedObservables.push_back(it.value());
+                it = shard.observablesLookupTable.erase(it);
+            }
+            shard.nodeLookupTable.remove(nodeUuid);
         }
-        d->m_nodeLookupTable.remove(nodeUuid);
         observable->d_func()->setArbiter(nullptr);
+
+        for (QObservableInterface *o : qAsConst(removedObservables)) {
+            QScenePrivate::ObservableShard &shard = d->observableShard(o);
+            QWriteLocker lock(&shard.lock);
+            shard.observableToUuid.remove(o);
+        }
+    }
+}
+
+// Called by main thread
+void QScene::removeObservables(const QVector<QNode *> &observables)
+{
+    Q_D(QScene);
+    int shardStarts[ShardCount + 1];
+    const QVector<QNode *> sortedObservables = QScenePrivate::nodesByShard(observables, shardStarts);
+    QVector<QObservableInterface *> removedObservables;
+    for (int i = 0; i < ShardCount; ++i) {
+        if (shardStarts[i] == shardStarts[i + 1])
+            continue;
+        QScenePrivate::NodeShard &shard = d->m_nodeShards[i];
+        QWriteLocker lock(&shard.lock);
+        for (int j = shardStarts[i]; j < shardStarts[i + 1]; ++j) {
+            QNode *observable = sortedObservables.at(j);
+            const QNodeId nodeUuid = observable->id();
+            const auto p = shard.observablesLookupTable.equal_range(nodeUuid); // must be non-const equal_range to ensure p.second stays valid
+            auto it = p.first;
+            while (it != p.second) {
+                it.value()->setArbiter(nullptr);
+                removedObservables.push_back(it.value());
+                it = shard.observablesLookupTable.erase(it);
+            }
+            shard.nodeLookupTable.remove(nodeUuid);
+            observable->d_func()->setArbiter(nullptr);
+        }
+    }
+
+    for (QObservableInterface *observable : qAsConst(removedObservables)) {
+        QScenePrivate::ObservableShard &shard = d->observableShard(observable);
+        QWriteLocker lock(&shard.lock);
+        shard.observableToUuid.remove(observable);
     }
 }
 
@@ -139,34 +276,50 @@ void QScene::removeObservable(QNode *observable)
 QObservableList QScene::lookupObservables(QNodeId id) const
 {
     Q_D(const QScene);
-    QReadLocker lock(&d->m_lock);
-    return d->m_observablesLookupTable.values(id);
+    const QScenePrivate::NodeShard &shard = d->nodeShard(id);
+    QReadLocker lock(&shard.lock);
+    return shard.observablesLookupTable.values(id);
 }
 
 // Called by any thread
 QNode *QScene::lookupNode(QNodeId id) const
 {
     Q_D(const QScene);
-    QReadLocker lock(&d->m_lock);
-    return d->m_nodeLookupTable.value(id);
+    const QScenePrivate::NodeShard &shard = d->nodeShard(id);
+    QReadLocker lock(&shard.lock);
+    return shard.nodeLookupTable.value(id);
 }
 
 QVector<QNode *> QScene::lookupNodes(const QVector<QNodeId> &ids) const
 {
     Q_D(const QScene);
-    QReadLocker lock(&d->m_lock);
     QVector<QNode *> nodes(ids.size());
-    int index = 0;
-    for (QNodeId id : ids)
-        nodes[index++] = d->m_nodeLookupTable.value(id);
+    // Visit the ids shard by shard so that each shard is locked once
+    QVarLengthArray<int, 1024> shards(ids.size());
+    quint32 usedShards = 0;
+    for (int i = 0, m = ids.size(); i < m; ++i) {
+        shards[i] = shardIndex(qHash(ids.at(i)));
+        usedShards |= 1U << shards[i];
+    }
+    for (int s = 0; s < ShardCount; ++s) {
+        if (!(usedShards & (1U << s)))
+            continue;
+        const QScenePrivate::NodeShard &shard = d->m_nodeShards[s];
+        QReadLocker lock(&shard.lock);
+        for (int i = 0, m = ids.size(); i < m; ++i) {
+            if (shards[i] == s)
+                nodes[i] = shard.nodeLookupTable.value(ids.at(i));
+        }
+    }
     return nodes;
 }
 
 QNodeId QScene::nodeIdFromObservable(QObservableInterface *observable) const
 {
     Q_D(const QScene);
-    QReadLocker lock(&d->m_lock);
-    return d->m_observableToUuid.value(observable);
+    const QScenePrivate::ObservableShard &shard = d->observableShard(observable);
+    QReadLocker lock(&shard.lock);
+    return shard.observableToUuid.value(observable);
 }
 
 void QScene::setArbiter(QLockableObserverInterface *arbiter)
@@ -184,9 +337,10 @@ QLockableObserverInterface *QScene::arbiter() const
 QVector<QNodeId> QScene::entitiesForComponent(QNodeId id) const
 {
     Q_D(const QScene);
-    QReadLocker lock(&d->m_lock);
+    const QScenePrivate::NodeShard &shard = d->nodeShard(id);
+    QReadLocker lock(&shard.lock);
     QVector<QNodeId> result;
-    const auto p = d->m_componentToEntities.equal_range(id);
+    const auto p = shard.componentToEntities.equal_range(id);
     for (auto it = p.first; it != p.second; ++it)
         result.push_back(*it);
     return result;
@@ -195,22 +349,25 @@ QVector<QNodeId> QScene::entitiesForComponent(QNodeId id) const
 void QScene::addEntityForComponent(QNodeId componentUuid, QNodeId entityUuid)
 {
     Q_D(QScene);
-    QWriteLocker lock(&d->m_lock);
-    d->m_componentToEntities.insert(componentUuid, entityUuid);
+    QScenePrivate::NodeShard &shard = d->nodeShard(componentUuid);
+    QWriteLocker lock(&shard.lock);
+    shard.componentToEntities.insert(componentUuid, entityUuid);
 }
 
 void QScene::removeEntityForComponent(QNodeId componentUuid, QNodeId entityUuid)
 {
     Q_D(QScene);
-    QWriteLocker lock(&d->m_lock);
-    d->m_componentToEntities.remove(componentUuid, entityUuid);
+    QScenePrivate::NodeShard &shard = d->nodeShard(componentUuid);
+    QWriteLocker lock(&shard.lock);
+    shard.componentToEntities.remove(componentUuid, entityUuid);
 }
 
 bool QScene::hasEntityForComponent(QNodeId componentUuid, QNodeId entityUuid)
 {
     Q_D(QScene);
-    QReadLocker lock(&d->m_lock);
-    return d->m_componentToEntities.values(componentUuid).contains(entityUuid);
+    const QScenePrivate::NodeShard &shard = d->nodeShard(componentUuid);
+    QReadLocker lock(&shard.lock);
+    return shard.componentToEntities.contains(componentUuid, entityUuid);
 }
 
 } // Qt3D
@@ -75,8 +75,10 @@ public:
 
     void addObservable(QObservableInterface *observable, QNodeId id);
     void addObservable(QNode *observable);
+    void addObservables(const QVector<QNode *> &observables);
     void removeObservable(QObservableInterface *observable, QNodeId id);
     void removeObservable(QNode *observable);
+    void removeObservables(const QVector<QNode *> &observables);
     QObservableList lookupObservables(QNodeId id) const;
 
     QNode *lookupNode(QNodeId id) const;
@@ -47,6 +47,12 @@ QSceneObserverInterface::~QSceneObserverInterface()
 {
 }
 
+void QSceneObserverInterface::sceneNodesAdded(QVector<QSceneChangePtr> &e)
+{
+    for (QSceneChangePtr &change : e)
+        sceneNodeAdded(change);
+}
+
 } // Qt3D
 
 QT_END_NAMESPACE
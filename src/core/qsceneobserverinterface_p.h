@@ -53,6 +53,7 @@
 
 #include <Qt3DCore/private/qt3dcore_global_p.h>
 #include <Qt3DCore/qscenechange.h>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -68,6 +69,8 @@ public:
 private:
     virtual void sceneNodeAdded(QSceneChangePtr &e) = 0;
     virtual void sceneNodeRemoved(QSceneChangePtr &e) = 0;
+    // Consecutive node creations, such as the nodes of an inserted subtree
+    virtual void sceneNodesAdded(QVector<QSceneChangePtr> &e);
 
     friend class QChangeArbiter;
 };
@@ -468,6 +468,20 @@ public:
         return handle;
     }
 
+    // Acquires the handles of several resources at once, taking the write
+    // lock a single time rather than once per resource
+    void getOrAcquireHandles(const QVector<KeyType> &ids)
+    {
+        typename LockingPolicy<QResourceManager>::WriteLocker writeLock(this);
+        for (const KeyType &id : ids) {
+            QHandle<ValueType, INDEXBITS> &handleToSet = m_keyToHandleMap[id];
+            if (handleToSet.isNull()) {
+                handleToSet = m_handleManager.acquire(AllocatingPolicy<ValueType, INDEXBITS>::allocateResource());
+                m_activeHandles.push_back(handleToSet);
+            }
+        }
+    }
+
     QHandle<ValueType, INDEXBITS> lookupHandle(const KeyType &id)
     {
         typename LockingPolicy<QResourceManager>::ReadLocker lock(this);
@@ -88,6 +88,15 @@ QAbstractFrameAdvanceService::QAbstractFrameAdvanceService(QAbstractFrameAdvance
     Stops the service, performing any cleanup deemed necessary.
 */
 
+/*
+    Called when the jobs of the frame granted by the last call to
+    waitForNextFrame() start after the aspect thread has been idle, waiting
+    for a change. The default implementation does nothing.
+*/
+void QAbstractFrameAdvanceService::resume()
+{
+}
+
 } // Qt3D
 
 QT_END_NAMESPACE
@@ -67,6 +67,7 @@ public:
     virtual qint64 waitForNextFrame() = 0;
     virtual void start() = 0;
     virtual void stop() = 0;
+    virtual void resume();
 
 protected:
     QAbstractFrameAdvanceService(const QString &description = QString());
@@ -310,6 +310,28 @@ void InputHandler::updateEventSource()
     }
 }
 
+// Called by QInputAspect in the aspect thread once the changes of the frame
+// have been distributed. Returns true if there are no events to dispatch and
+// no logical device to update
+bool InputHandler::isIdle() const
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        if (!m_pendingKeyEvents.isEmpty() || !m_pendingMouseEvents.isEmpty() || !m_pendingWheelEvents.isEmpty())
+            return false;
+    }
+
+    // Focus changes are dispatched even if no key was pressed
+    for (const HKeyboardDevice cHandle : m_activeKeyboardDevices) {
+        KeyboardDevice *keyboardDevice = m_keyboardDeviceManager->data(cHandle);
+        if (keyboardDevice && keyboardDevice->lastKeyboardInputRequester() != keyboardDevice->currentFocusItem())
+            return false;
+    }
+
+    // Axes and actions are updated every frame
+    return m_logicalDeviceManager->activeDevices().isEmpty();
+}
+
 AbstractActionInput *InputHandler::lookupActionInput(Qt3DCore::QNodeId id) const
 {
     AbstractActionInput *input = nullptr;
@@ -145,6 +145,7 @@ public:
     EventSourceSetterHelper *eventSourceHelper() const;
 
     void updateEventSource();
+    bool isIdle() const;
 
     AbstractActionInput *lookupActionInput(Qt3DCore::QNodeId id) const;
 
@@ -179,6 +179,23 @@ void QInputAspectPrivate::loadInputDevicePlugins()
     }
 }
 
+/*!
+    \internal
+ */
+bool QInputAspectPrivate::isIdle()
+{
+    // A new event source doesn't require a frame to be installed
+    m_inputHandler->updateEventSource();
+
+    // The integrations loaded from plugins poll their devices every frame
+    const auto integrations = m_inputHandler->inputDeviceIntegrations();
+    for (QInputDeviceIntegration *integration : integrations) {
+        if (integration != m_keyboardMouseIntegration.data())
+            return false;
+    }
+    return m_inputHandler->isIdle();
+}
+
 /*!
     Create a physical device identified by \a name using the input device integrations present
     returns a Q_NULLPTR if it is not found.
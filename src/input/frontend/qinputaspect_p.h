@@ -69,6 +69,7 @@ class QInputAspectPrivate : public Qt3DCore::QAbstractAspectPrivate
 public:
     QInputAspectPrivate();
     void loadInputDevicePlugins();
+    bool isIdle() Q_DECL_OVERRIDE;
 
     Q_DECLARE_PUBLIC(QInputAspect)
     QScopedPointer<Input::InputHandler> m_inputHandler;
@@ -0,0 +1,110 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "backendframeaction_p.h"
+#include "manager_p.h"
+#include "managers_p.h"
+#include "qbackendframeaction_p.h"
+#include <Qt3DCore/qnodecreatedchange.h>
+#include <Qt3DCore/qpropertyupdatedchange.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DLogic {
+namespace Logic {
+
+BackendFrameAction::BackendFrameAction()
+    : m_logicManager(nullptr)
+{
+}
+
+/*!
+   \internal
+
+   Called from the context of a thread pool thread
+*/
+void BackendFrameAction::trigger(float dt)
+{
+    if (isEnabled() && m_callback)
+        (*m_callback)(dt);
+}
+
+void BackendFrameAction::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &change)
+{
+    const auto typedChange = qSharedPointerCast<Qt3DCore::QNodeCreatedChange<QBackendFrameActionData>>(change);
+    m_callback = typedChange->data.callback;
+    m_logicManager->appendBackendFrameAction(this);
+}
+
+void BackendFrameAction::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
+{
+    if (e->type() == Qt3DCore::PropertyUpdated) {
+        const auto propertyChange = qSharedPointerCast<Qt3DCore::QPropertyUpdatedChange>(e);
+        if (propertyChange->propertyName() == QByteArrayLiteral("callback"))
+            m_callback = propertyChange->value().value<QBackendFrameCallbackPtr>();
+    }
+    QBackendNode::sceneChangeEvent(e);
+}
+
+BackendFrameActionFunctor::BackendFrameActionFunctor(Manager *manager)
+    : m_manager(manager)
+{
+}
+
+Qt3DCore::QBackendNode *BackendFrameActionFunctor::create(const Qt3DCore::QNodeCreatedChangeBasePtr &change) const
+{
+    BackendFrameAction *action = m_manager->backendFrameActionManager()->getOrCreateResource(change->subjectId());
+    action->setManager(m_manager);
+    return action;
+}
+
+Qt3DCore::QBackendNode *BackendFrameActionFunctor::get(Qt3DCore::QNodeId id) const
+{
+    return m_manager->backendFrameActionManager()->lookupResource(id);
+}
+
+void BackendFrameActionFunctor::destroy(Qt3DCore::QNodeId id) const
+{
+    m_manager->removeBackendFrameAction(id);
+}
+
+} // namespace Logic
+} // namespace Qt3DLogic
+
+QT_END_NAMESPACE
@@ -41,6 +41,7 @@
 #include <Qt3DLogic/qframeaction.h>
 #include <Qt3DCore/qnode.h>
 #include <Qt3DCore/private/qscene_p.h>
+#include <QtCore/qcoreapplication.h>
 #include <QtCore/qsemaphore.h>
 
 QT_BEGIN_NAMESPACE
@@ -53,6 +54,9 @@ namespace Logic {
 Executor::Executor(QObject *parent)
     : QObject(parent)
     , m_scene(nullptr)
+    , m_semaphore(nullptr)
+    , m_postedDt(0.0f)
+    , m_updatePosted(false)
 {
 }
 
@@ -62,6 +66,11 @@ void Executor::clearQueueAndProceed()
     // If the semaphore is acquired, release it to allow the logic job and hence the
     // manager and frame to complete and shutdown to continue.
     m_nodeIds.clear();
+    {
+        QMutexLocker lock(&m_mutex);
+        m_postedNodeIds.clear();
+        m_postedDt = 0.0f;
+    }
     if (m_semaphore->available() == 0)
         m_semaphore->release();
 }
@@ -71,11 +80,33 @@ void Executor::enqueueLogicFrameUpdates(const QVector<Qt3DCore::QNodeId> &nodeId
     m_nodeIds = nodeIds;
 }
 
+/*!
+   \internal
+
+   Called from context of a thread pool thread. Unlike enqueueLogicFrameUpdates,
+   the caller doesn't wait for the updates to be processed. Only one update is
+   pending at a time, it triggers the latest \a nodeIds with the time elapsed
+   since the previous processed update.
+*/
+void Executor::postLogicFrameUpdates(const QVector<Qt3DCore::QNodeId> &nodeIds, float dt)
+{
+    QMutexLocker lock(&m_mutex);
+    m_postedNodeIds = nodeIds;
+    m_postedDt += dt;
+    if (m_updatePosted)
+        return;
+    m_updatePosted = true;
+    qApp->postEvent(this, new FrameUpdateEvent(0.0f, false));
+}
+
 bool Executor::event(QEvent *e)
 {
     if (e->type() == QEvent::User) {
         FrameUpdateEvent *ev = static_cast<FrameUpdateEvent *>(e);
-        processLogicFrameUpdates(ev->deltaTime());
+        if (ev->isBlocking())
+            processLogicFrameUpdates(ev->deltaTime());
+        else
+            processPostedLogicFrameUpdates();
         e->setAccepted(true);
         return true;
     }
@@ -89,17 +120,42 @@ bool Executor::event(QEvent *e)
 */
 void Executor::processLogicFrameUpdates(float dt)
 {
-    Q_ASSERT(m_scene);
     Q_ASSERT(m_semaphore);
-    const QVector<QNode *> nodes = m_scene->lookupNodes(m_nodeIds);
+    triggerFrameActions(m_nodeIds, dt);
+
+    // Release the semaphore so the calling Manager can continue
+    m_semaphore->release();
+}
+
+/*!
+   \internal
+
+   Called from context of main thread
+*/
+void Executor::processPostedLogicFrameUpdates()
+{
+    QVector<Qt3DCore::QNodeId> nodeIds;
+    float dt = 0.0f;
+    {
+        QMutexLocker lock(&m_mutex);
+        nodeIds = std::move(m_postedNodeIds);
+        m_postedNodeIds.clear();
+        dt = m_postedDt;
+        m_postedDt = 0.0f;
+        m_updatePosted = false;
+    }
+    triggerFrameActions(nodeIds, dt);
+}
+
+void Executor::triggerFrameActions(const QVector<Qt3DCore::QNodeId> &nodeIds, float dt)
+{
+    Q_ASSERT(m_scene);
+    const QVector<QNode *> nodes = m_scene->lookupNodes(nodeIds);
     for (QNode *node : nodes) {
         QFrameAction *frameAction = qobject_cast<QFrameAction *>(node);
         if (frameAction)
             frameAction->onTriggered(dt);
     }
-
-    // Release the semaphore so the calling Manager can continue
-    m_semaphore->release();
 }
 
 } // namespace Logic
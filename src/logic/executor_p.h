@@ -53,6 +53,7 @@
 
 #include <QtCore/qobject.h>
 #include <QtCore/qcoreevent.h>
+#include <QtCore/qmutex.h>
 #include <Qt3DCore/qnodeid.h>
 
 QT_BEGIN_NAMESPACE
@@ -69,18 +70,21 @@ namespace Logic {
 class FrameUpdateEvent : public QEvent
 {
 public:
-    FrameUpdateEvent(float dt)
+    FrameUpdateEvent(float dt, bool blocking = true)
         : QEvent(QEvent::User)
         , m_dt(dt)
+        , m_blocking(blocking)
     {}
 
     float deltaTime() const { return m_dt; }
+    bool isBlocking() const { return m_blocking; }
 
 private:
     float m_dt;
+    bool m_blocking;
 };
 
-class Executor : public QObject
+class Q_AUTOTEST_EXPORT Executor : public QObject
 {
     Q_OBJECT
 public:
@@ -90,17 +94,28 @@ public:
     void setSemephore(QSemaphore *semaphore) { m_semaphore = semaphore; }
     void clearQueueAndProceed();
 
+    void postLogicFrameUpdates(const QVector<Qt3DCore::QNodeId> &nodeIds, float dt);
+
 public Q_SLOTS:
     void enqueueLogicFrameUpdates(const QVector<Qt3DCore::QNodeId> &nodeIds);
 
 protected:
     bool event(QEvent *e);
     void processLogicFrameUpdates(float dt);
+    void processPostedLogicFrameUpdates();
 
 private:
+    void triggerFrameActions(const QVector<Qt3DCore::QNodeId> &nodeIds, float dt);
+
     QVector<Qt3DCore::QNodeId> m_nodeIds;
     Qt3DCore::QScene *m_scene;
     QSemaphore *m_semaphore;
+
+    // Updates posted without waiting for them, guarded by m_mutex
+    QMutex m_mutex;
+    QVector<Qt3DCore::QNodeId> m_postedNodeIds;
+    float m_postedDt;
+    bool m_updatePosted;
 };
 
 } // namespace Logic
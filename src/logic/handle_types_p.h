@@ -59,7 +59,9 @@ namespace Qt3DLogic {
 namespace Logic {
 
 class Handler;
+class BackendFrameAction;
 typedef Qt3DCore::QHandle<Handler, 16> HHandler;
+typedef Qt3DCore::QHandle<BackendFrameAction, 16> HBackendFrameAction;
 
 } // namespace Logic
 } // namespace Qt3DLogic
@@ -5,6 +5,9 @@ HEADERS += \
     $$PWD/qlogicaspect.h \
     $$PWD/qlogicaspect_p.h \
     $$PWD/qframeaction.h \
+    $$PWD/qbackendframeaction.h \
+    $$PWD/qbackendframeaction_p.h \
+    $$PWD/backendframeaction_p.h \
     $$PWD/handle_types_p.h \
     $$PWD/qframeaction_p.h \
     $$PWD/callbackjob_p.h \
@@ -17,6 +20,8 @@ HEADERS += \
 SOURCES += \
     $$PWD/qlogicaspect.cpp \
     $$PWD/qframeaction.cpp \
+    $$PWD/qbackendframeaction.cpp \
+    $$PWD/backendframeaction.cpp \
     $$PWD/manager.cpp \
     $$PWD/handler.cpp \
     $$PWD/executor.cpp \
@@ -55,8 +55,12 @@ namespace Logic {
 
 Manager::Manager()
     : m_logicHandlerManager(new HandlerManager)
+    , m_logicAspect(nullptr)
+    , m_executor(nullptr)
     , m_semaphore(1)
     , m_dt(0.0f)
+    , m_backendFrameActionManager(new BackendFrameActionManager)
+    , m_blocking(qEnvironmentVariableIsEmpty("QT3DLOGIC_ASYNC_FRAME_ACTIONS"))
 {
     m_semaphore.acquire();
 }
@@ -87,6 +91,17 @@ void Manager::removeHandler(Qt3DCore::QNodeId id)
     m_logicHandlerManager->releaseResource(id);
 }
 
+void Manager::appendBackendFrameAction(BackendFrameAction *action)
+{
+    m_backendFrameActionIds.append(action->peerId());
+}
+
+void Manager::removeBackendFrameAction(Qt3DCore::QNodeId id)
+{
+    m_backendFrameActionIds.removeAll(id);
+    m_backendFrameActionManager->releaseResource(id);
+}
+
 void Manager::triggerLogicFrameUpdates()
 {
     Q_ASSERT(m_executor);
@@ -96,12 +111,33 @@ void Manager::triggerLogicFrameUpdates()
     if (Qt3DCore::QAbstractAspectPrivate::get(m_logicAspect)->m_aspectManager->isShuttingDown())
         return;
 
-    // Trigger the main thread to process logic frame updates for each
-    // logic component and then wait until done. The Executor will
-    // release the semaphore when it has completed its work.
-    m_executor->enqueueLogicFrameUpdates(m_logicComponentIds);
-    qApp->postEvent(m_executor, new FrameUpdateEvent(m_dt));
-    m_semaphore.acquire();
+    const bool waitForFrameActions = m_blocking && !m_logicComponentIds.isEmpty();
+    if (waitForFrameActions) {
+        // Trigger the main thread to process logic frame updates for each
+        // logic component and then wait until done. The Executor will
+        // release the semaphore when it has completed its work.
+        m_executor->enqueueLogicFrameUpdates(m_logicComponentIds);
+        qApp->postEvent(m_executor, new FrameUpdateEvent(m_dt));
+    } else if (!m_logicComponentIds.isEmpty()) {
+        // Let the main thread process the updates whenever it gets to them,
+        // the frames it misses are coalesced into a single update
+        m_executor->postLogicFrameUpdates(m_logicComponentIds, m_dt);
+    }
+
+    // Meanwhile run the backend frame actions on this thread
+    triggerBackendFrameActions();
+
+    if (waitForFrameActions)
+        m_semaphore.acquire();
+}
+
+void Manager::triggerBackendFrameActions()
+{
+    for (const Qt3DCore::QNodeId id : qAsConst(m_backendFrameActionIds)) {
+        BackendFrameAction *action = m_backendFrameActionManager->lookupResource(id);
+        if (action)
+            action->trigger(m_dt);
+    }
 }
 
 } // namespace Logic
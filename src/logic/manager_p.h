@@ -66,10 +66,12 @@ class QLogicAspect;
 
 namespace Logic {
 
+class BackendFrameAction;
+class BackendFrameActionManager;
 class Executor;
 class HandlerManager;
 
-class Manager
+class Q_AUTOTEST_EXPORT Manager
 {
 public:
     Manager();
@@ -79,15 +81,27 @@ public:
     void setExecutor(Executor *executor);
 
     HandlerManager *logicHandlerManager() const { return m_logicHandlerManager.data(); }
+    BackendFrameActionManager *backendFrameActionManager() const { return m_backendFrameActionManager.data(); }
 
     void appendHandler(Handler *handler);
     void removeHandler(Qt3DCore::QNodeId id);
 
+    void appendBackendFrameAction(BackendFrameAction *action);
+    void removeBackendFrameAction(Qt3DCore::QNodeId id);
+
     void triggerLogicFrameUpdates();
 
+    // Frame actions have to be triggered every frame
+    bool isIdle() const { return m_logicComponentIds.isEmpty() && m_backendFrameActionIds.isEmpty(); }
+
     void setDeltaTime(float dt) { m_dt = dt; }
 
+    void setBlocking(bool blocking) { m_blocking = blocking; }
+    bool isBlocking() const { return m_blocking; }
+
 private:
+    void triggerBackendFrameActions();
+
     QScopedPointer<HandlerManager> m_logicHandlerManager;
     QVector<HHandler> m_logicHandlers;
     QVector<Qt3DCore::QNodeId> m_logicComponentIds;
@@ -95,6 +109,9 @@ private:
     Executor *m_executor;
     QSemaphore m_semaphore;
     float m_dt;
+    QScopedPointer<BackendFrameActionManager> m_backendFrameActionManager;
+    QVector<Qt3DCore::QNodeId> m_backendFrameActionIds;
+    bool m_blocking;
 };
 
 } // namespace Logic
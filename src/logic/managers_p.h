@@ -54,6 +54,7 @@
 #include <QtGlobal>
 #include <Qt3DLogic/private/handle_types_p.h>
 #include <Qt3DLogic/private/handler_p.h>
+#include <Qt3DLogic/private/backendframeaction_p.h>
 #include <Qt3DCore/private/qresourcemanager_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -71,6 +72,16 @@ public:
     HandlerManager() {}
 };
 
+class BackendFrameActionManager : public Qt3DCore::QResourceManager<
+        BackendFrameAction,
+        Qt3DCore::QNodeId,
+        16,
+        Qt3DCore::ArrayAllocatingPolicy>
+{
+public:
+    BackendFrameActionManager() {}
+};
+
 } // namespace Logic
 } // namespace Qt3DLogic
 
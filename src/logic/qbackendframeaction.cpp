@@ -0,0 +1,145 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qbackendframeaction.h"
+#include "qbackendframeaction_p.h"
+#include <Qt3DCore/qnodecreatedchange.h>
+#include <Qt3DCore/qpropertyupdatedchange.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DLogic {
+
+QBackendFrameActionPrivate::QBackendFrameActionPrivate()
+    : QComponentPrivate()
+{
+}
+
+/*!
+    \class Qt3DLogic::QBackendFrameCallback
+    \inmodule Qt3DLogic
+    \since 5.9
+    \brief Functor called each frame by a QBackendFrameAction.
+
+    Reimplement operator()() with the work to perform each frame, \c dt
+    being the time since the last frame.
+*/
+
+/*!
+    \typedef Qt3DLogic::QBackendFrameCallbackPtr
+    \relates Qt3DLogic::QBackendFrameCallback
+
+    A shared pointer to QBackendFrameCallback.
+*/
+
+/*!
+    \class Qt3DLogic::QBackendFrameAction
+    \inmodule Qt3DLogic
+    \since 5.9
+    \brief Provides a way to have a function executed each frame on a Qt3D
+    worker thread.
+
+    Unlike QFrameAction, whose triggered signal is emitted on the main thread,
+    the callback of a QBackendFrameAction is called directly by the logic
+    aspect on one of the threads of the Qt3D thread pool. It never waits for
+    the main thread and doesn't delay the other aspects when the main thread
+    is busy.
+
+    As a consequence, the callback must not access QObjects or nodes of the
+    scene. It is meant for logic working on its own data, such as simulation
+    steps whose results are later picked up by the application.
+*/
+
+/*!
+    Constructs a new QBackendFrameAction instance with parent \a parent.
+ */
+QBackendFrameAction::QBackendFrameAction(Qt3DCore::QNode *parent)
+    : QComponent(*new QBackendFrameActionPrivate, parent)
+{
+}
+
+/*! \internal */
+QBackendFrameAction::~QBackendFrameAction()
+{
+}
+
+/*! \internal */
+QBackendFrameAction::QBackendFrameAction(QBackendFrameActionPrivate &dd, Qt3DCore::QNode *parent)
+    : QComponent(dd, parent)
+{
+}
+
+/*!
+    Sets the \a callback to be called each frame.
+ */
+void QBackendFrameAction::setCallback(const QBackendFrameCallbackPtr &callback)
+{
+    Q_D(QBackendFrameAction);
+    if (callback == d->m_callback)
+        return;
+    d->m_callback = callback;
+    if (d->m_changeArbiter != nullptr) {
+        auto change = Qt3DCore::QPropertyUpdatedChangePtr::create(d->m_id);
+        change->setPropertyName("callback");
+        change->setValue(QVariant::fromValue(d->m_callback));
+        d->notifyObservers(change);
+    }
+}
+
+/*!
+    \return the callback called each frame.
+ */
+QBackendFrameCallbackPtr QBackendFrameAction::callback() const
+{
+    Q_D(const QBackendFrameAction);
+    return d->m_callback;
+}
+
+Qt3DCore::QNodeCreatedChangeBasePtr QBackendFrameAction::createNodeCreationChange() const
+{
+    auto creationChange = Qt3DCore::QNodeCreatedChangePtr<QBackendFrameActionData>::create(this);
+    auto &data = creationChange->data;
+    Q_D(const QBackendFrameAction);
+    data.callback = d->m_callback;
+    return creationChange;
+}
+
+} // namespace Qt3DLogic
+
+QT_END_NAMESPACE
@@ -43,6 +43,8 @@
 #include "handler_p.h"
 #include "manager_p.h"
 #include "qframeaction.h"
+#include "qbackendframeaction.h"
+#include "backendframeaction_p.h"
 
 #include <Qt3DCore/qnode.h>
 #include <Qt3DCore/private/qchangearbiter_p.h>
@@ -64,6 +66,16 @@ namespace Qt3DLogic {
  \inmodule Qt3DLogic
  \brief Responsible for handling frame synchronization jobs.
  \since 5.7
+
+ Each frame, the aspect waits for the main thread to have triggered every
+ QFrameAction before letting the frame complete. When the
+ \c QT3DLOGIC_ASYNC_FRAME_ACTIONS environment variable is set, the frame
+ actions are instead triggered whenever the main thread gets to them,
+ without delaying the other aspects. The frames the main thread misses are
+ coalesced, the next triggering reporting the total elapsed time.
+
+ The callbacks of QBackendFrameAction components are called on a thread
+ pool thread in both cases.
 */
 
 QLogicAspectPrivate::QLogicAspectPrivate()
@@ -85,10 +97,16 @@ void QLogicAspectPrivate::onEngineAboutToShutdown()
     m_executor->clearQueueAndProceed();
 }
 
+bool QLogicAspectPrivate::isIdle()
+{
+    return m_manager->isIdle();
+}
+
 void QLogicAspectPrivate::registerBackendTypes()
 {
     Q_Q(QLogicAspect);
     q->registerBackendType<QFrameAction>(QBackendNodeMapperPtr(new Logic::HandlerFunctor(m_manager.data())));
+    q->registerBackendType<QBackendFrameAction>(QBackendNodeMapperPtr(new Logic::BackendFrameActionFunctor(m_manager.data())));
 }
 
 /*!
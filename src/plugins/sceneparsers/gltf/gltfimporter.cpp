@@ -41,9 +41,11 @@
 #include "gltfimporter.h"
 
 #include <QtCore/QDir>
+#include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
+#include <QtCore/QtEndian>
 
 #include <QtGui/QVector2D>
 
@@ -163,6 +165,16 @@ Q_LOGGING_CATEGORY(GLTFImporterLog, "Qt3D.GLTFImport")
 #define KEY_FUNCTIONS           QLatin1String("functions")
 #define KEY_TECHNIQUE_CORE      QLatin1String("techniqueCore")
 #define KEY_TECHNIQUE_GL2       QLatin1String("techniqueGL2")
+#define KEY_COMPRESSION         QLatin1String("compression")
+#define KEY_BINARY_GLTF         QLatin1String("binary_glTF")
+
+// KHR_binary_glTF container layout (all fields little endian):
+// magic "glTF", version, total length, content length, content format,
+// followed by the JSON content and the binary body.
+static const quint32 GLB_MAGIC = 0x46546C67; // "glTF"
+static const quint32 GLB_VERSION = 1;
+static const quint32 GLB_HEADER_SIZE = 20;
+static const quint32 GLB_CONTENT_FORMAT_JSON = 0;
 
 GLTFImporter::GLTFImporter() : QSceneImporter(),
     m_parseDone(false)
@@ -193,6 +205,48 @@ bool GLTFImporter::setJSON(const QJsonDocument &json )
     return true;
 }
 
+/*!
+ * Sets the content of a binary glTF (KHR_binary_glTF) container held in
+ * \a data. The JSON content is parsed right away, while the binary body is
+ * kept around, without copying, until the buffer views have been created.
+ * The caller must keep \a data alive until the scene has been parsed.
+ */
+bool GLTFImporter::setBinaryGLTF(const QByteArray &data)
+{
+    if (Q_UNLIKELY(!isBinaryGLTF(data))) {
+        qCWarning(GLTFImporterLog, "not a binary glTF container");
+        return false;
+    }
+
+    const uchar *header = reinterpret_cast<const uchar *>(data.constData());
+    const quint32 version = qFromLittleEndian<quint32>(header + 4);
+    const quint32 length = qFromLittleEndian<quint32>(header + 8);
+    const quint32 contentLength = qFromLittleEndian<quint32>(header + 12);
+    const quint32 contentFormat = qFromLittleEndian<quint32>(header + 16);
+
+    if (Q_UNLIKELY(version != GLB_VERSION || contentFormat != GLB_CONTENT_FORMAT_JSON)) {
+        qCWarning(GLTFImporterLog, "unsupported binary glTF version %u or content format %u",
+                  version, contentFormat);
+        return false;
+    }
+
+    if (Q_UNLIKELY(length < GLB_HEADER_SIZE
+                   || length > quint32(data.size())
+                   || contentLength > length - GLB_HEADER_SIZE)) {
+        qCWarning(GLTFImporterLog, "truncated binary glTF container");
+        return false;
+    }
+
+    const char *content = data.constData() + GLB_HEADER_SIZE;
+    const QJsonDocument sceneDocument = QJsonDocument::fromJson(QByteArray::fromRawData(content, contentLength));
+    if (Q_UNLIKELY(!setJSON(sceneDocument)))
+        return false;
+
+    const quint32 bodyOffset = GLB_HEADER_SIZE + contentLength;
+    m_binaryBody = QByteArray::fromRawData(data.constData() + bodyOffset, length - bodyOffset);
+    return true;
+}
+
 /*!
  * Sets the \a path used by the parser to load the scene file.
  * If the file is valid, parsing is automatically triggered.
@@ -205,19 +259,43 @@ void GLTFImporter::setSource(const QUrl &source)
         qCWarning(GLTFImporterLog, "missing file: %ls", qUtf16PrintableImpl(path));
         return;
     }
-    QFile f(path);
-    f.open(QIODevice::ReadOnly);
-
-    QByteArray jsonData = f.readAll();
-    QJsonDocument sceneDocument = QJsonDocument::fromBinaryData(jsonData);
-    if (sceneDocument.isNull())
-        sceneDocument = QJsonDocument::fromJson(jsonData);
-
-    if (Q_UNLIKELY(!setJSON(sceneDocument))) {
-        qCWarning(GLTFImporterLog, "not a JSON document");
+    m_binaryBody.clear();
+    m_mappedFile.reset(new QFile(path));
+    if (Q_UNLIKELY(!m_mappedFile->open(QIODevice::ReadOnly))) {
+        qCWarning(GLTFImporterLog, "cannot open file: %ls", qUtf16PrintableImpl(path));
+        m_mappedFile.reset();
         return;
     }
 
+    if (isBinaryGLTF(m_mappedFile->peek(GLB_HEADER_SIZE))) {
+        // Binary containers are mapped rather than read so that the body
+        // only gets touched when the buffer views are extracted from it
+        const qint64 size = m_mappedFile->size();
+        const uchar *mapped = m_mappedFile->map(0, size);
+        const QByteArray data = mapped ? QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), int(size))
+                                       : m_mappedFile->readAll();
+        if (Q_UNLIKELY(!setBinaryGLTF(data))) {
+            m_mappedFile.reset();
+            return;
+        }
+        // If mapping failed, make the body own a copy of the data we read
+        if (!mapped) {
+            m_binaryBody.detach();
+            m_mappedFile.reset();
+        }
+    } else {
+        const QByteArray jsonData = m_mappedFile->readAll();
+        m_mappedFile.reset();
+        QJsonDocument sceneDocument = QJsonDocument::fromBinaryData(jsonData);
+        if (sceneDocument.isNull())
+            sceneDocument = QJsonDocument::fromJson(jsonData);
+
+        if (Q_UNLIKELY(!setJSON(sceneDocument))) {
+            qCWarning(GLTFImporterLog, "not a JSON document");
+            return;
+        }
+    }
+
     setBasePath(finfo.dir().absolutePath());
 }
 
@@ -406,13 +484,15 @@ Qt3DCore::QEntity* GLTFImporter::scene(const QString &id)
 GLTFImporter::BufferData::BufferData()
     : length(0)
     , data(nullptr)
+    , compressed(false)
 {
 }
 
 GLTFImporter::BufferData::BufferData(const QJsonObject &json)
     : length(json.value(KEY_BYTE_LENGTH).toInt()),
       path(json.value(KEY_URI).toString()),
-      data(nullptr)
+      data(nullptr),
+      compressed(json.value(KEY_COMPRESSION).toString() == QLatin1String("Qt"))
 {
 }
 
@@ -463,7 +543,14 @@ bool GLTFImporter::isGLTFPath(const QString& path)
     // might need to detect other things in the future, but would
     // prefer to avoid doing a full parse.
     QString suffix = finfo.suffix().toLower();
-    return suffix == QLatin1String("json") || suffix == QLatin1String("gltf") || suffix == QLatin1String("qgltf");
+    return suffix == QLatin1String("json") || suffix == QLatin1String("gltf")
+            || suffix == QLatin1String("qgltf") || suffix == QLatin1String("glb");
+}
+
+bool GLTFImporter::isBinaryGLTF(const QByteArray &header)
+{
+    return header.size() >= int(GLB_HEADER_SIZE)
+            && qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(header.constData())) == GLB_MAGIC;
 }
 
 void GLTFImporter::renameFromJson(const QJsonObject &json, QObject * const object)
@@ -910,11 +997,19 @@ void GLTFImporter::processJSONBufferView(const QString &id, const QJsonObject& j
 
     quint64 len = json.value(KEY_BYTE_LENGTH).toInt();
 
-    QByteArray bytes = bufferData.data->mid(offset, len);
-    if (Q_UNLIKELY(bytes.count() != int(len))) {
+    if (Q_UNLIKELY(!bufferData.data || offset > quint64(bufferData.data->size()))) {
+        qCWarning(GLTFImporterLog, "failed to read data from: %ls for view %ls",
+                  qUtf16PrintableImpl(bufferData.path), qUtf16PrintableImpl(id));
+        return;
+    }
+
+    // Always deep copy: the buffer data may be a view on a mapped file
+    if (Q_UNLIKELY(offset + len > quint64(bufferData.data->size()))) {
         qCWarning(GLTFImporterLog, "failed to read sufficient bytes from: %ls for view %ls",
                   qUtf16PrintableImpl(bufferData.path), qUtf16PrintableImpl(id));
+        len = bufferData.data->size() - offset;
     }
+    const QByteArray bytes(bufferData.data->constData() + offset, int(len));
 
     Qt3DRender::QBuffer *b(new Qt3DRender::QBuffer(ty));
     b->setData(bytes);
@@ -1236,19 +1331,42 @@ void GLTFImporter::processJSONTexture(const QString &id, const QJsonObject &json
 
 void GLTFImporter::loadBufferData()
 {
-    for (auto &bufferData : m_bufferDatas) {
-        if (!bufferData.data) {
-            bufferData.data = new QByteArray(resolveLocalData(bufferData.path));
-        }
+    for (auto it = m_bufferDatas.begin(), end = m_bufferDatas.end(); it != end; ++it) {
+        if (!it->data)
+            it->data = bufferDataFor(it.key(), *it);
     }
 }
 
 void GLTFImporter::unloadBufferData()
 {
-    for (const auto &bufferData : qAsConst(m_bufferDatas)) {
-        QByteArray *data = bufferData.data;
-        delete data;
+    for (auto &bufferData : m_bufferDatas) {
+        delete bufferData.data;
+        bufferData.data = nullptr;
     }
+
+    // All buffer views hold their own copy by now, release the mapping
+    m_binaryBody.clear();
+    m_mappedFile.reset();
+}
+
+QByteArray *GLTFImporter::bufferDataFor(const QString &id, const BufferData &bufferData) const
+{
+    // The body of a binary glTF container is referenced through the
+    // special "binary_glTF" buffer id (KHR_binary_glTF)
+    const bool isBinaryBody = id == KEY_BINARY_GLTF && !m_binaryBody.isNull();
+    const QByteArray raw = isBinaryBody ? m_binaryBody : resolveLocalData(bufferData.path);
+
+    if (!bufferData.compressed)
+        return new QByteArray(raw);
+
+    // Buffers written by qgltf -c are compressed with qCompress()
+    QByteArray *data = new QByteArray(qUncompress(raw));
+    if (Q_UNLIKELY(data->isEmpty() && !raw.isEmpty()))
+        qCWarning(GLTFImporterLog, "failed to uncompress buffer %ls", qUtf16PrintableImpl(id));
+    else if (Q_UNLIKELY(quint64(data->size()) != bufferData.length))
+        qCWarning(GLTFImporterLog, "uncompressed buffer %ls has unexpected size %d (expected %lld)",
+                  qUtf16PrintableImpl(id), data->size(), bufferData.length);
+    return data;
 }
 
 QByteArray GLTFImporter::resolveLocalData(const QString &path) const
@@ -54,6 +54,7 @@
 
 #include <QtCore/QJsonDocument>
 #include <QtCore/QMultiHash>
+#include <QtCore/QScopedPointer>
 
 #include <Qt3DRender/qattribute.h>
 #include <Qt3DRender/qbuffer.h>
@@ -62,6 +63,7 @@
 QT_BEGIN_NAMESPACE
 
 class QByteArray;
+class QFile;
 
 namespace Qt3DCore {
 class QEntity;
@@ -92,6 +94,7 @@ public:
 
     void setBasePath(const QString& path);
     bool setJSON( const QJsonDocument &json );
+    bool setBinaryGLTF(const QByteArray &data);
 
     // SceneParserInterface interface
     void setSource(const QUrl &source) Q_DECL_FINAL;
@@ -109,6 +112,7 @@ private:
         quint64 length;
         QString path;
         QByteArray *data;
+        bool compressed;
         // type if ever useful
     };
 
@@ -137,6 +141,7 @@ private:
     };
 
     static bool isGLTFPath(const QString &path);
+    static bool isBinaryGLTF(const QByteArray &header);
     static void renameFromJson(const QJsonObject& json, QObject * const object );
     static bool hasStandardUniformNameFromSemantic(const QString &semantic);
     static QString standardAttributeNameFromSemantic(const QString &semantic);
@@ -163,6 +168,7 @@ private:
     void unloadBufferData();
 
     QByteArray resolveLocalData(const QString &path) const;
+    QByteArray *bufferDataFor(const QString &id, const BufferData &bufferData) const;
 
     QVariant parameterValueFromJSON(int type, const QJsonValue &value) const;
     static QAttribute::VertexBaseType accessorTypeFromJSON(int componentType);
@@ -176,6 +182,11 @@ private:
 
     QJsonDocument m_json;
     QString m_basePath;
+
+    // Body chunk of a binary glTF container. Usually points straight into
+    // m_mappedFile and is released once the buffer views have been created.
+    QByteArray m_binaryBody;
+    QScopedPointer<QFile> m_mappedFile;
     bool m_parseDone;
     QString m_defaultScene;
 
@@ -132,6 +132,7 @@ public:
     virtual void clearDirtyBits(BackendNodeDirtySet changes) = 0;
     virtual bool shouldRender() = 0;
     virtual void skipNextFrame() = 0;
+    virtual bool isIdle() = 0;
 
     virtual QVector<Qt3DCore::QAspectJobPtr> renderBinJobs() = 0;
     virtual Qt3DCore::QAspectJobPtr pickBoundingVolumeJob() = 0;
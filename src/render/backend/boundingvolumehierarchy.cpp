@@ -0,0 +1,305 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "boundingvolumehierarchy_p.h"
+#include <Qt3DRender/private/trianglesvisitor_p.h>
+#include <algorithm>
+#include <numeric>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+namespace {
+
+class TriangleCollector : public TrianglesVisitor
+{
+public:
+    explicit TriangleCollector(NodeManagers *manager)
+        : TrianglesVisitor(manager)
+    {}
+
+    QVector<TriangleBoundingVolumeHierarchy::Triangle> triangles;
+
+private:
+    void visit(uint andx, const QVector3D &a,
+               uint bndx, const QVector3D &b,
+               uint cndx, const QVector3D &c) Q_DECL_OVERRIDE
+    {
+        TriangleBoundingVolumeHierarchy::Triangle triangle;
+        triangle.vertices[0] = a;
+        triangle.vertices[1] = b;
+        triangle.vertices[2] = c;
+        triangle.vertexIndices[0] = andx;
+        triangle.vertexIndices[1] = bndx;
+        triangle.vertexIndices[2] = cndx;
+        triangle.index = triangles.size();
+        triangles.push_back(triangle);
+    }
+};
+
+// Note: a, b, c in counter clockwise order when seen from p
+// RealTime Collision Detection page 192
+bool intersectsSegmentTriangle(const QVector3D &p,
+                               const QVector3D &q,
+                               const QVector3D &a,
+                               const QVector3D &b,
+                               const QVector3D &c,
+                               bool pickBackFaces,
+                               float &t)
+{
+    const QVector3D ab = b - a;
+    const QVector3D ac = c - a;
+    const QVector3D qp = p - q;
+
+    const QVector3D n = QVector3D::crossProduct(ab, ac);
+    const float d = QVector3D::dotProduct(qp, n);
+
+    // Seen from the back, test the triangle with the opposite winding
+    if (d <= 0.0f) {
+        if (!pickBackFaces || d == 0.0f)
+            return false;
+        return intersectsSegmentTriangle(p, q, a, c, b, false, t);
+    }
+
+    const QVector3D ap = p - a;
+    t = QVector3D::dotProduct(ap, n);
+
+    if (t < 0.0f || t > d)
+        return false;
+
+    const QVector3D e = QVector3D::crossProduct(qp, ap);
+    const float v = QVector3D::dotProduct(ac, e);
+
+    if (v < 0.0f || v > d)
+        return false;
+
+    const float w = -QVector3D::dotProduct(ab, e);
+
+    if (w < 0.0f || v + w > d)
+        return false;
+
+    t /= d;
+    return true;
+}
+
+} // anonymous
+
+bool BoundingVolumeHierarchy::intersects(const BoundingBox &box, const QVector3D &origin,
+                                         const QVector3D &invDirection, float maxDistance)
+{
+    if (box.isEmpty())
+        return false;
+
+    // Slab test, comparisons against NaN (0 * inf) leave the range untouched
+    float tMin = 0.0f;
+    float tMax = maxDistance;
+    for (int i = 0; i < 3; ++i) {
+        float t0 = (box.min[i] - origin[i]) * invDirection[i];
+        float t1 = (box.max[i] - origin[i]) * invDirection[i];
+        if (t0 > t1)
+            std::swap(t0, t1);
+        if (t0 > tMin)
+            tMin = t0;
+        if (t1 < tMax)
+            tMax = t1;
+        if (tMin > tMax)
+            return false;
+    }
+    return true;
+}
+
+void BoundingVolumeHierarchy::build(const QVector<BoundingBox> &primitiveBounds)
+{
+    clear();
+
+    const int primitiveCount = primitiveBounds.size();
+    if (primitiveCount == 0)
+        return;
+
+    m_primitives.resize(primitiveCount);
+    std::iota(m_primitives.begin(), m_primitives.end(), 0);
+
+    QVector<QVector3D> centers(primitiveCount);
+    for (int i = 0; i < primitiveCount; ++i)
+        centers[i] = primitiveBounds.at(i).center();
+
+    m_nodes.reserve(2 * (primitiveCount / MaxLeafSize) + 1);
+    buildNode(primitiveBounds, centers, 0, primitiveCount);
+
+    m_primitiveBounds.resize(primitiveCount);
+    for (int i = 0; i < primitiveCount; ++i)
+        m_primitiveBounds[i] = primitiveBounds.at(m_primitives.at(i));
+}
+
+int BoundingVolumeHierarchy::buildNode(const QVector<BoundingBox> &primitiveBounds,
+                                       const QVector<QVector3D> &centers,
+                                       int first, int last)
+{
+    const int nodeIndex = m_nodes.size();
+    m_nodes.push_back(Node());
+
+    BoundingBox bounds;
+    BoundingBox centerBounds;
+    for (int i = first; i < last; ++i) {
+        const int primitive = m_primitives.at(i);
+        bounds.expand(primitiveBounds.at(primitive));
+        centerBounds.expand(centers.at(primitive));
+    }
+
+    // Split at the median centroid along the axis where centroids spread the most
+    const QVector3D extent = centerBounds.max - centerBounds.min;
+    int axis = 0;
+    if (extent.y() > extent[axis])
+        axis = 1;
+    if (extent.z() > extent[axis])
+        axis = 2;
+
+    int secondChild = -1;
+    if (last - first > MaxLeafSize && extent[axis] > 0.0f) {
+        const int middle = first + (last - first) / 2;
+        int *primitives = m_primitives.data();
+        std::nth_element(primitives + first, primitives + middle, primitives + last,
+                         [&centers, axis] (int a, int b) {
+            return centers.at(a)[axis] < centers.at(b)[axis];
+        });
+        buildNode(primitiveBounds, centers, first, middle);
+        secondChild = buildNode(primitiveBounds, centers, middle, last);
+    }
+
+    // m_nodes may have been reallocated by the recursion
+    Node &node = m_nodes[nodeIndex];
+    node.bounds = bounds;
+    node.first = first;
+    node.count = last - first;
+    node.secondChild = secondChild;
+    return nodeIndex;
+}
+
+void BoundingVolumeHierarchy::refit(const QVector<BoundingBox> &primitiveBounds)
+{
+    Q_ASSERT(primitiveBounds.size() == m_primitives.size());
+
+    // Children are always stored after their parent
+    for (int nodeIndex = m_nodes.size() - 1; nodeIndex >= 0; --nodeIndex) {
+        Node &node = m_nodes[nodeIndex];
+        BoundingBox bounds;
+        if (node.secondChild < 0) {
+            for (int i = node.first, last = node.first + node.count; i < last; ++i) {
+                m_primitiveBounds[i] = primitiveBounds.at(m_primitives.at(i));
+                bounds.expand(m_primitiveBounds.at(i));
+            }
+        } else {
+            bounds.expand(m_nodes.at(nodeIndex + 1).bounds);
+            bounds.expand(m_nodes.at(node.secondChild).bounds);
+        }
+        node.bounds = bounds;
+    }
+}
+
+void BoundingVolumeHierarchy::clear()
+{
+    m_nodes.clear();
+    m_primitives.clear();
+    m_primitiveBounds.clear();
+}
+
+void TriangleBoundingVolumeHierarchy::build(const QVector<Triangle> &triangles)
+{
+    m_triangles = triangles;
+
+    QVector<BoundingBox> bounds;
+    bounds.reserve(m_triangles.size());
+    for (const Triangle &triangle : qAsConst(m_triangles)) {
+        BoundingBox box;
+        box.expand(triangle.vertices[0]);
+        box.expand(triangle.vertices[1]);
+        box.expand(triangle.vertices[2]);
+        bounds.push_back(box);
+    }
+    m_hierarchy.build(bounds);
+}
+
+QSharedPointer<TriangleBoundingVolumeHierarchy> TriangleBoundingVolumeHierarchy::create(NodeManagers *manager,
+                                                                                        const GeometryRenderer *renderer,
+                                                                                        Qt3DCore::QNodeId id)
+{
+    TriangleCollector collector(manager);
+    collector.apply(renderer, id);
+
+    QSharedPointer<TriangleBoundingVolumeHierarchy> hierarchy = QSharedPointer<TriangleBoundingVolumeHierarchy>::create();
+    hierarchy->build(collector.triangles);
+    return hierarchy;
+}
+
+QVector<TriangleBoundingVolumeHierarchy::Intersection> TriangleBoundingVolumeHierarchy::intersect(const QRay3D &segment,
+                                                                                                  bool pickBackFaces,
+                                                                                                  bool flipWinding) const
+{
+    QVector<Intersection> intersections;
+
+    const QVector3D p = segment.origin();
+    const QVector3D q = segment.point(segment.distance());
+
+    m_hierarchy.traverse(p, q - p, 1.0f, [&] (int triangleIndex) {
+        const Triangle &triangle = m_triangles.at(triangleIndex);
+        // The TrianglesVisitor reports triangles in clockwise order, keep
+        // it as is when the world transform mirrors the geometry
+        const QVector3D &a = triangle.vertices[flipWinding ? 0 : 2];
+        const QVector3D &b = triangle.vertices[1];
+        const QVector3D &c = triangle.vertices[flipWinding ? 2 : 0];
+        float t = 0.0f;
+        if (intersectsSegmentTriangle(p, q, a, b, c, pickBackFaces, t)) {
+            Intersection intersection;
+            intersection.triangle = triangleIndex;
+            intersection.t = t;
+            intersections.push_back(intersection);
+        }
+    });
+
+    return intersections;
+}
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
@@ -0,0 +1,231 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QT3DRENDER_RENDER_BOUNDINGVOLUMEHIERARCHY_P_H
+#define QT3DRENDER_RENDER_BOUNDINGVOLUMEHIERARCHY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <Qt3DCore/qnodeid.h>
+#include <Qt3DRender/private/qray3d_p.h>
+#include <QVarLengthArray>
+#include <QVector>
+#include <QVector3D>
+#include <QSharedPointer>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+class GeometryRenderer;
+class NodeManagers;
+
+struct BoundingBox
+{
+    BoundingBox()
+        : min(std::numeric_limits<float>::max(),
+              std::numeric_limits<float>::max(),
+              std::numeric_limits<float>::max())
+        , max(-std::numeric_limits<float>::max(),
+              -std::numeric_limits<float>::max(),
+              -std::numeric_limits<float>::max())
+    {}
+
+    BoundingBox(const QVector3D &minimum, const QVector3D &maximum)
+        : min(minimum)
+        , max(maximum)
+    {}
+
+    bool isEmpty() const { return min.x() > max.x(); }
+    QVector3D center() const { return (min + max) * 0.5f; }
+
+    void expand(const QVector3D &point)
+    {
+        for (int i = 0; i < 3; ++i) {
+            min[i] = qMin(min[i], point[i]);
+            max[i] = qMax(max[i], point[i]);
+        }
+    }
+
+    void expand(const BoundingBox &box)
+    {
+        if (box.isEmpty())
+            return;
+        expand(box.min);
+        expand(box.max);
+    }
+
+    QVector3D min;
+    QVector3D max;
+};
+
+// Binary tree of axis aligned boxes built over a set of primitive boxes.
+// Nodes are stored depth first so that the first child of a node always
+// directly follows it.
+class Q_AUTOTEST_EXPORT BoundingVolumeHierarchy
+{
+public:
+    enum {
+        MaxLeafSize = 4
+    };
+
+    void build(const QVector<BoundingBox> &primitiveBounds);
+    // Updates the bounds of the nodes without changing the tree topology
+    void refit(const QVector<BoundingBox> &primitiveBounds);
+    void clear();
+
+    bool isEmpty() const { return m_nodes.isEmpty(); }
+    int nodeCount() const { return m_nodes.size(); }
+    int primitiveCount() const { return m_primitives.size(); }
+
+    // Calls visitor(primitiveIndex) for each primitive whose box is crossed
+    // by origin + t * direction, with t in [0, maxDistance]
+    template<typename Visitor>
+    void traverse(const QVector3D &origin, const QVector3D &direction,
+                  float maxDistance, Visitor visitor) const
+    {
+        if (m_nodes.isEmpty())
+            return;
+
+        const QVector3D invDirection(1.0f / direction.x(),
+                                     1.0f / direction.y(),
+                                     1.0f / direction.z());
+        QVarLengthArray<int, 64> stack;
+        stack.push_back(0);
+
+        while (!stack.isEmpty()) {
+            const int nodeIndex = stack.last();
+            stack.removeLast();
+            const Node &node = m_nodes.at(nodeIndex);
+
+            if (!intersects(node.bounds, origin, invDirection, maxDistance))
+                continue;
+
+            if (node.secondChild < 0) {
+                for (int i = node.first, last = node.first + node.count; i < last; ++i) {
+                    if (intersects(m_primitiveBounds.at(i), origin, invDirection, maxDistance))
+                        visitor(m_primitives.at(i));
+                }
+            } else {
+                stack.push_back(node.secondChild);
+                stack.push_back(nodeIndex + 1);
+            }
+        }
+    }
+
+    static bool intersects(const BoundingBox &box, const QVector3D &origin,
+                           const QVector3D &invDirection, float maxDistance);
+
+private:
+    struct Node
+    {
+        BoundingBox bounds;
+        int first;
+        int count;
+        int secondChild;
+    };
+
+    int buildNode(const QVector<BoundingBox> &primitiveBounds,
+                  const QVector<QVector3D> &centers,
+                  int first, int last);
+
+    QVector<Node> m_nodes;
+    QVector<int> m_primitives;
+    // Bounds of m_primitives, in the same order
+    QVector<BoundingBox> m_primitiveBounds;
+};
+
+// Triangles of a GeometryRenderer in object space, organized in a
+// BoundingVolumeHierarchy to only test the triangles close to a ray
+class Q_AUTOTEST_EXPORT TriangleBoundingVolumeHierarchy
+{
+public:
+    struct Triangle
+    {
+        QVector3D vertices[3];
+        uint vertexIndices[3];
+        uint index;
+    };
+
+    struct Intersection
+    {
+        int triangle;
+        // Parameter along the segment in [0, 1]
+        float t;
+    };
+
+    void build(const QVector<Triangle> &triangles);
+    static QSharedPointer<TriangleBoundingVolumeHierarchy> create(NodeManagers *manager,
+                                                                  const GeometryRenderer *renderer,
+                                                                  Qt3DCore::QNodeId id);
+
+    const QVector<Triangle> &triangles() const { return m_triangles; }
+    const BoundingVolumeHierarchy &hierarchy() const { return m_hierarchy; }
+
+    // The segment goes from segment.origin() to segment.point(segment.distance())
+    QVector<Intersection> intersect(const QRay3D &segment,
+                                    bool pickBackFaces,
+                                    bool flipWinding) const;
+
+private:
+    QVector<Triangle> m_triangles;
+    BoundingVolumeHierarchy m_hierarchy;
+};
+
+typedef QSharedPointer<TriangleBoundingVolumeHierarchy> TriangleBoundingVolumeHierarchyPtr;
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_BOUNDINGVOLUMEHIERARCHY_P_H
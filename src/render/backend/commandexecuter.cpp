@@ -46,6 +46,7 @@
 #include <Qt3DRender/private/nodemanagers_p.h>
 #include <Qt3DRender/private/geometryrenderermanager_p.h>
 #include <Qt3DRender/private/stringtoint_p.h>
+#include <Qt3DRender/private/vsyncframeadvanceservice_p.h>
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QJsonArray>
@@ -276,6 +277,7 @@ QJsonObject parameterPackToJson(const Render::ShaderParameterPack &pack)
         QJsonObject uboObj;
         uboObj.insert(QLatin1String("index"), ubo.m_blockIndex);
         uboObj.insert(QLatin1String("bufferId"), qint64(ubo.m_bufferID.id()));
+        uboObj.insert(QLatin1String("shaderDataId"), qint64(ubo.m_shaderDataID.id()));
         ubosArray.push_back(uboObj);
 
     }
@@ -363,6 +365,16 @@ void CommandExecuter::performAsynchronousCommandExecution(const QVector<Render::
 
             replyObj.insert(QLatin1String("renderViews"), viewArray);
             reply->setData(QJsonDocument(replyObj).toJson());
+        } else if (reply->commandName() == QLatin1String("framepacing")) {
+            const Render::VSyncFrameAdvanceService *service = m_renderer->m_vsyncFrameAdvanceService.data();
+            const Render::VSyncFrameAdvanceService::FramePacing pacing = service->framePacing();
+            QJsonObject replyObj;
+            replyObj.insert(QLatin1String("enabled"), service->isPacingEnabled());
+            replyObj.insert(QLatin1String("jobsDuration"), double(pacing.jobsDuration));
+            replyObj.insert(QLatin1String("submissionDuration"), double(pacing.submissionDuration));
+            replyObj.insert(QLatin1String("delay"), double(pacing.delay));
+            replyObj.insert(QLatin1String("submissionBound"), pacing.delay > 0);
+            reply->setData(QJsonDocument(replyObj).toJson());
         }
         reply->setFinished(true);
     }
@@ -374,7 +386,8 @@ QVariant CommandExecuter::executeCommand(const QStringList &args)
     // Note: The replies will be deleted by the AspectCommandDebugger
     if (args.length() > 0 &&
             (args.first() == QLatin1String("glinfo") ||
-             args.first() == QLatin1String("rendercommands"))) {
+             args.first() == QLatin1String("rendercommands") ||
+             args.first() == QLatin1String("framepacing"))) {
         auto reply = new Qt3DCore::Debug::AsynchronousCommandReply(args.first());
         QMutexLocker lock(m_renderer->mutex());
         m_pendingCommands.push_back(reply);
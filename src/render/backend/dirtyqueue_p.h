@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QT3DRENDER_RENDER_DIRTYQUEUE_P_H
+#define QT3DRENDER_RENDER_DIRTYQUEUE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QAtomicPointer>
+#include <QVector>
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+// Lock-free queue backend nodes push themselves into when they become dirty,
+// so that the renderer only visits the nodes that changed. Any thread can
+// push, values are taken all at once by a single consumer.
+// The same value may be pushed several times, consumers are expected to
+// check the state of the node they look up.
+template <typename T>
+class DirtyQueue
+{
+public:
+    DirtyQueue()
+        : m_head(nullptr)
+    {}
+
+    ~DirtyQueue()
+    {
+        clear();
+    }
+
+    // Any Thread
+    void push(const T &value)
+    {
+        Node *node = new Node(value);
+        Node *head = m_head.loadAcquire();
+        do {
+            node->next = head;
+        } while (!m_head.testAndSetOrdered(head, node, head));
+    }
+
+    // Any Thread
+    bool isEmpty() const
+    {
+        return m_head.loadAcquire() == nullptr;
+    }
+
+    // Returns the values in the order they were pushed
+    QVector<T> takeAll()
+    {
+        Node *node = m_head.fetchAndStoreAcquire(nullptr);
+        QVector<T> values;
+        while (node != nullptr) {
+            values.push_back(node->value);
+            Node *next = node->next;
+            delete node;
+            node = next;
+        }
+        std::reverse(values.begin(), values.end());
+        return values;
+    }
+
+    void clear()
+    {
+        Node *node = m_head.fetchAndStoreAcquire(nullptr);
+        while (node != nullptr) {
+            Node *next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(DirtyQueue)
+
+    struct Node
+    {
+        explicit Node(const T &v)
+            : value(v)
+            , next(nullptr)
+        {}
+
+        T value;
+        Node *next;
+    };
+
+    QAtomicPointer<Node> m_head;
+};
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_DIRTYQUEUE_P_H
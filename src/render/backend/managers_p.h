@@ -69,6 +69,7 @@
 #include <Qt3DRender/private/parameter_p.h>
 #include <Qt3DRender/private/shaderdata_p.h>
 #include <Qt3DRender/private/handle_types_p.h>
+#include <Qt3DRender/private/dirtyqueue_p.h>
 #include <Qt3DRender/private/glbuffer_p.h>
 #include <Qt3DRender/private/textureimage_p.h>
 #include <Qt3DRender/private/attribute_p.h>
@@ -200,6 +201,23 @@ class ShaderManager : public Qt3DCore::QResourceManager<
 {
 public:
     ShaderManager() {}
+
+    // Any Thread
+    void addShaderToLoad(Qt3DCore::QNodeId shaderId) { m_shadersToLoad.push(shaderId); }
+    // Techniques or RenderPasses changed, a shader left aside may now be needed
+    void setShaderReferencesDirty() { m_shaderReferencesDirty.storeRelease(1); }
+    bool hasShadersToLoad() const
+    {
+        return !m_shadersToLoad.isEmpty() || m_shaderReferencesDirty.loadAcquire() != 0;
+    }
+
+    // Renderer Job (single consumer)
+    QVector<Qt3DCore::QNodeId> takeShadersToLoad() { return m_shadersToLoad.takeAll(); }
+    bool takeShaderReferencesDirty() { return m_shaderReferencesDirty.fetchAndStoreAcquire(0) != 0; }
+
+private:
+    DirtyQueue<Qt3DCore::QNodeId> m_shadersToLoad;
+    QAtomicInt m_shaderReferencesDirty;
 };
 
 class TechniqueManager : public Qt3DCore::QResourceManager<
@@ -222,6 +240,16 @@ class TextureManager : public Qt3DCore::QResourceManager<
 {
 public:
     TextureManager() {}
+
+    // Any Thread
+    void addTextureToUpdate(Qt3DCore::QNodeId textureId) { m_texturesToUpdate.push(textureId); }
+    bool hasTexturesToUpdate() const { return !m_texturesToUpdate.isEmpty(); }
+
+    // Renderer Job (single consumer)
+    QVector<Qt3DCore::QNodeId> takeTexturesToUpdate() { return m_texturesToUpdate.takeAll(); }
+
+private:
+    DirtyQueue<Qt3DCore::QNodeId> m_texturesToUpdate;
 };
 
 class TransformManager : public Qt3DCore::QResourceManager<
@@ -287,6 +315,15 @@ class ShaderDataManager : public Qt3DCore::QResourceManager<
 {
 public:
     ShaderDataManager() {}
+
+    // Any Thread
+    void addShaderDataToRelease(Qt3DCore::QNodeId shaderDataId) { m_shaderDataToRelease.push(shaderDataId); }
+
+    // Render Thread, the GL resources generated from these are released
+    QVector<Qt3DCore::QNodeId> takeShaderDataToRelease() { return m_shaderDataToRelease.takeAll(); }
+
+private:
+    DirtyQueue<Qt3DCore::QNodeId> m_shaderDataToRelease;
 };
 
 class GLBufferManager : public Qt3DCore::QResourceManager<
@@ -64,10 +64,18 @@ void OpenGLVertexArrayObject::setGraphicsContext(GraphicsContext *ctx)
 void OpenGLVertexArrayObject::bind()
 {
     Q_ASSERT(m_ctx);
+    // Consecutive commands often share the same VAO
+    if (m_ctx->m_currentVAO == this) {
+        m_ctx->countStateChange(GraphicsContext::VertexArrayStateChange, false);
+        return;
+    }
+    m_ctx->countStateChange(GraphicsContext::VertexArrayStateChange, true);
+
     if (m_supportsVao) {
         Q_ASSERT(!m_vao.isNull());
         Q_ASSERT(m_vao->isCreated());
         m_vao->bind();
+        m_ctx->m_currentVAO = this;
     } else {
         // Unbind any other VAO that may have been bound and not released correctly
         if (m_ctx->m_currentVAO != nullptr && m_ctx->m_currentVAO != this)
@@ -89,7 +97,9 @@ void OpenGLVertexArrayObject::release()
     if (m_supportsVao) {
         Q_ASSERT(!m_vao.isNull());
         Q_ASSERT(m_vao->isCreated());
+        // Unbinds whichever VAO is bound, not only this one
         m_vao->release();
+        m_ctx->m_currentVAO = nullptr;
     } else {
         if (m_ctx->m_currentVAO == this) {
             for (const GraphicsContext::VAOVertexAttribute &attr : m_vertexAttributes)
@@ -59,7 +59,7 @@ QT_BEGIN_NAMESPACE
 namespace Qt3DRender {
 namespace Render {
 
-class OpenGLVertexArrayObject
+class Q_AUTOTEST_EXPORT OpenGLVertexArrayObject
 {
 public:
     OpenGLVertexArrayObject();
@@ -65,7 +65,7 @@ namespace Render {
 
 class AbstractRenderer;
 
-class PlatformSurfaceFilter : public QObject
+class Q_AUTOTEST_EXPORT PlatformSurfaceFilter : public QObject
 {
     Q_OBJECT
 
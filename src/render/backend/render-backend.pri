@@ -26,6 +26,7 @@ HEADERS += \
     $$PWD/boundingvolumedebug_p.h \
     $$PWD/nodemanagers_p.h \
     $$PWD/triangleboundingvolume_p.h \
+    $$PWD/boundingvolumehierarchy_p.h \
     $$PWD/openglvertexarrayobject_p.h \
     $$PWD/trianglesextractor_p.h \
     $$PWD/trianglesvisitor_p.h \
@@ -37,7 +38,9 @@ HEADERS += \
     $$PWD/rendertargetoutput_p.h \
     $$PWD/commandexecuter_p.h \
     $$PWD/uniform_p.h \
-    $$PWD/shaderparameterpack_p.h
+    $$PWD/shaderparameterpack_p.h \
+    $$PWD/dirtyqueue_p.h \
+    $$PWD/offscreensurfacehelper_p.h
 
 SOURCES += \
     $$PWD/renderthread.cpp \
@@ -57,6 +60,7 @@ SOURCES += \
     $$PWD/boundingvolumedebug.cpp \
     $$PWD/nodemanagers.cpp \
     $$PWD/triangleboundingvolume.cpp \
+    $$PWD/boundingvolumehierarchy.cpp \
     $$PWD/trianglesextractor.cpp \
     $$PWD/trianglesvisitor.cpp \
     $$PWD/computecommand.cpp \
@@ -68,5 +72,6 @@ SOURCES += \
     $$PWD/commandexecuter.cpp \
     $$PWD/openglvertexarrayobject.cpp \
     $$PWD/uniform.cpp \
-    $$PWD/shaderparameterpack.cpp
+    $$PWD/shaderparameterpack.cpp \
+    $$PWD/offscreensurfacehelper.cpp
 
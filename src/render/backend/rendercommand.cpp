@@ -47,7 +47,7 @@ namespace Render {
 RenderCommand::RenderCommand()
     : m_stateSet(nullptr)
     , m_depth(0.0f)
-    , m_changeCost(0)
+    , m_stateSetId(0)
     , m_type(RenderCommand::Draw)
     , m_sortBackToFront(false)
     , m_primitiveCount(0)
@@ -63,6 +63,11 @@ RenderCommand::RenderCommand()
     , m_drawIndexed(false)
     , m_primitiveRestartEnabled(false)
     , m_isValid(false)
+    , m_instanceAttributeLocation(-1)
+    , m_instanceDataOffset(-1)
+    , m_instanceTransformCount(0)
+    , m_indirectDrawOffset(-1)
+    , m_indirectDrawCount(0)
 {
    m_sortingType.global = 0;
    m_workGroups[0] = 0;
@@ -70,7 +70,7 @@ namespace Render {
 
 class RenderStateSet;
 
-class RenderCommand
+class Q_AUTOTEST_EXPORT RenderCommand
 {
 public:
     RenderCommand();
@@ -79,7 +79,7 @@ public:
     HShader m_shader; // Shader for given pass and mesh
     ShaderParameterPack m_parameterPack; // Might need to be reworked so as to be able to destroy the
                             // Texture while submission is happening.
-    RenderStateSet *m_stateSet;
+    RenderStateSet *m_stateSet; // Shared by the commands of a RenderView with the same states
 
     HGeometry m_geometry;
     HGeometryRenderer m_geometryRenderer;
@@ -89,7 +89,7 @@ public:
     QVector<int> m_attributes;
 
     float m_depth;
-    int m_changeCost;
+    int m_stateSetId; // 0 for commands without their own states
     uint m_shaderDna;
 
     enum CommandType {
@@ -121,6 +121,30 @@ public:
     bool m_drawIndexed;
     bool m_primitiveRestartEnabled;
     bool m_isValid;
+
+    // Commands whose shader declares the qt3d_InstanceModelMatrix attribute
+    // read their world transform from the RenderView instance data, adjacent
+    // ones only differing by it are merged into a single instanced draw
+    QMatrix4x4 m_instanceTransform;
+    int m_instanceAttributeLocation;
+    int m_instanceDataOffset;
+    int m_instanceTransformCount;
+
+    // Indexed commands sharing a VAO with adjacent ones are drawn with a
+    // single glMultiDrawElementsIndirect reading m_indirectDrawCount draws
+    // at m_indirectDrawOffset of the RenderView indirect draw data
+    int m_indirectDrawOffset;
+    int m_indirectDrawCount;
+};
+
+// Layout of the draws read by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand
+{
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
 };
 
 bool compareCommands(RenderCommand *r1, RenderCommand *r2);
@@ -75,11 +75,14 @@
 #include <Qt3DRender/private/managers_p.h>
 #include <Qt3DRender/private/buffermanager_p.h>
 #include <Qt3DRender/private/nodemanagers_p.h>
+#include <Qt3DRender/private/texturedatamanager_p.h>
+#include <Qt3DRender/private/scenemanager_p.h>
 #include <Qt3DRender/private/geometryrenderermanager_p.h>
 #include <Qt3DRender/private/openglvertexarrayobject_p.h>
 #include <Qt3DRender/private/platformsurfacefilter_p.h>
 #include <Qt3DRender/private/loadbufferjob_p.h>
 #include <Qt3DRender/private/rendercapture_p.h>
+#include <Qt3DRender/private/offscreensurfacehelper_p.h>
 
 #include <Qt3DRender/qcameralens.h>
 #include <Qt3DCore/private/qeventfilterservice_p.h>
@@ -95,6 +98,7 @@
 #include <QDir>
 #include <QUrl>
 #include <QOffscreenSurface>
+#include <QCoreApplication>
 #include <QWindow>
 
 #include <QtGui/private/qopenglcontext_p.h>
@@ -116,6 +120,35 @@ using namespace Qt3DCore;
 namespace Qt3DRender {
 namespace Render {
 
+namespace {
+
+// Number of frames that can be in flight at once, the one being submitted
+// included. With 1 the aspect thread only starts a frame once the previous one
+// has been submitted, with 3 it can build a frame while the previous one waits
+// to be submitted behind the current one.
+int framesInFlight()
+{
+    bool ok = false;
+    const int frames = qEnvironmentVariableIntValue("QT3DRENDER_FRAMES_IN_FLIGHT", &ok);
+    return ok ? frames : 2;
+}
+
+int indexTypeSize(GLint indexType)
+{
+    switch (indexType) {
+    case GL_UNSIGNED_BYTE:
+        return 1;
+    case GL_UNSIGNED_SHORT:
+        return 2;
+    case GL_UNSIGNED_INT:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+} // anonymous
+
 /*!
     \internal
 
@@ -141,15 +174,19 @@ Renderer::Renderer(QRenderAspect::RenderType type)
     , m_nodesManager(nullptr)
     , m_defaultRenderStateSet(nullptr)
     , m_graphicsContext(nullptr)
-    , m_renderQueue(new RenderQueue())
+    , m_renderQueues(new RenderQueueRing(framesInFlight()))
     , m_renderThread(type == QRenderAspect::Threaded ? new RenderThread(this) : nullptr)
     , m_vsyncFrameAdvanceService(new VSyncFrameAdvanceService())
     , m_waitForInitializationToBeCompleted(0)
+    , m_frameAdvanceReleased(false)
     , m_pickEventFilter(new PickEventFilter())
     , m_exposed(0)
     , m_changeSet(0)
     , m_lastFrameCorrect(0)
+    // Until the context is known, the largest alignment drivers report
+    , m_standardUniformBlockAlignment(256)
     , m_glContext(nullptr)
+    , m_offscreenHelper(nullptr)
     , m_pickBoundingVolumeJob(PickBoundingVolumeJobPtr::create(this))
     , m_time(0)
     , m_settings(nullptr)
@@ -182,6 +219,8 @@ Renderer::Renderer(QRenderAspect::RenderType type)
 
     // All world stuff depends on the RenderEntity's localBoundingVolume
     m_pickBoundingVolumeJob->addDependency(m_framePreparationJob);
+    // Picking queries the world bounding volumes of the frame
+    m_pickBoundingVolumeJob->addDependency(m_updateWorldBoundingVolumeJob);
 
     m_defaultRenderStateSet = new RenderStateSet;
     m_defaultRenderStateSet->addState(RenderStateSet::createState<DepthTest>(GL_LESS));
@@ -197,7 +236,7 @@ Renderer::~Renderer()
     if (m_renderThread)
         m_renderThread->wait();
 
-    delete m_renderQueue;
+    delete m_renderQueues;
     delete m_defaultRenderStateSet;
 }
 
@@ -279,9 +318,18 @@ void Renderer::initialize()
     // The context will be made current later on (at render time)
     m_graphicsContext->setOpenGLContext(ctx);
 
+    // Shaders are compiled in a context of their own, made current on an
+    // offscreen surface that has to be created in the GUI thread
+    if (!qEnvironmentVariableIsSet("QT3DRENDER_DISABLE_ASYNC_SHADER_COMPILATION")) {
+        m_offscreenHelper = new OffscreenSurfaceHelper(ctx->format());
+        m_offscreenHelper->moveToThread(QCoreApplication::instance()->thread());
+        QMetaObject::invokeMethod(m_offscreenHelper, "createOffscreenSurface");
+    }
+
     // Awake setScenegraphRoot in case it was waiting
     m_waitForInitializationToBeCompleted.release(1);
     // Allow the aspect manager to proceed
+    m_frameAdvanceReleased = true;
     m_vsyncFrameAdvanceService->proceedToNextFrame();
 }
 
@@ -297,11 +345,6 @@ void Renderer::shutdown()
     qCDebug(Backend) << Q_FUNC_INFO << "Requesting renderer shutdown";
     m_running.store(0);
 
-    // We delete any renderqueue that we may not have had time to render
-    // before the surface was destroyed
-    qDeleteAll(m_renderQueue->nextFrameQueue());
-    m_renderQueue->reset();
-
     if (!m_renderThread) {
         releaseGraphicsResources();
     } else {
@@ -321,8 +364,22 @@ void Renderer::shutdown()
 */
 void Renderer::releaseGraphicsResources()
 {
+    // We delete any renderqueue that we may not have had time to render
+    // before the surface was destroyed. This happens in the thread submitting
+    // the frames so that we can't delete RenderViews still being submitted
+    {
+        QMutexLocker locker(&m_mutex);
+        qDeleteAll(m_renderQueues->renderViews());
+        m_renderQueues->reset();
+    }
+
     // Clean up the graphics context and any resources
     m_graphicsContext.reset(nullptr);
+    // Deleted along with its surface in the GUI thread
+    if (m_offscreenHelper != nullptr) {
+        m_offscreenHelper->deleteLater();
+        m_offscreenHelper = nullptr;
+    }
     qCDebug(Backend) << Q_FUNC_INFO << "Renderer properly shutdown";
 }
 
@@ -409,17 +466,19 @@ void Renderer::render()
 void Renderer::doRender()
 {
     bool submissionSucceeded = false;
-    bool hasCleanedQueueAndProceeded = false;
     Renderer::ViewSubmissionResultData submissionData;
-    bool preprocessingComplete = false;
 
     if (isReadyToSubmit()) {
-
-        // Lock the mutex to protect access to m_surface and check if we are still set
-        // to the running state and that we have a valid surface on which to draw
-        // TO DO: Is that still needed given the surface changes
-        QMutexLocker locker(&m_mutex);
-        const QVector<Render::RenderView *> renderViews = m_renderQueue->nextFrameQueue();
+        // The oldest frame of the ring is complete. The aspect thread only ever
+        // writes to the newest one, so the queue can be read without holding
+        // the mutex until it is released below
+        RenderQueue *renderQueue = nullptr;
+        {
+            QMutexLocker locker(&m_mutex);
+            renderQueue = m_renderQueues->oldestQueue();
+        }
+        const QVector<Render::RenderView *> renderViews = renderQueue->nextFrameQueue();
+        bool preprocessingComplete = false;
 
 #ifdef QT3D_JOBS_RUN_STATS
         // Save start of frame
@@ -435,56 +494,65 @@ void Renderer::doRender()
 #endif
 
         if (canRender() && (submissionSucceeded = renderViews.size() > 0) == true) {
-            // Clear all dirty flags but Compute so that
-            // we still render every frame when a compute shader is used in a scene
-            BackendNodeDirtySet changesToUnset = m_changeSet;
-            if (changesToUnset.testFlag(Renderer::ComputeDirty))
-                changesToUnset.setFlag(Renderer::ComputeDirty, false);
-            clearDirtyBits(changesToUnset);
-
-            { // Scoped to destroy surfaceLock
+            // 1) Execute commands for buffer uploads, texture updates, shader loading
+            //    and update VAOs and uniforms, unless this was done while the previous
+            //    frame was being submitted, in which case we only make the context current
+            if (!renderQueue->isPrepared()) {
+                preprocessingComplete = prepareFrame(renderQueue, true);
+            } else if (renderQueue->isSubmittable()) {
                 QSurface *surface = renderViews.first()->surface();
                 SurfaceLocker surfaceLock(surface);
-                const bool surfaceIsValid = (surface && surfaceLock.isSurfaceValid());
-                if (surfaceIsValid && m_graphicsContext->beginDrawing(surface)) {
-                    // 1) Execute commands for buffer uploads, texture updates, shader loading first
-                    updateGLResources();
-                    // 2) Update VAO and copy data into commands to allow concurrent submission
-                    prepareCommandsSubmission(renderViews);
-                    preprocessingComplete = true;
-                }
+                preprocessingComplete = surface && surfaceLock.isSurfaceValid() && m_graphicsContext->beginDrawing(surface);
             }
-            // 2) Proceed to next frame and start preparing frame n + 1
-            m_renderQueue->reset();
-            m_vsyncFrameAdvanceService->proceedToNextFrame();
-            hasCleanedQueueAndProceeded = true;
+        } else if (!renderQueue->isPrepared()) {
+            renderQueue->setPrepared(false);
+        }
+
+        // 2) Proceed to next frame and start preparing frame n + 1
+        {
+            QMutexLocker locker(&m_mutex);
+            proceedToNextFrameIfPossible();
+        }
 
 #ifdef QT3D_JOBS_RUN_STATS
-            if (preprocessingComplete) {
-                submissionStatsPart2.startTime = QThreadPooler::m_jobsStatTimer.nsecsElapsed();
-                submissionStatsPart1.endTime = submissionStatsPart2.startTime;
-            }
+        if (preprocessingComplete) {
+            submissionStatsPart2.startTime = QThreadPooler::m_jobsStatTimer.nsecsElapsed();
+            submissionStatsPart1.endTime = submissionStatsPart2.startTime;
+        }
 #endif
-            // Only try to submit the RenderViews if the preprocessing was successful
-            // This part of the submission is happening in parallel to the RV building for the next frame
-            if (preprocessingComplete) {
-                // 3) Submit the render commands for frame n (making sure we never reference something that could be changing)
-                // Render using current device state and renderer configuration
-                submissionData = submitRenderViews(renderViews);
-
-                // Perform any required cleanup of the Graphics resources (Buffers deleted, Shader deleted...)
-                cleanGraphicsResources();
-            }
+        // Only try to submit the RenderViews if the preprocessing was successful
+        // This part of the submission is happening in parallel to the RV building for the next frame
+        if (preprocessingComplete) {
+            // 3) Submit the render commands for frame n (making sure we never reference something that could be changing)
+            // Render using current device state and renderer configuration
+            submissionData = submitRenderViews(renderViews);
+
+            // Perform any required cleanup of the Graphics resources (Buffers deleted, Shader deleted...)
+            cleanGraphicsResources();
         }
 
 #ifdef QT3D_JOBS_RUN_STATS
         // Execute the pending shell commands
-        m_commandExecuter->performAsynchronousCommandExecution(renderViews);
+        {
+            QMutexLocker locker(&m_mutex);
+            m_commandExecuter->performAsynchronousCommandExecution(renderViews);
+        }
 #endif
 
         // Delete all the RenderViews which will clear the allocators
-        // that were used for their allocation
+        // that were used for their allocation and hand the queue back
         qDeleteAll(renderViews);
+        {
+            QMutexLocker locker(&m_mutex);
+            m_renderQueues->releaseOldestFrame();
+            proceedToNextFrameIfPossible();
+        }
+
+        // 4) The commands of frame n have all been issued, if frame n + 1 was
+        //    completed in the meantime consume its backend data now so that the
+        //    aspect thread can start on frame n + 2 while we swap buffers
+        if (preprocessingComplete)
+            prepareNextFrame(submissionData.surface);
 
 #ifdef QT3D_JOBS_RUN_STATS
         if (preprocessingComplete) {
@@ -496,49 +564,122 @@ void Renderer::doRender()
             Qt3DCore::QThreadPooler::addSubmissionLogStatsEntry(submissionStatsPart2);
         }
 #endif
+    } else if (m_renderThread) {
+        // A shutdown has been requested, make sure the aspect thread
+        // isn't left waiting for a frame that will never be rendered
+        m_vsyncFrameAdvanceService->proceedToNextFrame();
     }
 
     // Note: submissionSucceeded is false when
     // * we cannot render because a shutdown has been scheduled
     // * the renderqueue is incomplete (only when rendering with a Scene3D)
+    // * the frame was skipped
     // Otherwise returns true even for cases like
-    // * No render view
     // * No surface set
     // * OpenGLContext failed to be set current
-    // This behavior is important as we need to
-    // call proceedToNextFrame despite rendering errors that aren't fatal
-
-    // Only reset renderQueue and proceed to next frame if the submission
-    // succeeded or it we are using a render thread and that is wasn't performed
-    // already
-
-    // If submissionSucceeded isn't true this implies that something went wrong
-    // with the rendering and/or the renderqueue is incomplete from some reason
-    // (in the case of scene3d the render jobs may be taking too long ....)
-    if (m_renderThread || submissionSucceeded) {
-
-        if (!hasCleanedQueueAndProceeded) {
-            // Reset the m_renderQueue so that we won't try to render
-            // with a queue used by a previous frame with corrupted content
-            // if the current queue was correctly submitted
-            m_renderQueue->reset();
-
-            // We allow the RenderTickClock service to proceed to the next frame
-            // In turn this will allow the aspect manager to request a new set of jobs
-            // to be performed for each aspect
-            m_vsyncFrameAdvanceService->proceedToNextFrame();
-        }
 
-        // Perform the last swapBuffers calls after the proceedToNextFrame
-        // as this allows us to gain a bit of time for the preparation of the
-        // next frame
+    // Perform the last swapBuffers calls after the proceedToNextFrame
+    // as this allows us to gain a bit of time for the preparation of the
+    // next frame
+    // Finish up with last surface used in the list of RenderViews
+    if (submissionSucceeded) {
+        SurfaceLocker surfaceLock(submissionData.surface);
         // Finish up with last surface used in the list of RenderViews
-        if (submissionSucceeded) {
-            SurfaceLocker surfaceLock(submissionData.surface);
-            // Finish up with last surface used in the list of RenderViews
-            m_graphicsContext->endDrawing(submissionData.lastBoundFBOId == m_graphicsContext->defaultFBO() && surfaceLock.isSurfaceValid());
+        m_graphicsContext->endDrawing(submissionData.lastBoundFBOId == m_graphicsContext->defaultFBO() && surfaceLock.isSurfaceValid());
+
+        // Let the frame advance service know how long the aspect thread had
+        // to prepare the next frame
+        m_vsyncFrameAdvanceService->frameSubmitted();
+    }
+}
+
+/*!
+    \internal
+
+    Consumes everything the commands of the frame held by \a renderQueue need
+    from the backend nodes: resources to upload, VAOs and uniform values. This
+    must happen before the aspect thread is allowed to start the following
+    frame as it is going to modify these nodes. The RenderCommands don't
+    reference the backend nodes past this point, which is what allows the
+    submission of a frame to overlap with the building of the next ones.
+
+    Returns true if the frame can be submitted.
+ */
+bool Renderer::prepareFrame(RenderQueue *renderQueue, bool makeContextCurrent)
+{
+    const QVector<RenderView *> renderViews = renderQueue->nextFrameQueue();
+    bool submittable = false;
+
+    if (canRender() && !renderViews.isEmpty()) {
+        // Clear all dirty flags but Compute so that
+        // we still render every frame when a compute shader is used in a scene
+        BackendNodeDirtySet changesToUnset = dirtyBits();
+        if (changesToUnset.testFlag(Renderer::ComputeDirty))
+            changesToUnset.setFlag(Renderer::ComputeDirty, false);
+        clearDirtyBits(changesToUnset);
+
+        QSurface *surface = renderViews.first()->surface();
+        SurfaceLocker surfaceLock(surface);
+        const bool surfaceIsValid = (surface && surfaceLock.isSurfaceValid());
+        if (surfaceIsValid && (!makeContextCurrent || m_graphicsContext->beginDrawing(surface))) {
+            updateGLResources();
+            prepareCommandsSubmission(renderViews);
+            submittable = true;
         }
     }
+
+    renderQueue->setPrepared(submittable);
+    return submittable;
+}
+
+/*!
+    \internal
+
+    Called once all the commands of a frame have been issued with the context
+    still current on \a currentSurface. If the aspect thread has completed the
+    next frame, prepares it right away rather than after the buffers have been
+    swapped. Frames rendering to another surface wait for their turn.
+ */
+void Renderer::prepareNextFrame(QSurface *currentSurface)
+{
+    RenderQueue *renderQueue = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        renderQueue = m_renderQueues->oldestQueue();
+        if (renderQueue == nullptr || renderQueue->isPrepared() || !renderQueue->isFrameQueueComplete())
+            return;
+    }
+
+    const QVector<RenderView *> renderViews = renderQueue->nextFrameQueue();
+    if (!renderViews.isEmpty() && renderViews.first()->surface() != currentSurface)
+        return;
+
+    prepareFrame(renderQueue, false);
+
+    QMutexLocker locker(&m_mutex);
+    proceedToNextFrameIfPossible();
+}
+
+/*!
+    \internal
+
+    Lets the aspect thread start building a new frame, once every frame it
+    has built has been prepared and a queue is available in the ring.
+    Called with m_mutex locked.
+ */
+void Renderer::proceedToNextFrameIfPossible()
+{
+    if (m_frameAdvanceReleased || !m_renderQueues->canBeginFrame())
+        return;
+    RenderQueue *newestQueue = m_renderQueues->newestQueue();
+    if (newestQueue != nullptr && !newestQueue->isPrepared())
+        return;
+
+    // We allow the RenderTickClock service to proceed to the next frame
+    // In turn this will allow the aspect manager to request a new set of jobs
+    // to be performed for each aspect
+    m_frameAdvanceReleased = true;
+    m_vsyncFrameAdvanceService->proceedToNextFrame();
 }
 
 // Called by RenderViewJobs
@@ -552,9 +693,16 @@ void Renderer::enqueueRenderView(Render::RenderView *renderView, int submitOrder
     //   the counter could be complete but the renderview not yet added to the
     //   buffer depending on whichever order the cpu decides to process this
 
-    if (m_renderQueue->queueRenderView(renderView, submitOrder)) {
-        if (m_renderThread && m_running.load())
-            Q_ASSERT(m_submitRenderViewsSemaphore.available() == 0);
+    // The queues have been released on shutdown
+    if (!m_running.load()) {
+        delete renderView;
+        return;
+    }
+
+    // Only the newest frame of the ring is ever being built
+    if (m_renderQueues->newestQueue()->queueRenderView(renderView, submitOrder)) {
+        if (m_renderThread)
+            Q_ASSERT(m_submitRenderViewsSemaphore.available() < m_renderQueues->queuedFrameCount());
         m_submitRenderViewsSemaphore.release(1);
     }
 }
@@ -586,11 +734,10 @@ bool Renderer::isReadyToSubmit()
         if (m_running.load() == 0)
             return false;
 
-        // When using Thread rendering, the semaphore should only
-        // be released when the frame queue is complete and there's
-        // something to render
+        // When using Thread rendering, the semaphore is released once
+        // for each frame queue that gets completed, in frame order
         // The case of shutdown should have been handled just before
-        Q_ASSERT(m_renderQueue->isFrameQueueComplete());
+        Q_ASSERT(m_renderQueues->oldestQueue() && m_renderQueues->oldestQueue()->isFrameQueueComplete());
     } else {
         // When using synchronous rendering (QtQuick)
         // We are not sure that the frame queue is actually complete
@@ -599,7 +746,8 @@ bool Renderer::isReadyToSubmit()
         // In such a case we return early, waiting for a next call with
         // the frame queue complete at this point
         QMutexLocker locker(&m_mutex);
-        if (!m_renderQueue->isFrameQueueComplete())
+        RenderQueue *renderQueue = m_renderQueues->oldestQueue();
+        if (renderQueue == nullptr || !renderQueue->isFrameQueueComplete())
             return false;
     }
     return true;
@@ -709,31 +857,54 @@ void Renderer::prepareCommandsSubmission(const QVector<RenderView *> &renderView
 }
 
 // Executed in a job
+// Buffers queue themselves in the BufferManager when they become dirty
 void Renderer::lookForDirtyBuffers()
 {
-    const QVector<HBuffer> activeBufferHandles = m_nodesManager->bufferManager()->activeHandles();
-    for (HBuffer handle: activeBufferHandles) {
-        Buffer *buffer = m_nodesManager->bufferManager()->data(handle);
-        if (buffer->isDirty())
+    BufferManager *bufferManager = m_nodesManager->bufferManager();
+    const QVector<QNodeId> bufferIds = bufferManager->takeBuffersToUpload();
+    for (const QNodeId bufferId : bufferIds) {
+        const HBuffer handle = bufferManager->lookupHandle(bufferId);
+        Buffer *buffer = bufferManager->data(handle);
+        // The buffer may have been destroyed since it was queued
+        if (buffer != nullptr && buffer->isDirty())
             m_dirtyBuffers.push_back(handle);
     }
 }
 
 // Executed in a job
+// Textures queue themselves in the TextureManager when they become dirty
 void Renderer::lookForDirtyTextures()
 {
-    const QVector<HTexture> activeTextureHandles = m_nodesManager->textureManager()->activeHandles();
-    for (HTexture handle: activeTextureHandles) {
-        Texture *texture = m_nodesManager->textureManager()->data(handle);
-        if (texture->isDirty())
+    TextureManager *textureManager = m_nodesManager->textureManager();
+    const QVector<QNodeId> textureIds = textureManager->takeTexturesToUpdate();
+    for (const QNodeId textureId : textureIds) {
+        const HTexture handle = textureManager->lookupHandle(textureId);
+        Texture *texture = textureManager->data(handle);
+        if (texture != nullptr && texture->isDirty())
             m_dirtyTextures.push_back(handle);
     }
 }
 
 // Executed in a job
+// Shaders queue themselves in the ShaderManager when they need to be loaded.
+// Only those used by a technique matching the API of the renderer are loaded,
+// the others wait until a technique or a render pass changes
 void Renderer::lookForDirtyShaders()
 {
     if (isRunning()) {
+        ShaderManager *shaderManager = m_nodesManager->shaderManager();
+        const QVector<QNodeId> queuedShaderIds = shaderManager->takeShadersToLoad();
+        const bool shaderReferencesDirty = shaderManager->takeShaderReferencesDirty();
+
+        for (const QNodeId shaderId : queuedShaderIds) {
+            if (!m_shadersWaitingForTechnique.contains(shaderId))
+                m_shadersWaitingForTechnique.push_back(shaderId);
+        }
+
+        if ((queuedShaderIds.isEmpty() && !shaderReferencesDirty) || m_shadersWaitingForTechnique.isEmpty())
+            return;
+
+        QVector<QNodeId> referencedShaderIds;
         const QVector<HTechnique> activeTechniques = m_nodesManager->techniqueManager()->activeHandles();
         for (HTechnique techniqueHandle : activeTechniques) {
             Technique *technique = m_nodesManager->techniqueManager()->data(techniqueHandle);
@@ -742,21 +913,48 @@ void Renderer::lookForDirtyShaders()
                 const auto passIds = technique->renderPasses();
                 for (const QNodeId passId : passIds) {
                     RenderPass *renderPass = m_nodesManager->renderPassManager()->lookupResource(passId);
-                    HShader shaderHandle = m_nodesManager->shaderManager()->lookupHandle(renderPass->shaderProgram());
-                    Shader *shader = m_nodesManager->shaderManager()->data(shaderHandle);
-                    if (shader != nullptr && !shader->isLoaded())
-                        m_dirtyShaders.push_back(shaderHandle);
+                    if (renderPass != nullptr && m_shadersWaitingForTechnique.contains(renderPass->shaderProgram()))
+                        referencedShaderIds.push_back(renderPass->shaderProgram());
                 }
             }
         }
+
+        QVector<QNodeId> stillWaiting;
+        for (const QNodeId shaderId : qAsConst(m_shadersWaitingForTechnique)) {
+            const HShader shaderHandle = shaderManager->lookupHandle(shaderId);
+            Shader *shader = shaderManager->data(shaderHandle);
+            if (shader == nullptr || shader->isLoaded())
+                continue;
+            if (referencedShaderIds.contains(shaderId))
+                m_dirtyShaders.push_back(shaderHandle);
+            else
+                stillWaiting.push_back(shaderId);
+        }
+        m_shadersWaitingForTechnique = std::move(stillWaiting);
     }
 }
 
 void Renderer::updateGLResources()
 {
+    // Shaders are loaded asynchronously once the offscreen surface exists
+    if (m_offscreenHelper != nullptr && !m_graphicsContext->hasShaderCompiler()) {
+        QOffscreenSurface *surface = m_offscreenHelper->offscreenSurface();
+        if (surface != nullptr && !m_graphicsContext->startShaderCompiler(surface)) {
+            m_offscreenHelper->deleteLater();
+            m_offscreenHelper = nullptr;
+        }
+    }
+    m_graphicsContext->collectCompiledShaders();
+
+    // Picked up by the RenderViews built from now on
+    m_standardUniformBlockAlignment.store(m_graphicsContext->standardUniformBlockAlignment());
+
     const QVector<HBuffer> dirtyBufferHandles = std::move(m_dirtyBuffers);
     for (HBuffer handle: dirtyBufferHandles) {
         Buffer *buffer = m_nodesManager->bufferManager()->data(handle);
+        // Already uploaded if the buffer was queued several times
+        if (buffer == nullptr || !buffer->isDirty())
+            continue;
         // Perform data upload
         // Forces creation if it doesn't exit
         if (!m_graphicsContext->hasGLBufferForBuffer(buffer))
@@ -923,6 +1121,20 @@ Renderer::ViewSubmissionResultData Renderer::submitRenderViews(const QVector<Ren
     queueElapsed = timer.elapsed() - queueElapsed;
     qCDebug(Rendering) << Q_FUNC_INFO << "Submission of Queue in " << queueElapsed << "ms <=> " << queueElapsed / renderViewsCount << "ms per RenderView <=> Avg " << 1000.0f / (queueElapsed * 1.0f/ renderViewsCount * 1.0f) << " RenderView/s";
     qCDebug(Rendering) << Q_FUNC_INFO << "Submission Completed in " << timer.elapsed() << "ms";
+    qCDebug(Rendering) << Q_FUNC_INFO << "GL state changes issued/skipped:"
+                       << "programs" << m_graphicsContext->issuedStateChanges(GraphicsContext::ProgramStateChange)
+                       << "/" << m_graphicsContext->skippedStateChanges(GraphicsContext::ProgramStateChange)
+                       << "VAOs" << m_graphicsContext->issuedStateChanges(GraphicsContext::VertexArrayStateChange)
+                       << "/" << m_graphicsContext->skippedStateChanges(GraphicsContext::VertexArrayStateChange)
+                       << "textures" << m_graphicsContext->issuedStateChanges(GraphicsContext::TextureStateChange)
+                       << "/" << m_graphicsContext->skippedStateChanges(GraphicsContext::TextureStateChange)
+                       << "buffer bindings" << m_graphicsContext->issuedStateChanges(GraphicsContext::BufferBindingStateChange)
+                       << "/" << m_graphicsContext->skippedStateChanges(GraphicsContext::BufferBindingStateChange)
+                       << "block bindings" << m_graphicsContext->issuedStateChanges(GraphicsContext::BlockBindingStateChange)
+                       << "/" << m_graphicsContext->skippedStateChanges(GraphicsContext::BlockBindingStateChange)
+                       << "render states" << m_graphicsContext->issuedStateChanges(GraphicsContext::RenderStateChange)
+                       << "/" << m_graphicsContext->skippedStateChanges(GraphicsContext::RenderStateChange);
+    m_graphicsContext->resetStateChangeCounters();
 
     // Stores the necessary information to safely perform
     // the last swap buffer call
@@ -936,17 +1148,21 @@ Renderer::ViewSubmissionResultData Renderer::submitRenderViews(const QVector<Ren
 void Renderer::markDirty(BackendNodeDirtySet changes, BackendNode *node)
 {
     Q_UNUSED(node);
-    m_changeSet |= changes;
+    m_changeSet.fetchAndOrOrdered(int(changes));
+    // Entities or components may have been added or removed, the tree of
+    // pickable entities has to be rebuilt rather than refitted
+    if (changes & AllDirty)
+        m_pickBoundingVolumeJob->markEntityHierarchyDirty();
 }
 
 Renderer::BackendNodeDirtySet Renderer::dirtyBits()
 {
-    return m_changeSet;
+    return BackendNodeDirtySet(QFlag(m_changeSet.load()));
 }
 
 void Renderer::clearDirtyBits(BackendNodeDirtySet changes)
 {
-    m_changeSet &= ~changes;
+    m_changeSet.fetchAndAndOrdered(~int(changes));
 }
 
 bool Renderer::shouldRender()
@@ -954,7 +1170,7 @@ bool Renderer::shouldRender()
     // Only render if something changed during the last frame, or the last frame
     // was not rendered successfully (or render-on-demand is disabled)
     return (m_settings->renderPolicy() == QRenderSettings::Always
-            || m_changeSet != 0
+            || m_changeSet.load() != 0
             || !m_lastFrameCorrect.load());
 }
 
@@ -963,10 +1179,30 @@ void Renderer::skipNextFrame()
     Q_ASSERT(m_settings->renderPolicy() != QRenderSettings::Always);
 
     // make submitRenderViews() actually run
-    m_renderQueue->setNoRender();
+    QMutexLocker locker(&m_mutex);
+    m_frameAdvanceReleased = false;
+    m_renderQueues->beginFrame()->setNoRender();
     m_submitRenderViewsSemaphore.release(1);
 }
 
+// Called by QRenderAspect in the context of the QAspectThread once the changes
+// of the frame have been distributed. Returns true if the next frame would be
+// skipped and nothing is waiting to be loaded or picked, in which case the
+// aspect thread can wait for the next change rather than skip frames
+bool Renderer::isIdle()
+{
+    if (!m_running.load() || m_settings == nullptr || shouldRender())
+        return false;
+
+    TextureDataManager *textureDataManager = m_nodesManager->textureDataManager();
+    TextureDecodeQueue *decodeQueue = textureDataManager->decodeQueue();
+    return !m_pickEventFilter->hasPendingEvents()
+            && textureDataManager->texturesPending().isEmpty()
+            && !decodeQueue->hasPendingRequests()
+            && !decodeQueue->hasDecodedTextures()
+            && !m_nodesManager->sceneManager()->hasPendingSceneLoaderJobs();
+}
+
 // Waits to be told to create jobs for the next frame
 // Called by QRenderAspect jobsToExecute context of QAspectThread
 // Returns all the jobs (and with proper dependency chain) required
@@ -995,11 +1231,19 @@ QVector<Qt3DCore::QAspectJobPtr> Renderer::renderBinJobs()
     FrameGraphVisitor visitor(this, m_nodesManager->frameGraphManager());
     visitor.traverse(frameGraphRoot(), &renderBinJobs);
 
+    // Only gather the resources to upload when some were queued
+    const bool buffersToUpload = m_nodesManager->bufferManager()->hasBuffersToUpload();
+    const bool texturesToUpdate = m_nodesManager->textureManager()->hasTexturesToUpdate();
+    const bool shadersToLoad = m_nodesManager->shaderManager()->hasShadersToLoad();
+
     // Set dependencies of resource gatherer
     for (const QAspectJobPtr &jobPtr : renderBinJobs) {
-        jobPtr->addDependency(m_bufferGathererJob);
-        jobPtr->addDependency(m_textureGathererJob);
-        jobPtr->addDependency(m_shaderGathererJob);
+        if (buffersToUpload)
+            jobPtr->addDependency(m_bufferGathererJob);
+        if (texturesToUpdate)
+            jobPtr->addDependency(m_textureGathererJob);
+        if (shadersToLoad)
+            jobPtr->addDependency(m_shaderGathererJob);
     }
 
     // Add jobs
@@ -1013,12 +1257,19 @@ QVector<Qt3DCore::QAspectJobPtr> Renderer::renderBinJobs()
     renderBinJobs.append(bufferJobs);
 
     // Jobs to prepare GL Resource upload
-    renderBinJobs.push_back(m_bufferGathererJob);
-    renderBinJobs.push_back(m_textureGathererJob);
-    renderBinJobs.push_back(m_shaderGathererJob);
-
-    // Set target number of RenderViews
-    m_renderQueue->setTargetRenderViewCount(visitor.leafNodeCount());
+    if (buffersToUpload)
+        renderBinJobs.push_back(m_bufferGathererJob);
+    if (texturesToUpdate)
+        renderBinJobs.push_back(m_textureGathererJob);
+    if (shadersToLoad)
+        renderBinJobs.push_back(m_shaderGathererJob);
+
+    // Set target number of RenderViews of the frame being begun
+    {
+        QMutexLocker locker(&m_mutex);
+        m_frameAdvanceReleased = false;
+        m_renderQueues->beginFrame()->setTargetRenderViewCount(visitor.leafNodeCount());
+    }
 
     return renderBinJobs;
 }
@@ -1042,8 +1293,12 @@ void Renderer::performDraw(RenderCommand *command)
     if (command->m_primitiveRestartEnabled)
         m_graphicsContext->enablePrimitiveRestart(command->m_restartIndexValue);
 
-    // TO DO: Add glMulti Draw variants
-    if (command->m_drawIndexed) {
+    if (command->m_indirectDrawCount > 0) {
+        m_graphicsContext->multiDrawElementsIndirect(command->m_primitiveType,
+                                                     command->m_indexAttributeDataType,
+                                                     command->m_indirectDrawOffset,
+                                                     command->m_indirectDrawCount);
+    } else if (command->m_drawIndexed) {
         m_graphicsContext->drawElementsInstancedBaseVertexBaseInstance(command->m_primitiveType,
                                                                        command->m_primitiveCount,
                                                                        command->m_indexAttributeDataType,
@@ -1069,6 +1324,32 @@ void Renderer::performDraw(RenderCommand *command)
         m_graphicsContext->disablePrimitiveRestart();
 }
 
+// Called by executeCommands when the indirect draws of a RenderView couldn't
+// be uploaded, the draws packed in the command are then issued one by one
+void Renderer::performPackedDraws(RenderCommand *command,
+                                  const QByteArray &instanceData,
+                                  const QByteArray &indirectDrawData)
+{
+    const DrawElementsIndirectCommand *draws =
+            reinterpret_cast<const DrawElementsIndirectCommand *>(indirectDrawData.constData() + command->m_indirectDrawOffset);
+    const int indexSize = indexTypeSize(command->m_indexAttributeDataType);
+    const int instanceTransformSize = 16 * sizeof(float);
+    for (int i = 0; i < command->m_indirectDrawCount; ++i) {
+        const DrawElementsIndirectCommand &draw = draws[i];
+        m_graphicsContext->specifyInstanceTransforms(instanceData,
+                                                     command->m_instanceAttributeLocation,
+                                                     int(draw.baseInstance) * instanceTransformSize,
+                                                     1);
+        m_graphicsContext->drawElementsInstancedBaseVertexBaseInstance(command->m_primitiveType,
+                                                                       draw.count,
+                                                                       command->m_indexAttributeDataType,
+                                                                       reinterpret_cast<void*>(quintptr(draw.firstIndex * indexSize)),
+                                                                       draw.instanceCount,
+                                                                       draw.baseVertex,
+                                                                       0);
+    }
+}
+
 void Renderer::performCompute(const RenderView *, RenderCommand *command)
 {
     m_graphicsContext->activateShader(command->m_shaderDna);
@@ -1078,7 +1359,7 @@ void Renderer::performCompute(const RenderView *, RenderCommand *command)
             command->m_workGroups[2]);
 
     // HACK: Reset the compute flag to dirty
-    m_changeSet |= AbstractRenderer::ComputeDirty;
+    m_changeSet.fetchAndOrOrdered(AbstractRenderer::ComputeDirty);
 
 #if defined(QT3D_RENDER_ASPECT_OPENGL_DEBUG)
     int err = m_graphicsContext->openGLContext()->functions()->glGetError();
@@ -1126,15 +1407,47 @@ bool Renderer::executeCommandsSubmission(const RenderView *rv)
     RenderStateSet *globalState = m_graphicsContext->currentStateSet();
     OpenGLVertexArrayObject *vao = nullptr;
 
+    // Upload the standard uniforms of all the commands at once. Without a
+    // buffer for them, the frame is rendered again with the standard
+    // uniforms set individually
+    if (!m_graphicsContext->setStandardUniformData(rv->standardUniformData())) {
+        m_standardUniformBlockAlignment.store(0);
+        allCommandsIssued = false;
+    }
+
+    // Same for the transforms of the instanced commands
+    const QByteArray instanceData = rv->instanceData();
+    m_graphicsContext->setInstanceData(instanceData);
+
+    // And the draws packed in multi draw indirect calls, issued one by one
+    // if they can't be uploaded
+    const QByteArray indirectDrawData = rv->indirectDrawData();
+    const bool indirectDrawsUploaded = m_graphicsContext->setIndirectDrawData(indirectDrawData);
+
+    // Commands of a shader which failed to link are never issued, rendering
+    // the frame again wouldn't change that
+    ShaderManager *shaderManager = m_nodesManager->shaderManager();
+    const auto hasLinkFailed = [shaderManager] (const RenderCommand *command) {
+        const Shader *shader = shaderManager->data(command->m_shader);
+        return shader != nullptr && shader->hasLinkFailed();
+    };
+
     for (RenderCommand *command : qAsConst(commands)) {
 
         if (command->m_type == RenderCommand::Compute) { // Compute Call
+            // Skipped until the compiler thread is done with the program
+            if (!m_graphicsContext->isShaderProgramReady(command->m_shaderDna)) {
+                if (!hasLinkFailed(command))
+                    allCommandsIssued = false;
+                continue;
+            }
             performCompute(rv, command);
         } else { // Draw Command
 
             // Check if we have a valid command that can be drawn
             if (!command->m_isValid) {
-                allCommandsIssued = false;
+                if (!hasLinkFailed(command))
+                    allCommandsIssued = false;
                 continue;
             }
 
@@ -1149,24 +1462,39 @@ bool Renderer::executeCommandsSubmission(const RenderView *rv)
             //// Update program uniforms
             m_graphicsContext->setParameters(command->m_parameterPack);
 
+            // Per instance world transforms, a single transform is shared by
+            // all the instances of an unmerged command. Multi draws select
+            // their transforms with the base instance of each draw instead
+            if (command->m_indirectDrawCount > 0)
+                m_graphicsContext->specifyInstanceTransforms(instanceData,
+                                                             command->m_instanceAttributeLocation,
+                                                             0, 1);
+            else if (command->m_instanceDataOffset >= 0)
+                m_graphicsContext->specifyInstanceTransforms(instanceData,
+                                                             command->m_instanceAttributeLocation,
+                                                             command->m_instanceDataOffset,
+                                                             command->m_instanceTransformCount > 1 ? 1 : qMax(1, command->m_instanceCount));
+
             //// OpenGL State
             // TO DO: Make states not dependendent on their backend node for this step
             // Set state
             RenderStateSet *localState = command->m_stateSet;
-            // Merge the RenderCommand state with the globalState of the RenderView
-            // Or restore the globalState if no stateSet for the RenderCommand
-            if (localState != nullptr) {
-                command->m_stateSet->merge(globalState);
-                m_graphicsContext->setCurrentStateSet(command->m_stateSet);
-            } else {
+            // The RenderCommand state was merged with the globalState of the
+            // RenderView when building the command, restore the globalState if
+            // no stateSet for the RenderCommand
+            if (localState != nullptr)
+                m_graphicsContext->setCurrentStateSet(localState);
+            else
                 m_graphicsContext->setCurrentStateSet(globalState);
-            }
             // All Uniforms for a pass are stored in the QUniformPack of the command
             // Uniforms for Effect, Material and Technique should already have been correctly resolved
             // at that point
 
             //// Draw Calls
-            performDraw(command);
+            if (command->m_indirectDrawCount > 0 && !indirectDrawsUploaded)
+                performPackedDraws(command, instanceData, indirectDrawData);
+            else
+                performDraw(command);
         }
     } // end of RenderCommands loop
 
@@ -1262,6 +1590,11 @@ void Renderer::cleanGraphicsResources()
     const QVector<Qt3DCore::QNodeId> buffersToRelease = std::move(m_nodesManager->bufferManager()->buffersToRelease());
     for (Qt3DCore::QNodeId bufferId : buffersToRelease)
         m_graphicsContext->releaseBuffer(bufferId);
+
+    // Clean UBOs generated from ShaderData
+    const QVector<Qt3DCore::QNodeId> shaderDataToRelease = m_nodesManager->shaderDataManager()->takeShaderDataToRelease();
+    for (Qt3DCore::QNodeId shaderDataId : shaderDataToRelease)
+        m_graphicsContext->releaseShaderDataUniformBuffers(shaderDataId);
 }
 
 QList<QMouseEvent> Renderer::pendingPickingEvents() const
@@ -126,6 +126,7 @@ class Shader;
 class Entity;
 class RenderCommand;
 class RenderQueue;
+class RenderQueueRing;
 class RenderView;
 class Effect;
 class RenderPass;
@@ -134,6 +135,7 @@ class RenderStateSet;
 class VSyncFrameAdvanceService;
 class PickEventFilter;
 class NodeManagers;
+class OffscreenSurfaceHelper;
 
 class QT3DRENDERSHARED_PRIVATE_EXPORT Renderer : public AbstractRenderer
 {
@@ -176,6 +178,7 @@ public:
 
     bool shouldRender() Q_DECL_OVERRIDE;
     void skipNextFrame() Q_DECL_OVERRIDE;
+    bool isIdle() Q_DECL_OVERRIDE;
 
     QVector<Qt3DCore::QAspectJobPtr> renderBinJobs() Q_DECL_OVERRIDE;
     Qt3DCore::QAspectJobPtr pickBoundingVolumeJob() Q_DECL_OVERRIDE;
@@ -197,6 +200,8 @@ public:
 
     void updateGLResources();
     void prepareCommandsSubmission(const QVector<RenderView *> &renderViews);
+    bool prepareFrame(RenderQueue *renderQueue, bool makeContextCurrent);
+    void prepareNextFrame(QSurface *currentSurface);
     bool executeCommandsSubmission(const RenderView *rv);
     void updateVAOWithAttributes(Geometry *geometry,
                                  RenderCommand *command,
@@ -208,6 +213,7 @@ public:
 
     void setOpenGLContext(QOpenGLContext *context);
     const GraphicsApiFilterData *contextInfo() const;
+    int standardUniformBlockAlignment() const { return m_standardUniformBlockAlignment.load(); }
 
     inline RenderStateSet *defaultRenderState() const { return m_defaultRenderStateSet; }
 
@@ -260,13 +266,17 @@ private:
 
     QScopedPointer<GraphicsContext> m_graphicsContext;
 
-    RenderQueue *m_renderQueue;
+    RenderQueueRing *m_renderQueues;
     QScopedPointer<RenderThread> m_renderThread;
     QScopedPointer<VSyncFrameAdvanceService> m_vsyncFrameAdvanceService;
 
     QMutex m_mutex;
     QSemaphore m_submitRenderViewsSemaphore;
     QSemaphore m_waitForInitializationToBeCompleted;
+    // Guarded by m_mutex, true while the aspect thread may begin a frame
+    bool m_frameAdvanceReleased;
+
+    void proceedToNextFrameIfPossible();
 
     QAtomicInt m_running;
 
@@ -275,9 +285,14 @@ private:
     QVector<Attribute *> m_dirtyAttributes;
     QVector<Geometry *> m_dirtyGeometry;
     QAtomicInt m_exposed;
-    BackendNodeDirtySet m_changeSet;
+    // Backend nodes are marked dirty from the node creation jobs
+    QAtomicInt m_changeSet;
     QAtomicInt m_lastFrameCorrect;
+    // Alignment of the command ranges in the standard uniform buffers of the
+    // RenderViews, 0 if standard uniforms have to be set individually
+    QAtomicInt m_standardUniformBlockAlignment;
     QOpenGLContext *m_glContext;
+    OffscreenSurfaceHelper *m_offscreenHelper;
     PickBoundingVolumeJobPtr m_pickBoundingVolumeJob;
 
     qint64 m_time;
@@ -295,6 +310,9 @@ private:
     QVector<Qt3DCore::QNodeId> m_pendingRenderCaptureSendRequests;
 
     void performDraw(RenderCommand *command);
+    void performPackedDraws(RenderCommand *command,
+                            const QByteArray &instanceData,
+                            const QByteArray &indirectDrawData);
     void performCompute(const RenderView *rv, RenderCommand *command);
     void createOrUpdateVAO(RenderCommand *command,
                            HVao *previousVAOHandle,
@@ -311,6 +329,7 @@ private:
     QVector<HBuffer> m_dirtyBuffers;
     QVector<HShader> m_dirtyShaders;
     QVector<HTexture> m_dirtyTextures;
+    QVector<Qt3DCore::QNodeId> m_shadersWaitingForTechnique;
 
 #ifdef QT3D_JOBS_RUN_STATS
     QScopedPointer<Qt3DRender::Debug::CommandExecuter> m_commandExecuter;
@@ -49,8 +49,11 @@ namespace Render {
 
 RenderQueue::RenderQueue()
     : m_noRender(false)
+    , m_prepared(false)
+    , m_submittable(false)
     , m_targetRenderViewCount(0)
     , m_currentRenderViewCount(0)
+    , m_frameIndex(0)
     , m_currentWorkQueue(1)
 {
 }
@@ -70,6 +73,8 @@ void RenderQueue::reset()
     m_targetRenderViewCount = 0;
     m_currentWorkQueue.clear();
     m_noRender = false;
+    m_prepared = false;
+    m_submittable = false;
 }
 
 void RenderQueue::setNoRender()
@@ -96,7 +101,7 @@ bool RenderQueue::queueRenderView(RenderView *renderView, uint submissionOrderIn
  * A call to reset is required after rendering of the frame. Otherwise under some
  * conditions the current but then invalidated frame queue could be reused.
  */
-QVector<RenderView *> RenderQueue::nextFrameQueue()
+QVector<RenderView *> RenderQueue::nextFrameQueue() const
 {
     return m_currentWorkQueue;
 }
@@ -111,6 +116,17 @@ void RenderQueue::setTargetRenderViewCount(int targetRenderViewCount)
     m_currentWorkQueue.resize(targetRenderViewCount);
 }
 
+/*!
+ * Records that the backend data referenced by the RenderView objects of the
+ * frame has been consumed by the Renderer. \a submittable is false when
+ * there is nothing to submit for the frame.
+ */
+void RenderQueue::setPrepared(bool submittable)
+{
+    m_prepared = true;
+    m_submittable = submittable;
+}
+
 /*!
  * Returns true if all the RenderView objects making up the current frame have been queued.
  * Returns false otherwise.
@@ -122,6 +138,93 @@ bool RenderQueue::isFrameQueueComplete() const
             || (m_targetRenderViewCount && m_targetRenderViewCount == currentRenderViewCount()));
 }
 
+/*!
+ * \class Qt3DRender::Render::RenderQueueRing
+ * \internal
+ *
+ * Holds the RenderQueue of every frame between the moment the aspect thread
+ * starts building it and the moment the Renderer is done submitting it.
+ * \a framesInFlight, clamped between 1 and MaxFramesInFlight, is the number of
+ * frames that can be queued at once, the one being submitted included.
+ *
+ * Frames are numbered in the order they are begun and a frame always lives
+ * in the queue of index frameIndex % framesInFlight. Not thread safe, the
+ * Renderer guards it with its mutex.
+ */
+RenderQueueRing::RenderQueueRing(int framesInFlight)
+    : m_framesInFlight(qBound(1, framesInFlight, int(MaxFramesInFlight)))
+    , m_queuedFrameCount(0)
+    , m_nextFrameIndex(0)
+{
+}
+
+/*!
+ * Returns the reset queue of the next frame. A queue must be available.
+ */
+RenderQueue *RenderQueueRing::beginFrame()
+{
+    Q_ASSERT(canBeginFrame());
+    RenderQueue *renderQueue = &m_queues[m_nextFrameIndex % m_framesInFlight];
+    renderQueue->reset();
+    renderQueue->setFrameIndex(m_nextFrameIndex++);
+    ++m_queuedFrameCount;
+    return renderQueue;
+}
+
+/*!
+ * Returns the queue of the oldest frame, the next one to be submitted, or
+ * nullptr if no frame is queued.
+ */
+RenderQueue *RenderQueueRing::oldestQueue()
+{
+    if (m_queuedFrameCount == 0)
+        return nullptr;
+    return &m_queues[(m_nextFrameIndex - m_queuedFrameCount) % m_framesInFlight];
+}
+
+/*!
+ * Returns the queue of the last frame begun, or nullptr if no frame is queued.
+ */
+RenderQueue *RenderQueueRing::newestQueue()
+{
+    if (m_queuedFrameCount == 0)
+        return nullptr;
+    return &m_queues[(m_nextFrameIndex - 1) % m_framesInFlight];
+}
+
+/*!
+ * Resets the queue of the oldest frame and makes it available to a new
+ * frame. The caller is responsible for deleting its RenderView objects.
+ */
+void RenderQueueRing::releaseOldestFrame()
+{
+    Q_ASSERT(m_queuedFrameCount > 0);
+    oldestQueue()->reset();
+    --m_queuedFrameCount;
+}
+
+/*!
+ * Returns the RenderView objects of all the queued frames, oldest first.
+ * Frames still being built may contain null entries.
+ */
+QVector<RenderView *> RenderQueueRing::renderViews() const
+{
+    QVector<RenderView *> renderViews;
+    for (int i = m_queuedFrameCount; i > 0; --i)
+        renderViews += m_queues[(m_nextFrameIndex - i) % m_framesInFlight].nextFrameQueue();
+    return renderViews;
+}
+
+/*!
+ * Drops all the queued frames. Frame indices keep increasing.
+ */
+void RenderQueueRing::reset()
+{
+    for (int i = 0; i < m_framesInFlight; ++i)
+        m_queues[i].reset();
+    m_queuedFrameCount = 0;
+}
+
 } // namespace Render
 
 } // namespace Qt3DRender
@@ -73,18 +73,57 @@ public:
     bool isFrameQueueComplete() const;
 
     bool queueRenderView(RenderView *renderView, uint submissionOrderIndex);
-    QVector<RenderView *> nextFrameQueue();
+    QVector<RenderView *> nextFrameQueue() const;
     void reset();
 
     void setNoRender();
 
+    void setFrameIndex(quint64 frameIndex) { m_frameIndex = frameIndex; }
+    quint64 frameIndex() const { return m_frameIndex; }
+
+    void setPrepared(bool submittable);
+    bool isPrepared() const { return m_prepared; }
+    bool isSubmittable() const { return m_submittable; }
+
 private:
     bool m_noRender;
+    bool m_prepared;
+    bool m_submittable;
     int m_targetRenderViewCount;
     int m_currentRenderViewCount;
+    quint64 m_frameIndex;
     QVector<RenderView *> m_currentWorkQueue;
 };
 
+class Q_AUTOTEST_EXPORT RenderQueueRing
+{
+public:
+    enum {
+        MaxFramesInFlight = 3
+    };
+
+    explicit RenderQueueRing(int framesInFlight = 2);
+
+    int framesInFlight() const { return m_framesInFlight; }
+    int queuedFrameCount() const { return m_queuedFrameCount; }
+    quint64 nextFrameIndex() const { return m_nextFrameIndex; }
+    bool canBeginFrame() const { return m_queuedFrameCount < m_framesInFlight; }
+
+    RenderQueue *beginFrame();
+    RenderQueue *oldestQueue();
+    RenderQueue *newestQueue();
+    void releaseOldestFrame();
+
+    QVector<RenderView *> renderViews() const;
+    void reset();
+
+private:
+    RenderQueue m_queues[MaxFramesInFlight];
+    int m_framesInFlight;
+    int m_queuedFrameCount;
+    quint64 m_nextFrameIndex;
+};
+
 } // namespace Render
 
 } // namespace Qt3DRender
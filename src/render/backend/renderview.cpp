@@ -67,6 +67,7 @@
 #include <Qt3DRender/private/geometryrenderermanager_p.h>
 #include <Qt3DRender/private/rendercapture_p.h>
 #include <Qt3DRender/private/stringtoint_p.h>
+#include <Qt3DRender/private/texturedatamanager_p.h>
 #include <Qt3DCore/qentity.h>
 #include <QtGui/qsurface.h>
 #include <algorithm>
@@ -93,12 +94,188 @@ const int MAX_LIGHTS = 8;
 #define LIGHT_COLOR_NAME     QLatin1String(".color")
 #define LIGHT_INTENSITY_NAME QLatin1String(".intensity")
 
-int LIGHT_COUNT_NAME_ID = 0;
+// Uniform blocks named qt3d_StandardUniforms, declared without an instance
+// name, get their standard uniforms from the RenderView standard uniform buffer
+const int STANDARD_UNIFORM_BLOCK_NAME_ID = StringToInt::StandardUniformBlockNameId;
+
+// Vertex attribute (qt3d_InstanceModelMatrix) through which shaders opt in
+// to instanced batching
+const int INSTANCE_MODEL_MATRIX_NAME_ID = StringToInt::InstanceModelMatrixNameId;
+
+// Standard uniforms depending on the world transform, they are allowed to
+// differ between commands merged into an instanced draw
+const int MODEL_UNIFORM_COUNT = 9;
+
+const int MODEL_UNIFORM_NAME_IDS[MODEL_UNIFORM_COUNT] = {
+    StringToInt::ModelMatrixNameId,
+    StringToInt::ModelViewNameId,
+    StringToInt::ModelViewProjectionNameId,
+    StringToInt::MvpNameId,
+    StringToInt::InverseModelMatrixNameId,
+    StringToInt::InverseModelViewNameId,
+    StringToInt::InverseModelViewProjectionNameId,
+    StringToInt::ModelNormalMatrixNameId,
+    StringToInt::ModelViewNormalNameId
+};
+const int LIGHT_COUNT_NAME_ID = StringToInt::LightCountNameId;
 int LIGHT_POSITION_NAMES[MAX_LIGHTS];
 int LIGHT_TYPE_NAMES[MAX_LIGHTS];
 int LIGHT_COLOR_NAMES[MAX_LIGHTS];
 int LIGHT_INTENSITY_NAMES[MAX_LIGHTS];
 QString LIGHT_STRUCT_NAMES[MAX_LIGHTS];
+int LIGHT_STRUCT_NAME_IDS[MAX_LIGHTS];
+
+bool isModelUniform(int nameId)
+{
+    return std::find(MODEL_UNIFORM_NAME_IDS, MODEL_UNIFORM_NAME_IDS + MODEL_UNIFORM_COUNT, nameId)
+            != MODEL_UNIFORM_NAME_IDS + MODEL_UNIFORM_COUNT;
+}
+
+bool hasSameParametersButTransform(const ShaderParameterPack &a, const ShaderParameterPack &b)
+{
+    const PackUniformHash &uniformsA = a.uniforms();
+    const PackUniformHash &uniformsB = b.uniforms();
+    if (uniformsA.size() != uniformsB.size())
+        return false;
+    for (auto it = uniformsA.cbegin(), end = uniformsA.cend(); it != end; ++it) {
+        const auto other = uniformsB.constFind(it.key());
+        if (other == uniformsB.cend())
+            return false;
+        if (!isModelUniform(it.key()) && other.value() != it.value())
+            return false;
+    }
+
+    const QVector<ShaderParameterPack::NamedTexture> texturesA = a.textures();
+    const QVector<ShaderParameterPack::NamedTexture> texturesB = b.textures();
+    if (texturesA.size() != texturesB.size())
+        return false;
+    for (int i = 0, m = texturesA.size(); i < m; ++i) {
+        if (texturesA.at(i).glslNameId != texturesB.at(i).glslNameId || texturesA.at(i).texId != texturesB.at(i).texId)
+            return false;
+    }
+
+    const QVector<BlockToUBO> uniformBuffersA = a.uniformBuffers();
+    const QVector<BlockToUBO> uniformBuffersB = b.uniformBuffers();
+    if (uniformBuffersA.size() != uniformBuffersB.size())
+        return false;
+    for (int i = 0, m = uniformBuffersA.size(); i < m; ++i) {
+        if (uniformBuffersA.at(i).m_blockIndex != uniformBuffersB.at(i).m_blockIndex
+                || uniformBuffersA.at(i).m_bufferID != uniformBuffersB.at(i).m_bufferID
+                || uniformBuffersA.at(i).m_shaderDataID != uniformBuffersB.at(i).m_shaderDataID
+                || uniformBuffersA.at(i).m_values != uniformBuffersB.at(i).m_values)
+            return false;
+    }
+
+    const QVector<BlockToSSBO> storageBuffersA = a.shaderStorageBuffers();
+    const QVector<BlockToSSBO> storageBuffersB = b.shaderStorageBuffers();
+    if (storageBuffersA.size() != storageBuffersB.size())
+        return false;
+    for (int i = 0, m = storageBuffersA.size(); i < m; ++i) {
+        if (storageBuffersA.at(i).m_blockIndex != storageBuffersB.at(i).m_blockIndex
+                || storageBuffersA.at(i).m_bufferID != storageBuffersB.at(i).m_bufferID)
+            return false;
+    }
+
+    return a.standardUniformSize() == b.standardUniformSize();
+}
+
+bool hasSameStateSet(const RenderCommand *command, const RenderCommand *other)
+{
+    // The state sets of the commands of a RenderView are interned
+    return command->m_stateSet == other->m_stateSet;
+}
+
+// Commands can be drawn as instances of the same draw call if they draw the
+// same geometry with the same program, states and parameters
+bool canMergeInstances(const RenderCommand *command, const RenderCommand *other)
+{
+    if (!other->m_isValid || other->m_instanceAttributeLocation != command->m_instanceAttributeLocation)
+        return false;
+    if (command->m_instanceCount != 1 || other->m_instanceCount != 1
+            || command->m_firstInstance != 0 || other->m_firstInstance != 0)
+        return false;
+    if (command->m_shaderDna != other->m_shaderDna
+            || command->m_geometry != other->m_geometry
+            || command->m_geometryRenderer != other->m_geometryRenderer)
+        return false;
+    // All the instances are drawn with the draw parameters of the first command
+    if (command->m_drawIndexed != other->m_drawIndexed
+            || command->m_primitiveType != other->m_primitiveType
+            || command->m_primitiveCount != other->m_primitiveCount
+            || command->m_indexAttributeByteOffset != other->m_indexAttributeByteOffset
+            || command->m_indexAttributeDataType != other->m_indexAttributeDataType
+            || command->m_indexOffset != other->m_indexOffset
+            || command->m_firstVertex != other->m_firstVertex)
+        return false;
+    return hasSameStateSet(command, other)
+            && hasSameParametersButTransform(command->m_parameterPack, other->m_parameterPack);
+}
+
+int indexTypeSize(GLint indexType)
+{
+    switch (indexType) {
+    case GL_UNSIGNED_BYTE:
+        return 1;
+    case GL_UNSIGNED_SHORT:
+        return 2;
+    case GL_UNSIGNED_INT:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+// Indirect draws can't change uniforms between draws, only the commands
+// reading a transform per instance from the instance data qualify
+bool canDrawIndirect(const RenderCommand *command)
+{
+    const int indexSize = indexTypeSize(command->m_indexAttributeDataType);
+    return command->m_isValid
+            && command->m_type == RenderCommand::Draw
+            && command->m_drawIndexed
+            && !command->m_primitiveRestartEnabled
+            && command->m_primitiveType != QGeometryRenderer::Patches
+            && command->m_instanceDataOffset >= 0
+            && command->m_instanceCount == command->m_instanceTransformCount
+            && command->m_firstInstance == 0
+            && indexSize > 0
+            && command->m_indexAttributeByteOffset % indexSize == 0;
+}
+
+// Commands drawing parts of the same geometry with the same program share a
+// VAO and can be packed in the same multi draw
+bool canShareIndirectDraw(const RenderCommand *command, const RenderCommand *other)
+{
+    if (!canDrawIndirect(other))
+        return false;
+    if (command->m_shaderDna != other->m_shaderDna
+            || command->m_geometry != other->m_geometry
+            || command->m_primitiveType != other->m_primitiveType
+            || command->m_indexAttributeDataType != other->m_indexAttributeDataType
+            || command->m_instanceAttributeLocation != other->m_instanceAttributeLocation)
+        return false;
+    return hasSameStateSet(command, other)
+            && hasSameParametersButTransform(command->m_parameterPack, other->m_parameterPack);
+}
+
+void appendIndirectDraw(QByteArray &indirectDrawData, const RenderCommand *command)
+{
+    DrawElementsIndirectCommand draw;
+    draw.count = command->m_primitiveCount;
+    draw.instanceCount = command->m_instanceCount;
+    draw.firstIndex = command->m_indexAttributeByteOffset / indexTypeSize(command->m_indexAttributeDataType);
+    // Matches performDraw which uses the index offset as base vertex
+    draw.baseVertex = command->m_indexOffset;
+    // The instance attribute is read from the start of the instance data
+    draw.baseInstance = command->m_instanceDataOffset / (16 * sizeof(float));
+    indirectDrawData.append(reinterpret_cast<const char *>(&draw), sizeof(DrawElementsIndirectCommand));
+}
+
+void appendInstanceTransform(QByteArray &instanceData, const QMatrix4x4 &transform)
+{
+    // Column-major, as expected for a mat4 attribute
+    instanceData.append(reinterpret_cast<const char *>(transform.constData()), 16 * sizeof(float));
+}
 
 } // anonymous namespace
 
@@ -110,25 +287,25 @@ RenderView::StandardUniformsPFuncsHash RenderView::initializeStandardUniformSett
 {
     RenderView::StandardUniformsPFuncsHash setters;
 
-    setters.insert(StringToInt::lookupId(QLatin1String("modelMatrix")), &RenderView::modelMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("viewMatrix")), &RenderView::viewMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("projectionMatrix")), &RenderView::projectionMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("modelView")), &RenderView::modelViewMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("viewProjectionMatrix")), &RenderView::viewProjectionMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("modelViewProjection")), &RenderView::modelViewProjectionMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("mvp")), &RenderView::modelViewProjectionMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("inverseModelMatrix")), &RenderView::inverseModelMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("inverseViewMatrix")), &RenderView::inverseViewMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("inverseProjectionMatrix")), &RenderView::inverseProjectionMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("inverseModelView")), &RenderView::inverseModelViewMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("inverseViewProjectionMatrix")), &RenderView::inverseViewProjectionMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("inverseModelViewProjection")), &RenderView::inverseModelViewProjectionMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("modelNormalMatrix")), &RenderView::modelNormalMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("modelViewNormal")), &RenderView::modelViewNormalMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("viewportMatrix")), &RenderView::viewportMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("inverseViewportMatrix")), &RenderView::inverseViewportMatrix);
-    setters.insert(StringToInt::lookupId(QLatin1String("time")), &RenderView::time);
-    setters.insert(StringToInt::lookupId(QLatin1String("eyePosition")), &RenderView::eyePosition);
+    setters.insert(StringToInt::ModelMatrixNameId, &RenderView::modelMatrix);
+    setters.insert(StringToInt::ViewMatrixNameId, &RenderView::viewMatrix);
+    setters.insert(StringToInt::ProjectionMatrixNameId, &RenderView::projectionMatrix);
+    setters.insert(StringToInt::ModelViewNameId, &RenderView::modelViewMatrix);
+    setters.insert(StringToInt::ViewProjectionMatrixNameId, &RenderView::viewProjectionMatrix);
+    setters.insert(StringToInt::ModelViewProjectionNameId, &RenderView::modelViewProjectionMatrix);
+    setters.insert(StringToInt::MvpNameId, &RenderView::modelViewProjectionMatrix);
+    setters.insert(StringToInt::InverseModelMatrixNameId, &RenderView::inverseModelMatrix);
+    setters.insert(StringToInt::InverseViewMatrixNameId, &RenderView::inverseViewMatrix);
+    setters.insert(StringToInt::InverseProjectionMatrixNameId, &RenderView::inverseProjectionMatrix);
+    setters.insert(StringToInt::InverseModelViewNameId, &RenderView::inverseModelViewMatrix);
+    setters.insert(StringToInt::InverseViewProjectionMatrixNameId, &RenderView::inverseViewProjectionMatrix);
+    setters.insert(StringToInt::InverseModelViewProjectionNameId, &RenderView::inverseModelViewProjectionMatrix);
+    setters.insert(StringToInt::ModelNormalMatrixNameId, &RenderView::modelNormalMatrix);
+    setters.insert(StringToInt::ModelViewNormalNameId, &RenderView::modelViewNormalMatrix);
+    setters.insert(StringToInt::ViewportMatrixNameId, &RenderView::viewportMatrix);
+    setters.insert(StringToInt::InverseViewportMatrixNameId, &RenderView::inverseViewportMatrix);
+    setters.insert(StringToInt::TimeNameId, &RenderView::time);
+    setters.insert(StringToInt::EyePositionNameId, &RenderView::eyePosition);
 
     return setters;
 }
@@ -262,6 +439,7 @@ RenderView::RenderView()
     , m_noDraw(false)
     , m_compute(false)
     , m_frustumCulling(false)
+    , m_standardUniformBlockAlignment(0)
 {
     m_workGroups[0] = 1;
     m_workGroups[1] = 1;
@@ -272,10 +450,10 @@ RenderView::RenderView()
         // and this hash relies on the static StringToInt class
         wasInitialized = true;
         RenderView::ms_standardUniformSetters = RenderView::initializeStandardUniformSetters();
-        LIGHT_COUNT_NAME_ID = StringToInt::lookupId(QLatin1String("lightCount"));
         for (int i = 0; i < MAX_LIGHTS; ++i) {
             Q_STATIC_ASSERT_X(MAX_LIGHTS < 10, "can't use the QChar trick anymore");
             LIGHT_STRUCT_NAMES[i] = QLatin1String("lights[") + QLatin1Char(char('0' + i)) + QLatin1Char(']');
+            LIGHT_STRUCT_NAME_IDS[i] = StringToInt::lookupId(LIGHT_STRUCT_NAMES[i]);
             LIGHT_POSITION_NAMES[i] = StringToInt::lookupId(LIGHT_STRUCT_NAMES[i] + LIGHT_POSITION_NAME);
             LIGHT_TYPE_NAMES[i] = StringToInt::lookupId(LIGHT_STRUCT_NAMES[i] + LIGHT_TYPE_NAME);
             LIGHT_COLOR_NAMES[i] = StringToInt::lookupId(LIGHT_STRUCT_NAMES[i] + LIGHT_COLOR_NAME);
@@ -287,10 +465,27 @@ RenderView::RenderView()
 RenderView::~RenderView()
 {
     delete m_stateSet;
-    for (RenderCommand *command : qAsConst(m_commands)) {
-        delete command->m_stateSet;
-        delete command;
+    qDeleteAll(m_internedStateSets);
+    qDeleteAll(m_commands);
+}
+
+RenderStateSet *RenderView::internStateSet(RenderStateSet *stateSet, int *stateSetId) const
+{
+    QMutexLocker lock(&m_internedStateSetsMutex);
+    const StateMaskSet mask = stateSet->stateMask();
+    for (auto it = m_internedStateSetIndices.constFind(mask), end = m_internedStateSetIndices.constEnd();
+         it != end && it.key() == mask; ++it) {
+        RenderStateSet *internedStateSet = m_internedStateSets.at(it.value());
+        if (*internedStateSet == *stateSet) {
+            delete stateSet;
+            *stateSetId = it.value() + 1;
+            return internedStateSet;
+        }
     }
+    m_internedStateSetIndices.insert(mask, m_internedStateSets.size());
+    m_internedStateSets.push_back(stateSet);
+    *stateSetId = m_internedStateSets.size();
+    return stateSet;
 }
 
 void RenderView::sort()
@@ -298,8 +493,10 @@ void RenderView::sort()
     // Compares the bitsetKey of the RenderCommands
     // Key[Depth | StateCost | Shader]
     std::sort(m_commands.begin(), m_commands.end(), compareCommands);
+}
 
-    // Minimize uniform changes
+void RenderView::minimizeUniformChanges()
+{
     int i = 0;
     while (i < m_commands.size()) {
         int j = i;
@@ -341,6 +538,67 @@ void RenderView::sort()
     }
 }
 
+void RenderView::mergeInstancedCommands(bool supportsInstancedArrays)
+{
+    m_instanceData.clear();
+    QVector<RenderCommand *> commands;
+    commands.reserve(m_commands.size());
+
+    for (int i = 0, m = m_commands.size(); i < m; ++i) {
+        RenderCommand *command = m_commands.at(i);
+        commands.push_back(command);
+        if (command->m_instanceAttributeLocation < 0 || !command->m_isValid)
+            continue;
+
+        command->m_instanceDataOffset = m_instanceData.size();
+        command->m_instanceTransformCount = 1;
+        appendInstanceTransform(m_instanceData, command->m_instanceTransform);
+
+        // Commands are sorted, only adjacent ones can be merged without
+        // changing the draw order
+        while (supportsInstancedArrays && i + 1 < m && canMergeInstances(command, m_commands.at(i + 1))) {
+            RenderCommand *mergedCommand = m_commands.at(++i);
+            appendInstanceTransform(m_instanceData, mergedCommand->m_instanceTransform);
+            ++command->m_instanceTransformCount;
+            delete mergedCommand;
+        }
+        if (command->m_instanceTransformCount > 1)
+            command->m_instanceCount = command->m_instanceTransformCount;
+    }
+
+    m_commands = commands;
+}
+
+void RenderView::packIndirectDraws(bool supportsMultiDrawIndirect)
+{
+    m_indirectDrawData.clear();
+    if (!supportsMultiDrawIndirect)
+        return;
+
+    QVector<RenderCommand *> commands;
+    commands.reserve(m_commands.size());
+
+    for (int i = 0, m = m_commands.size(); i < m; ++i) {
+        RenderCommand *command = m_commands.at(i);
+        commands.push_back(command);
+        if (!canDrawIndirect(command) || i + 1 == m || !canShareIndirectDraw(command, m_commands.at(i + 1)))
+            continue;
+
+        command->m_indirectDrawOffset = m_indirectDrawData.size();
+        command->m_indirectDrawCount = 1;
+        appendIndirectDraw(m_indirectDrawData, command);
+
+        while (i + 1 < m && canShareIndirectDraw(command, m_commands.at(i + 1))) {
+            RenderCommand *packedCommand = m_commands.at(++i);
+            appendIndirectDraw(m_indirectDrawData, packedCommand);
+            ++command->m_indirectDrawCount;
+            delete packedCommand;
+        }
+    }
+
+    m_commands = commands;
+}
+
 void RenderView::setRenderer(Renderer *renderer)
 {
     m_renderer = renderer;
@@ -396,18 +654,17 @@ void RenderView::addClearBuffers(const ClearBuffers *cb) {
 }
 
 // If we are there, we know that entity had a GeometryRenderer + Material
-QVector<RenderCommand *> RenderView::buildDrawRenderCommands(const QVector<Entity *> &entities) const
+QVector<RenderCommand *> RenderView::buildDrawRenderCommands(const QVector<Entity *> &entities, QByteArray *standardUniformData) const
 {
-    // Note: since many threads can be building render commands
-    // we need to ensure that the UniformBlockValueBuilder they are using
-    // is only accessed from the same thread
-    UniformBlockValueBuilder *builder = new UniformBlockValueBuilder();
-    builder->shaderDataManager = m_manager->shaderDataManager();
-    m_localData.setLocalData(builder);
-
     QVector<RenderCommand *> commands;
     commands.reserve(entities.size());
 
+    TextureDecodeQueue *decodeQueue = m_manager->textureDataManager()->decodeQueue();
+
+    // The state set of a pass only depends on the pass, it is built and
+    // interned once per job
+    QHash<const RenderPass *, QPair<RenderStateSet *, int>> passStateSets;
+
     for (Entity *node : entities) {
         GeometryRenderer *geometryRenderer = nullptr;
         HGeometryRenderer geometryRendererHandle = node->componentHandle<GeometryRenderer, 16>();
@@ -434,14 +691,22 @@ QVector<RenderCommand *> RenderView::buildDrawRenderCommands(const QVector<Entit
                 // StateSet in the FrameGraph
                 RenderPass *pass = passData.pass;
                 if (pass->hasRenderStates()) {
-                    command->m_stateSet = new RenderStateSet();
-                    addToRenderStateSet(command->m_stateSet, pass->renderStates(), m_manager->renderStateManager());
-
-                    // Merge per pass stateset with global stateset
-                    // so that the local stateset only overrides
-                    if (m_stateSet != nullptr)
-                        command->m_stateSet->merge(m_stateSet);
-                    command->m_changeCost = m_renderer->defaultRenderState()->changeCost(command->m_stateSet);
+                    auto passStateSetIt = passStateSets.find(pass);
+                    if (passStateSetIt == passStateSets.end()) {
+                        RenderStateSet *stateSet = new RenderStateSet();
+                        addToRenderStateSet(stateSet, pass->renderStates(), m_manager->renderStateManager());
+
+                        // Merge per pass stateset with global stateset
+                        // so that the local stateset only overrides, the
+                        // Renderer uses the default stateset for RenderViews
+                        // without one
+                        stateSet->merge(m_stateSet != nullptr ? m_stateSet : m_renderer->defaultRenderState());
+                        int stateSetId = 0;
+                        stateSet = internStateSet(stateSet, &stateSetId);
+                        passStateSetIt = passStateSets.insert(pass, qMakePair(stateSet, stateSetId));
+                    }
+                    command->m_stateSet = passStateSetIt.value().first;
+                    command->m_stateSetId = passStateSetIt.value().second;
                 }
 
                 // Pick which lights to take in to account.
@@ -455,7 +720,14 @@ QVector<RenderCommand *> RenderView::buildDrawRenderCommands(const QVector<Entit
                 ParameterInfoList globalParameters = passData.parameterInfo;
                 // setShaderAndUniforms can initialize a localData
                 // make sure this is cleared before we leave this function
-                setShaderAndUniforms(command, pass, globalParameters, *(node->worldTransform()), lightSources.mid(0, std::max(lightSources.size(), MAX_LIGHTS)));
+                setShaderAndUniforms(command, pass, globalParameters, *(node->worldTransform()), lightSources.mid(0, std::max(lightSources.size(), MAX_LIGHTS)), standardUniformData);
+
+                // Textures still being decoded are served closest to the camera first
+                if (decodeQueue->hasPendingRequests()) {
+                    const QVector<ShaderParameterPack::NamedTexture> textures = command->m_parameterPack.textures();
+                    for (const ShaderParameterPack::NamedTexture &namedTexture : textures)
+                        decodeQueue->setTexturePriority(namedTexture.texId, command->m_depth);
+                }
 
                 // Store all necessary information for actual drawing if command is valid
                 command->m_isValid = !command->m_attributes.empty();
@@ -508,21 +780,11 @@ QVector<RenderCommand *> RenderView::buildDrawRenderCommands(const QVector<Entit
         }
     }
 
-    // We reset the local data once we are done with it
-    m_localData.setLocalData(nullptr);
-
     return commands;
 }
 
-QVector<RenderCommand *> RenderView::buildComputeRenderCommands(const QVector<Entity *> &entities) const
+QVector<RenderCommand *> RenderView::buildComputeRenderCommands(const QVector<Entity *> &entities, QByteArray *standardUniformData) const
 {
-    // Note: since many threads can be building render commands
-    // we need to ensure that the UniformBlockValueBuilder they are using
-    // is only accessed from the same thread
-    UniformBlockValueBuilder *builder = new UniformBlockValueBuilder();
-    builder->shaderDataManager = m_manager->shaderDataManager();
-    m_localData.setLocalData(builder);
-
     // If the RenderView contains only a ComputeDispatch then it cares about
     // A ComputeDispatch is also implicitely a NoDraw operation
     // enabled flag
@@ -554,15 +816,13 @@ QVector<RenderCommand *> RenderView::buildComputeRenderCommands(const QVector<En
                                      pass,
                                      globalParameters,
                                      *(node->worldTransform()),
-                                     QVector<LightSource>());
+                                     QVector<LightSource>(),
+                                     standardUniformData);
                 commands.append(command);
             }
         }
     }
 
-    // We reset the local data once we are done with it
-    m_localData.setLocalData(nullptr);
-
     return commands;
 }
 
@@ -605,13 +865,43 @@ void RenderView::setStandardUniformValue(ShaderParameterPack &uniformPack, int g
     uniformPack.setUniform(glslNameId, (this->*ms_standardUniformSetters[nameId])(worldTransform));
 }
 
+// Appends a zeroed range for the block to the standard uniform data of the
+// builder, fills in the standard uniforms it contains and records the range
+// in the pack so that the GraphicsContext can bind it for the draw. Blocks
+// with a standard uniform that can't be written are not used at all
+void RenderView::setStandardUniformBlockValue(ShaderParameterPack &uniformPack,
+                                              Shader *shader,
+                                              const ShaderUniformBlock &block,
+                                              const QMatrix4x4 &worldTransform,
+                                              QByteArray *standardUniformData,
+                                              QVarLengthArray<int, 32> &blockUniformNameIds) const
+{
+    const int offset = appendStandardUniformBlock(standardUniformData, block.m_size, m_standardUniformBlockAlignment);
+    char *blockData = standardUniformData->data() + offset;
+    const int nameIdCount = blockUniformNameIds.size();
+
+    const QHash<QString, ShaderUniform> blockUniforms = shader->activeUniformsForUniformBlock(block.m_index);
+    for (const ShaderUniform &uniform : blockUniforms) {
+        if (!ms_standardUniformSetters.contains(uniform.m_nameId))
+            continue;
+        if (!writeStandardUniform(blockData, block.m_size, uniform,
+                                  (this->*ms_standardUniformSetters[uniform.m_nameId])(worldTransform))) {
+            qCWarning(Render::Backend) << Q_FUNC_INFO << "Unsupported standard uniform block member" << uniform.m_name;
+            standardUniformData->resize(offset);
+            blockUniformNameIds.resize(nameIdCount);
+            return;
+        }
+        blockUniformNameIds.push_back(uniform.m_nameId);
+    }
+
+    uniformPack.setStandardUniformBlock(block.m_index, offset, block.m_size);
+}
+
 void RenderView::setUniformBlockValue(ShaderParameterPack &uniformPack,
                                       Shader *shader,
                                       const ShaderUniformBlock &block,
                                       const UniformValue &value) const
 {
-    Q_UNUSED(shader)
-
     if (value.valueType() == UniformValue::NodeId) {
 
         Buffer *buffer = nullptr;
@@ -621,57 +911,27 @@ void RenderView::setUniformBlockValue(ShaderParameterPack &uniformPack,
             uniformBlockUBO.m_bufferID = buffer->peerId();
             uniformPack.setUniformBuffer(std::move(uniformBlockUBO));
             // Buffer update to GL buffer will be done at render time
+            return;
         }
 
-
-        //ShaderData *shaderData = nullptr;
-        // if ((shaderData = m_manager->shaderDataManager()->lookupResource(value.value<Qt3DCore::QNodeId>())) != nullptr) {
-        // UBO are indexed by <ShaderId, ShaderDataId> so that a same QShaderData can be used among different shaders
-        // while still making sure that if they have a different layout everything will still work
-        // If two shaders define the same block with the exact same layout, in that case the UBO could be shared
-        // but how do we know that ? We'll need to compare ShaderUniformBlocks
-
-        // Note: we assume that if a buffer is shared accross multiple shaders
-        // then it implies that they share the same layout
-
-        // Temporarly disabled
-
-        //        BufferShaderKey uboKey(shaderData->peerId(),
-        //                               shader->peerId());
-
-        //        BlockToUBO uniformBlockUBO;
-        //        uniformBlockUBO.m_blockIndex = block.m_index;
-        //        uniformBlockUBO.m_shaderDataID = shaderData->peerId();
-        //        bool uboNeedsUpdate = false;
-
-        //        // build UBO at uboId if not created before
-        //        if (!m_manager->glBufferManager()->contains(uboKey)) {
-        //            m_manager->glBufferManager()->getOrCreateResource(uboKey);
-        //            uboNeedsUpdate = true;
-        //        }
-
-        //        // If shaderData  has been updated (property has changed or one of the nested properties has changed)
-        //        // foreach property defined in the QShaderData, we try to fill the value of the corresponding active uniform(s)
-        //        // for all the updated properties (all the properties if the UBO was just created)
-        //        if (shaderData->updateViewTransform(*m_data->m_viewMatrix) || uboNeedsUpdate) {
-        //            // Clear previous values remaining in the hash
-        //            m_data->m_uniformBlockBuilder.activeUniformNamesToValue.clear();
-        //            // Update only update properties if uboNeedsUpdate is true, otherwise update the whole block
-        //            m_data->m_uniformBlockBuilder.updatedPropertiesOnly = uboNeedsUpdate;
-        //            // Retrieve names and description of each active uniforms in the uniform block
-        //            m_data->m_uniformBlockBuilder.uniforms = shader->activeUniformsForUniformBlock(block.m_index);
-        //            // Builds the name-value map for the block
-        //            m_data->m_uniformBlockBuilder.buildActiveUniformNameValueMapStructHelper(shaderData, block.m_name);
-        //            if (!uboNeedsUpdate)
-        //                shaderData->markDirty();
-        //            // copy the name-value map into the BlockToUBO
-        //            uniformBlockUBO.m_updatedProperties = m_data->m_uniformBlockBuilder.activeUniformNamesToValue;
-        //            uboNeedsUpdate = true;
-        //        }
-
-        //        uniformBlockUBO.m_needsUpdate = uboNeedsUpdate;
-        //        uniformPack.setUniformBuffer(std::move(uniformBlockUBO));
-        // }
+        ShaderData *shaderData = nullptr;
+        if ((shaderData = m_manager->shaderDataManager()->lookupResource(*value.constData<Qt3DCore::QNodeId>())) != nullptr) {
+            // UBO are indexed by <ShaderDataId, block layout> so that a same QShaderData
+            // can be used among different shaders. Shaders which declare the block
+            // with the exact same layout share the UBO
+            const ShaderDataValues shaderDataBlock = shaderDataValues(shader, shaderData, block.m_nameId, block.m_index);
+            BlockToUBO uniformBlockUBO;
+            uniformBlockUBO.m_blockIndex = block.m_index;
+            uniformBlockUBO.m_shaderDataID = shaderData->peerId();
+            uniformBlockUBO.m_blockSize = block.m_size;
+            uniformBlockUBO.m_layoutHash = block.m_layoutHash;
+            uniformBlockUBO.m_blockLayout = block.m_layout;
+            uniformBlockUBO.m_layout = shaderDataBlock.layout;
+            uniformBlockUBO.m_values = shaderDataBlock.values;
+            uniformPack.setUniformBuffer(std::move(uniformBlockUBO));
+            // Only the values which changed since the last upload
+            // will be written to the GL buffer at render time
+        }
     }
 }
 
@@ -693,28 +953,46 @@ void RenderView::setShaderStorageValue(ShaderParameterPack &uniformPack,
     }
 }
 
-void RenderView::setDefaultUniformBlockShaderDataValue(ShaderParameterPack &uniformPack, Shader *shader, ShaderData *shaderData, const QString &structName) const
+void RenderView::setDefaultUniformBlockShaderDataValue(ShaderParameterPack &uniformPack, Shader *shader, ShaderData *shaderData, int structNameId) const
 {
-    UniformBlockValueBuilder *builder = m_localData.localData();
-    builder->activeUniformNamesToValue.clear();
-
-    // Set the view matrix to be used to transform "Transformed" properties in the ShaderData
-    builder->viewMatrix = m_data.m_viewMatrix;
-    // Force to update the whole block
-    builder->updatedPropertiesOnly = false;
-    // Retrieve names and description of each active uniforms in the uniform block
-    builder->uniforms = shader->activeUniformsForUniformBlock(-1);
-    // Build name-value map for the block
-    builder->buildActiveUniformNameValueMapStructHelper(shaderData, structName);
-    // Set uniform values for each entrie of the block name-value map
-    QHash<int, QVariant>::const_iterator activeValuesIt = builder->activeUniformNamesToValue.constBegin();
-    const QHash<int, QVariant>::const_iterator activeValuesEnd = builder->activeUniformNamesToValue.constEnd();
+    const ShaderDataValues shaderDataStruct = shaderDataValues(shader, shaderData, structNameId);
+
+    int valueIndex = 0;
+    for (const ShaderDataLayout::Node &node : shaderDataStruct.layout.nodes()) {
+        for (const ShaderDataLayout::Member &member : node.members) {
+            const QVariant &value = shaderDataStruct.values.at(valueIndex++);
+            // TO DO: Make the ShaderData store UniformValue
+            if (value.isValid())
+                setUniformValue(uniformPack, member.uniform.m_nameId, UniformValue::fromVariant(value));
+        }
+    }
+}
 
-    // TO DO: Make the ShaderData store UniformValue
-    while (activeValuesIt != activeValuesEnd) {
-        setUniformValue(uniformPack, activeValuesIt.key(), UniformValue::fromVariant(activeValuesIt.value()));
-        ++activeValuesIt;
+RenderView::ShaderDataValues RenderView::shaderDataValues(Shader *shader,
+                                                        ShaderData *shaderData,
+                                                        int blockNameId,
+                                                        int blockIndex) const
+{
+    const QPair<Qt3DCore::QNodeId, QPair<Qt3DCore::QNodeId, int>> key(shader->peerId(),
+                                                                      qMakePair(shaderData->peerId(), blockNameId));
+    {
+        QMutexLocker lock(&m_shaderDataValuesMutex);
+        const auto it = m_shaderDataValues.constFind(key);
+        if (it != m_shaderDataValues.cend())
+            return it.value();
     }
+
+    // Uniform names are resolved once per shader and ShaderData structure,
+    // here we only have to fetch the current values. The view matrix is
+    // used to transform "Transformed" properties in the ShaderData
+    ShaderDataManager *shaderDataManager = m_manager->shaderDataManager();
+    ShaderDataValues blockValues;
+    blockValues.layout = shader->shaderDataLayout(shaderDataManager, shaderData, blockNameId, blockIndex);
+    blockValues.values = blockValues.layout.values(shaderDataManager, m_data.m_viewMatrix);
+
+    QMutexLocker lock(&m_shaderDataValuesMutex);
+    m_shaderDataValues.insert(key, blockValues);
+    return blockValues;
 }
 
 void RenderView::buildSortingKey(RenderCommand *command) const
@@ -728,7 +1006,7 @@ void RenderView::buildSortingKey(RenderCommand *command) const
     for (int i = 0; i < sortCount && i < 4; i++) {
         switch (m_data.m_sortingTypes.at(i)) {
         case QSortPolicy::StateChangeCost:
-            command->m_sortingType.sorts[i] = command->m_changeCost; // State change cost
+            command->m_sortingType.sorts[i] = char(command->m_stateSetId); // Identical states are adjacent
             break;
         case QSortPolicy::BackToFront:
             command->m_sortBackToFront = true; // Depth value
@@ -743,7 +1021,7 @@ void RenderView::buildSortingKey(RenderCommand *command) const
 }
 
 void RenderView::setShaderAndUniforms(RenderCommand *command, RenderPass *rPass, ParameterInfoList &parameters, const QMatrix4x4 &worldTransform,
-                                      const QVector<LightSource> &activeLightSources) const
+                                      const QVector<LightSource> &activeLightSources, QByteArray *standardUniformData) const
 {
     // The VAO Handle is set directly in the renderer thread so as to avoid having to use a mutex here
     // Set shader, technique, and effect by basically doing :
@@ -785,9 +1063,20 @@ void RenderView::setShaderAndUniforms(RenderCommand *command, RenderPass *rPass,
             if (!uniformNamesIds.isEmpty() || !attributeNamesIds.isEmpty() ||
                     !shaderStorageBlockNamesIds.isEmpty() || !attributeNamesIds.isEmpty()) {
 
+                // Standard uniforms of the qt3d_StandardUniforms block go to the standard uniform buffer
+                QVarLengthArray<int, 32> blockUniformNameIds;
+                if (standardUniformData != nullptr && m_standardUniformBlockAlignment > 0
+                        && uniformBlockNamesIds.contains(STANDARD_UNIFORM_BLOCK_NAME_ID)) {
+                    const ShaderUniformBlock block = shader->uniformBlockForBlockNameId(STANDARD_UNIFORM_BLOCK_NAME_ID);
+                    if (block.m_index != -1 && block.m_size > 0)
+                        setStandardUniformBlockValue(command->m_parameterPack, shader, block, worldTransform,
+                                                     standardUniformData, blockUniformNameIds);
+                }
+
                 // Set default standard uniforms without bindings
                 for (const int uniformNameId : uniformNamesIds) {
-                    if (ms_standardUniformSetters.contains(uniformNameId))
+                    if (ms_standardUniformSetters.contains(uniformNameId)
+                            && !blockUniformNameIds.contains(uniformNameId))
                         setStandardUniformValue(command->m_parameterPack, uniformNameId, uniformNameId, worldTransform);
                 }
 
@@ -795,6 +1084,18 @@ void RenderView::setShaderAndUniforms(RenderCommand *command, RenderPass *rPass,
                 for (const int attributeNameId : attributeNamesIds)
                     command->m_attributes.push_back(attributeNameId);
 
+                // The world transform is read from a per instance attribute
+                if (command->m_type == RenderCommand::Draw && attributeNamesIds.contains(INSTANCE_MODEL_MATRIX_NAME_ID)) {
+                    const QVector<ShaderAttribute> shaderAttributes = shader->attributes();
+                    for (const ShaderAttribute &attribute : shaderAttributes) {
+                        if (attribute.m_nameId == INSTANCE_MODEL_MATRIX_NAME_ID && attribute.m_type == GL_FLOAT_MAT4) {
+                            command->m_instanceAttributeLocation = attribute.m_location;
+                            command->m_instanceTransform = worldTransform;
+                            break;
+                        }
+                    }
+                }
+
                 // Parameters remaining could be
                 // -> uniform scalar / vector
                 // -> uniform struct / arrays
@@ -817,7 +1118,7 @@ void RenderView::setShaderAndUniforms(RenderCommand *command, RenderPass *rPass,
                         if (v.valueType() == UniformValue::NodeId &&
                                 (shaderData = m_manager->shaderDataManager()->lookupResource(*v.constData<Qt3DCore::QNodeId>())) != nullptr) {
                             // Try to check if we have a struct or array matching a QShaderData parameter
-                            setDefaultUniformBlockShaderDataValue(command->m_parameterPack, shader, shaderData, StringToInt::lookupString(it->nameId));
+                            setDefaultUniformBlockShaderDataValue(command->m_parameterPack, shader, shaderData, it->nameId);
                         }
                         // Otherwise: param unused by current shader
                     }
@@ -856,7 +1157,7 @@ void RenderView::setShaderAndUniforms(RenderCommand *command, RenderPass *rPass,
                         if (worldTransform)
                             shaderData->updateWorldTransform(*worldTransform);
 
-                        setDefaultUniformBlockShaderDataValue(command->m_parameterPack, shader, shaderData, LIGHT_STRUCT_NAMES[lightIdx]);
+                        setDefaultUniformBlockShaderDataValue(command->m_parameterPack, shader, shaderData, LIGHT_STRUCT_NAME_IDS[lightIdx]);
                         ++lightIdx;
                     }
                 }
@@ -61,6 +61,8 @@
 #include <Qt3DRender/private/handle_types_p.h>
 #include <Qt3DRender/private/qsortpolicy_p.h>
 #include <Qt3DRender/private/lightsource_p.h>
+#include <Qt3DRender/private/genericstate_p.h>
+#include <Qt3DRender/private/shaderdatalayout_p.h>
 
 #include <Qt3DCore/private/qframeallocator_p.h>
 
@@ -68,6 +70,7 @@
 #include <Qt3DRender/private/renderviewjobutils_p.h>
 
 #include <QVector>
+#include <QVarLengthArray>
 #include <QSurface>
 #include <QMutex>
 #include <QColor>
@@ -123,6 +126,10 @@ public:
 
     // TODO: Add a way to specify a sort predicate for the RenderCommands
     void sort();
+    // Drops the uniforms set to the same value by the previous command using
+    // the same shader. Only called once the commands were merged and packed,
+    // as these compare the full parameter packs of the commands
+    void minimizeUniformChanges();
 
     void setRenderer(Renderer *renderer);
     inline void setSurfaceSize(const QSize &size) Q_DECL_NOTHROW { m_surfaceSize = size; }
@@ -194,11 +201,32 @@ public:
 
     RenderPassList passesAndParameters(ParameterInfoList *parameter, Entity *node, bool useDefaultMaterials = true);
 
-    QVector<RenderCommand *> buildDrawRenderCommands(const QVector<Entity *> &entities) const;
-    QVector<RenderCommand *> buildComputeRenderCommands(const QVector<Entity *> &entities) const;
+    QVector<RenderCommand *> buildDrawRenderCommands(const QVector<Entity *> &entities, QByteArray *standardUniformData = nullptr) const;
+    QVector<RenderCommand *> buildComputeRenderCommands(const QVector<Entity *> &entities, QByteArray *standardUniformData = nullptr) const;
+    // Takes ownership of stateSet and returns the set of the RenderView equal
+    // to it, which the commands share. Its id, starting at 1, sorts commands
+    // with identical states next to each other
+    RenderStateSet *internStateSet(RenderStateSet *stateSet, int *stateSetId) const;
     void setCommands(QVector<RenderCommand *> &commands) Q_DECL_NOTHROW { m_commands = commands; }
     QVector<RenderCommand *> commands() const Q_DECL_NOTHROW { return m_commands; }
 
+    // Content of the uniform buffer backing the qt3d_StandardUniforms
+    // blocks of all the commands, uploaded once per RenderView
+    void setStandardUniformData(const QByteArray &data) Q_DECL_NOTHROW { m_standardUniformData = data; }
+    QByteArray standardUniformData() const Q_DECL_NOTHROW { return m_standardUniformData; }
+    // Alignment of the range of each command in the standard uniform data,
+    // 0 to set the standard uniforms individually
+    void setStandardUniformBlockAlignment(int alignment) Q_DECL_NOTHROW { m_standardUniformBlockAlignment = alignment; }
+    int standardUniformBlockAlignment() const Q_DECL_NOTHROW { return m_standardUniformBlockAlignment; }
+
+    // Merges adjacent commands only differing by their world transform into
+    // instanced draws, the transforms of all the commands using the
+    // qt3d_InstanceModelMatrix attribute end up in the instance data
+    void mergeInstancedCommands(bool supportsInstancedArrays);
+    QByteArray instanceData() const Q_DECL_NOTHROW { return m_instanceData; }
+    void packIndirectDraws(bool supportsMultiDrawIndirect);
+    QByteArray indirectDrawData() const Q_DECL_NOTHROW { return m_indirectDrawData; }
+
     void setAttachmentPack(const AttachmentPack &pack) { m_attachmentPack = pack; }
     const AttachmentPack &attachmentPack() const { return m_attachmentPack; }
 
@@ -243,9 +271,7 @@ public:
 
 private:
     void setShaderAndUniforms(RenderCommand *command, RenderPass *pass, ParameterInfoList &parameters, const QMatrix4x4 &worldTransform,
-                              const QVector<LightSource> &activeLightSources) const;
-
-    mutable QThreadStorage<UniformBlockValueBuilder*> m_localData;
+                              const QVector<LightSource> &activeLightSources, QByteArray *standardUniformData) const;
 
     Qt3DCore::QNodeId m_renderCaptureNodeId;
 
@@ -266,6 +292,19 @@ private:
     ClearBufferInfo m_globalClearColorBuffer;               // global ClearColor
     QVector<ClearBufferInfo> m_specificClearColorBuffers;   // different draw buffers with distinct colors
     RenderStateSet *m_stateSet;
+    mutable QMutex m_internedStateSetsMutex;
+    mutable QVector<RenderStateSet *> m_internedStateSets;
+    mutable QMultiHash<StateMaskSet, int> m_internedStateSetIndices;
+
+    // Layout and values of the ShaderData used by the commands, built once
+    // per shader, ShaderData and block or struct name
+    struct ShaderDataValues
+    {
+        ShaderDataLayout layout;
+        QVector<QVariant> values;
+    };
+    mutable QMutex m_shaderDataValuesMutex;
+    mutable QHash<QPair<Qt3DCore::QNodeId, QPair<Qt3DCore::QNodeId, int>>, ShaderDataValues> m_shaderDataValues;
     bool m_noDraw:1;
     bool m_compute:1;
     bool m_frustumCulling:1;
@@ -275,6 +314,10 @@ private:
     // render aspect is free to change the drawables on the next frame whilst
     // the render thread is submitting these commands.
     QVector<RenderCommand *> m_commands;
+    QByteArray m_standardUniformData;
+    int m_standardUniformBlockAlignment;
+    QByteArray m_instanceData;
+    QByteArray m_indirectDrawData;
     mutable QVector<LightSource> m_lightSources;
 
     QHash<Qt3DCore::QNodeId, QVector<RenderPassParameterData>> m_parameters;
@@ -304,6 +347,9 @@ private:
 
     void setUniformValue(ShaderParameterPack &uniformPack, int nameId, const UniformValue &value) const;
     void setStandardUniformValue(ShaderParameterPack &uniformPack, int glslNameId, int nameId, const QMatrix4x4 &worldTransform) const;
+    void setStandardUniformBlockValue(ShaderParameterPack &uniformPack, Shader *shader, const ShaderUniformBlock &block,
+                                      const QMatrix4x4 &worldTransform, QByteArray *standardUniformData,
+                                      QVarLengthArray<int, 32> &blockUniformNameIds) const;
     void setUniformBlockValue(ShaderParameterPack &uniformPack,
                               Shader *shader,
                               const ShaderUniformBlock &block,
@@ -315,7 +361,11 @@ private:
     void setDefaultUniformBlockShaderDataValue(ShaderParameterPack &uniformPack,
                                                Shader *shader,
                                                ShaderData *shaderData,
-                                               const QString &structName) const;
+                                               int structNameId) const;
+    ShaderDataValues shaderDataValues(Shader *shader,
+                                      ShaderData *shaderData,
+                                      int blockNameId,
+                                      int blockIndex = -1) const;
     void buildSortingKey(RenderCommand *command) const;
 };
 
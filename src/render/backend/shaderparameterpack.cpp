@@ -55,6 +55,13 @@ QT_BEGIN_NAMESPACE
 namespace Qt3DRender {
 namespace Render {
 
+ShaderParameterPack::ShaderParameterPack()
+    : m_standardUniformBlockIndex(-1)
+    , m_standardUniformOffset(0)
+    , m_standardUniformSize(0)
+{
+}
+
 ShaderParameterPack::~ShaderParameterPack()
 {
     m_uniforms.clear();
@@ -94,6 +101,13 @@ void ShaderParameterPack::setSubmissionUniform(const ShaderUniform &uniform)
     m_submissionUniforms.push_back(uniform);
 }
 
+void ShaderParameterPack::setStandardUniformBlock(int blockIndex, int offset, int size)
+{
+    m_standardUniformBlockIndex = blockIndex;
+    m_standardUniformOffset = offset;
+    m_standardUniformSize = size;
+}
+
 } // namespace Render
 } // namespace Qt3DRender
 
@@ -59,6 +59,7 @@
 #include <Qt3DRender/private/renderlogging_p.h>
 #include <Qt3DRender/private/shadervariables_p.h>
 #include <Qt3DRender/private/uniform_p.h>
+#include <Qt3DRender/private/shaderdatalayout_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -74,10 +75,23 @@ namespace Render {
 class GraphicsContext;
 
 struct BlockToUBO {
+    BlockToUBO()
+        : m_blockIndex(-1)
+        , m_blockSize(0)
+        , m_layoutHash(0)
+    {}
+
     int m_blockIndex;
+    // Set when the block is backed by a Buffer
     Qt3DCore::QNodeId m_bufferID;
-    bool m_needsUpdate;
-    QHash<QString, QVariant> m_updatedProperties;
+    // Set when the block is generated from a ShaderData, values are in the
+    // order of the layout members
+    Qt3DCore::QNodeId m_shaderDataID;
+    int m_blockSize;
+    uint m_layoutHash;
+    QVector<ShaderUniformBlockMember> m_blockLayout;
+    ShaderDataLayout m_layout;
+    QVector<QVariant> m_values;
 };
 QT3D_DECLARE_TYPEINFO_2(Qt3DRender, Render, BlockToUBO, Q_MOVABLE_TYPE)
 
@@ -90,9 +104,10 @@ QT3D_DECLARE_TYPEINFO_2(Qt3DRender, Render, BlockToSSBO, Q_PRIMITIVE_TYPE)
 
 typedef QHash<int, UniformValue> PackUniformHash;
 
-class ShaderParameterPack
+class Q_AUTOTEST_EXPORT ShaderParameterPack
 {
 public:
+    ShaderParameterPack();
     ~ShaderParameterPack();
 
     void setUniform(const int glslNameId, const UniformValue &val);
@@ -100,6 +115,7 @@ public:
     void setUniformBuffer(BlockToUBO blockToUBO);
     void setShaderStorageBuffer(BlockToSSBO blockToSSBO);
     void setSubmissionUniform(const ShaderUniform &uniform);
+    void setStandardUniformBlock(int blockIndex, int offset, int size);
 
     inline PackUniformHash &uniforms() { return m_uniforms; }
     inline const PackUniformHash &uniforms() const { return m_uniforms; }
@@ -121,6 +137,12 @@ public:
     inline QVector<BlockToUBO> uniformBuffers() const { return m_uniformBuffers; }
     inline QVector<BlockToSSBO> shaderStorageBuffers() const { return m_shaderStorageBuffers; }
     inline QVector<ShaderUniform> submissionUniforms() const { return m_submissionUniforms; }
+
+    // Range of the RenderView standard uniform buffer backing the
+    // qt3d_StandardUniforms block, a size of 0 means the shader has none
+    inline int standardUniformBlockIndex() const { return m_standardUniformBlockIndex; }
+    inline int standardUniformOffset() const { return m_standardUniformOffset; }
+    inline int standardUniformSize() const { return m_standardUniformSize; }
 private:
     PackUniformHash m_uniforms;
 
@@ -128,6 +150,9 @@ private:
     QVector<BlockToUBO> m_uniformBuffers;
     QVector<BlockToSSBO> m_shaderStorageBuffers;
     QVector<ShaderUniform> m_submissionUniforms;
+    int m_standardUniformBlockIndex;
+    int m_standardUniformOffset;
+    int m_standardUniformSize;
 
     friend class RenderView;
 };
@@ -53,6 +53,7 @@
 
 #include <Qt3DRender/qt3drender_global.h>
 #include <QOpenGLContext>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -88,6 +89,7 @@ struct ShaderUniform
         , m_arrayStride(-1)
         , m_matrixStride(-1)
         , m_rawByteSize(0)
+        , m_rowMajor(false)
     {}
 
     QString m_name;
@@ -100,10 +102,36 @@ struct ShaderUniform
     int m_arrayStride; // -1 is the default, >= 0 if uniform defined in uniform block and if it's an array
     int m_matrixStride; // -1 is the default, >= 0 uniform defined in uniform block and is a matrix
     uint m_rawByteSize; // contains byte size (size / type / strides)
+    bool m_rowMajor; // true if uniform defined in uniform block as a row_major matrix
     // size, offset and strides are in bytes
 };
 QT3D_DECLARE_TYPEINFO_2(Qt3DRender, Render, ShaderUniform, Q_MOVABLE_TYPE)
 
+// Part of the memory layout of a uniform block, the name id is the one of
+// the uniform name prefixed with the block name
+struct ShaderUniformBlockMember
+{
+    int m_nameId;
+    GLenum m_type;
+    int m_size;
+    int m_offset;
+    int m_arrayStride;
+    int m_matrixStride;
+};
+QT3D_DECLARE_TYPEINFO_2(Qt3DRender, Render, ShaderUniformBlockMember, Q_PRIMITIVE_TYPE)
+
+inline bool operator==(const ShaderUniformBlockMember &a, const ShaderUniformBlockMember &b)
+{
+    return a.m_nameId == b.m_nameId && a.m_type == b.m_type && a.m_size == b.m_size
+            && a.m_offset == b.m_offset && a.m_arrayStride == b.m_arrayStride
+            && a.m_matrixStride == b.m_matrixStride;
+}
+
+inline bool operator!=(const ShaderUniformBlockMember &a, const ShaderUniformBlockMember &b)
+{
+    return !(a == b);
+}
+
 struct ShaderUniformBlock
 {
     ShaderUniformBlock()
@@ -112,6 +140,7 @@ struct ShaderUniformBlock
         , m_binding(-1)
         , m_activeUniformsCount(0)
         , m_size(0)
+        , m_layoutHash(0)
     {}
 
     QString m_name;
@@ -120,6 +149,8 @@ struct ShaderUniformBlock
     int m_binding;
     int m_activeUniformsCount;
     int m_size;
+    uint m_layoutHash; // Equal for blocks whose active uniforms share names, types and offsets
+    QVector<ShaderUniformBlockMember> m_layout; // Active uniforms sorted by offset
 };
 QT3D_DECLARE_TYPEINFO_2(Qt3DRender, Render, ShaderUniformBlock, Q_MOVABLE_TYPE)
 
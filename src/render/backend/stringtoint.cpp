@@ -38,8 +38,9 @@
 ****************************************************************************/
 
 #include "stringtoint_p.h"
+#include <QAtomicPointer>
 #include <QMutex>
-#include <QReadWriteLock>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -49,70 +50,225 @@ namespace Render {
 
 namespace {
 
-QMutex mutex;
-QReadWriteLock readLock;
+// Order has to match StringToInt::StandardNameId
+const char * const standardNames[] = {
+    "modelMatrix",
+    "viewMatrix",
+    "projectionMatrix",
+    "modelView",
+    "viewProjectionMatrix",
+    "modelViewProjection",
+    "mvp",
+    "inverseModelMatrix",
+    "inverseViewMatrix",
+    "inverseProjectionMatrix",
+    "inverseModelView",
+    "inverseViewProjectionMatrix",
+    "inverseModelViewProjection",
+    "modelNormalMatrix",
+    "modelViewNormal",
+    "viewportMatrix",
+    "inverseViewportMatrix",
+    "time",
+    "eyePosition",
+    "lightCount",
+    "qt3d_StandardUniforms",
+    "qt3d_InstanceModelMatrix"
+};
+Q_STATIC_ASSERT(sizeof(standardNames) / sizeof(standardNames[0]) == StringToInt::StandardNameIdCount);
 
-} // anonymous
+// FNV-1a over the UTF-16 code units so that the Latin-1 and the
+// QString versions of a name hash the same
+template<typename Char>
+uint hashString(const Char *data, int size)
+{
+    uint hash = 2166136261u;
+    for (int i = 0; i < size; ++i) {
+        hash ^= uint(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
 
-QVector<QString> StringToInt::m_stringsArray = QVector<QString>();
-QVector<QString> StringToInt::m_pendingStringsArray = QVector<QString>();
-int StringToInt::m_calls = 0;
+uint hashString(const QString &str)
+{
+    return hashString(str.utf16(), str.size());
+}
 
-int StringToInt::lookupId(QLatin1String str)
+uint hashString(QLatin1String str)
 {
-    // ### optimize me
-    return lookupId(QString(str));
+    return hashString(reinterpret_cast<const uchar *>(str.data()), str.size());
 }
 
-int StringToInt::lookupId(const QString &str)
+struct InternedString
 {
-    // Note: how do we protect against the case where
-    // we are synching the two arrays ?
-    QReadLocker readLocker(&readLock);
-    int idx = StringToInt::m_stringsArray.indexOf(str);
-
-    if (Q_UNLIKELY(idx < 0)) {
-        QMutexLocker lock(&mutex);
-
-        // If not found in m_stringsArray, maybe it's in the pending array
-        if ((idx = StringToInt::m_pendingStringsArray.indexOf(str)) >= 0) {
-            idx += StringToInt::m_stringsArray.size();
-        } else {
-            // If not, we add it to the m_pendingStringArray
-            StringToInt::m_pendingStringsArray.push_back(str);
-            idx = StringToInt::m_stringsArray.size() + m_pendingStringsArray.size() - 1;
-        }
+    QString string;
+    uint hash;
+    int id;
+};
+
+// Interned strings are never removed. Readers probe an open addressing
+// table without locking, writers are serialized by a mutex and publish
+// entries with release semantics. When growing, the previous table is
+// kept alive as readers may still be probing it.
+class StringTable
+{
+public:
+    StringTable();
+    ~StringTable();
+
+    template<typename String>
+    int lookupId(const String &str)
+    {
+        const uint hash = hashString(str);
+        const int id = find(m_buckets.loadAcquire(), str, hash);
+        if (Q_LIKELY(id >= 0))
+            return id;
+        return insert(QString(str), hash);
+    }
+
+    QString lookupString(int id) const;
 
-        // We sync the two arrays every 20 calls
-        if (StringToInt::m_calls % 20 == 0 && StringToInt::m_pendingStringsArray.size() > 0) {
-            // Unlock reader to writeLock
-            // since a read lock cannot be locked for writing
-            lock.unlock();
-            readLocker.unlock();
+private:
+    enum {
+        ChunkSize = 4096,
+        ChunkCount = 1024,
+        InitialBucketCount = 256
+    };
 
-            QWriteLocker writeLock(&readLock);
-            lock.relock();
+    struct Buckets
+    {
+        explicit Buckets(int count)
+            : mask(count - 1)
+            , slots(new QAtomicPointer<InternedString>[count])
+        {}
+        ~Buckets() { delete [] slots; }
 
-            StringToInt::m_stringsArray += StringToInt::m_pendingStringsArray;
-            StringToInt::m_pendingStringsArray.clear();
-            StringToInt::m_calls = 0;
+        const int mask;
+        QAtomicPointer<InternedString> *slots;
+    };
+
+    template<typename String>
+    static int find(const Buckets *buckets, const String &str, uint hash)
+    {
+        // The table is at most half full, probing always ends on an empty slot
+        for (int i = hash & buckets->mask; ; i = (i + 1) & buckets->mask) {
+            const InternedString *entry = buckets->slots[i].loadAcquire();
+            if (entry == nullptr)
+                return -1;
+            if (entry->hash == hash && entry->string == str)
+                return entry->id;
         }
     }
-    return idx;
+
+    static void insertEntry(Buckets *buckets, InternedString *entry);
+    int insert(const QString &str, uint hash);
+    InternedString *entryAt(int id) const;
+
+    QMutex m_mutex;
+    QAtomicPointer<Buckets> m_buckets;
+    QVector<Buckets *> m_retiredBuckets;
+    // Entries indexed by id, chunks never move once allocated
+    QAtomicPointer<InternedString *> m_chunks[ChunkCount];
+    QAtomicInt m_count;
+};
+
+StringTable::StringTable()
+    : m_buckets(new Buckets(InitialBucketCount))
+    , m_count(0)
+{
+    for (int i = 0; i < StringToInt::StandardNameIdCount; ++i) {
+        const QLatin1String name(standardNames[i]);
+        const int id = insert(QString(name), hashString(name));
+        Q_UNUSED(id);
+        Q_ASSERT(id == i);
+    }
 }
 
-QString StringToInt::lookupString(int idx)
+StringTable::~StringTable()
+{
+    for (int i = 0, m = m_count.load(); i < m; ++i)
+        delete entryAt(i);
+    for (QAtomicPointer<InternedString *> &chunk : m_chunks)
+        delete [] chunk.load();
+    qDeleteAll(m_retiredBuckets);
+    delete m_buckets.load();
+}
+
+InternedString *StringTable::entryAt(int id) const
+{
+    return m_chunks[id / ChunkSize].loadAcquire()[id % ChunkSize];
+}
+
+void StringTable::insertEntry(Buckets *buckets, InternedString *entry)
 {
-    QReadLocker readLocker(&readLock);
-    if (Q_LIKELY(StringToInt::m_stringsArray.size() > idx))
-        return StringToInt::m_stringsArray.at(idx);
+    int i = entry->hash & buckets->mask;
+    while (buckets->slots[i].load() != nullptr)
+        i = (i + 1) & buckets->mask;
+    buckets->slots[i].storeRelease(entry);
+}
+
+int StringTable::insert(const QString &str, uint hash)
+{
+    QMutexLocker lock(&m_mutex);
+
+    // Another thread may have interned it meanwhile
+    Buckets *buckets = m_buckets.load();
+    int id = find(buckets, str, hash);
+    if (id >= 0)
+        return id;
+
+    id = m_count.load();
+    if (Q_UNLIKELY(id >= ChunkSize * ChunkCount))
+        qFatal("StringToInt: too many interned strings");
+
+    InternedString **chunk = m_chunks[id / ChunkSize].load();
+    if (chunk == nullptr) {
+        chunk = new InternedString *[ChunkSize];
+        m_chunks[id / ChunkSize].storeRelease(chunk);
+    }
 
-    // Maybe it's in the pending array then
-    QMutexLocker lock(&mutex);
-    if (StringToInt::m_stringsArray.size() + StringToInt::m_pendingStringsArray.size() > idx)
-        return StringToInt::m_pendingStringsArray.at(idx - StringToInt::m_stringsArray.size());
+    InternedString *entry = new InternedString { str, hash, id };
+    chunk[id % ChunkSize] = entry;
+    m_count.storeRelease(id + 1);
+
+    if (2 * (id + 1) > buckets->mask + 1) {
+        Buckets *grownBuckets = new Buckets(2 * (buckets->mask + 1));
+        for (int i = 0; i <= id; ++i)
+            insertEntry(grownBuckets, entryAt(i));
+        m_retiredBuckets.push_back(buckets);
+        m_buckets.storeRelease(grownBuckets);
+    } else {
+        insertEntry(buckets, entry);
+    }
+
+    return id;
+}
+
+QString StringTable::lookupString(int id) const
+{
+    if (Q_UNLIKELY(id < 0 || id >= m_count.loadAcquire()))
+        return QString();
+    return entryAt(id)->string;
+}
 
-    return QString();
+Q_GLOBAL_STATIC(StringTable, stringTable)
+
+} // anonymous
+
+int StringToInt::lookupId(QLatin1String str)
+{
+    return stringTable()->lookupId(str);
+}
+
+int StringToInt::lookupId(const QString &str)
+{
+    return stringTable()->lookupId(str);
+}
+
+QString StringToInt::lookupString(int idx)
+{
+    return stringTable()->lookupString(idx);
 }
 
 } // Render
@@ -52,7 +52,6 @@
 //
 
 
-#include <QVector>
 #include <QString>
 
 QT_BEGIN_NAMESPACE
@@ -64,14 +63,38 @@ namespace Render {
 class Q_AUTOTEST_EXPORT StringToInt
 {
 public:
+    // Names interned before any other, their ids are therefore known at
+    // compile time and can be used without looking them up
+    enum StandardNameId {
+        ModelMatrixNameId = 0,
+        ViewMatrixNameId,
+        ProjectionMatrixNameId,
+        ModelViewNameId,
+        ViewProjectionMatrixNameId,
+        ModelViewProjectionNameId,
+        MvpNameId,
+        InverseModelMatrixNameId,
+        InverseViewMatrixNameId,
+        InverseProjectionMatrixNameId,
+        InverseModelViewNameId,
+        InverseViewProjectionMatrixNameId,
+        InverseModelViewProjectionNameId,
+        ModelNormalMatrixNameId,
+        ModelViewNormalNameId,
+        ViewportMatrixNameId,
+        InverseViewportMatrixNameId,
+        TimeNameId,
+        EyePositionNameId,
+        LightCountNameId,
+        StandardUniformBlockNameId,
+        InstanceModelMatrixNameId,
+        StandardNameIdCount
+    };
+
+    // Lookups of already interned strings don't take any lock
     static int lookupId(const QString &str);
     static int lookupId(QLatin1String str);
     static QString lookupString(int idx);
-
-private:
-    static QVector<QString> m_stringsArray;
-    static QVector<QString> m_pendingStringsArray;
-    static int m_calls;
 };
 
 } // Render
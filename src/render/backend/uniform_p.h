@@ -169,6 +169,7 @@ public:
     }
 
     ValueType valueType() const { return m_valueType; }
+    int byteSize() const { return m_data.size() * int(sizeof(float)); }
 
     static UniformValue fromVariant(const QVariant &variant);
 
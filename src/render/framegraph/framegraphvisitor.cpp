@@ -50,6 +50,8 @@
 #include <Qt3DRender/private/nodemanagers_p.h>
 #include <Qt3DRender/private/renderviewbuilderjob_p.h>
 #include <Qt3DRender/private/renderview_p.h>
+#include <Qt3DRender/private/rendercommand_p.h>
+#include <Qt3DRender/private/qgraphicsapifilter_p.h>
 #include <Qt3DRender/private/frustumcullingjob_p.h>
 #include <Qt3DRender/private/lightgatherer_p.h>
 #include <QThreadPool>
@@ -307,14 +309,50 @@ void FrameGraphVisitor::visit(Render::FrameGraphNode *node)
             QVector<RenderCommand *> commands;
             commands.reserve(totalCommandCount);
 
-            // Reduction
-            for (const auto renderViewCommandBuilder : qAsConst(renderViewCommandBuilders))
+            // Reduction, the standard uniform ranges of each builder are
+            // shifted by the size of the data of the previous builders
+            QByteArray standardUniformData;
+            for (const auto renderViewCommandBuilder : qAsConst(renderViewCommandBuilders)) {
+                const QByteArray &builderUniformData = renderViewCommandBuilder->standardUniformData();
+                if (!builderUniformData.isEmpty()) {
+                    const int baseOffset = standardUniformData.size();
+                    if (baseOffset > 0) {
+                        for (RenderCommand *command : qAsConst(renderViewCommandBuilder->commands())) {
+                            ShaderParameterPack &pack = command->m_parameterPack;
+                            if (pack.standardUniformSize() > 0)
+                                pack.setStandardUniformBlock(pack.standardUniformBlockIndex(),
+                                                             pack.standardUniformOffset() + baseOffset,
+                                                             pack.standardUniformSize());
+                        }
+                    }
+                    standardUniformData += builderUniformData;
+                }
                 commands += std::move(renderViewCommandBuilder->commands());
+            }
             rv->setCommands(commands);
+            rv->setStandardUniformData(standardUniformData);
 
             // Sort the commands
             rv->sort();
 
+            // Merge the commands only differing by their transform into
+            // instanced draws when the context has instanced arrays
+            const GraphicsApiFilterData *contextInfo = renderer->contextInfo();
+            const bool isOpenGLES = contextInfo->m_api == QGraphicsApiFilter::OpenGLES;
+            const bool supportsInstancedArrays = isOpenGLES
+                    ? contextInfo->m_major >= 3
+                    : (contextInfo->m_major > 3 || (contextInfo->m_major == 3 && contextInfo->m_minor >= 3));
+            rv->mergeInstancedCommands(supportsInstancedArrays);
+
+            // Then pack what remains of the draws of a same VAO into multi
+            // draws, glMultiDrawElementsIndirect requires OpenGL 4.3
+            const bool supportsMultiDrawIndirect = !isOpenGLES
+                    && (contextInfo->m_major > 4 || (contextInfo->m_major == 4 && contextInfo->m_minor >= 3));
+            rv->packIndirectDraws(supportsMultiDrawIndirect);
+
+            // Only then skip the uniforms already set by the previous command
+            rv->minimizeUniformChanges();
+
             // Enqueue our fully populated RenderView with the RenderThread
             renderer->enqueueRenderView(rv, currentRenderViewIndex);
         };
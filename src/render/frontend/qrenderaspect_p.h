@@ -82,6 +82,7 @@ public:
     void renderSynchronous();
     void renderShutdown();
     QVector<Qt3DCore::QAspectJobPtr> createGeometryRendererJobs();
+    bool isIdle() Q_DECL_OVERRIDE;
 
     Render::NodeManagers *m_nodeManagers;
     Render::AbstractRenderer *m_renderer;
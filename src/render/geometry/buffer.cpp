@@ -49,11 +49,29 @@ using namespace Qt3DCore;
 namespace Qt3DRender {
 namespace Render {
 
+namespace {
+
+// Granularity at which new data is compared to the previous one
+const int diffBlockSize = 256;
+
+// QT3DRENDER_BUFFER_DIFF=0 disables diffing, data set on a QBuffer is
+// then always uploaded as a whole without being compared. Partial
+// uploads only come from QBuffer::updateData in that case
+bool isDataDiffEnabled()
+{
+    static const bool enabled = qgetenv("QT3DRENDER_BUFFER_DIFF") != QByteArrayLiteral("0");
+    return enabled;
+}
+
+} // anonymous
+
 Buffer::Buffer()
     : BackendNode(QBackendNode::ReadWrite)
     , m_type(QBuffer::VertexBuffer)
     , m_usage(QBuffer::StaticDraw)
     , m_bufferDirty(false)
+    , m_fullUploadRequired(false)
+    , m_dataOutOfSync(false)
     , m_syncData(false)
     , m_manager(nullptr)
 {
@@ -73,6 +91,8 @@ void Buffer::cleanup()
     m_bufferUpdates.clear();
     m_functor.reset();
     m_bufferDirty = false;
+    m_fullUploadRequired = false;
+    m_dataOutOfSync = false;
     m_syncData = false;
 }
 
@@ -86,6 +106,11 @@ void Buffer::executeFunctor()
 {
     Q_ASSERT(m_functor);
     m_data = (*m_functor)();
+    m_dataOutOfSync = false;
+    // The data may be generated after the buffer was last uploaded
+    requestFullUpload();
+    if (m_manager != nullptr)
+        m_manager->addBufferToUpload(peerId());
     if (m_syncData) {
         // Send data back to the frontend
         auto e = Qt3DCore::QPropertyUpdatedChangePtr::create(peerId());
@@ -104,12 +129,13 @@ void Buffer::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &chang
     m_type = data.type;
     m_usage = data.usage;
     m_syncData = data.syncData;
-    m_bufferDirty = true;
+    requestFullUpload();
 
     m_functor = data.functor;
     Q_ASSERT(m_manager);
     if (m_functor)
         m_manager->addDirtyBuffer(peerId());
+    m_manager->addBufferToUpload(peerId());
 }
 
 void Buffer::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
@@ -118,28 +144,31 @@ void Buffer::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
         QPropertyUpdatedChangePtr propertyChange = qSharedPointerCast<QPropertyUpdatedChange>(e);
         QByteArray propertyName = propertyChange->propertyName();
         if (propertyName == QByteArrayLiteral("data")) {
-            QByteArray newData = propertyChange->value().value<QByteArray>();
-            m_bufferDirty |= m_data != newData;
-            m_data = newData;
+            setData(propertyChange->value().value<QByteArray>());
         } else if (propertyName == QByteArrayLiteral("updateData")) {
             Qt3DRender::QBufferUpdate updateData = propertyChange->value().value<Qt3DRender::QBufferUpdate>();
             m_bufferUpdates.push_back(updateData);
             m_bufferDirty = true;
+            // m_data doesn't contain the update, it can't be diffed against anymore
+            m_dataOutOfSync = true;
         } else if (propertyName == QByteArrayLiteral("type")) {
             m_type = static_cast<QBuffer::BufferType>(propertyChange->value().value<int>());
-            m_bufferDirty = true;
+            requestFullUpload();
         } else if (propertyName == QByteArrayLiteral("usage")) {
             m_usage = static_cast<QBuffer::UsageType>(propertyChange->value().value<int>());
-            m_bufferDirty = true;
+            requestFullUpload();
         } else if (propertyName == QByteArrayLiteral("dataGenerator")) {
             QBufferDataGeneratorPtr newGenerator = propertyChange->value().value<QBufferDataGeneratorPtr>();
-            m_bufferDirty |= !(newGenerator && m_functor && *newGenerator == *m_functor);
+            if (!(newGenerator && m_functor && *newGenerator == *m_functor))
+                requestFullUpload();
             m_functor = newGenerator;
             if (m_functor && m_manager != nullptr)
                 m_manager->addDirtyBuffer(peerId());
         } else if (propertyName == QByteArrayLiteral("syncData")) {
             m_syncData = propertyChange->value().toBool();
         }
+        if (m_bufferDirty && m_manager != nullptr)
+            m_manager->addBufferToUpload(peerId());
         markDirty(AbstractRenderer::AllDirty);
     }
     BackendNode::sceneChangeEvent(e);
@@ -149,6 +178,81 @@ void Buffer::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
 void Buffer::unsetDirty()
 {
     m_bufferDirty = false;
+    m_fullUploadRequired = false;
+}
+
+// Returns the ranges where newData differs from oldData, ranges separated
+// by a single identical block are merged. Both must have the same size
+QVector<Qt3DRender::QBufferUpdate> Buffer::changedRanges(const QByteArray &oldData, const QByteArray &newData)
+{
+    Q_ASSERT(oldData.size() == newData.size());
+    QVector<Qt3DRender::QBufferUpdate> ranges;
+    const int size = newData.size();
+    int rangeStart = -1;
+    int rangeEnd = -1;
+
+    const auto addRange = [&] {
+        Qt3DRender::QBufferUpdate update;
+        update.offset = rangeStart;
+        update.data = newData.mid(rangeStart, rangeEnd - rangeStart);
+        ranges.push_back(update);
+    };
+
+    for (int offset = 0; offset < size; offset += diffBlockSize) {
+        const int blockSize = qMin(diffBlockSize, size - offset);
+        if (memcmp(oldData.constData() + offset, newData.constData() + offset, blockSize) == 0)
+            continue;
+        if (rangeStart >= 0 && offset - rangeEnd > diffBlockSize) {
+            addRange();
+            rangeStart = -1;
+        }
+        if (rangeStart < 0)
+            rangeStart = offset;
+        rangeEnd = offset + blockSize;
+    }
+    if (rangeStart >= 0)
+        addRange();
+    return ranges;
+}
+
+// The whole content (and usage) has to be uploaded again, previous
+// partial updates are included or superseded
+void Buffer::requestFullUpload()
+{
+    m_bufferUpdates.clear();
+    m_bufferDirty = true;
+    m_fullUploadRequired = true;
+}
+
+// Only the ranges that changed are uploaded when the data can be diffed
+void Buffer::setData(const QByteArray &data)
+{
+    if (m_fullUploadRequired || m_dataOutOfSync || !isDataDiffEnabled()
+            || data.size() != m_data.size()) {
+        if (isDataDiffEnabled() && !m_dataOutOfSync && data == m_data)
+            return;
+        m_data = data;
+        m_dataOutOfSync = false;
+        requestFullUpload();
+        return;
+    }
+
+    const QVector<Qt3DRender::QBufferUpdate> ranges = changedRanges(m_data, data);
+    m_data = data;
+    if (ranges.isEmpty())
+        return;
+
+    int changedSize = 0;
+    for (const Qt3DRender::QBufferUpdate &range : ranges)
+        changedSize += range.data.size();
+
+    // Uploading the whole buffer is cheaper past that point
+    if (changedSize > data.size() / 2) {
+        requestFullUpload();
+    } else {
+        m_bufferUpdates += ranges;
+        m_bufferDirty = true;
+    }
 }
 
 BufferFunctor::BufferFunctor(AbstractRenderer *renderer, BufferManager *manager)
@@ -82,18 +82,25 @@ public:
     inline QByteArray data() const { return m_data; }
     inline QVector<Qt3DRender::QBufferUpdate> &pendingBufferUpdates() { return m_bufferUpdates; }
     inline bool isDirty() const { return m_bufferDirty; }
+    inline bool isFullUploadRequired() const { return m_fullUploadRequired; }
     inline QBufferDataGeneratorPtr dataGenerator() const { return m_functor; }
     inline bool isSyncData() const { return m_syncData; }
     void unsetDirty();
 
+    static QVector<Qt3DRender::QBufferUpdate> changedRanges(const QByteArray &oldData, const QByteArray &newData);
+
 private:
     void initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &change) Q_DECL_FINAL;
+    void setData(const QByteArray &data);
+    void requestFullUpload();
 
     QBuffer::BufferType m_type;
     QBuffer::UsageType m_usage;
     QByteArray m_data;
     QVector<Qt3DRender::QBufferUpdate> m_bufferUpdates;
     bool m_bufferDirty;
+    bool m_fullUploadRequired;
+    bool m_dataOutOfSync;
     bool m_syncData;
     QBufferDataGeneratorPtr m_functor;
     BufferManager *m_manager;
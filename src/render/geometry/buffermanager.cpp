@@ -75,6 +75,21 @@ QVector<Qt3DCore::QNodeId> &BufferManager::buffersToRelease()
     return m_buffersToRelease;
 }
 
+void BufferManager::addBufferToUpload(Qt3DCore::QNodeId bufferId)
+{
+    m_buffersToUpload.push(bufferId);
+}
+
+bool BufferManager::hasBuffersToUpload() const
+{
+    return !m_buffersToUpload.isEmpty();
+}
+
+QVector<Qt3DCore::QNodeId> BufferManager::takeBuffersToUpload()
+{
+    return m_buffersToUpload.takeAll();
+}
+
 } // namespace Render
 } // namespace Qt3DRender
 
@@ -53,6 +53,7 @@
 
 #include <Qt3DCore/private/qresourcemanager_p.h>
 #include <Qt3DRender/private/buffer_p.h>
+#include <Qt3DRender/private/dirtyqueue_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -80,9 +81,16 @@ public:
     // Render Thread (no concurrent access)
     QVector<Qt3DCore::QNodeId> &buffersToRelease();
 
+    // Any Thread
+    void addBufferToUpload(Qt3DCore::QNodeId bufferId);
+    bool hasBuffersToUpload() const;
+    // Renderer Job (single consumer)
+    QVector<Qt3DCore::QNodeId> takeBuffersToUpload();
+
 private:
     QVector<Qt3DCore::QNodeId> m_dirtyBuffers;
     QVector<Qt3DCore::QNodeId> m_buffersToRelease;
+    DirtyQueue<Qt3DCore::QNodeId> m_buffersToUpload;
 };
 
 } // namespace Render
@@ -40,6 +40,7 @@
 #include "geometryrenderer_p.h"
 #include <Qt3DRender/private/geometryrenderermanager_p.h>
 #include <Qt3DRender/private/qboundingvolume_p.h>
+#include <Qt3DRender/private/boundingvolumehierarchy_p.h>
 #include <Qt3DRender/private/qgeometryrenderer_p.h>
 #include <Qt3DCore/qpropertyupdatedchange.h>
 #include <Qt3DCore/qpropertynodeaddedchange.h>
@@ -94,6 +95,7 @@ void GeometryRenderer::cleanup()
     m_geometryFactory.reset();
     qDeleteAll(m_triangleVolumes);
     m_triangleVolumes.clear();
+    invalidateTriangleVolumeHierarchy();
 }
 
 void GeometryRenderer::setManager(GeometryRendererManager *manager)
@@ -175,6 +177,9 @@ void GeometryRenderer::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
         break;
     }
 
+    if (m_dirty)
+        invalidateTriangleVolumeHierarchy();
+
     markDirty(AbstractRenderer::AllDirty);
 
     BackendNode::sceneChangeEvent(e);
@@ -220,6 +225,24 @@ QVector<QBoundingVolume *> GeometryRenderer::triangleData() const
     return m_triangleVolumes;
 }
 
+QSharedPointer<TriangleBoundingVolumeHierarchy> GeometryRenderer::triangleVolumeHierarchy() const
+{
+    QMutexLocker lock(&m_triangleVolumeHierarchyMutex);
+    return m_triangleVolumeHierarchy;
+}
+
+void GeometryRenderer::setTriangleVolumeHierarchy(const QSharedPointer<TriangleBoundingVolumeHierarchy> &hierarchy)
+{
+    QMutexLocker lock(&m_triangleVolumeHierarchyMutex);
+    m_triangleVolumeHierarchy = hierarchy;
+}
+
+void GeometryRenderer::invalidateTriangleVolumeHierarchy()
+{
+    QMutexLocker lock(&m_triangleVolumeHierarchyMutex);
+    m_triangleVolumeHierarchy.reset();
+}
+
 GeometryRendererFunctor::GeometryRendererFunctor(AbstractRenderer *renderer, GeometryRendererManager *manager)
     : m_manager(manager)
     , m_renderer(renderer)
@@ -54,6 +54,8 @@
 #include <Qt3DRender/private/backendnode_p.h>
 #include <Qt3DRender/qgeometryrenderer.h>
 #include <Qt3DRender/qgeometryfactory.h>
+#include <QMutex>
+#include <QSharedPointer>
 
 QT_BEGIN_NAMESPACE
 
@@ -64,6 +66,7 @@ class QBoundingVolume;
 namespace Render {
 
 class GeometryRendererManager;
+class TriangleBoundingVolumeHierarchy;
 
 class Q_AUTOTEST_EXPORT GeometryRenderer : public BackendNode
 {
@@ -95,6 +98,11 @@ public:
     // Pick volumes job
     QVector<QBoundingVolume *> triangleData() const;
 
+    // Built lazily by the pick job, reset whenever the geometry changes
+    QSharedPointer<TriangleBoundingVolumeHierarchy> triangleVolumeHierarchy() const;
+    void setTriangleVolumeHierarchy(const QSharedPointer<TriangleBoundingVolumeHierarchy> &hierarchy);
+    void invalidateTriangleVolumeHierarchy();
+
 private:
     void initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &change) Q_DECL_FINAL;
 
@@ -112,6 +120,8 @@ private:
     QGeometryFactoryPtr m_geometryFactory;
     GeometryRendererManager *m_manager;
     QVector<QBoundingVolume *> m_triangleVolumes;
+    mutable QMutex m_triangleVolumeHierarchyMutex;
+    QSharedPointer<TriangleBoundingVolumeHierarchy> m_triangleVolumeHierarchy;
 };
 
 class GeometryRendererFunctor : public Qt3DCore::QBackendNodeMapper
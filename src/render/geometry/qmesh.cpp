@@ -186,6 +186,9 @@ QGeometry *MeshFunctor::operator()()
     ObjLoader loader;
     loader.setLoadTextureCoordinatesEnabled(true);
     loader.setTangentGenerationEnabled(true);
+    // Opt-in binary cache making reloads of large OBJ files nearly free
+    static const QString cacheDirectory = QString::fromLocal8Bit(qgetenv("QT3DRENDER_MESH_CACHE_DIR"));
+    loader.setCacheDirectory(cacheDirectory);
     qCDebug(Render::Jobs) << Q_FUNC_INFO << "Loading mesh from" << m_sourcePath << " part:" << m_meshName;
 
 
@@ -78,26 +78,19 @@
 #include <QOpenGLTexture>
 #include <QOpenGLDebugLogger>
 
-QT_BEGIN_NAMESPACE
+#include <algorithm>
 
-extern Q_GUI_EXPORT QImage qt_gl_read_framebuffer(const QSize &size, bool alpha_format, bool include_alpha);
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
 
-namespace {
+#ifndef GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+#define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 0x8A34
+#endif
 
-QOpenGLShader::ShaderType shaderType(Qt3DRender::QShaderProgram::ShaderType type)
-{
-    switch (type) {
-    case Qt3DRender::QShaderProgram::Vertex: return QOpenGLShader::Vertex;
-    case Qt3DRender::QShaderProgram::TessellationControl: return QOpenGLShader::TessellationControl;
-    case Qt3DRender::QShaderProgram::TessellationEvaluation: return QOpenGLShader::TessellationEvaluation;
-    case Qt3DRender::QShaderProgram::Geometry: return QOpenGLShader::Geometry;
-    case Qt3DRender::QShaderProgram::Fragment: return QOpenGLShader::Fragment;
-    case Qt3DRender::QShaderProgram::Compute: return QOpenGLShader::Compute;
-    default: Q_UNREACHABLE();
-    }
-}
+QT_BEGIN_NAMESPACE
 
-} // anonymous namespace
+extern Q_GUI_EXPORT QImage qt_gl_read_framebuffer(const QSize &size, bool alpha_format, bool include_alpha);
 
 namespace Qt3DRender {
 namespace Render {
@@ -151,6 +144,7 @@ GraphicsContext::GraphicsContext()
     , m_surface(nullptr)
     , m_glHelper(nullptr)
     , m_ownCurrent(true)
+    , m_stagingBufferRequested(false)
     , m_activeShader(nullptr)
     , m_activeShaderDNA(0)
     , m_currClearStencilValue(0)
@@ -164,10 +158,13 @@ GraphicsContext::GraphicsContext()
     , m_renderer(nullptr)
     , m_uboTempArray(QByteArray(1024, 0))
     , m_supportsVAO(true)
+    , m_supportsProgramBinary(false)
+    , m_standardUniformBlockAlignment(0)
     , m_debugLogger(nullptr)
     , m_currentVAO(nullptr)
 {
     static_contexts[m_id] = this;
+    resetStateChangeCounters();
 }
 
 GraphicsContext::~GraphicsContext()
@@ -203,6 +200,35 @@ void GraphicsContext::initialize()
 
     m_defaultFBO = m_gl->defaultFramebufferObject();
     qCDebug(Backend) << "VAO support = " << m_supportsVAO;
+
+    // Ranges of the standard uniform buffer bound to a command have to start
+    // at a multiple of the offset alignment of the context
+    m_standardUniformBlockAlignment = 0;
+    if (m_glHelper->supportsFeature(GraphicsHelperInterface::UniformBufferObject)) {
+        GLint alignment = 0;
+        m_gl->functions()->glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        m_standardUniformBlockAlignment = qMax(alignment, 1);
+    }
+    qCDebug(Backend) << "Standard uniform block alignment = " << m_standardUniformBlockAlignment;
+
+    // Linked programs are cached on disk when the driver can give them back
+    const QPair<int, int> version = m_gl->format().version();
+    m_supportsProgramBinary = m_gl->isOpenGLES() ? version >= qMakePair(3, 0)
+                                                 : (version >= qMakePair(4, 1) || m_gl->hasExtension(QByteArrayLiteral("GL_ARB_get_program_binary")));
+    if (m_supportsProgramBinary) {
+        GLint binaryFormatCount = 0;
+        m_gl->functions()->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+        m_supportsProgramBinary = binaryFormatCount > 0;
+    }
+    const QString shaderCacheDirectory = ShaderCache::defaultDiskCacheDirectory();
+    if (m_supportsProgramBinary && !shaderCacheDirectory.isEmpty() && !m_shaderCache.isDiskCacheLoaded()) {
+        QOpenGLFunctions *f = m_gl->functions();
+        const QByteArray driverKey = QByteArray(reinterpret_cast<const char *>(f->glGetString(GL_VENDOR))) + '|'
+                + QByteArray(reinterpret_cast<const char *>(f->glGetString(GL_RENDERER))) + '|'
+                + QByteArray(reinterpret_cast<const char *>(f->glGetString(GL_VERSION)));
+        m_shaderCache.loadDiskCache(shaderCacheDirectory, driverKey);
+    }
+    qCDebug(Backend) << "Program binary support = " << m_supportsProgramBinary;
 }
 
 bool GraphicsContext::beginDrawing(QSurface *surface)
@@ -254,6 +280,9 @@ bool GraphicsContext::beginDrawing(QSurface *surface)
 
     m_activeTextures.fill(0);
     m_boundArrayBuffer = nullptr;
+    clearBindingCaches();
+    if (m_supportsVAO)
+        m_currentVAO = nullptr;
 
     static int callCount = 0;
     ++callCount;
@@ -282,6 +311,7 @@ void GraphicsContext::clearBackBuffer(QClearBuffers::BufferTypeFlags buffers)
 
 void GraphicsContext::endDrawing(bool swapBuffers)
 {
+    m_stagingBuffer.endFrame(m_gl);
     if (swapBuffers)
         m_gl->swapBuffers(m_surface);
     if (m_ownCurrent)
@@ -356,9 +386,34 @@ void GraphicsContext::setViewport(const QRectF &viewport, const QSize &surfaceSi
 
 void GraphicsContext::releaseOpenGL()
 {
+    m_shaderCompiler.destroy();
+    m_pendingShaderPrograms.clear();
     m_shaderCache.clear();
     m_renderBufferHash.clear();
 
+    // Buffers go away with the context if it isn't current
+    if (m_gl != nullptr && QOpenGLContext::currentContext() == m_gl)
+        m_stagingBuffer.destroy(m_gl);
+    m_stagingBuffer = GLStagingBuffer();
+    m_stagingBufferRequested = false;
+    if (m_gl != nullptr && QOpenGLContext::currentContext() == m_gl) {
+        if (m_standardUniformBuffer.isCreated())
+            m_standardUniformBuffer.destroy(this);
+        if (m_instanceBuffer.isCreated())
+            m_instanceBuffer.destroy(this);
+        if (m_indirectDrawBuffer.isCreated())
+            m_indirectDrawBuffer.destroy(this);
+        for (ShaderDataUniformBuffer &ubo : m_shaderDataUniformBuffers) {
+            if (ubo.buffer.isCreated())
+                ubo.buffer.destroy(this);
+        }
+    }
+    m_shaderDataUniformBuffers.clear();
+    m_standardUniformBuffer = GLBuffer();
+    m_instanceBuffer = GLBuffer();
+    m_indirectDrawBuffer = GLBuffer();
+    clearBindingCaches();
+
     // Stop and destroy the OpenGL logger
     if (m_debugLogger) {
         m_debugLogger->stopLogging();
@@ -418,31 +473,37 @@ void GraphicsContext::doneCurrent()
     m_gl->doneCurrent();
 }
 
-QOpenGLShaderProgram *GraphicsContext::createShaderProgram(Shader *shaderNode)
+ShaderCompiler::Request GraphicsContext::shaderCompileRequest(Shader *shaderNode) const
 {
-    QScopedPointer<QOpenGLShaderProgram> shaderProgram(new QOpenGLShaderProgram);
+    ShaderCompiler::Request request;
+    request.dna = shaderNode->dna();
+    request.shaderCode = shaderNode->shaderCode();
+    request.fragOutputs = shaderNode->fragOutputs();
+    request.bindFragOutputs = m_glHelper->supportsFeature(GraphicsHelperInterface::MRT) &&
+            m_glHelper->supportsFeature(GraphicsHelperInterface::BindableFragmentOutputs);
 
-    // Compile shaders
-    const auto shaderCode = shaderNode->shaderCode();
-    for (int i = QShaderProgram::Vertex; i <= QShaderProgram::Compute; ++i) {
-        QShaderProgram::ShaderType type = static_cast<const QShaderProgram::ShaderType>(i);
-        if (!shaderCode.at(i).isEmpty() &&
-                !shaderProgram->addShaderFromSourceCode(shaderType(type), shaderCode.at(i))) {
-            qWarning().noquote() << "Failed to compile shader:" << shaderProgram->log();
-        }
+    if (m_supportsProgramBinary && m_shaderCache.isDiskCacheLoaded()) {
+        request.binaryKey = ShaderCache::programBinaryKey(request.dna, request.shaderCode, request.fragOutputs);
+        m_shaderCache.programBinary(request.binaryKey, &request.binaryFormat, &request.binary);
     }
+    return request;
+}
 
-    // Call glBindFragDataLocation and link the program
-    // Since we are sharing shaders in the backend, we assume that if using custom
-    // fragOutputs, they should all be the same for a given shader
-    bindFragOutputs(shaderProgram->programId(), shaderNode->fragOutputs());
-    if (!shaderProgram->link()) {
-        qWarning().noquote() << "Failed to link shader program:" << shaderProgram->log();
-        return nullptr;
-    }
+void GraphicsContext::storeProgramBinary(const ShaderCompiler::Result &result)
+{
+    if (result.binaryRejected)
+        m_shaderCache.removeProgramBinary(result.binaryKey);
+    if (!result.binary.isEmpty())
+        m_shaderCache.insertProgramBinary(result.binaryKey, result.binaryFormat, result.binary);
+}
 
-    // take from scoped-pointer so it doesn't get deleted
-    return shaderProgram.take();
+QOpenGLShaderProgram *GraphicsContext::createShaderProgram(Shader *shaderNode)
+{
+    const ShaderCompiler::Result result = ShaderCompiler::compileProgram(m_gl, shaderCompileRequest(shaderNode));
+    storeProgramBinary(result);
+    if (result.program == nullptr)
+        shaderNode->setLinkFailed(result.log);
+    return result.program;
 }
 
 // That assumes that the shaderProgram in Shader stays the same
@@ -450,13 +511,31 @@ void GraphicsContext::loadShader(Shader *shader)
 {
     QOpenGLShaderProgram *shaderProgram = m_shaderCache.getShaderProgramAndAddRef(shader->dna(), shader->peerId());
     if (!shaderProgram) {
+        // Compiled by the compiler thread, the Shader stays unloaded and the
+        // commands using it are skipped until the program is collected
+        if (m_shaderCompiler.isCreated()) {
+            QVector<Qt3DCore::QNodeId> &pendingShaderIds = m_pendingShaderPrograms[shader->dna()];
+            if (pendingShaderIds.isEmpty())
+                m_shaderCompiler.compile(shaderCompileRequest(shader));
+            if (!pendingShaderIds.contains(shader->peerId()))
+                pendingShaderIds.push_back(shader->peerId());
+            return;
+        }
+
         // No matching QOpenGLShader in the cache so create one
         shaderProgram = createShaderProgram(shader);
+        if (shaderProgram == nullptr)
+            return;
 
         // Store in cache
         m_shaderCache.insert(shader->dna(), shader->peerId(), shaderProgram);
     }
 
+    initializeShaderInterface(shader, shaderProgram);
+}
+
+void GraphicsContext::initializeShaderInterface(Shader *shader, QOpenGLShaderProgram *shaderProgram)
+{
     // Ensure the Shader node knows about the program interface
     // TODO: Improve this so we only introspect once per actual OpenGL shader program
     //       rather than once per ShaderNode. Could cache the interface description along
@@ -475,9 +554,65 @@ void GraphicsContext::loadShader(Shader *shader)
     }
 }
 
+bool GraphicsContext::startShaderCompiler(QSurface *surface)
+{
+    Q_ASSERT(!m_shaderCompiler.isCreated());
+    if (!m_shaderCompiler.create(m_gl, surface))
+        return false;
+    qCDebug(Shaders) << "Compiling shader programs asynchronously";
+    return true;
+}
+
+// Hands the programs compiled since the last call over to the Shaders
+// that requested them
+void GraphicsContext::collectCompiledShaders()
+{
+    if (m_pendingShaderPrograms.isEmpty())
+        return;
+
+    ShaderManager *shaderManager = m_renderer->nodeManagers()->shaderManager();
+    const QVector<ShaderCompiler::Result> results = m_shaderCompiler.takeResults();
+    for (const ShaderCompiler::Result &result : results) {
+        const QVector<Qt3DCore::QNodeId> shaderIds = m_pendingShaderPrograms.take(result.dna);
+        storeProgramBinary(result);
+        if (result.program == nullptr) {
+            // The Shaders stay unloaded until their code changes
+            for (const Qt3DCore::QNodeId shaderId : shaderIds) {
+                Shader *shader = shaderManager->lookupResource(shaderId);
+                if (shader != nullptr && shader->dna() == result.dna)
+                    shader->setLinkFailed(result.log);
+            }
+            continue;
+        }
+
+        bool programInserted = false;
+        for (const Qt3DCore::QNodeId shaderId : shaderIds) {
+            Shader *shader = shaderManager->lookupResource(shaderId);
+            // The Shader may have been destroyed or its code changed in the meantime
+            if (shader == nullptr || shader->dna() != result.dna)
+                continue;
+            if (!programInserted) {
+                m_shaderCache.insert(result.dna, shaderId, result.program);
+                programInserted = true;
+            } else {
+                m_shaderCache.getShaderProgramAndAddRef(result.dna, shaderId);
+            }
+            initializeShaderInterface(shader, result.program);
+        }
+        if (!programInserted)
+            delete result.program;
+    }
+}
+
+bool GraphicsContext::isShaderProgramReady(ProgramDNA shaderDNA) const
+{
+    return m_shaderCache.getShaderProgramForDNA(shaderDNA) != nullptr;
+}
+
 // Called only from RenderThread
 void GraphicsContext::activateShader(ProgramDNA shaderDNA)
 {
+    countStateChange(ProgramStateChange, shaderDNA != m_activeShaderDNA);
     if (shaderDNA != m_activeShaderDNA) {
         m_activeShader = m_shaderCache.getShaderProgramForDNA(shaderDNA);
         if (Q_LIKELY(m_activeShader != nullptr)) {
@@ -608,6 +743,9 @@ int GraphicsContext::activateTexture(TextureScope scope, Texture *tex, int onUni
         QOpenGLTexture *glTex = tex->getOrCreateGLTexture();
         glTex->bind(onUnit);
         m_activeTextures[onUnit] = tex->dna();
+        countStateChange(TextureStateChange, true);
+    } else {
+        countStateChange(TextureStateChange, false);
     }
 
 #if defined(QT3D_RENDER_ASPECT_OPENGL_DEBUG)
@@ -776,6 +914,24 @@ void GraphicsContext::drawElementsInstancedBaseVertexBaseInstance(GLenum primiti
                                                             baseInstance);
 }
 
+/*!
+ * Wraps an OpenGL call to glMultiDrawElementsIndirect, reading \a drawCount
+ * tightly packed draw commands at \a indirectOffset of the indirect buffer
+ * set with setIndirectDrawData.
+ */
+void GraphicsContext::multiDrawElementsIndirect(GLenum primitiveType,
+                                                GLint indexType,
+                                                int indirectOffset,
+                                                GLsizei drawCount)
+{
+    bindGLBuffer(&m_indirectDrawBuffer, GLBuffer::DrawIndirectBuffer);
+    m_glHelper->multiDrawElementsIndirect(primitiveType,
+                                          indexType,
+                                          reinterpret_cast<void *>(quintptr(indirectOffset)),
+                                          drawCount,
+                                          0);
+}
+
 /*!
  * Wraps an OpenGL call to glDrawArraysInstanced.
  */
@@ -881,17 +1037,68 @@ void GraphicsContext::bindFragOutputs(GLuint shader, const QHash<QString, int> &
 
 void GraphicsContext::bindUniformBlock(GLuint programId, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
 {
+    const auto key = qMakePair(programId, uniformBlockIndex);
+    const auto it = m_uniformBlockBindings.constFind(key);
+    if (it != m_uniformBlockBindings.cend() && it.value() == uniformBlockBinding) {
+        countStateChange(BlockBindingStateChange, false);
+        return;
+    }
     m_glHelper->bindUniformBlock(programId, uniformBlockIndex, uniformBlockBinding);
+    m_uniformBlockBindings.insert(key, uniformBlockBinding);
+    countStateChange(BlockBindingStateChange, true);
 }
 
 void GraphicsContext::bindShaderStorageBlock(GLuint programId, GLuint shaderStorageBlockIndex, GLuint shaderStorageBlockBinding)
 {
+    const auto key = qMakePair(programId, shaderStorageBlockIndex);
+    const auto it = m_shaderStorageBlockBindings.constFind(key);
+    if (it != m_shaderStorageBlockBindings.cend() && it.value() == shaderStorageBlockBinding) {
+        countStateChange(BlockBindingStateChange, false);
+        return;
+    }
     m_glHelper->bindShaderStorageBlock(programId, shaderStorageBlockIndex, shaderStorageBlockBinding);
+    m_shaderStorageBlockBindings.insert(key, shaderStorageBlockBinding);
+    countStateChange(BlockBindingStateChange, true);
 }
 
+// A size of 0 stands for the whole buffer bound with glBindBufferBase
 void GraphicsContext::bindBufferBase(GLenum target, GLuint bindingIndex, GLuint buffer)
 {
+    const auto key = qMakePair(target, bindingIndex);
+    const auto it = m_indexedBufferBindings.constFind(key);
+    if (it != m_indexedBufferBindings.cend() && it->buffer == buffer && it->offset == 0 && it->size == 0) {
+        countStateChange(BufferBindingStateChange, false);
+        return;
+    }
     m_glHelper->bindBufferBase(target, bindingIndex, buffer);
+    m_indexedBufferBindings.insert(key, { buffer, 0, 0 });
+    countStateChange(BufferBindingStateChange, true);
+}
+
+void GraphicsContext::bindBufferRange(GLenum target, GLuint bindingIndex, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    const auto key = qMakePair(target, bindingIndex);
+    const auto it = m_indexedBufferBindings.constFind(key);
+    if (it != m_indexedBufferBindings.cend() && it->buffer == buffer && it->offset == offset && it->size == size) {
+        countStateChange(BufferBindingStateChange, false);
+        return;
+    }
+    m_glHelper->bindBufferRange(target, bindingIndex, buffer, offset, size);
+    m_indexedBufferBindings.insert(key, { buffer, offset, size });
+    countStateChange(BufferBindingStateChange, true);
+}
+
+void GraphicsContext::clearBindingCaches()
+{
+    m_indexedBufferBindings.clear();
+    m_uniformBlockBindings.clear();
+    m_shaderStorageBlockBindings.clear();
+}
+
+void GraphicsContext::resetStateChangeCounters()
+{
+    std::fill(m_issuedStateChanges, m_issuedStateChanges + StateChangeTypeCount, 0);
+    std::fill(m_skippedStateChanges, m_skippedStateChanges + StateChangeTypeCount, 0);
 }
 
 void GraphicsContext::buildUniformBuffer(const QVariant &v, const ShaderUniform &description, QByteArray &buffer)
@@ -1113,11 +1320,18 @@ void GraphicsContext::setParameters(ShaderParameterPack &parameterPack)
         // TO DO: Make sure that there's enough binding points
     }
 
-    // Bind UniformBlocks to UBO and update UBO from Buffer
-    // TO DO: Convert ShaderData to Buffer so that we can use that generic process
+    // Bind UniformBlocks to UBO and update UBO from Buffer or ShaderData
     const QVector<BlockToUBO> blockToUBOs = parameterPack.uniformBuffers();
     int uboIndex = 0;
     for (const BlockToUBO &b : blockToUBOs) {
+        if (!b.m_shaderDataID.isNull()) {
+            GLBuffer *ubo = uniformBufferForShaderData(b);
+            if (ubo == nullptr)
+                continue;
+            bindUniformBlock(shader->programId(), b.m_blockIndex, uboIndex);
+            ubo->bindBufferBase(this, uboIndex++, GLBuffer::UniformBuffer);
+            continue;
+        }
         Buffer *cpuBuffer = m_renderer->nodeManagers()->bufferManager()->lookupResource(b.m_bufferID);
         GLBuffer *ubo = glBufferForRenderBuffer(cpuBuffer);
         bindUniformBlock(shader->programId(), b.m_blockIndex, uboIndex);
@@ -1133,6 +1347,16 @@ void GraphicsContext::setParameters(ShaderParameterPack &parameterPack)
         // TO DO: Make sure that there's enough binding points
     }
 
+    // Bind the qt3d_StandardUniforms block to the range of the RenderView
+    // standard uniform buffer filled for this command
+    if (parameterPack.standardUniformSize() > 0 && m_standardUniformBuffer.isCreated()) {
+        bindUniformBlock(shader->programId(), parameterPack.standardUniformBlockIndex(), uboIndex);
+        m_standardUniformBuffer.bindBufferRange(this, uboIndex++,
+                                                parameterPack.standardUniformOffset(),
+                                                parameterPack.standardUniformSize(),
+                                                GLBuffer::UniformBuffer);
+    }
+
     // Update uniforms in the Default Uniform Block
     const PackUniformHash values = parameterPack.uniforms();
     const QVector<ShaderUniform> activeUniforms = parameterPack.submissionUniforms();
@@ -1144,6 +1368,78 @@ void GraphicsContext::setParameters(ShaderParameterPack &parameterPack)
     }
 }
 
+// Uploads the standard uniforms of all the commands of a RenderView at once,
+// setParameters then binds the range of each command. Returns false if the
+// buffer couldn't be created, standardUniformBlockAlignment() is then 0 so
+// that the next RenderViews set the standard uniforms individually
+bool GraphicsContext::setStandardUniformData(const QByteArray &data)
+{
+    if (data.isEmpty())
+        return true;
+    if (!m_standardUniformBuffer.isCreated() && !m_standardUniformBuffer.create(this)) {
+        qCWarning(Backend) << "Failed to create the standard uniform buffer";
+        m_standardUniformBlockAlignment = 0;
+        return false;
+    }
+    bindGLBuffer(&m_standardUniformBuffer, GLBuffer::UniformBuffer);
+    // Orphan the previous storage so that we don't wait on draws still using it
+    m_standardUniformBuffer.allocate(this, data.constData(), data.size(), true);
+    return true;
+}
+
+// Uploads the world transforms of the instanced commands of a RenderView
+void GraphicsContext::setInstanceData(const QByteArray &data)
+{
+    if (data.isEmpty() || !m_glHelper->supportsFeature(GraphicsHelperInterface::InstancedArrays))
+        return;
+    if (!m_instanceBuffer.isCreated() && !m_instanceBuffer.create(this))
+        return;
+    bindGLBuffer(&m_instanceBuffer, GLBuffer::ArrayBuffer);
+    m_instanceBuffer.allocate(this, data.constData(), data.size(), true);
+}
+
+// Uploads the indirect draw commands of a RenderView, returns false if
+// they can't be read by multiDrawElementsIndirect
+bool GraphicsContext::setIndirectDrawData(const QByteArray &data)
+{
+    if (data.isEmpty())
+        return true;
+    if (!m_glHelper->supportsFeature(GraphicsHelperInterface::MultiDrawIndirect))
+        return false;
+    if (!m_indirectDrawBuffer.isCreated() && !m_indirectDrawBuffer.create(this))
+        return false;
+    if (!bindGLBuffer(&m_indirectDrawBuffer, GLBuffer::DrawIndirectBuffer))
+        return false;
+    m_indirectDrawBuffer.allocate(this, data.constData(), data.size(), true);
+    return true;
+}
+
+// Points the 4 columns of the mat4 instance attribute of the active shader
+// at the transforms of a command, must be called with its VAO bound
+void GraphicsContext::specifyInstanceTransforms(const QByteArray &instanceData, int location, int offset, int divisor)
+{
+    QOpenGLShaderProgram *prog = activeShader();
+    if (prog == nullptr || location < 0)
+        return;
+
+    const int columnSize = 4 * sizeof(float);
+    if (m_instanceBuffer.isCreated() && m_glHelper->supportsFeature(GraphicsHelperInterface::InstancedArrays)) {
+        bindGLBuffer(&m_instanceBuffer, GLBuffer::ArrayBuffer);
+        for (int column = 0; column < 4; ++column) {
+            prog->enableAttributeArray(location + column);
+            prog->setAttributeBuffer(location + column, GL_FLOAT, offset + column * columnSize, 4, 4 * columnSize);
+            m_glHelper->vertexAttribDivisor(location + column, divisor);
+        }
+    } else {
+        // Commands aren't merged without instanced arrays, the transform
+        // is set as a constant attribute value instead
+        Q_ASSERT(offset + 4 * columnSize <= instanceData.size());
+        for (int column = 0; column < 4; ++column)
+            prog->disableAttributeArray(location + column);
+        prog->setAttributeValue(location, reinterpret_cast<const GLfloat *>(instanceData.constData() + offset), 4, 4);
+    }
+}
+
 void GraphicsContext::enableAttribute(const VAOVertexAttribute &attr)
 {
     // Bind buffer within the current VAO
@@ -1315,7 +1611,7 @@ void GraphicsContext::specifyAttribute(const Attribute *attribute, Buffer *buffe
         enableAttribute(attr);
 
         // Save this in the current emulated VAO
-        if (m_currentVAO)
+        if (m_currentVAO && !m_supportsVAO)
             m_currentVAO->saveVertexAttribute(attr);
     }
 }
@@ -1330,7 +1626,7 @@ void GraphicsContext::specifyIndices(Buffer *buffer)
 
     // bound within the current VAO
     // Save this in the current emulated VAO
-    if (m_currentVAO)
+    if (m_currentVAO && !m_supportsVAO)
         m_currentVAO->saveIndexAttribute(m_renderer->nodeManagers()->glBufferManager()->lookupHandle(buffer->peerId()));
 }
 
@@ -1349,8 +1645,9 @@ void GraphicsContext::releaseBuffer(Qt3DCore::QNodeId bufferId)
         GLBuffer *glBuff = m_renderer->nodeManagers()->glBufferManager()->data(glBuffHandle);
 
         Q_ASSERT(glBuff);
-        // Destroy the GPU resource
+        // Destroy the GPU resource, its name can be reused by the next buffer
         glBuff->destroy(this);
+        clearBindingCaches();
         // Destroy the GLBuffer instance
         m_renderer->nodeManagers()->glBufferManager()->releaseResource(bufferId);
         // Remove Id - HGLBuffer entry
@@ -1384,9 +1681,76 @@ HGLBuffer GraphicsContext::createGLBufferFor(Buffer *buffer)
 
     // TO DO: Handle usage pattern
     b->allocate(this, buffer->data().constData(), buffer->data().size(), false);
+    // Partial updates received since the data was set
+    const QVector<Qt3DRender::QBufferUpdate> updates = std::move(buffer->pendingBufferUpdates());
+    for (const Qt3DRender::QBufferUpdate &update : updates)
+        b->update(this, update.data.constData(), update.data.size(), update.offset);
     return m_renderer->nodeManagers()->glBufferManager()->lookupHandle(buffer->peerId());
 }
 
+// Returns the UBO of a ShaderData for a block layout, bound and up to date
+// with the values of the block
+GLBuffer *GraphicsContext::uniformBufferForShaderData(const BlockToUBO &block)
+{
+    const ShaderDataUniformBufferKey key = { block.m_shaderDataID, block.m_blockSize,
+                                             block.m_layoutHash, block.m_blockLayout };
+    ShaderDataUniformBuffer &ubo = m_shaderDataUniformBuffers[key];
+    if (!ubo.buffer.isCreated() && !ubo.buffer.create(this))
+        return nullptr;
+    if (!bindGLBuffer(&ubo.buffer, GLBuffer::UniformBuffer))
+        return nullptr;
+
+    const bool needsAllocation = ubo.data.size() != block.m_blockSize;
+    if (needsAllocation)
+        ubo.data = QByteArray(block.m_blockSize, 0);
+    // Values are compared by index, a mismatch only ever causes extra writes
+    if (needsAllocation || ubo.values.size() != block.m_values.size())
+        ubo.values = QVector<QVariant>(block.m_values.size());
+
+    int dirtyBegin = ubo.data.size();
+    int dirtyEnd = 0;
+    int valueIndex = 0;
+    for (const ShaderDataLayout::Node &node : block.m_layout.nodes()) {
+        for (const ShaderDataLayout::Member &member : node.members) {
+            const QVariant &value = block.m_values.at(valueIndex);
+            if (value.isValid() && value != ubo.values.at(valueIndex)) {
+                const ShaderUniform &uniform = member.uniform;
+                buildUniformBuffer(value, uniform, ubo.data);
+                ubo.values[valueIndex] = value;
+                const int byteSize = qMax(int(uniform.m_rawByteSize), qMax(uniform.m_arrayStride, 0) * uniform.m_size);
+                dirtyBegin = qMin(dirtyBegin, uniform.m_offset);
+                dirtyEnd = qMax(dirtyEnd, qMin(uniform.m_offset + byteSize, ubo.data.size()));
+            }
+            ++valueIndex;
+        }
+    }
+
+    if (needsAllocation)
+        ubo.buffer.allocate(this, ubo.data.constData(), ubo.data.size(), true);
+    else if (dirtyBegin < dirtyEnd)
+        ubo.buffer.update(this, ubo.data.constData() + dirtyBegin, dirtyEnd - dirtyBegin, dirtyBegin);
+    return &ubo.buffer;
+}
+
+void GraphicsContext::releaseShaderDataUniformBuffers(Qt3DCore::QNodeId shaderDataId)
+{
+    bool released = false;
+    auto it = m_shaderDataUniformBuffers.begin();
+    while (it != m_shaderDataUniformBuffers.end()) {
+        if (it.key().shaderDataId == shaderDataId) {
+            if (it->buffer.isCreated())
+                it->buffer.destroy(this);
+            it = m_shaderDataUniformBuffers.erase(it);
+            released = true;
+        } else {
+            ++it;
+        }
+    }
+    // The names of the destroyed buffers can be reused by the next buffers
+    if (released)
+        clearBindingCaches();
+}
+
 bool GraphicsContext::bindGLBuffer(GLBuffer *buffer, GLBuffer::Type type)
 {
     if (type == GLBuffer::ArrayBuffer && buffer == m_boundArrayBuffer)
@@ -1409,27 +1773,38 @@ void GraphicsContext::uploadDataToGLBuffer(Buffer *buffer, GLBuffer *b, bool rel
     // * setData was called changing the whole data or functor (or the usage pattern)
     // * partial buffer updates where received
 
-    // Note: we assume the case where both setData/functor and updates are called to be a misuse
-    // with unexpected behavior
+    // Updates received after the whole data was set are applied on top of it
     const QVector<Qt3DRender::QBufferUpdate> updates = std::move(buffer->pendingBufferUpdates());
-    if (!updates.empty()) {
-        for (const Qt3DRender::QBufferUpdate &update : updates) {
-            // TO DO: based on the number of updates .., it might make sense to
-            // sometime use glMapBuffer rather than glBufferSubData
-            b->update(this, update.data.constData(), update.data.size(), update.offset);
-        }
-    } else {
+    if (buffer->isFullUploadRequired() || updates.empty()) {
         const int bufferSize = buffer->data().size();
         // TO DO: Handle usage pattern
         b->allocate(this, bufferSize, false); // orphan the buffer
         b->allocate(this, buffer->data().constData(), bufferSize, false);
     }
+
+    if (!updates.empty() && !m_stagingBufferRequested) {
+        // QT3DRENDER_BUFFER_STAGING_SIZE=0 disables the staging buffer
+        m_stagingBufferRequested = true;
+        bool ok = false;
+        int stagingSize = qEnvironmentVariableIntValue("QT3DRENDER_BUFFER_STAGING_SIZE", &ok);
+        if (!ok)
+            stagingSize = 8 * 1024 * 1024;
+        if (stagingSize > 0)
+            m_stagingBuffer.create(m_gl, stagingSize);
+    }
+
+    for (const Qt3DRender::QBufferUpdate &update : updates) {
+        // Partial updates go through the persistently mapped staging buffer
+        // when possible and fall back to glBufferSubData
+        if (!m_stagingBuffer.upload(m_gl, b->bufferId(), update.data.constData(), update.data.size(), update.offset))
+            b->update(this, update.data.constData(), update.data.size(), update.offset);
+    }
     if (releaseBuffer) {
         b->release(this);
         if (bufferTypeToGLBufferType(buffer->type()) == GLBuffer::ArrayBuffer)
             m_boundArrayBuffer = nullptr;
     }
-    qCDebug(Render::Io) << "uploaded buffer size=" << buffer->data().size();
+    qCDebug(Render::Io) << "uploaded buffer size=" << buffer->data().size() << "updates=" << updates.size();
 }
 
 GLint GraphicsContext::elementType(GLint type)
@@ -64,10 +64,12 @@
 #include <Qt3DRender/qclearbuffers.h>
 #include <Qt3DRender/private/shader_p.h>
 #include <Qt3DRender/private/glbuffer_p.h>
+#include <Qt3DRender/private/glstagingbuffer_p.h>
 #include <Qt3DRender/qattribute.h>
 #include <Qt3DRender/private/handle_types_p.h>
 #include <Qt3DRender/private/qgraphicsapifilter_p.h>
 #include <Qt3DRender/private/shadercache_p.h>
+#include <Qt3DRender/private/shadercompiler_p.h>
 #include <Qt3DRender/private/uniform_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -100,12 +102,23 @@ enum TextureScope
 
 typedef QPair<QString, int> NamedUniformLocation;
 
-class GraphicsContext
+class Q_AUTOTEST_EXPORT GraphicsContext
 {
 public:
     GraphicsContext();
     ~GraphicsContext();
 
+    // Kinds of GL state the context shadows to skip redundant calls
+    enum StateChangeType {
+        ProgramStateChange = 0,
+        VertexArrayStateChange,
+        TextureStateChange,
+        BufferBindingStateChange,
+        BlockBindingStateChange,
+        RenderStateChange,
+        StateChangeTypeCount
+    };
+
     int id() const; // unique, small integer ID of this context
 
     bool beginDrawing(QSurface *surface);
@@ -129,6 +142,10 @@ public:
 
     QOpenGLShaderProgram *createShaderProgram(Shader *shaderNode);
     void loadShader(Shader* shader);
+    bool startShaderCompiler(QSurface *surface);
+    bool hasShaderCompiler() const { return m_shaderCompiler.isCreated(); }
+    void collectCompiledShaders();
+    bool isShaderProgramReady(ProgramDNA shaderDNA) const;
     void activateShader(ProgramDNA shaderDNA);
     void removeShaderProgramReference(Shader *shaderNode);
 
@@ -157,8 +174,13 @@ public:
     void updateBuffer(Buffer *buffer);
     void releaseBuffer(Qt3DCore::QNodeId bufferId);
     bool hasGLBufferForBuffer(Buffer *buffer);
+    void releaseShaderDataUniformBuffers(Qt3DCore::QNodeId shaderDataId);
 
     void setParameters(ShaderParameterPack &parameterPack);
+    bool setStandardUniformData(const QByteArray &data);
+    void setInstanceData(const QByteArray &data);
+    void specifyInstanceTransforms(const QByteArray &instanceData, int location, int offset, int divisor);
+    bool setIndirectDrawData(const QByteArray &data);
 
     /**
      * @brief glBufferFor - given a client-side (CPU) buffer, provide the
@@ -186,6 +208,7 @@ public:
     void    alphaTest(GLenum mode1, GLenum mode2);
     void    bindFramebuffer(GLuint fbo);
     void    bindBufferBase(GLenum target, GLuint bindingIndex, GLuint buffer);
+    void    bindBufferRange(GLenum target, GLuint bindingIndex, GLuint buffer, GLintptr offset, GLsizeiptr size);
     void    bindFragOutputs(GLuint shader, const QHash<QString, int> &outputs);
     void    bindUniformBlock(GLuint programId, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
     void    bindShaderStorageBlock(GLuint programId, GLuint shaderStorageBlockIndex, GLuint shaderStorageBlockBinding);
@@ -209,6 +232,7 @@ public:
     void    drawArraysInstancedBaseInstance(GLenum primitiveType, GLint first, GLsizei count, GLsizei instances, GLsizei baseinstance);
     void    drawElements(GLenum primitiveType, GLsizei primitiveCount, GLint indexType, void * indices, GLint baseVertex);
     void    drawElementsInstancedBaseVertexBaseInstance(GLenum primitiveType, GLsizei primitiveCount, GLint indexType, void * indices, GLsizei instances, GLint baseVertex, GLint baseInstance);
+    void    multiDrawElementsIndirect(GLenum primitiveType, GLint indexType, int indirectOffset, GLsizei drawCount);
     void    enableClipPlane(int clipPlane);
     void    enablei(GLenum cap, GLuint index);
     void    enablePrimitiveRestart(int restartIndex);
@@ -227,8 +251,22 @@ public:
     static GLuint byteSizeFromType(GLint type);
     static GLint glDataTypeFromAttributeDataType(QAttribute::VertexBaseType dataType);
 
+    // Counts the GL state changes issued and skipped since the last reset
+    inline void countStateChange(StateChangeType type, bool issued)
+    {
+        if (issued)
+            ++m_issuedStateChanges[type];
+        else
+            ++m_skippedStateChanges[type];
+    }
+    int issuedStateChanges(StateChangeType type) const { return m_issuedStateChanges[type]; }
+    int skippedStateChanges(StateChangeType type) const { return m_skippedStateChanges[type]; }
+    void resetStateChangeCounters();
+
     bool supportsDrawBuffersBlend() const;
     bool supportsVAO() const { return m_supportsVAO; }
+    // 0 if the standard uniforms can't be given through a uniform buffer
+    int standardUniformBlockAlignment() const { return m_standardUniformBlockAlignment; }
 
     QImage readFramebuffer(QSize size);
 
@@ -247,6 +285,11 @@ private:
     HGLBuffer createGLBufferFor(Buffer *buffer);
     void uploadDataToGLBuffer(Buffer *buffer, GLBuffer *b, bool releaseBuffer = false);
     bool bindGLBuffer(GLBuffer *buffer, GLBuffer::Type type);
+    GLBuffer *uniformBufferForShaderData(const BlockToUBO &block);
+    ShaderCompiler::Request shaderCompileRequest(Shader *shaderNode) const;
+    void storeProgramBinary(const ShaderCompiler::Result &result);
+    void initializeShaderInterface(Shader *shader, QOpenGLShaderProgram *shaderProgram);
+    void clearBindingCaches();
 
     bool m_initialized;
     const unsigned int m_id;
@@ -256,6 +299,10 @@ private:
     bool m_ownCurrent;
 
     ShaderCache m_shaderCache;
+    ShaderCompiler m_shaderCompiler;
+    QHash<ProgramDNA, QVector<Qt3DCore::QNodeId>> m_pendingShaderPrograms;
+    GLStagingBuffer m_stagingBuffer;
+    bool m_stagingBufferRequested;
     QOpenGLShaderProgram *m_activeShader;
     ProgramDNA m_activeShaderDNA;
 
@@ -292,8 +339,60 @@ private:
     GraphicsApiFilterData m_contextInfo;
 
     QByteArray m_uboTempArray;
+    GLBuffer m_standardUniformBuffer;
+    GLBuffer m_instanceBuffer;
+    GLBuffer m_indirectDrawBuffer;
+
+    // UBOs generated from ShaderData, shared by all the shaders declaring
+    // the block with the same layout. The values last written are kept so
+    // that only the ones which changed are uploaded again
+    struct ShaderDataUniformBuffer
+    {
+        GLBuffer buffer;
+        QByteArray data;
+        QVector<QVariant> values;
+    };
+    // The layout hash only speeds up lookups, blocks whose hashes collide
+    // are told apart by their size and members
+    struct ShaderDataUniformBufferKey
+    {
+        Qt3DCore::QNodeId shaderDataId;
+        int blockSize;
+        uint layoutHash;
+        QVector<ShaderUniformBlockMember> layout;
+
+        friend bool operator==(const ShaderDataUniformBufferKey &a, const ShaderDataUniformBufferKey &b)
+        {
+            return a.shaderDataId == b.shaderDataId && a.blockSize == b.blockSize
+                    && a.layoutHash == b.layoutHash && a.layout == b.layout;
+        }
+
+        friend uint qHash(const ShaderDataUniformBufferKey &key, uint seed = 0)
+        {
+            using QT_PREPEND_NAMESPACE(qHash);
+            return qHash(key.shaderDataId, qHash(key.layoutHash, seed));
+        }
+    };
+    QHash<ShaderDataUniformBufferKey, ShaderDataUniformBuffer> m_shaderDataUniformBuffers;
+
+    // Shadowed indexed buffer and program block bindings, cleared every
+    // frame as other users of the context may have changed them
+    struct IndexedBufferBinding
+    {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+    QHash<QPair<GLenum, GLuint>, IndexedBufferBinding> m_indexedBufferBindings;
+    QHash<QPair<GLuint, GLuint>, GLuint> m_uniformBlockBindings;
+    QHash<QPair<GLuint, GLuint>, GLuint> m_shaderStorageBlockBindings;
+
+    int m_issuedStateChanges[StateChangeTypeCount];
+    int m_skippedStateChanges[StateChangeTypeCount];
 
     bool m_supportsVAO;
+    bool m_supportsProgramBinary;
+    int m_standardUniformBlockAlignment;
     QScopedPointer<QOpenGLDebugLogger> m_debugLogger;
 
     friend class OpenGLVertexArrayObject;
@@ -147,6 +147,20 @@ void GraphicsHelperES2::drawElements(GLenum primitiveType,
                             indices);
 }
 
+void GraphicsHelperES2::multiDrawElementsIndirect(GLenum primitiveType,
+                                                  GLint indexType,
+                                                  void *indirect,
+                                                  GLsizei drawCount,
+                                                  GLsizei stride)
+{
+    Q_UNUSED(primitiveType);
+    Q_UNUSED(indexType);
+    Q_UNUSED(indirect);
+    Q_UNUSED(drawCount);
+    Q_UNUSED(stride);
+    qWarning() << "glMultiDrawElementsIndirect is not supported by OpenGL ES";
+}
+
 void GraphicsHelperES2::drawArrays(GLenum primitiveType,
                                     GLint first,
                                     GLsizei count)
@@ -388,6 +402,16 @@ void GraphicsHelperES2::bindBufferBase(GLenum target, GLuint index, GLuint buffe
     qWarning() << "bindBufferBase is not supported by ES 2.0 (since ES 3.0)";
 }
 
+void GraphicsHelperES2::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    Q_UNUSED(target);
+    Q_UNUSED(index);
+    Q_UNUSED(buffer);
+    Q_UNUSED(offset);
+    Q_UNUSED(size);
+    qWarning() << "bindBufferRange is not supported by ES 2.0 (since ES 3.0)";
+}
+
 void GraphicsHelperES2::buildUniformBuffer(const QVariant &v, const ShaderUniform &description, QByteArray &buffer)
 {
     Q_UNUSED(v);
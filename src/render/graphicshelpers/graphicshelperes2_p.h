@@ -69,6 +69,7 @@ public:
     // QGraphicHelperInterface interface
     void alphaTest(GLenum mode1, GLenum mode2) Q_DECL_OVERRIDE;
     void bindBufferBase(GLenum target, GLuint index, GLuint buffer) Q_DECL_OVERRIDE;
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) Q_DECL_OVERRIDE;
     void bindFragDataLocation(GLuint shader, const QHash<QString, int> &outputs) Q_DECL_OVERRIDE;
     void bindFrameBufferAttachment(QOpenGLTexture *texture, const Attachment &attachment) Q_DECL_OVERRIDE;
     void bindFrameBufferObject(GLuint frameBufferId) Q_DECL_OVERRIDE;
@@ -101,6 +102,7 @@ public:
     QSize getRenderBufferDimensions(GLuint renderBufferId) Q_DECL_OVERRIDE;
     QSize getTextureDimensions(GLuint textureId, GLenum target, uint level = 0) Q_DECL_OVERRIDE;
     void initializeHelper(QOpenGLContext *context, QAbstractOpenGLFunctions *functions) Q_DECL_OVERRIDE;
+    void multiDrawElementsIndirect(GLenum primitiveType, GLint indexType, void *indirect, GLsizei drawCount, GLsizei stride) Q_DECL_OVERRIDE;
     void pointSize(bool programmable, GLfloat value) Q_DECL_OVERRIDE;
     GLint maxClipPlaneCount() Q_DECL_OVERRIDE;
     QVector<ShaderUniformBlock> programUniformBlocks(GLuint programId) Q_DECL_OVERRIDE;
@@ -135,6 +135,7 @@ bool GraphicsHelperES3::supportsFeature(GraphicsHelperInterface::Feature feature
     switch (feature) {
     case RenderBufferDimensionRetrieval:
     case MRT:
+    case InstancedArrays:
         return true;
     default:
         return false;
@@ -130,6 +130,20 @@ void GraphicsHelperGL2::drawElements(GLenum primitiveType,
                             indices);
 }
 
+void GraphicsHelperGL2::multiDrawElementsIndirect(GLenum primitiveType,
+                                                  GLint indexType,
+                                                  void *indirect,
+                                                  GLsizei drawCount,
+                                                  GLsizei stride)
+{
+    Q_UNUSED(primitiveType);
+    Q_UNUSED(indexType);
+    Q_UNUSED(indirect);
+    Q_UNUSED(drawCount);
+    Q_UNUSED(stride);
+    qWarning() << "glMultiDrawElementsIndirect is not supported by OpenGL 2.0 (since OpenGL 4.3)";
+}
+
 void GraphicsHelperGL2::drawArrays(GLenum primitiveType,
                                    GLint first,
                                    GLsizei count)
@@ -397,6 +411,16 @@ void GraphicsHelperGL2::bindBufferBase(GLenum target, GLuint index, GLuint buffe
     qWarning() << "bindBufferBase is not supported by OpenGL 2.0 (since OpenGL 3.0)";
 }
 
+void GraphicsHelperGL2::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    Q_UNUSED(target);
+    Q_UNUSED(index);
+    Q_UNUSED(buffer);
+    Q_UNUSED(offset);
+    Q_UNUSED(size);
+    qWarning() << "bindBufferRange is not supported by OpenGL 2.0 (since OpenGL 3.0)";
+}
+
 void GraphicsHelperGL2::buildUniformBuffer(const QVariant &v, const ShaderUniform &description, QByteArray &buffer)
 {
     Q_UNUSED(v);
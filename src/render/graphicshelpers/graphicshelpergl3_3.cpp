@@ -60,6 +60,7 @@
 #  define GL_UNIFORM_OFFSET 0x8A3B
 #  define GL_UNIFORM_ARRAY_STRIDE 0x8A3C
 #  define GL_UNIFORM_MATRIX_STRIDE 0x8A3D
+#  define GL_UNIFORM_IS_ROW_MAJOR 0x8A3E
 #  define GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS 0x8A42
 #  define GL_UNIFORM_BLOCK_BINDING 0x8A3F
 #  define GL_UNIFORM_BLOCK_DATA_SIZE 0x8A40
@@ -149,6 +150,20 @@ void GraphicsHelperGL3_3::drawElements(GLenum primitiveType,
                                       baseVertex);
 }
 
+void GraphicsHelperGL3_3::multiDrawElementsIndirect(GLenum primitiveType,
+                                                    GLint indexType,
+                                                    void *indirect,
+                                                    GLsizei drawCount,
+                                                    GLsizei stride)
+{
+    Q_UNUSED(primitiveType);
+    Q_UNUSED(indexType);
+    Q_UNUSED(indirect);
+    Q_UNUSED(drawCount);
+    Q_UNUSED(stride);
+    qWarning() << "glMultiDrawElementsIndirect is not supported by OpenGL 3.3 (since OpenGL 4.3)";
+}
+
 void GraphicsHelperGL3_3::drawArrays(GLenum primitiveType,
                                       GLint first,
                                       GLsizei count)
@@ -200,6 +215,9 @@ QVector<ShaderUniform> GraphicsHelperGL3_3::programUniformsAndLocations(GLuint p
         m_funcs->glGetActiveUniformsiv(programId, 1, (GLuint*)&i, GL_UNIFORM_OFFSET, &uniform.m_offset);
         m_funcs->glGetActiveUniformsiv(programId, 1, (GLuint*)&i, GL_UNIFORM_ARRAY_STRIDE, &uniform.m_arrayStride);
         m_funcs->glGetActiveUniformsiv(programId, 1, (GLuint*)&i, GL_UNIFORM_MATRIX_STRIDE, &uniform.m_matrixStride);
+        GLint rowMajor = 0;
+        m_funcs->glGetActiveUniformsiv(programId, 1, (GLuint*)&i, GL_UNIFORM_IS_ROW_MAJOR, &rowMajor);
+        uniform.m_rowMajor = rowMajor != 0;
         uniform.m_rawByteSize = uniformByteSize(uniform);
         uniforms.append(uniform);
         qCDebug(Render::Rendering) << uniform.m_name << "size" << uniform.m_size
@@ -388,6 +406,7 @@ bool GraphicsHelperGL3_3::supportsFeature(GraphicsHelperInterface::Feature featu
     case RenderBufferDimensionRetrieval:
     case TextureDimensionRetrieval:
     case BindableFragmentOutputs:
+    case InstancedArrays:
         return true;
     case Tessellation:
         return !m_tessFuncs.isNull();
@@ -430,6 +449,11 @@ void GraphicsHelperGL3_3::bindBufferBase(GLenum target, GLuint index, GLuint buf
     m_funcs->glBindBufferBase(target, index, buffer);
 }
 
+void GraphicsHelperGL3_3::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    m_funcs->glBindBufferRange(target, index, buffer, offset, size);
+}
+
 void GraphicsHelperGL3_3::buildUniformBuffer(const QVariant &v, const ShaderUniform &description, QByteArray &buffer)
 {
     char *bufferData = buffer.data();
@@ -61,6 +61,7 @@
 #  define GL_UNIFORM_OFFSET 0x8A3B
 #  define GL_UNIFORM_ARRAY_STRIDE 0x8A3C
 #  define GL_UNIFORM_MATRIX_STRIDE 0x8A3D
+#  define GL_UNIFORM_IS_ROW_MAJOR 0x8A3E
 #  define GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS 0x8A42
 #  define GL_UNIFORM_BLOCK_BINDING 0x8A3F
 #  define GL_UNIFORM_BLOCK_DATA_SIZE 0x8A40
@@ -140,6 +141,20 @@ void GraphicsHelperGL4::drawElements(GLenum primitiveType,
                                       baseVertex);
 }
 
+void GraphicsHelperGL4::multiDrawElementsIndirect(GLenum primitiveType,
+                                                  GLint indexType,
+                                                  void *indirect,
+                                                  GLsizei drawCount,
+                                                  GLsizei stride)
+{
+    // glMultiDrawElementsIndirect OpenGL 4.3 or greater
+    m_funcs->glMultiDrawElementsIndirect(primitiveType,
+                                         indexType,
+                                         indirect,
+                                         drawCount,
+                                         stride);
+}
+
 void GraphicsHelperGL4::drawArrays(GLenum primitiveType,
                                    GLint first,
                                    GLsizei count)
@@ -181,6 +196,9 @@ QVector<ShaderUniform> GraphicsHelperGL4::programUniformsAndLocations(GLuint pro
         m_funcs->glGetActiveUniformsiv(programId, 1, (GLuint*)&i, GL_UNIFORM_OFFSET, &uniform.m_offset);
         m_funcs->glGetActiveUniformsiv(programId, 1, (GLuint*)&i, GL_UNIFORM_ARRAY_STRIDE, &uniform.m_arrayStride);
         m_funcs->glGetActiveUniformsiv(programId, 1, (GLuint*)&i, GL_UNIFORM_MATRIX_STRIDE, &uniform.m_matrixStride);
+        GLint rowMajor = 0;
+        m_funcs->glGetActiveUniformsiv(programId, 1, (GLuint*)&i, GL_UNIFORM_IS_ROW_MAJOR, &rowMajor);
+        uniform.m_rowMajor = rowMajor != 0;
         uniform.m_rawByteSize = uniformByteSize(uniform);
         uniforms.append(uniform);
         qCDebug(Render::Rendering) << uniform.m_name << "size" << uniform.m_size
@@ -586,6 +604,8 @@ bool GraphicsHelperGL4::supportsFeature(GraphicsHelperInterface::Feature feature
     case ShaderStorageObject:
     case Compute:
     case DrawBuffersBlend:
+    case InstancedArrays:
+    case MultiDrawIndirect:
         return true;
     default:
         return false;
@@ -623,6 +643,11 @@ void GraphicsHelperGL4::bindBufferBase(GLenum target, GLuint index, GLuint buffe
     m_funcs->glBindBufferBase(target, index, buffer);
 }
 
+void GraphicsHelperGL4::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    m_funcs->glBindBufferRange(target, index, buffer, offset, size);
+}
+
 void GraphicsHelperGL4::buildUniformBuffer(const QVariant &v, const ShaderUniform &description, QByteArray &buffer)
 {
     char *bufferData = buffer.data();
@@ -77,12 +77,15 @@ public:
         TextureDimensionRetrieval,
         ShaderStorageObject,
         Compute,
-        DrawBuffersBlend
+        DrawBuffersBlend,
+        InstancedArrays,
+        MultiDrawIndirect
     };
 
     virtual ~GraphicsHelperInterface() {}
     virtual void    alphaTest(GLenum mode1, GLenum mode2) = 0;
     virtual void    bindBufferBase(GLenum target, GLuint index, GLuint buffer) = 0;
+    virtual void    bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) = 0;
     virtual void    bindFragDataLocation(GLuint shader, const QHash<QString, int> &outputs) = 0;
     virtual void    bindFrameBufferAttachment(QOpenGLTexture *texture, const Attachment &attachment) = 0;
     virtual void    bindFrameBufferObject(GLuint frameBufferId) = 0;
@@ -116,6 +119,7 @@ public:
     virtual QSize   getTextureDimensions(GLuint textureId, GLenum target, uint level = 0) = 0;
     virtual void    initializeHelper(QOpenGLContext *context, QAbstractOpenGLFunctions *functions) = 0;
     virtual GLint   maxClipPlaneCount() = 0;
+    virtual void    multiDrawElementsIndirect(GLenum primitiveType, GLint indexType, void *indirect, GLsizei drawCount, GLsizei stride) = 0;
     virtual void    pointSize(bool programmable, GLfloat value) = 0;
     virtual QVector<ShaderAttribute> programAttributesAndLocations(GLuint programId) = 0;
     virtual QVector<ShaderUniform> programUniformsAndLocations(GLuint programId) = 0;
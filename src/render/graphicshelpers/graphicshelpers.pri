@@ -10,7 +10,8 @@ HEADERS += \
     $$PWD/graphicshelpergl2_p.h \
     $$PWD/graphicshelpergl3_3_p.h \
     $$PWD/graphicshelpergl4_p.h \
-    $$PWD/graphicshelpergl3_2_p.h
+    $$PWD/graphicshelpergl3_2_p.h \
+    $$PWD/shadercompiler_p.h
 
 SOURCES += \
     $$PWD/graphicscontext.cpp \
@@ -19,4 +20,5 @@ SOURCES += \
     $$PWD/graphicshelpergl2.cpp \
     $$PWD/graphicshelpergl3_3.cpp \
     $$PWD/graphicshelpergl4.cpp \
-    $$PWD/graphicshelpergl3_2.cpp
+    $$PWD/graphicshelpergl3_2.cpp \
+    $$PWD/shadercompiler.cpp
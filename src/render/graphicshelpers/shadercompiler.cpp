@@ -0,0 +1,281 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "shadercompiler_p.h"
+#include <Qt3DRender/qshaderprogram.h>
+#include <Qt3DRender/private/renderlogging_p.h>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+
+#if !defined(GL_PROGRAM_BINARY_RETRIEVABLE_HINT)
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#if !defined(GL_PROGRAM_BINARY_LENGTH)
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+namespace {
+
+typedef void (QOPENGLF_APIENTRYP BindFragDataLocationFunction)(GLuint program, GLuint color, const char *name);
+
+QOpenGLShader::ShaderType shaderType(QShaderProgram::ShaderType type)
+{
+    switch (type) {
+    case QShaderProgram::Vertex: return QOpenGLShader::Vertex;
+    case QShaderProgram::TessellationControl: return QOpenGLShader::TessellationControl;
+    case QShaderProgram::TessellationEvaluation: return QOpenGLShader::TessellationEvaluation;
+    case QShaderProgram::Geometry: return QOpenGLShader::Geometry;
+    case QShaderProgram::Fragment: return QOpenGLShader::Fragment;
+    case QShaderProgram::Compute: return QOpenGLShader::Compute;
+    default: Q_UNREACHABLE();
+    }
+}
+
+} // anonymous
+
+ShaderCompiler::Request::Request()
+    : dna(0)
+    , bindFragOutputs(false)
+    , binaryFormat(0)
+{
+}
+
+ShaderCompiler::Result::Result()
+    : dna(0)
+    , program(nullptr)
+    , binaryRejected(false)
+    , binaryFormat(0)
+{
+}
+
+ShaderCompiler::ShaderCompiler()
+    : QThread()
+    , m_shareContext(nullptr)
+    , m_surface(nullptr)
+    , m_resultThread(nullptr)
+    , m_created(false)
+    , m_running(false)
+    , m_startSemaphore(0)
+{
+}
+
+ShaderCompiler::~ShaderCompiler()
+{
+    destroy();
+}
+
+// Starts the compiler thread and waits for its context to be created.
+// Returns false if no context sharing with shareContext could be made
+// current on surface, shaders then have to be compiled synchronously
+bool ShaderCompiler::create(QOpenGLContext *shareContext, QSurface *surface)
+{
+    Q_ASSERT(!isRunning());
+    m_shareContext = shareContext;
+    m_surface = surface;
+    m_resultThread = QThread::currentThread();
+    m_running = true;
+    start();
+    m_startSemaphore.acquire();
+    if (!m_created) {
+        wait();
+        m_running = false;
+    }
+    return m_created;
+}
+
+void ShaderCompiler::destroy()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_running = false;
+        m_requests.clear();
+        m_waitCondition.wakeAll();
+    }
+    wait();
+    m_created = false;
+
+    // Compiled but never collected
+    for (const Result &result : qAsConst(m_results))
+        delete result.program;
+    m_results.clear();
+}
+
+void ShaderCompiler::compile(const Request &request)
+{
+    Q_ASSERT(m_created);
+    QMutexLocker lock(&m_mutex);
+    m_requests.push_back(request);
+    m_waitCondition.wakeOne();
+}
+
+// Programs returned are owned by the caller
+QVector<ShaderCompiler::Result> ShaderCompiler::takeResults()
+{
+    QMutexLocker lock(&m_mutex);
+    return std::move(m_results);
+}
+
+// Compiler thread
+void ShaderCompiler::run()
+{
+    QOpenGLContext context;
+    context.setShareContext(m_shareContext);
+    context.setFormat(m_shareContext->format());
+    m_created = context.create() && context.makeCurrent(m_surface);
+    if (!m_created)
+        qCWarning(Shaders) << "Failed to create a shared context for shader compilation";
+    m_startSemaphore.release();
+    if (!m_created)
+        return;
+
+    QMutexLocker lock(&m_mutex);
+    while (m_running) {
+        if (m_requests.isEmpty()) {
+            m_waitCondition.wait(&m_mutex);
+            continue;
+        }
+        const QVector<Request> requests = std::move(m_requests);
+        lock.unlock();
+
+        QVector<Result> results;
+        results.reserve(requests.size());
+        for (const Request &request : requests) {
+            Result result = compileProgram(&context, request);
+            if (result.program != nullptr)
+                result.program->moveToThread(m_resultThread);
+            results.push_back(result);
+        }
+        // Objects have to be complete before being used by another
+        // context of the share group
+        context.functions()->glFinish();
+
+        lock.relock();
+        m_results += results;
+    }
+    lock.unlock();
+
+    context.doneCurrent();
+}
+
+ShaderCompiler::Result ShaderCompiler::compileProgram(QOpenGLContext *context, const Request &request)
+{
+    Result result;
+    result.dna = request.dna;
+    result.binaryKey = request.binaryKey;
+
+    const bool useProgramBinary = !request.binaryKey.isEmpty();
+    if (useProgramBinary && !request.binary.isEmpty()) {
+        QScopedPointer<QOpenGLShaderProgram> shaderProgram(new QOpenGLShaderProgram);
+        shaderProgram->create();
+        context->extraFunctions()->glProgramBinary(shaderProgram->programId(), request.binaryFormat,
+                                                   request.binary.constData(), request.binary.size());
+        // Without shaders, link only checks whether the binary was accepted
+        if (shaderProgram->link()) {
+            result.program = shaderProgram.take();
+            return result;
+        }
+        // Rejected, usually after a driver update, build it from sources
+        qCDebug(Shaders) << "Program binary rejected, compiling from sources";
+        result.binaryRejected = true;
+    }
+
+    QScopedPointer<QOpenGLShaderProgram> shaderProgram(new QOpenGLShaderProgram);
+    if (useProgramBinary) {
+        shaderProgram->create();
+        context->extraFunctions()->glProgramParameteri(shaderProgram->programId(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    // Compile shaders
+    for (int i = QShaderProgram::Vertex; i <= QShaderProgram::Compute; ++i) {
+        QShaderProgram::ShaderType type = static_cast<const QShaderProgram::ShaderType>(i);
+        if (!request.shaderCode.at(i).isEmpty() &&
+                !shaderProgram->addShaderFromSourceCode(shaderType(type), request.shaderCode.at(i))) {
+            qWarning().noquote() << "Failed to compile shader:" << shaderProgram->log();
+        }
+    }
+
+    // Call glBindFragDataLocation and link the program
+    // Since we are sharing shaders in the backend, we assume that if using custom
+    // fragOutputs, they should all be the same for a given shader
+    if (request.bindFragOutputs && !request.fragOutputs.isEmpty()) {
+        shaderProgram->create();
+        const auto bindFragDataLocation = reinterpret_cast<BindFragDataLocationFunction>(context->getProcAddress("glBindFragDataLocation"));
+        if (bindFragDataLocation != nullptr) {
+            for (auto it = request.fragOutputs.cbegin(), end = request.fragOutputs.cend(); it != end; ++it)
+                bindFragDataLocation(shaderProgram->programId(), it.value(), it.key().toStdString().c_str());
+        }
+    }
+    if (!shaderProgram->link()) {
+        qWarning().noquote() << "Failed to link shader program:" << shaderProgram->log();
+        result.log = shaderProgram->log();
+        return result;
+    }
+
+    if (useProgramBinary) {
+        QOpenGLExtraFunctions *f = context->extraFunctions();
+        GLint binaryLength = 0;
+        f->glGetProgramiv(shaderProgram->programId(), GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+        if (binaryLength > 0) {
+            QByteArray binary(binaryLength, Qt::Uninitialized);
+            GLenum binaryFormat = 0;
+            f->glGetProgramBinary(shaderProgram->programId(), binaryLength, &binaryLength,
+                                  &binaryFormat, binary.data());
+            binary.resize(binaryLength);
+            result.binaryFormat = binaryFormat;
+            result.binary = binary;
+        }
+    }
+
+    // take from scoped-pointer so it doesn't get deleted
+    result.program = shaderProgram.take();
+    return result;
+}
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
@@ -0,0 +1,143 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QT3DRENDER_RENDER_SHADERCOMPILER_P_H
+#define QT3DRENDER_RENDER_SHADERCOMPILER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <Qt3DRender/private/shader_p.h>
+
+#include <QThread>
+#include <QtCore/QMutex>
+#include <QtCore/QSemaphore>
+#include <QtCore/QWaitCondition>
+
+QT_BEGIN_NAMESPACE
+
+class QOpenGLContext;
+class QOpenGLShaderProgram;
+class QSurface;
+
+namespace Qt3DRender {
+
+namespace Render {
+
+// Compiles and links shader programs in a context sharing objects with the
+// one used for submission, so that loading new content doesn't stall the
+// frame being rendered. Programs are handed back in the thread that created
+// the compiler, ready to be bound once collected.
+class Q_AUTOTEST_EXPORT ShaderCompiler : public QThread
+{
+    Q_OBJECT
+public:
+    struct Request
+    {
+        Request();
+
+        ProgramDNA dna;
+        QVector<QByteArray> shaderCode;
+        QHash<QString, int> fragOutputs;
+        bool bindFragOutputs;
+        // Key and previously stored binary, the binary is tried before the sources
+        QByteArray binaryKey;
+        uint binaryFormat;
+        QByteArray binary;
+    };
+
+    struct Result
+    {
+        Result();
+
+        ProgramDNA dna;
+        QOpenGLShaderProgram *program; // nullptr if the program couldn't be linked
+        QString log; // Set when program is nullptr
+        QByteArray binaryKey;
+        bool binaryRejected;
+        // Binary retrieved after linking from sources
+        uint binaryFormat;
+        QByteArray binary;
+    };
+
+    ShaderCompiler();
+    ~ShaderCompiler();
+
+    // Called from the submission thread with shareContext current
+    bool create(QOpenGLContext *shareContext, QSurface *surface);
+    void destroy();
+    bool isCreated() const { return m_created; }
+
+    void compile(const Request &request);
+    QVector<Result> takeResults();
+
+    // Compiles in context, which has to be current
+    static Result compileProgram(QOpenGLContext *context, const Request &request);
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    QOpenGLContext *m_shareContext;
+    QSurface *m_surface;
+    QThread *m_resultThread;
+    bool m_created;
+    bool m_running;
+    QSemaphore m_startSemaphore;
+    QMutex m_mutex;
+    QWaitCondition m_waitCondition;
+    QVector<Request> m_requests;
+    QVector<Result> m_results;
+};
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_SHADERCOMPILER_P_H
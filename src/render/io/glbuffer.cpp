@@ -58,6 +58,9 @@
 #if !defined(GL_PIXEL_UNPACK_BUFFER)
 #define GL_PIXEL_UNPACK_BUFFER 0x88EC
 #endif
+#if !defined(GL_DRAW_INDIRECT_BUFFER)
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -76,7 +79,8 @@ GLenum glBufferTypes[] = {
     GL_ELEMENT_ARRAY_BUFFER,
     GL_SHADER_STORAGE_BUFFER,
     GL_PIXEL_PACK_BUFFER,
-    GL_PIXEL_UNPACK_BUFFER
+    GL_PIXEL_UNPACK_BUFFER,
+    GL_DRAW_INDIRECT_BUFFER
 };
 
 } // anonymous
@@ -146,6 +150,11 @@ void GLBuffer::bindBufferBase(GraphicsContext *ctx, int bindingPoint)
     ctx->bindBufferBase(m_lastTarget, bindingPoint, m_bufferId);
 }
 
+void GLBuffer::bindBufferRange(GraphicsContext *ctx, int bindingPoint, int offset, int size, GLBuffer::Type t)
+{
+    ctx->bindBufferRange(glBufferTypes[t], bindingPoint, m_bufferId, offset, size);
+}
+
 } // namespace Render
 
 } // namespace Qt3DRender
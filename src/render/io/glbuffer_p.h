@@ -74,7 +74,8 @@ public:
         IndexBuffer,
         ShaderStorageBuffer,
         PixelPackBuffer,
-        PixelUnpackBuffer
+        PixelUnpackBuffer,
+        DrawIndirectBuffer
     };
 
     bool bind(GraphicsContext *ctx, Type t);
@@ -86,6 +87,7 @@ public:
     void update(GraphicsContext *ctx, const void *data, uint size, int offset = 0);
     void bindBufferBase(GraphicsContext *ctx, int bindingPoint, Type t);
     void bindBufferBase(GraphicsContext *ctx, int bindingPoint);
+    void bindBufferRange(GraphicsContext *ctx, int bindingPoint, int offset, int size, Type t);
 
     inline GLuint bufferId() const { return m_bufferId; }
     inline bool isCreated() const { return m_isCreated; }
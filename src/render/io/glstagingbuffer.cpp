@@ -0,0 +1,223 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "glstagingbuffer_p.h"
+#include <QOpenGLExtraFunctions>
+#include <Qt3DRender/private/renderlogging_p.h>
+
+#if !defined(GL_MAP_WRITE_BIT)
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
+#if !defined(GL_MAP_PERSISTENT_BIT)
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#if !defined(GL_MAP_COHERENT_BIT)
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#if !defined(GL_COPY_READ_BUFFER)
+#define GL_COPY_READ_BUFFER 0x8F36
+#endif
+#if !defined(GL_COPY_WRITE_BUFFER)
+#define GL_COPY_WRITE_BUFFER 0x8F37
+#endif
+#if !defined(GL_SYNC_GPU_COMMANDS_COMPLETE)
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#if !defined(GL_SYNC_FLUSH_COMMANDS_BIT)
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#if !defined(GL_WAIT_FAILED)
+#define GL_WAIT_FAILED 0x911D
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+namespace {
+
+typedef void (QOPENGLF_APIENTRYP BufferStorageFunction)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+BufferStorageFunction resolveBufferStorage(QOpenGLContext *ctx)
+{
+    if (ctx->isOpenGLES())
+        return ctx->hasExtension(QByteArrayLiteral("GL_EXT_buffer_storage"))
+                ? reinterpret_cast<BufferStorageFunction>(ctx->getProcAddress("glBufferStorageEXT"))
+                : nullptr;
+    if (ctx->format().version() >= qMakePair(4, 4) || ctx->hasExtension(QByteArrayLiteral("GL_ARB_buffer_storage")))
+        return reinterpret_cast<BufferStorageFunction>(ctx->getProcAddress("glBufferStorage"));
+    return nullptr;
+}
+
+const uint stagingAlignment = 16;
+
+} // anonymous
+
+GLStagingBuffer::GLStagingBuffer()
+    : m_bufferId(0)
+    , m_mappedData(nullptr)
+    , m_segmentSize(0)
+    , m_segmentOffset(0)
+    , m_segment(0)
+    , m_segmentBusy(false)
+{
+    for (int i = 0; i < SegmentCount; ++i)
+        m_fences[i] = nullptr;
+}
+
+// Persistent mapping requires buffer storage, copies and fences,
+// GL 3.x / ES 3.0 are needed for the latter
+bool GLStagingBuffer::isSupported(QOpenGLContext *ctx)
+{
+    const QPair<int, int> version = ctx->format().version();
+    if (ctx->isOpenGLES() ? version < qMakePair(3, 0) : version < qMakePair(3, 2))
+        return false;
+    return resolveBufferStorage(ctx) != nullptr;
+}
+
+bool GLStagingBuffer::create(QOpenGLContext *ctx, uint size)
+{
+    if (isCreated())
+        return true;
+    if (size < SegmentCount * stagingAlignment || !isSupported(ctx))
+        return false;
+
+    const BufferStorageFunction bufferStorage = resolveBufferStorage(ctx);
+    QOpenGLExtraFunctions *f = ctx->extraFunctions();
+
+    m_segmentSize = (size / SegmentCount) & ~(stagingAlignment - 1);
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    f->glGenBuffers(1, &m_bufferId);
+    f->glBindBuffer(GL_COPY_READ_BUFFER, m_bufferId);
+    bufferStorage(GL_COPY_READ_BUFFER, m_segmentSize * SegmentCount, nullptr, flags);
+    m_mappedData = static_cast<char *>(f->glMapBufferRange(GL_COPY_READ_BUFFER, 0,
+                                                           m_segmentSize * SegmentCount, flags));
+    f->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    if (m_mappedData == nullptr) {
+        qCWarning(Render::Io) << Q_FUNC_INFO << "failed to map the staging buffer";
+        f->glDeleteBuffers(1, &m_bufferId);
+        m_bufferId = 0;
+        return false;
+    }
+
+    m_segmentOffset = 0;
+    m_segment = 0;
+    qCDebug(Render::Io) << "created persistently mapped staging buffer of" << m_segmentSize * SegmentCount << "bytes";
+    return true;
+}
+
+void GLStagingBuffer::destroy(QOpenGLContext *ctx)
+{
+    if (!isCreated())
+        return;
+
+    QOpenGLExtraFunctions *f = ctx->extraFunctions();
+    for (int i = 0; i < SegmentCount; ++i) {
+        if (m_fences[i] != nullptr) {
+            f->glDeleteSync(m_fences[i]);
+            m_fences[i] = nullptr;
+        }
+    }
+    f->glBindBuffer(GL_COPY_READ_BUFFER, m_bufferId);
+    f->glUnmapBuffer(GL_COPY_READ_BUFFER);
+    f->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    f->glDeleteBuffers(1, &m_bufferId);
+    m_bufferId = 0;
+    m_mappedData = nullptr;
+}
+
+bool GLStagingBuffer::upload(QOpenGLContext *ctx, GLuint destinationBufferId,
+                             const void *data, uint size, uint offset)
+{
+    if (!isCreated() || size > m_segmentSize - m_segmentOffset)
+        return false;
+
+    QOpenGLExtraFunctions *f = ctx->extraFunctions();
+
+    // First write of the frame in this segment, the GPU may still
+    // be reading what was copied from it SegmentCount frames ago
+    if (m_fences[m_segment] != nullptr) {
+        // Once a wait timed out, the remaining updates of the frame only poll
+        const GLuint64 timeout = m_segmentBusy ? 0 : GLuint64(1000000000);
+        const GLenum result = f->glClientWaitSync(m_fences[m_segment], GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+            if (result == GL_WAIT_FAILED)
+                qCWarning(Render::Io) << Q_FUNC_INFO << "waiting for the staging buffer failed";
+            m_segmentBusy = true;
+            return false;
+        }
+        f->glDeleteSync(m_fences[m_segment]);
+        m_fences[m_segment] = nullptr;
+    }
+
+    const uint stagingOffset = m_segment * m_segmentSize + m_segmentOffset;
+    memcpy(m_mappedData + stagingOffset, data, size);
+    m_segmentOffset += (size + stagingAlignment - 1) & ~(stagingAlignment - 1);
+
+    // Copy bindings are used so that the buffers bound
+    // for drawing are left untouched
+    f->glBindBuffer(GL_COPY_READ_BUFFER, m_bufferId);
+    f->glBindBuffer(GL_COPY_WRITE_BUFFER, destinationBufferId);
+    f->glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, stagingOffset, offset, size);
+    f->glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    f->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    return true;
+}
+
+// Called once per frame, fences the segment that was written and moves to the next one
+void GLStagingBuffer::endFrame(QOpenGLContext *ctx)
+{
+    m_segmentBusy = false;
+    if (!isCreated() || m_segmentOffset == 0)
+        return;
+
+    m_fences[m_segment] = ctx->extraFunctions()->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_segment = (m_segment + 1) % SegmentCount;
+    m_segmentOffset = 0;
+}
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
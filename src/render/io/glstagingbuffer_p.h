@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QT3DRENDER_RENDER_GLSTAGINGBUFFER_P_H
+#define QT3DRENDER_RENDER_GLSTAGINGBUFFER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QOpenGLContext>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+// Ring of persistently mapped memory used to stream partial buffer updates.
+// Data is written into the segment of the current frame and copied on the
+// GPU into the destination buffer. A segment is only written again once the
+// fence placed at the end of the frame that last used it was signaled.
+class GLStagingBuffer
+{
+public:
+    GLStagingBuffer();
+
+    bool create(QOpenGLContext *ctx, uint size);
+    void destroy(QOpenGLContext *ctx);
+    inline bool isCreated() const { return m_mappedData != nullptr; }
+
+    // Returns false if the data doesn't fit in what's left of the current
+    // segment or if the GPU is still reading the segment, the caller has to
+    // upload it by other means
+    bool upload(QOpenGLContext *ctx, GLuint destinationBufferId,
+                const void *data, uint size, uint offset);
+    void endFrame(QOpenGLContext *ctx);
+
+    static bool isSupported(QOpenGLContext *ctx);
+
+private:
+    enum {
+        SegmentCount = 3
+    };
+
+    GLuint m_bufferId;
+    char *m_mappedData;
+    uint m_segmentSize;
+    uint m_segmentOffset;
+    int m_segment;
+    bool m_segmentBusy;
+    GLsync m_fences[SegmentCount];
+};
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_GLSTAGINGBUFFER_P_H
@@ -11,6 +11,7 @@ HEADERS += \
     $$PWD/qsceneimporter_p.h \
     $$PWD/qsceneimportplugin_p.h \
     $$PWD/glbuffer_p.h \
+    $$PWD/glstagingbuffer_p.h \
     $$PWD/qsceneimportfactory_p.h
 
 SOURCES += \
@@ -23,4 +24,5 @@ SOURCES += \
     $$PWD/qsceneimporter.cpp \
     $$PWD/qsceneimportplugin.cpp \
     $$PWD/glbuffer.cpp \
+    $$PWD/glstagingbuffer.cpp \
     $$PWD/qsceneimportfactory.cpp
@@ -37,6 +37,7 @@
 **
 ****************************************************************************/
 
+
 #include "objloader_p.h"
 
 #include "qmesh.h"
@@ -47,96 +48,498 @@
 #include <Qt3DRender/private/qaxisalignedboundingbox_p.h>
 
 #include <Qt3DRender/private/renderlogging_p.h>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
 #include <QFile>
-#include <QTextStream>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QThread>
 #include <QVector>
 #include <QRegExp>
+#include <QtConcurrent/QtConcurrent>
 
 #include <Qt3DRender/qgeometry.h>
 #include <Qt3DRender/qattribute.h>
 #include <Qt3DRender/qbuffer.h>
 
+#include <cstring>
+
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DRender {
 
+namespace {
+
+// Inputs are split in chunks of roughly that many bytes which are parsed in parallel
+const qint64 parseChunkSize = 1 << 20;
+// Below that many elements, per vertex/triangle passes run on the calling thread
+const int parallelThreshold = 1 << 14;
+
+const unsigned int invalidIndex = std::numeric_limits<unsigned int>::max();
+// Relative indices are stored biased, relatively to the start of their chunk
+const unsigned int relativeIndexFlag = 0x80000000;
+const int relativeIndexBias = 0x40000000;
+
 /*
- * A helper class to split a QByteArray and access its sections without
- * additional memory allocations.
+ * Runs f(begin, end) over [0, count) split in ranges on the global thread pool.
  */
-class ByteArraySplitter
+template <typename F>
+void parallelFor(int count, const F &f)
 {
-public:
-    explicit ByteArraySplitter(const char *begin, const char *end, char delimiter, QString::SplitBehavior splitBehavior)
-        : m_input(begin)
-    {
-        int position = 0;
-        int lastPosition = 0;
-        for (auto it = begin; it != end; ++it) {
-            if (*it == delimiter) {
-                if (position > lastPosition || splitBehavior == QString::KeepEmptyParts) { // skip multiple consecutive delimiters
-                    const Entry entry = { lastPosition, position - lastPosition };
-                    m_entries.append(entry);
-                }
-                lastPosition = position + 1;
+    if (count < parallelThreshold) {
+        f(0, count);
+        return;
+    }
+
+    const int rangeCount = qMin(std::max(QThread::idealThreadCount(), 2) * 4, count / (parallelThreshold / 4));
+    const int rangeSize = (count + rangeCount - 1) / rangeCount;
+    QVector<QPair<int, int>> ranges;
+    ranges.reserve(rangeCount);
+    for (int begin = 0; begin < count; begin += rangeSize)
+        ranges.append(qMakePair(begin, qMin(begin + rangeSize, count)));
+
+    QtConcurrent::blockingMap(ranges, [&f] (const QPair<int, int> &range) {
+        f(range.first, range.second);
+    });
+}
+
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline const char *skipBlanks(const char *p, const char *end)
+{
+    while (p != end && isBlank(*p))
+        ++p;
+    return p;
+}
+
+inline const char *skipToken(const char *p, const char *end)
+{
+    while (p != end && !isBlank(*p))
+        ++p;
+    return p;
+}
+
+/*
+ * Parses a float from [p, end) without going through the locale aware
+ * machinery. Only the plain decimal notation is handled here, anything
+ * else (inf, nan, hex floats) is handed over to qstrntod.
+ */
+const char *parseFloat(const char *p, const char *end, float *value)
+{
+    static const double powersOf10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const int maxPower = sizeof(powersOf10) / sizeof(powersOf10[0]) - 1;
+
+    const char *start = p;
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    quint64 mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+
+    for (; p != end && isDigit(*p); ++p) {
+        hasDigits = true;
+        if (significantDigits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa)
+                ++significantDigits;
+        } else {
+            ++exponent;
+        }
+    }
+
+    if (p != end && *p == '.') {
+        for (++p; p != end && isDigit(*p); ++p) {
+            hasDigits = true;
+            if (significantDigits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa)
+                    ++significantDigits;
+                --exponent;
             }
+        }
+    }
 
-            ++position;
+    if (Q_UNLIKELY(!hasDigits)) {
+        const char *tokenEnd = skipToken(start, end);
+        *value = float(qstrntod(start, int(tokenEnd - start), nullptr, nullptr));
+        return tokenEnd;
+    }
+
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        const char *exponentStart = p++;
+        bool negativeExponent = false;
+        if (p != end && (*p == '-' || *p == '+')) {
+            negativeExponent = *p == '-';
+            ++p;
+        }
+        if (p != end && isDigit(*p)) {
+            int e = 0;
+            for (; p != end && isDigit(*p); ++p) {
+                if (e < 10000)
+                    e = e * 10 + (*p - '0');
+            }
+            exponent += negativeExponent ? -e : e;
+        } else {
+            p = exponentStart; // not an exponent after all
         }
+    }
 
-        const Entry entry = { lastPosition, position - lastPosition };
-        m_entries.append(entry);
+    double result = double(mantissa);
+    if (mantissa) {
+        while (exponent < -maxPower) {
+            result /= powersOf10[maxPower];
+            exponent += maxPower;
+        }
+        while (exponent > maxPower) {
+            result *= powersOf10[maxPower];
+            exponent -= maxPower;
+        }
+        result = exponent < 0 ? result / powersOf10[-exponent] : result * powersOf10[exponent];
     }
 
-    int size() const
-    {
-        return m_entries.size();
+    *value = float(negative ? -result : result);
+    return p;
+}
+
+bool parseFloats(const char *&p, const char *end, float *values, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        p = skipBlanks(p, end);
+        if (p == end)
+            return false;
+        p = parseFloat(p, end, values + i);
+    }
+    return true;
+}
+
+/*
+ * Parses a one based OBJ index and returns it zero based, or invalidIndex
+ * when the index is missing (e.g. "1//3"). A relative (negative) index
+ * refers to the count elements parsed so far in the chunk, it is returned
+ * flagged and resolved by resolveIndex once the previous chunks are known.
+ */
+const char *parseIndex(const char *p, const char *end, int count, unsigned int *index)
+{
+    const bool relative = p != end && *p == '-';
+    if (relative)
+        ++p;
+
+    if (p == end || !isDigit(*p)) {
+        *index = invalidIndex;
+        while (p != end && !isBlank(*p) && *p != '/')
+            ++p;
+        return p;
     }
 
-    const char* charPtrAt(int index) const
-    {
-        return m_input + m_entries[index].start;
+    unsigned int value = 0;
+    for (; p != end && isDigit(*p); ++p) {
+        if (value < unsigned(relativeIndexBias))
+            value = value * 10 + (*p - '0');
     }
 
-    float floatAt(int index) const
-    {
-        return qstrntod(m_input + m_entries[index].start, m_entries[index].size, nullptr, nullptr);
+    if (value == 0 || value >= unsigned(relativeIndexBias))
+        *index = invalidIndex;
+    else if (relative)
+        *index = relativeIndexFlag | unsigned(count - int(value) + relativeIndexBias);
+    else
+        *index = value - 1;
+    return p;
+}
+
+/*
+ * Returns the index in the merged elements of an index parsed in a chunk
+ * starting at chunkStart, once offset elements of skipped sub meshes were
+ * removed. Invalid indices wrap around and are rejected by the callers.
+ */
+unsigned int resolveIndex(unsigned int index, unsigned int chunkStart, unsigned int offset)
+{
+    if (index == invalidIndex)
+        return invalidIndex;
+    if (index & relativeIndexFlag) {
+        const qint64 absolute = qint64(chunkStart) + int(index & ~relativeIndexFlag) - relativeIndexBias;
+        if (absolute < 0)
+            return invalidIndex;
+        index = unsigned(absolute);
     }
+    return index - offset;
+}
+
+struct ObjectMarker
+{
+    QString name;
+    int positionCount;
+    int texCoordCount;
+    int normalCount;
+    int faceIndexCount;
+};
 
-    int intAt(int index) const
+/*
+ * Output of parsing one chunk of the input. Face indices are stored as
+ * read from the file (zero based), the offsets introduced by skipped
+ * sub meshes are applied when the chunks are merged.
+ */
+struct ObjChunk
+{
+    ObjChunk()
+        : begin(nullptr)
+        , end(nullptr)
+        , loadTextureCoords(true)
+        , faceCount(0)
+    {}
+
+    const char *begin;
+    const char *end;
+    bool loadTextureCoords;
+
+    QVector<QVector3D> positions;
+    QVector<QVector2D> texCoords;
+    QVector<QVector3D> normals;
+    QVector<FaceIndices> faceIndices; // triangulated
+    QVector<ObjectMarker> markers;
+    int faceCount;
+};
+
+void parseChunk(ObjChunk &chunk)
+{
+    const char *p = chunk.begin;
+    const char *end = chunk.end;
+
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(memchr(p, '\n', end - p));
+        if (!lineEnd)
+            lineEnd = end;
+
+        p = skipBlanks(p, lineEnd);
+        if (lineEnd - p >= 2) {
+            float v[3];
+            if (p[0] == 'v' && isBlank(p[1])) {
+                p += 2;
+                if (!parseFloats(p, lineEnd, v, 3))
+                    qCWarning(Render::Io) << "Unsupported number of components in vertex";
+                else
+                    chunk.positions.append(QVector3D(v[0], v[1], v[2]));
+            } else if (p[0] == 'v' && p[1] == 't' && lineEnd - p >= 3 && isBlank(p[2])) {
+                if (chunk.loadTextureCoords) {
+                    p += 3;
+                    if (!parseFloats(p, lineEnd, v, 2))
+                        qCWarning(Render::Io) << "Unsupported number of components in texture coordinate";
+                    else
+                        chunk.texCoords.append(QVector2D(v[0], v[1]));
+                }
+            } else if (p[0] == 'v' && p[1] == 'n' && lineEnd - p >= 3 && isBlank(p[2])) {
+                p += 3;
+                if (!parseFloats(p, lineEnd, v, 3))
+                    qCWarning(Render::Io) << "Unsupported number of components in vertex normal";
+                else
+                    chunk.normals.append(QVector3D(v[0], v[1], v[2]));
+            } else if (p[0] == 'f' && isBlank(p[1])) {
+                ++chunk.faceCount;
+                p += 2;
+
+                QVarLengthArray<FaceIndices, 4> face; // try to avoid allocations in the common case of triangulated data
+                for (p = skipBlanks(p, lineEnd); p != lineEnd; p = skipBlanks(p, lineEnd)) {
+                    FaceIndices faceIndices;
+                    p = parseIndex(p, lineEnd, chunk.positions.size(), &faceIndices.positionIndex);
+                    if (p != lineEnd && *p == '/') {
+                        p = parseIndex(p + 1, lineEnd, chunk.texCoords.size(), &faceIndices.texCoordIndex);
+                        if (p != lineEnd && *p == '/')
+                            p = parseIndex(p + 1, lineEnd, chunk.normals.size(), &faceIndices.normalIndex);
+                    }
+                    p = skipToken(p, lineEnd);
+                    face.append(faceIndices);
+                }
+
+                if (face.size() < 3) {
+                    qCWarning(Render::Io) << "Unsupported number of indices in face element";
+                } else {
+                    // If number of edges in face is greater than 3,
+                    // decompose into triangles as a triangle fan.
+                    for (int i = 2; i < face.size(); ++i) {
+                        chunk.faceIndices.append(face[0]);
+                        chunk.faceIndices.append(face[i - 1]);
+                        chunk.faceIndices.append(face[i]);
+                    }
+                }
+            } else if (p[0] == 'o' && isBlank(p[1])) {
+                const char *nameBegin = skipBlanks(p + 2, lineEnd);
+                const char *nameEnd = lineEnd;
+                while (nameEnd != nameBegin && isBlank(nameEnd[-1]))
+                    --nameEnd;
+                if (nameBegin == nameEnd) {
+                    qCWarning(Render::Io) << "Missing submesh name";
+                } else {
+                    const ObjectMarker marker = {
+                        QString::fromLatin1(nameBegin, int(nameEnd - nameBegin)),
+                        chunk.positions.size(),
+                        chunk.texCoords.size(),
+                        chunk.normals.size(),
+                        chunk.faceIndices.size()
+                    };
+                    chunk.markers.append(marker);
+                }
+            }
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+/*
+ * Open addressing hash table mapping the face indices of an OBJ file
+ * to unique vertex indices (in OpenGL parlance).
+ */
+class FaceIndexTable
+{
+public:
+    explicit FaceIndexTable(int expectedSize)
+        : m_size(0)
     {
-        return strtol(m_input + m_entries[index].start, nullptr, 10);
+        int capacity = 16;
+        while (capacity < expectedSize * 2)
+            capacity <<= 1;
+        rehash(capacity);
     }
 
-    QString stringAt(int index) const
+    // Returns the vertex index for faceIndices, assigning the next
+    // free one if faceIndices was not in the table yet
+    unsigned int findOrInsert(const FaceIndices &faceIndices, bool *inserted)
     {
-        return QString::fromLatin1(m_input + m_entries[index].start, m_entries[index].size);
+        if ((m_size + 1) * 2 > m_values.size())
+            rehash(m_values.size() * 2);
+
+        const uint mask = uint(m_values.size() - 1);
+        for (uint i = hash(faceIndices) & mask; ; i = (i + 1) & mask) {
+            if (m_values[i] == invalidIndex) {
+                m_keys[i] = faceIndices;
+                m_values[i] = unsigned(m_size++);
+                *inserted = true;
+                return m_values[i];
+            }
+            if (m_keys[i] == faceIndices) {
+                *inserted = false;
+                return m_values[i];
+            }
+        }
     }
 
-    ByteArraySplitter splitterAt(int index, char delimiter, QString::SplitBehavior splitBehavior) const
+    int size() const { return m_size; }
+
+private:
+    static uint hash(const FaceIndices &f)
     {
-        return ByteArraySplitter(m_input + m_entries[index].start, m_input + m_entries[index].start + m_entries[index].size, delimiter, splitBehavior);
+        const quint64 h = quint64(f.positionIndex) * Q_UINT64_C(0x9E3779B97F4A7C15)
+                ^ quint64(f.texCoordIndex) * Q_UINT64_C(0xC2B2AE3D27D4EB4F)
+                ^ quint64(f.normalIndex) * Q_UINT64_C(0x165667B19E3779F9);
+        return uint(h ^ (h >> 29));
     }
 
-    struct Entry
+    void rehash(int capacity)
     {
-        int start;
-        int size;
-    };
+        const QVector<FaceIndices> keys = m_keys;
+        const QVector<unsigned int> values = m_values;
+        m_keys = QVector<FaceIndices>(capacity);
+        m_values = QVector<unsigned int>(capacity, invalidIndex);
+
+        const uint mask = uint(capacity - 1);
+        for (int j = 0, n = values.size(); j < n; ++j) {
+            if (values[j] == invalidIndex)
+                continue;
+            uint i = hash(keys[j]) & mask;
+            while (m_values[i] != invalidIndex)
+                i = (i + 1) & mask;
+            m_keys[i] = keys[j];
+            m_values[i] = values[j];
+        }
+    }
 
-private:
-    QVarLengthArray<Entry, 16> m_entries;
-    const char *m_input;
+    QVector<FaceIndices> m_keys;
+    QVector<unsigned int> m_values;
+    int m_size;
+};
+
+// Binary cache layout: header followed by the points, normals, texture
+// coordinates, tangents and indices arrays, tightly packed. The arrays are
+// stored in the host representation, caches written by hosts with another
+// byte order or other element sizes are discarded.
+struct ObjCacheHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 byteOrder;
+    quint32 elementSizes;
+    qint64 sourceModified;
+    qint64 sourceSize;
+    quint32 pointCount;
+    quint32 normalCount;
+    quint32 texCoordCount;
+    quint32 tangentCount;
+    quint32 indexCount;
+    quint32 padding;
 };
-QT3D_DECLARE_TYPEINFO(Qt3DRender, ByteArraySplitter::Entry, Q_PRIMITIVE_TYPE)
 
-inline uint qHash(const FaceIndices &faceIndices)
+const quint32 objCacheMagic = 0x434a424f; // "OBJC"
+const quint32 objCacheVersion = 2;
+const quint32 objCacheByteOrder = 0x01020304;
+const quint32 objCacheElementSizes = sizeof(QVector2D) | sizeof(QVector3D) << 8
+        | sizeof(QVector4D) << 16 | sizeof(unsigned int) << 24;
+
+template <typename T>
+const char *readCacheArray(const char *p, quint32 count, QVector<T> &v)
+{
+    v.resize(int(count));
+    memcpy(v.data(), p, count * sizeof(T));
+    return p + count * sizeof(T);
+}
+
+template <typename T>
+void writeCacheArray(QIODevice *dev, const QVector<T> &v)
 {
-    return faceIndices.positionIndex
-            + 10 * faceIndices.texCoordIndex
-            + 100 * faceIndices.normalIndex;
+    dev->write(reinterpret_cast<const char *>(v.constData()), v.size() * sizeof(T));
 }
 
+} // anonymous
+
+/*
+ * Vertex to triangle adjacency in compressed row storage, used to gather
+ * per triangle values into vertices without any write contention.
+ */
+struct ObjLoader::TriangleAdjacency
+{
+    TriangleAdjacency(const QVector<unsigned int> &faces, int vertexCount)
+        : offsets(vertexCount + 1, 0)
+        , triangles(faces.size())
+    {
+        for (unsigned int v : faces)
+            ++offsets[v + 1];
+        for (int i = 0; i < vertexCount; ++i)
+            offsets[i + 1] += offsets[i];
+
+        QVector<int> cursor = offsets;
+        for (int i = 0, n = faces.size(); i < n; ++i)
+            triangles[cursor[faces[i]]++] = i / 3;
+    }
+
+    QVector<int> offsets;
+    QVector<int> triangles;
+};
+
 ObjLoader::ObjLoader()
     : m_loadTextureCoords( true ),
       m_generateTangents( true ),
@@ -146,26 +549,22 @@ ObjLoader::ObjLoader()
 
 bool ObjLoader::load(const QString& fileName , const QString &subMesh)
 {
+    const QString cachePath = cacheFilePath(fileName, subMesh);
+    if (!cachePath.isEmpty() && loadFromCache(cachePath, fileName))
+        return true;
+
     QFile file(fileName);
-    if (!file.open(::QIODevice::ReadOnly|::QIODevice::Text)) {
+    if (!file.open(::QIODevice::ReadOnly)) {
         qCDebug(Render::Io) << "Could not open file" << fileName << "for reading";
         return false;
     }
 
-    return load(&file, subMesh);
-}
+    if (!load(&file, subMesh))
+        return false;
 
-static void addFaceVertex(const FaceIndices &faceIndices,
-                          QVector<FaceIndices> &faceIndexVector,
-                          QHash<FaceIndices, unsigned int> &faceIndexMap)
-{
-    if (faceIndices.positionIndex != std::numeric_limits<unsigned int>::max()) {
-        faceIndexVector.append(faceIndices);
-        if (!faceIndexMap.contains(faceIndices))
-            faceIndexMap.insert(faceIndices, faceIndexMap.size());
-    } else {
-        qCWarning(Render::Io) << "Missing position index";
-    }
+    if (!cachePath.isEmpty())
+        saveToCache(cachePath, fileName);
+    return true;
 }
 
 bool ObjLoader::load(::QIODevice *ioDev, const QString &subMesh)
@@ -176,156 +575,190 @@ bool ObjLoader::load(::QIODevice *ioDev, const QString &subMesh)
         return false;
     }
 
-    int faceCount = 0;
+    // Map files whenever possible so that the chunks can be parsed in
+    // place, fall back to reading everything in memory otherwise
+    QFileDevice *fileDevice = qobject_cast<QFileDevice *>(ioDev);
+    if (fileDevice && !ioDev->isSequential() && ioDev->pos() == 0) {
+        const qint64 size = fileDevice->size();
+        if (size == 0)
+            return parse(nullptr, nullptr, subMesh);
+        if (uchar *mapped = fileDevice->map(0, size)) {
+            const char *begin = reinterpret_cast<const char *>(mapped);
+            const bool result = parse(begin, begin + size, subMesh);
+            fileDevice->unmap(mapped);
+            return result;
+        }
+    }
 
-    // Parse faces taking into account each vertex in a face can index different indices
-    // for the positions, normals and texture coords;
-    // Generate unique vertices (in OpenGL parlance) and output to m_points, m_texCoords,
-    // m_normals and calculate mapping from faces to unique indices
-    QVector<QVector3D> positions;
-    QVector<QVector3D> normals;
-    QVector<QVector2D> texCoords;
-    QHash<FaceIndices, unsigned int> faceIndexMap;
-    QVector<FaceIndices> faceIndexVector;
+    const QByteArray data = ioDev->readAll();
+    return parse(data.constData(), data.constData() + data.size(), subMesh);
+}
+
+bool ObjLoader::parse(const char *begin, const char *end, const QString &subMesh)
+{
+    // Split the input at line boundaries and parse the chunks in parallel
+    QVector<ObjChunk> chunks;
+    {
+        const qint64 size = end - begin;
+        chunks.reserve(int(size / parseChunkSize) + 1);
+        const char *chunkBegin = begin;
+        while (chunkBegin < end) {
+            const char *chunkEnd = end;
+            if (end - chunkBegin > parseChunkSize) {
+                const char *newline = static_cast<const char *>(memchr(chunkBegin + parseChunkSize, '\n',
+                                                                      end - chunkBegin - parseChunkSize));
+                if (newline)
+                    chunkEnd = newline + 1;
+            }
+            ObjChunk chunk;
+            chunk.begin = chunkBegin;
+            chunk.end = chunkEnd;
+            chunk.loadTextureCoords = m_loadTextureCoords;
+            chunks.append(chunk);
+            chunkBegin = chunkEnd;
+        }
+    }
 
-    bool skipping = false;
-    int positionsOffset = 0;
-    int normalsOffset = 0;
-    int texCoordsOffset = 0;
+    if (chunks.size() > 1)
+        QtConcurrent::blockingMap(chunks, parseChunk);
+    else if (!chunks.isEmpty())
+        parseChunk(chunks.first());
 
+    // Merge the chunks in file order. Parts belonging to sub meshes not
+    // matching subMesh are skipped, the face indices of the following
+    // parts are shifted by the amount of skipped elements.
     QRegExp subMeshMatch(subMesh);
     if (!subMeshMatch.isValid())
         subMeshMatch.setPattern(QLatin1String("^(") + subMesh + QLatin1String(")$"));
     Q_ASSERT(subMeshMatch.isValid());
 
-    char lineBuffer[1024];
-    const char *line;
-    QByteArray longLine;
-    while (!ioDev->atEnd()) {
-        // try to read into lineBuffer first, if the line fits (common case) we can do this without expensive allocations
-        // if not, fall back to dynamically allocated QByteArrays
-        auto lineSize = ioDev->readLine(lineBuffer, sizeof(lineBuffer));
-        if (lineSize == sizeof(lineBuffer) - 1 && lineBuffer[lineSize - 1] != '\n') {
-            longLine = QByteArray(lineBuffer, lineSize);
-            longLine += ioDev->readLine();
-            line = longLine.constData();
-            lineSize = longLine.size();
-        } else {
-            line = lineBuffer;
-        }
-
-        if (lineSize > 0 && line[0] != '#') {
-            if (line[lineSize - 1] == '\n')
-                --lineSize; // chop newline
-
-            const ByteArraySplitter tokens(line, line + lineSize, ' ', QString::SkipEmptyParts);
+    struct FaceRange
+    {
+        const ObjChunk *chunk;
+        int begin;
+        int end;
+        unsigned int positionsOffset;
+        unsigned int texCoordsOffset;
+        unsigned int normalsOffset;
+        // Elements of the previous chunks, relative indices are based on it
+        unsigned int positionsStart;
+        unsigned int texCoordsStart;
+        unsigned int normalsStart;
+    };
 
-            if (qstrncmp(tokens.charPtrAt(0), "v ", 2) == 0) {
-                if (tokens.size() < 4) {
-                    qCWarning(Render::Io) << "Unsupported number of components in vertex";
-                } else {
-                    if (!skipping) {
-                        float x = tokens.floatAt(1);
-                        float y = tokens.floatAt(2);
-                        float z = tokens.floatAt(3);
-                        positions.append(QVector3D( x, y, z ));
-                    } else {
-                        positionsOffset++;
-                    }
-                }
-            } else if (m_loadTextureCoords && qstrncmp(tokens.charPtrAt(0), "vt ", 3) == 0) {
-                if (tokens.size() < 3) {
-                    qCWarning(Render::Io) << "Unsupported number of components in texture coordinate";
-                } else {
-                    if (!skipping) {
-                        // Process texture coordinate
-                        float s = tokens.floatAt(1);
-                        float t = tokens.floatAt(2);
-                        texCoords.append(QVector2D( s, t ));
-                    } else {
-                        texCoordsOffset++;
+    QVector<QVector3D> positions;
+    QVector<QVector3D> normals;
+    QVector<QVector2D> texCoords;
+    QVector<FaceRange> faceRanges;
+    int faceCount = 0;
+    int faceIndexCount = 0;
+    {
+        bool skipping = false;
+        unsigned int positionsOffset = 0;
+        unsigned int normalsOffset = 0;
+        unsigned int texCoordsOffset = 0;
+        unsigned int positionsStart = 0;
+        unsigned int normalsStart = 0;
+        unsigned int texCoordsStart = 0;
+
+        for (const ObjChunk &chunk : qAsConst(chunks)) {
+            faceCount += chunk.faceCount;
+            int position = 0, texCoord = 0, normal = 0, faceIndex = 0;
+            for (int m = 0, markerCount = chunk.markers.size(); m <= markerCount; ++m) {
+                const bool isLast = m == markerCount;
+                const int positionEnd = isLast ? chunk.positions.size() : chunk.markers[m].positionCount;
+                const int texCoordEnd = isLast ? chunk.texCoords.size() : chunk.markers[m].texCoordCount;
+                const int normalEnd = isLast ? chunk.normals.size() : chunk.markers[m].normalCount;
+                const int faceIndexEnd = isLast ? chunk.faceIndices.size() : chunk.markers[m].faceIndexCount;
+
+                if (!skipping) {
+                    positions += chunk.positions.mid(position, positionEnd - position);
+                    texCoords += chunk.texCoords.mid(texCoord, texCoordEnd - texCoord);
+                    normals += chunk.normals.mid(normal, normalEnd - normal);
+                    if (faceIndexEnd > faceIndex) {
+                        const FaceRange range = { &chunk, faceIndex, faceIndexEnd,
+                                                  positionsOffset, texCoordsOffset, normalsOffset,
+                                                  positionsStart, texCoordsStart, normalsStart };
+                        faceRanges.append(range);
+                        faceIndexCount += faceIndexEnd - faceIndex;
                     }
-                }
-            } else if (qstrncmp(tokens.charPtrAt(0), "vn ", 3) == 0) {
-                if (tokens.size() < 4) {
-                    qCWarning(Render::Io) << "Unsupported number of components in vertex normal";
                 } else {
-                    if (!skipping) {
-                        float x = tokens.floatAt(1);
-                        float y = tokens.floatAt(2);
-                        float z = tokens.floatAt(3);
-                        normals.append(QVector3D( x, y, z ));
-                    } else {
-                        normalsOffset++;
-                    }
+                    positionsOffset += positionEnd - position;
+                    texCoordsOffset += texCoordEnd - texCoord;
+                    normalsOffset += normalEnd - normal;
                 }
-            } else if (!skipping && qstrncmp(tokens.charPtrAt(0), "f ", 2) == 0) {
-                // Process face
-                ++faceCount;
 
-                int faceVertices = tokens.size() - 1;
+                if (!isLast && !subMesh.isEmpty())
+                    skipping = subMeshMatch.indexIn(chunk.markers[m].name) < 0;
 
-                QVarLengthArray<FaceIndices, 4> face; // try to avoid allocations in the common case of triangulated data
-                face.reserve(faceVertices);
+                position = positionEnd;
+                texCoord = texCoordEnd;
+                normal = normalEnd;
+                faceIndex = faceIndexEnd;
+            }
 
-                for (int i = 0; i < faceVertices; i++) {
-                    FaceIndices faceIndices;
-                    const ByteArraySplitter indices = tokens.splitterAt(i + 1, '/', QString::KeepEmptyParts);
-                    switch (indices.size()) {
-                    case 3:
-                        faceIndices.normalIndex = indices.intAt(2) - 1 - normalsOffset;  // fall through
-                    case 2:
-                        faceIndices.texCoordIndex = indices.intAt(1) - 1 - texCoordsOffset; // fall through
-                    case 1:
-                        faceIndices.positionIndex = indices.intAt(0) - 1 - positionsOffset;
-                        break;
-                    default:
-                        qCWarning(Render::Io) << "Unsupported number of indices in face element";
-                    }
+            positionsStart += chunk.positions.size();
+            texCoordsStart += chunk.texCoords.size();
+            normalsStart += chunk.normals.size();
+        }
+    }
 
-                    face.append(faceIndices);
-                }
+    // Generate unique vertices and output to m_points, m_texCoords and
+    // m_normals along with the indices referencing them
+    const bool hasTexCoords = !texCoords.isEmpty();
+    const bool hasNormals = !normals.isEmpty();
+    clear();
+    m_indices.reserve(faceIndexCount);
+    m_points.reserve(positions.size());
+
+    FaceIndexTable faceIndexTable(positions.size());
+    for (const FaceRange &range : qAsConst(faceRanges)) {
+        const FaceIndices *faceIndices = range.chunk->faceIndices.constData();
+        for (int i = range.begin; i + 2 < range.end; i += 3) {
+            FaceIndices triangle[3];
+            bool valid = true;
+            for (int j = 0; j < 3; ++j) {
+                const FaceIndices &f = faceIndices[i + j];
+                triangle[j].positionIndex = resolveIndex(f.positionIndex, range.positionsStart, range.positionsOffset);
+                if (triangle[j].positionIndex >= unsigned(positions.size()))
+                    valid = false;
+                if (hasTexCoords)
+                    triangle[j].texCoordIndex = resolveIndex(f.texCoordIndex, range.texCoordsStart, range.texCoordsOffset);
+                if (hasNormals)
+                    triangle[j].normalIndex = resolveIndex(f.normalIndex, range.normalsStart, range.normalsOffset);
+            }
 
-                // If number of edges in face is greater than 3,
-                // decompose into triangles as a triangle fan.
-                FaceIndices v0 = face[0];
-                FaceIndices v1 = face[1];
-                FaceIndices v2 = face[2];
-
-                // First face
-                addFaceVertex(v0, faceIndexVector, faceIndexMap);
-                addFaceVertex(v1, faceIndexVector, faceIndexMap);
-                addFaceVertex(v2, faceIndexVector, faceIndexMap);
-
-                for ( int i = 3; i < face.size(); ++i ) {
-                    v1 = v2;
-                    v2 = face[i];
-                    addFaceVertex(v0, faceIndexVector, faceIndexMap);
-                    addFaceVertex(v1, faceIndexVector, faceIndexMap);
-                    addFaceVertex(v2, faceIndexVector, faceIndexMap);
-                }
+            if (Q_UNLIKELY(!valid)) {
+                qCWarning(Render::Io) << "Missing position index";
+                continue;
+            }
 
-                // end of face
-            } else if (qstrncmp(tokens.charPtrAt(0), "o ", 2) == 0) {
-                if (tokens.size() < 2) {
-                    qCWarning(Render::Io) << "Missing submesh name";
-                } else {
-                    if (!subMesh.isEmpty() ) {
-                        const QString objName = tokens.stringAt(1);
-                        skipping = subMeshMatch.indexIn(objName) < 0;
-                    }
+            for (const FaceIndices &f : triangle) {
+                bool inserted = false;
+                const unsigned int index = faceIndexTable.findOrInsert(f, &inserted);
+                if (inserted) {
+                    m_points.append(positions[f.positionIndex]);
+                    if (hasTexCoords)
+                        m_texCoords.append(f.texCoordIndex < unsigned(texCoords.size()) ? texCoords[f.texCoordIndex] : QVector2D());
+                    if (hasNormals)
+                        m_normals.append(f.normalIndex < unsigned(normals.size()) ? normals[f.normalIndex] : QVector3D());
                 }
+                m_indices.append(index);
             }
-        } // empty input line
-    } // while (!ioDev->atEnd())
+        }
+    }
 
-    updateIndices(positions, normals, texCoords, faceIndexMap, faceIndexVector);
+    const bool needsNormals = m_normals.isEmpty();
+    const bool needsTangents = m_generateTangents && !m_texCoords.isEmpty();
+    if (needsNormals || needsTangents) {
+        const TriangleAdjacency adjacency(m_indices, m_points.size());
 
-    if (m_normals.isEmpty())
-        generateAveragedNormals(m_points, m_normals, m_indices);
+        if (needsNormals)
+            generateAveragedNormals(m_points, m_normals, m_indices, adjacency);
 
-    if (m_generateTangents && !m_texCoords.isEmpty())
-        generateTangents(m_points, m_normals, m_indices, m_texCoords, m_tangents);
+        if (needsTangents)
+            generateTangents(m_points, m_normals, m_indices, m_texCoords, m_tangents, adjacency);
+    }
 
     if (m_centerMesh)
         center(m_points);
@@ -341,6 +774,135 @@ bool ObjLoader::load(::QIODevice *ioDev, const QString &subMesh)
     return true;
 }
 
+QString ObjLoader::cacheFilePath(const QString &fileName, const QString &subMesh) const
+{
+    if (m_cacheDirectory.isEmpty())
+        return QString();
+
+    const QFileInfo info(fileName);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(info.absoluteFilePath().toUtf8());
+    hash.addData(subMesh.toUtf8());
+    const char flags[] = { char(m_loadTextureCoords), char(m_generateTangents), char(m_centerMesh) };
+    hash.addData(flags, sizeof(flags));
+
+    return QDir(m_cacheDirectory).filePath(QString::fromLatin1(hash.result().toHex() + ".objcache"));
+}
+
+bool ObjLoader::loadFromCache(const QString &cachePath, const QString &fileName)
+{
+    const QFileInfo sourceInfo(fileName);
+    if (!sourceInfo.lastModified().isValid())
+        return false;
+
+    QFile file(cachePath);
+    if (!file.open(::QIODevice::ReadOnly) || file.size() < qint64(sizeof(ObjCacheHeader)))
+        return false;
+
+    const uchar *mapped = file.map(0, file.size());
+    if (!mapped)
+        return false;
+
+    ObjCacheHeader header;
+    memcpy(&header, mapped, sizeof(header));
+    if (header.magic != objCacheMagic || header.version != objCacheVersion
+            || header.byteOrder != objCacheByteOrder || header.elementSizes != objCacheElementSizes) {
+        qCDebug(Render::Io) << "Discarding incompatible mesh cache" << cachePath << "for" << fileName;
+        return false;
+    }
+
+    const qint64 expectedSize = qint64(sizeof(header))
+            + qint64(header.pointCount) * sizeof(QVector3D)
+            + qint64(header.normalCount) * sizeof(QVector3D)
+            + qint64(header.texCoordCount) * sizeof(QVector2D)
+            + qint64(header.tangentCount) * sizeof(QVector4D)
+            + qint64(header.indexCount) * sizeof(unsigned int);
+    if (header.sourceModified != sourceInfo.lastModified().toMSecsSinceEpoch()
+            || header.sourceSize != sourceInfo.size()
+            || expectedSize != file.size()) {
+        qCDebug(Render::Io) << "Discarding stale mesh cache" << cachePath << "for" << fileName;
+        return false;
+    }
+
+    // Every vertex attribute is either missing or given for each point
+    const auto isValidCount = [&header] (quint32 count) {
+        return count == 0 || count == header.pointCount;
+    };
+    if (header.pointCount > quint32(std::numeric_limits<int>::max())
+            || header.indexCount > quint32(std::numeric_limits<int>::max())
+            || header.indexCount % 3 != 0
+            || !isValidCount(header.normalCount)
+            || !isValidCount(header.texCoordCount)
+            || !isValidCount(header.tangentCount)) {
+        qCDebug(Render::Io) << "Discarding corrupted mesh cache" << cachePath << "for" << fileName;
+        return false;
+    }
+
+    const char *p = reinterpret_cast<const char *>(mapped) + sizeof(header);
+    p = readCacheArray(p, header.pointCount, m_points);
+    p = readCacheArray(p, header.normalCount, m_normals);
+    p = readCacheArray(p, header.texCoordCount, m_texCoords);
+    p = readCacheArray(p, header.tangentCount, m_tangents);
+    readCacheArray(p, header.indexCount, m_indices);
+
+    for (unsigned int index : qAsConst(m_indices)) {
+        if (Q_UNLIKELY(index >= header.pointCount)) {
+            qCDebug(Render::Io) << "Discarding corrupted mesh cache" << cachePath << "for" << fileName;
+            clear();
+            return false;
+        }
+    }
+
+    qCDebug(Render::Io) << "Loaded mesh" << fileName << "from cache" << cachePath;
+    return true;
+}
+
+void ObjLoader::saveToCache(const QString &cachePath, const QString &fileName) const
+{
+    const QFileInfo sourceInfo(fileName);
+    if (!sourceInfo.lastModified().isValid())
+        return;
+
+    QDir().mkpath(m_cacheDirectory);
+    QSaveFile file(cachePath);
+    if (!file.open(::QIODevice::WriteOnly)) {
+        qCDebug(Render::Io) << "Could not open mesh cache" << cachePath << "for writing";
+        return;
+    }
+
+    ObjCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = objCacheMagic;
+    header.version = objCacheVersion;
+    header.byteOrder = objCacheByteOrder;
+    header.elementSizes = objCacheElementSizes;
+    header.sourceModified = sourceInfo.lastModified().toMSecsSinceEpoch();
+    header.sourceSize = sourceInfo.size();
+    header.pointCount = m_points.size();
+    header.normalCount = m_normals.size();
+    header.texCoordCount = m_texCoords.size();
+    header.tangentCount = m_tangents.size();
+    header.indexCount = m_indices.size();
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writeCacheArray(&file, m_points);
+    writeCacheArray(&file, m_normals);
+    writeCacheArray(&file, m_texCoords);
+    writeCacheArray(&file, m_tangents);
+    writeCacheArray(&file, m_indices);
+    if (!file.commit())
+        qCDebug(Render::Io) << "Could not write mesh cache" << cachePath;
+}
+
+void ObjLoader::clear()
+{
+    m_points.clear();
+    m_texCoords.clear();
+    m_normals.clear();
+    m_tangents.clear();
+    m_indices.clear();
+}
+
 QGeometry *ObjLoader::geometry() const
 {
     QByteArray bufferBytes;
@@ -350,31 +912,34 @@ QGeometry *ObjLoader::geometry() const
             + (hasTangents() ? 4 : 0);
     const quint32 stride = elementSize * sizeof(float);
     bufferBytes.resize(stride * count);
-    float* fptr = reinterpret_cast<float*>(bufferBytes.data());
-
-    for (int index = 0; index < count; ++index) {
-        *fptr++ = m_points.at(index).x();
-        *fptr++ = m_points.at(index).y();
-        *fptr++ = m_points.at(index).z();
-
-        if (hasTextureCoordinates()) {
-            *fptr++ = m_texCoords.at(index).x();
-            *fptr++ = m_texCoords.at(index).y();
-        }
+    float *bufferData = reinterpret_cast<float*>(bufferBytes.data());
+
+    parallelFor(count, [=] (int begin, int end) {
+        float *fptr = bufferData + begin * elementSize;
+        for (int index = begin; index < end; ++index) {
+            *fptr++ = m_points.at(index).x();
+            *fptr++ = m_points.at(index).y();
+            *fptr++ = m_points.at(index).z();
+
+            if (hasTextureCoordinates()) {
+                *fptr++ = m_texCoords.at(index).x();
+                *fptr++ = m_texCoords.at(index).y();
+            }
 
-        if (hasNormals()) {
-            *fptr++ = m_normals.at(index).x();
-            *fptr++ = m_normals.at(index).y();
-            *fptr++ = m_normals.at(index).z();
-        }
+            if (hasNormals()) {
+                *fptr++ = m_normals.at(index).x();
+                *fptr++ = m_normals.at(index).y();
+                *fptr++ = m_normals.at(index).z();
+            }
 
-        if (hasTangents()) {
-            *fptr++ = m_tangents.at(index).x();
-            *fptr++ = m_tangents.at(index).y();
-            *fptr++ = m_tangents.at(index).z();
-            *fptr++ = m_tangents.at(index).w();
+            if (hasTangents()) {
+                *fptr++ = m_tangents.at(index).x();
+                *fptr++ = m_tangents.at(index).y();
+                *fptr++ = m_tangents.at(index).z();
+                *fptr++ = m_tangents.at(index).w();
+            }
         }
-    } // of buffer filling loop
+    }); // of buffer filling loop
 
     QBuffer *buf(new QBuffer(QBuffer::VertexBuffer));
     buf->setData(bufferBytes);
@@ -428,126 +993,99 @@ QGeometry *ObjLoader::geometry() const
     return geometry;
 }
 
-void ObjLoader::updateIndices(const QVector<QVector3D> &positions,
-                              const QVector<QVector3D> &normals,
-                              const QVector<QVector2D> &texCoords,
-                              const QHash<FaceIndices, unsigned int> &faceIndexMap,
-                              const QVector<FaceIndices> &faceIndexVector)
-{
-    // Iterate over the faceIndexMap and pull out pos, texCoord and normal data
-    // thereby generating unique vertices of data (by OpenGL definition)
-    const int vertexCount = faceIndexMap.size();
-    const bool hasTexCoords = !texCoords.isEmpty();
-    const bool hasNormals = !normals.isEmpty();
-
-    m_points.resize(vertexCount);
-    m_texCoords.clear();
-    if (hasTexCoords)
-        m_texCoords.resize(vertexCount);
-    m_normals.clear();
-    if (hasNormals)
-        m_normals.resize(vertexCount);
-
-    for (QHash<FaceIndices, unsigned int>::const_iterator it = faceIndexMap.begin(), endIt = faceIndexMap.end(); it != endIt; ++it) {
-        m_points[it.value()] = positions[it.key().positionIndex];
-        if (hasTexCoords)
-            m_texCoords[it.value()] = std::numeric_limits<unsigned int>::max() != it.key().texCoordIndex ? texCoords[it.key().texCoordIndex] : QVector2D();
-        if (hasNormals)
-            m_normals[it.value()] = normals[it.key().normalIndex];
-    }
-
-    // Now iterate over the face indices and lookup the unique vertex index
-    const int indexCount = faceIndexVector.size();
-    m_indices.clear();
-    m_indices.reserve(indexCount);
-    for (const FaceIndices faceIndices : faceIndexVector) {
-        const unsigned int i = faceIndexMap.value(faceIndices);
-        m_indices.append(i);
-    }
-}
-
 void ObjLoader::generateAveragedNormals( const QVector<QVector3D>& points,
                                          QVector<QVector3D>& normals,
-                                         const QVector<unsigned int>& faces ) const
+                                         const QVector<unsigned int>& faces,
+                                         const TriangleAdjacency &adjacency ) const
 {
-    for ( int i = 0; i < points.size(); ++i )
-        normals.append( QVector3D() );
-
-    for ( int i = 0; i < faces.size(); i += 3 )
-    {
-        const QVector3D& p1 = points[ faces[i]   ];
-        const QVector3D& p2 = points[ faces[i+1] ];
-        const QVector3D& p3 = points[ faces[i+2] ];
-
-        QVector3D a = p2 - p1;
-        QVector3D b = p3 - p1;
-        QVector3D n = QVector3D::crossProduct( a, b ).normalized();
-
-        normals[ faces[i]   ] += n;
-        normals[ faces[i+1] ] += n;
-        normals[ faces[i+2] ] += n;
-    }
-
-    for ( int i = 0; i < normals.size(); ++i )
-        normals[i].normalize();
+    const int triangleCount = faces.size() / 3;
+    QVector<QVector3D> faceNormals(triangleCount);
+
+    parallelFor(triangleCount, [&] (int begin, int end) {
+        for ( int t = begin; t < end; ++t )
+        {
+            const QVector3D& p1 = points[ faces[3 * t]     ];
+            const QVector3D& p2 = points[ faces[3 * t + 1] ];
+            const QVector3D& p3 = points[ faces[3 * t + 2] ];
+
+            QVector3D a = p2 - p1;
+            QVector3D b = p3 - p1;
+            faceNormals[t] = QVector3D::crossProduct( a, b ).normalized();
+        }
+    });
+
+    // Gather the face normals of the adjacent triangles of each vertex
+    normals.resize(points.size());
+    parallelFor(points.size(), [&] (int begin, int end) {
+        for ( int i = begin; i < end; ++i )
+        {
+            QVector3D n;
+            for ( int j = adjacency.offsets[i]; j < adjacency.offsets[i + 1]; ++j )
+                n += faceNormals[ adjacency.triangles[j] ];
+            normals[i] = n.normalized();
+        }
+    });
 }
 
 void ObjLoader::generateTangents( const QVector<QVector3D>& points,
                                   const QVector<QVector3D>& normals,
                                   const QVector<unsigned  int>& faces,
                                   const QVector<QVector2D>& texCoords,
-                                  QVector<QVector4D>& tangents ) const
+                                  QVector<QVector4D>& tangents,
+                                  const TriangleAdjacency &adjacency ) const
 {
-    tangents.clear();
-    QVector<QVector3D> tan1Accum;
-    QVector<QVector3D> tan2Accum;
-
-    tan1Accum.resize(points.size());
-    tan2Accum.resize(points.size());
-    tangents.resize(points.size());
+    const int triangleCount = faces.size() / 3;
+    QVector<QVector3D> tan1PerFace(triangleCount);
+    QVector<QVector3D> tan2PerFace(triangleCount);
 
     // Compute the tangent vector
-    for ( int i = 0; i < faces.size(); i += 3 )
-    {
-        const QVector3D& p1 = points[ faces[i] ];
-        const QVector3D& p2 = points[ faces[i+1] ];
-        const QVector3D& p3 = points[ faces[i+2] ];
-
-        const QVector2D& tc1 = texCoords[ faces[i] ];
-        const QVector2D& tc2 = texCoords[ faces[i+1] ];
-        const QVector2D& tc3 = texCoords[ faces[i+2] ];
-
-        QVector3D q1 = p2 - p1;
-        QVector3D q2 = p3 - p1;
-        float s1 = tc2.x() - tc1.x(), s2 = tc3.x() - tc1.x();
-        float t1 = tc2.y() - tc1.y(), t2 = tc3.y() - tc1.y();
-        float r = 1.0f / ( s1 * t2 - s2 * t1 );
-        QVector3D tan1( ( t2 * q1.x() - t1 * q2.x() ) * r,
-                        ( t2 * q1.y() - t1 * q2.y() ) * r,
-                        ( t2 * q1.z() - t1 * q2.z() ) * r );
-        QVector3D tan2( ( s1 * q2.x() - s2 * q1.x() ) * r,
-                        ( s1 * q2.y() - s2 * q1.y() ) * r,
-                        ( s1 * q2.z() - s2 * q1.z() ) * r );
-        tan1Accum[ faces[i]   ] += tan1;
-        tan1Accum[ faces[i+1] ] += tan1;
-        tan1Accum[ faces[i+2] ] += tan1;
-        tan2Accum[ faces[i]   ] += tan2;
-        tan2Accum[ faces[i+1] ] += tan2;
-        tan2Accum[ faces[i+2] ] += tan2;
-    }
+    parallelFor(triangleCount, [&] (int begin, int end) {
+        for ( int t = begin; t < end; ++t )
+        {
+            const int i = 3 * t;
+            const QVector3D& p1 = points[ faces[i] ];
+            const QVector3D& p2 = points[ faces[i+1] ];
+            const QVector3D& p3 = points[ faces[i+2] ];
+
+            const QVector2D& tc1 = texCoords[ faces[i] ];
+            const QVector2D& tc2 = texCoords[ faces[i+1] ];
+            const QVector2D& tc3 = texCoords[ faces[i+2] ];
+
+            QVector3D q1 = p2 - p1;
+            QVector3D q2 = p3 - p1;
+            float s1 = tc2.x() - tc1.x(), s2 = tc3.x() - tc1.x();
+            float t1 = tc2.y() - tc1.y(), t2 = tc3.y() - tc1.y();
+            float r = 1.0f / ( s1 * t2 - s2 * t1 );
+            tan1PerFace[t] = QVector3D( ( t2 * q1.x() - t1 * q2.x() ) * r,
+                                        ( t2 * q1.y() - t1 * q2.y() ) * r,
+                                        ( t2 * q1.z() - t1 * q2.z() ) * r );
+            tan2PerFace[t] = QVector3D( ( s1 * q2.x() - s2 * q1.x() ) * r,
+                                        ( s1 * q2.y() - s2 * q1.y() ) * r,
+                                        ( s1 * q2.z() - s2 * q1.z() ) * r );
+        }
+    });
 
-    for ( int i = 0; i < points.size(); ++i )
-    {
-        const QVector3D& n = normals[i];
-        const QVector3D& t1 = tan1Accum[i];
-        const QVector3D& t2 = tan2Accum[i];
+    tangents.clear();
+    tangents.resize(points.size());
+    parallelFor(points.size(), [&] (int begin, int end) {
+        for ( int i = begin; i < end; ++i )
+        {
+            QVector3D t1;
+            QVector3D t2;
+            for ( int j = adjacency.offsets[i]; j < adjacency.offsets[i + 1]; ++j ) {
+                t1 += tan1PerFace[ adjacency.triangles[j] ];
+                t2 += tan2PerFace[ adjacency.triangles[j] ];
+            }
 
-        // Gram-Schmidt orthogonalize
-        tangents[i] = QVector4D( QVector3D( t1 - QVector3D::dotProduct( n, t1 ) * n ).normalized(), 0.0f );
+            const QVector3D& n = normals[i];
 
-        // Store handedness in w
-        tangents[i].setW( ( QVector3D::dotProduct( QVector3D::crossProduct( n, t1 ), t2 ) < 0.0f ) ? -1.0f : 1.0f );
-    }
+            // Gram-Schmidt orthogonalize
+            tangents[i] = QVector4D( QVector3D( t1 - QVector3D::dotProduct( n, t1 ) * n ).normalized(), 0.0f );
+
+            // Store handedness in w
+            tangents[i].setW( ( QVector3D::dotProduct( QVector3D::crossProduct( n, t1 ), t2 ) < 0.0f ) ? -1.0f : 1.0f );
+        }
+    });
 }
 
 void ObjLoader::center( QVector<QVector3D>& points )
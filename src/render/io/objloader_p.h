@@ -53,6 +53,7 @@
 
 #include <Qt3DCore/qt3dcore_global.h>
 
+#include <QString>
 #include <QVector>
 #include <QVector2D>
 #include <QVector3D>
@@ -110,6 +111,11 @@ public:
     void setMeshCenteringEnabled( bool b ) { m_centerMesh = b; }
     bool isMeshCenteringEnabled() const { return m_centerMesh; }
 
+    // When set, meshes loaded from files are stored in and reloaded from
+    // a binary cache in that directory, keyed by file path and mtime
+    void setCacheDirectory( const QString &path ) { m_cacheDirectory = path; }
+    QString cacheDirectory() const { return m_cacheDirectory; }
+
     bool hasNormals() const { return !m_normals.isEmpty(); }
     bool hasTextureCoordinates() const { return !m_texCoords.isEmpty(); }
     bool hasTangents() const { return !m_tangents.isEmpty(); }
@@ -126,24 +132,30 @@ public:
     QGeometry *geometry() const;
 
 private:
-    void updateIndices(const QVector<QVector3D> &positions,
-                       const QVector<QVector3D> &normals,
-                       const QVector<QVector2D> &texCoords,
-                       const QHash<FaceIndices, unsigned int> &faceIndexMap,
-                       const QVector<FaceIndices> &faceIndexVector);
+    struct TriangleAdjacency;
+
+    bool parse(const char *begin, const char *end, const QString &subMesh);
+    void clear();
+    bool loadFromCache(const QString &cachePath, const QString &fileName);
+    void saveToCache(const QString &cachePath, const QString &fileName) const;
+    QString cacheFilePath(const QString &fileName, const QString &subMesh) const;
+
     void generateAveragedNormals( const QVector<QVector3D>& points,
                                   QVector<QVector3D>& normals,
-                                  const QVector<unsigned int>& faces ) const;
+                                  const QVector<unsigned int>& faces,
+                                  const TriangleAdjacency &adjacency ) const;
     void generateTangents( const QVector<QVector3D>& points,
                            const QVector<QVector3D>& normals,
                            const QVector<unsigned int>& faces,
                            const QVector<QVector2D>& texCoords,
-                           QVector<QVector4D>& tangents ) const;
+                           QVector<QVector4D>& tangents,
+                           const TriangleAdjacency &adjacency ) const;
     void center( QVector<QVector3D>& points );
 
     bool m_loadTextureCoords;
     bool m_generateTangents;
     bool m_centerMesh;
+    QString m_cacheDirectory;
 
     QVector<QVector3D> m_points;
     QVector<QVector3D> m_normals;
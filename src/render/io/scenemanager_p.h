@@ -77,6 +77,7 @@ public:
 
     void addSceneData(const QUrl &source, Qt3DCore::QNodeId sceneUuid);
     QVector<LoadSceneJobPtr> pendingSceneLoaderJobs();
+    bool hasPendingSceneLoaderJobs() const { return !m_pendingJobs.isEmpty(); }
 
 private:
     QVector<LoadSceneJobPtr> m_pendingJobs;
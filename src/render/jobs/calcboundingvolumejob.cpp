@@ -141,6 +141,9 @@ void calculateLocalBoundingVolume(NodeManagers *manager, Entity *node)
 
                     node->localBoundingVolume()->initializeFromPoints(vertices);
                     node->unsetBoundingVolumeDirty();
+
+                    // Positions may have changed, triangles will be gathered again on next pick
+                    gRenderer->invalidateTriangleVolumeHierarchy();
                 }
             }
         }
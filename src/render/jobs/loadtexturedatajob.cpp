@@ -41,6 +41,7 @@
 #include <Qt3DRender/private/nodemanagers_p.h>
 #include <Qt3DRender/private/managers_p.h>
 #include <Qt3DRender/private/texturedatamanager_p.h>
+#include <Qt3DRender/private/texturedecodequeue_p.h>
 #include <Qt3DRender/private/qtextureimage_p.h>
 #include <Qt3DRender/qtextureimagedata.h>
 #include <Qt3DRender/qtexturedata.h>
@@ -57,46 +58,46 @@ namespace {
 
 typedef QPair<HTextureData, QTextureImageData *> HandleDataPair;
 
-HandleDataPair textureDataFromGenerator(TextureDataManager *textureDataManager,
-                                        QTextureImageDataGeneratorPtr generator)
+// Returns false if the generator still has to be decoded, in which case
+// the decode queue will reschedule a job for the texture once it is done
+bool textureDataFromGenerator(TextureDataManager *textureDataManager,
+                              QTextureImageDataGeneratorPtr generator,
+                              Qt3DCore::QNodeId textureId,
+                              HandleDataPair *handleData)
 {
-    HTextureData textureDataHandle;
-    QTextureImageData *data = nullptr;
-
     QMutexLocker locker(textureDataManager->mutex());
     // We don't want to take the chance of having two jobs uploading the same functor
     // because of sync issues
 
-    textureDataHandle = textureDataManager->textureDataFromFunctor(generator);
+    const HTextureData textureDataHandle = textureDataManager->textureDataFromFunctor(generator);
 
     // Texture data handle isn't null == there's already a matching TextureData
     if (!textureDataHandle.isNull()) {
-        data = textureDataManager->data(textureDataHandle);
-    } else {
-        // Texture data is null -> we need to generate it
-        QTextureImageDataPtr dataPtr = generator->operator ()();
-        if (dataPtr.isNull()) {
-            qCDebug(Jobs) << Q_FUNC_INFO << "Texture has no raw data";
-        } else {
-            // Save the QTextureImageDataPtr with it's functor as a key
-            textureDataHandle = textureDataManager->acquire();
-            data = textureDataManager->data(textureDataHandle);
-            *data = *(dataPtr.data());
-            textureDataManager->addTextureDataForFunctor(textureDataHandle, generator);
-        }
+        *handleData = qMakePair(textureDataHandle, textureDataManager->data(textureDataHandle));
+        return true;
     }
 
-    return qMakePair(textureDataHandle, data);
+    // Texture data is null -> we need to generate it in the background,
+    // unless the generator has already failed to provide any data
+    if (textureDataManager->decodeQueue()->enqueue(generator, textureId))
+        return false;
+
+    qCDebug(Jobs) << Q_FUNC_INFO << "Texture has no raw data";
+    *handleData = HandleDataPair(HTextureData(), nullptr);
+    return true;
 }
 
 void createTextureFromGenerator(TextureDataManager *textureDataManager,
-                                Texture *texture)
+                                Texture *texture,
+                                const QTextureDataPtr &generatedData)
 {
-    QTextureGeneratorPtr generator = texture->dataGenerator();
-    const QTextureDataPtr generatedData = generator->operator ()();
-
     // TO DO set the status of the texture based on the status of the functor
 
+    if (generatedData.isNull()) {
+        qWarning() << "Texture generator failed to provide any data";
+        return;
+    }
+
     // Use the first QTexImageData loaded to determine the target / mipmaps
     // if not specified
 
@@ -109,7 +110,8 @@ void createTextureFromGenerator(TextureDataManager *textureDataManager,
     texture->setFormat(generatedData->format());
 
     // Note: These texture data handles aren't associated with a QTextureImageDataGenerator
-    // and will therefore be destroyed when the Texture element is destroyed or cleaned up
+    // and will therefore be released when the Texture element is destroyed or cleaned up
+    // They may be shared with other textures loading the same content
     const QVector<QTextureImageDataPtr> imageData = generatedData->imageData();
 
     if (imageData.size() > 0) {
@@ -122,10 +124,12 @@ void createTextureFromGenerator(TextureDataManager *textureDataManager,
             texture->setMipLevels(imageData.first()->mipLevels());
 
         for (QTextureImageDataPtr dataPtr : imageData) {
-            HTextureData textureDataHandle = textureDataManager->acquire();
-            QTextureImageData *data = textureDataManager->data(textureDataHandle);
-            *data = *(dataPtr.data());
+            bool shared = false;
+            HTextureData textureDataHandle = textureDataManager->addTextureData(*dataPtr, &shared);
             texture->addTextureDataHandle(textureDataHandle);
+            if (!shared)
+                textureDataManager->decodeQueue()->trackPendingUpload(textureDataHandle,
+                                                                      TextureDecodeQueue::byteSize(dataPtr.data()));
         }
     }
 }
@@ -150,13 +154,32 @@ void LoadTextureDataJob::run()
     TextureDataManager *textureDataManager = m_manager->manager<QTextureImageData, TextureDataManager>();
 
     if (txt != nullptr) {
-        // We need to clear the TextureData handles of the texture in case it was previously
-        // loaded with a different functor
-        txt->releaseTextureDataHandles();
+        TextureDecodeQueue *decodeQueue = textureDataManager->decodeQueue();
+        bool dataUpdated = false;
 
         // If the texture has a functor we used it to generate embedded TextureImages
-        if (txt->dataGenerator())
-            createTextureFromGenerator(textureDataManager, txt);
+        // The previous TextureData handles are kept until the new data is available
+        // so that the texture remains usable while its generator is decoded
+        const QTextureGeneratorPtr textureGenerator = txt->dataGenerator();
+        if (textureGenerator) {
+            QTextureDataPtr generatedData;
+            if (decodeQueue->takeTextureData(m_textureId, textureGenerator, &generatedData)) {
+                txt->releaseTextureDataHandles();
+                createTextureFromGenerator(textureDataManager, txt, generatedData);
+                dataUpdated = true;
+            } else {
+                decodeQueue->enqueue(textureGenerator, m_textureId);
+            }
+        } else {
+            // Drop what was decoded for a generator the texture doesn't use anymore
+            decodeQueue->removeTexture(m_textureId);
+            if (!txt->textureDataHandles().isEmpty()) {
+                // We need to clear the TextureData handles of the texture in case it was previously
+                // loaded with a different functor
+                txt->releaseTextureDataHandles();
+                dataUpdated = true;
+            }
+        }
 
         // Load update each TextureImage
         const auto texImgHandles = txt->textureImages();
@@ -165,7 +188,9 @@ void LoadTextureDataJob::run()
             if (texImg != nullptr && texImg->isDirty() && !texImg->dataGenerator().isNull()) {
                 QTextureImageDataGeneratorPtr generator = texImg->dataGenerator();
 
-                QPair<HTextureData, QTextureImageData *> handleData = textureDataFromGenerator(textureDataManager, generator);
+                HandleDataPair handleData;
+                if (!textureDataFromGenerator(textureDataManager, generator, m_textureId, &handleData))
+                    continue;
 
                 // If using QTextureImage, notify the frontend of the change in status
                 const QImageTextureDataFunctor *imageGenerator = functor_cast<QImageTextureDataFunctor>(generator.data());
@@ -206,11 +231,16 @@ void LoadTextureDataJob::run()
                 texImg->setTextureDataHandle(textureDataHandle);
                 if (data)
                     texImg->updateDNA(::qHash(QTextureImageDataPrivate::get(data)->m_data));
+                dataUpdated = true;
             }
         }
         // Tell the renderer to reload/upload to GPU the TextureImage for the Texture
         // next frame
-        txt->requestTextureDataUpdate();
+        if (dataUpdated)
+            txt->requestTextureDataUpdate();
+    } else {
+        // The texture was destroyed before its decoded data was taken
+        textureDataManager->decodeQueue()->removeTexture(m_textureId);
     }
 }
 
@@ -51,7 +51,7 @@
 #include <Qt3DRender/private/managers_p.h>
 #include <Qt3DRender/private/sphere_p.h>
 #include <Qt3DRender/private/geometryrenderer_p.h>
-#include <Qt3DRender/private/trianglesvisitor_p.h>
+#include <Qt3DRender/private/boundingvolumehierarchy_p.h>
 #include <Qt3DRender/private/qraycastingservice_p.h>
 #include <Qt3DRender/private/rendersurfaceselector_p.h>
 #include <Qt3DRender/private/rendersettings_p.h>
@@ -146,127 +146,20 @@ public:
 
 };
 
-static QVector<Entity *> gatherEntities(Entity *entity, QVector<Entity *> entities)
-{
-    if (entity != nullptr) {
-        entities.push_back(entity);
-        // Traverse children
-        const auto children = entity->children();
-        for (Entity *child : children)
-            entities = gatherEntities(child, std::move(entities));
-    }
-    return entities;
-}
-
-class EntityGatherer
-{
-public:
-    explicit EntityGatherer(Entity *root)
-        : m_root(root)
-        , m_needsRefresh(true)
-    {
-    }
+typedef QVector<QCollisionQueryResult::Hit> HitList;
 
-    QVector<Entity *> entities() const
-    {
-        if (m_needsRefresh) {
-            m_entities.clear();
-            m_entities = gatherEntities(m_root, std::move(m_entities));
-            m_needsRefresh = false;
-        }
-        return m_entities;
-    }
-
-private:
-    Entity *m_root;
-    mutable QVector<Entity *> m_entities;
-    mutable bool m_needsRefresh;
-};
-
-class CollisionVisitor : public TrianglesVisitor
+// Hits on entities without an ObjectPicker, or a parent with one, are
+// discarded by the collision functors. They can't occlude the entities behind
+// them and don't need to be tested against the ray at all
+void gatherPickableEntities(Entity *entity, bool parentHasPicker, QVector<HEntity> &entities)
 {
-public:
-    typedef QVector<QCollisionQueryResult::Hit> HitList;
-    HitList hits;
-
-    CollisionVisitor(NodeManagers* manager, const Entity *root, const QRay3D& ray, QPickingSettings::FaceOrientationPickingMode faceOrientationPickingMode) : TrianglesVisitor(manager), m_root(root), m_ray(ray), m_faceOrientationPickingMode(faceOrientationPickingMode), m_triangleIndex(0) { }
-private:
-    const Entity *m_root;
-    QRay3D m_ray;
-    QPickingSettings::FaceOrientationPickingMode m_faceOrientationPickingMode;
-    uint m_triangleIndex;
-
-    void visit(uint andx, const QVector3D &a,
-               uint bndx, const QVector3D &b,
-               uint cndx, const QVector3D &c)
-    {
-        const QMatrix4x4* mat = m_root->worldTransform();
-        const QVector3D tA = *mat * a;
-        const QVector3D tB = *mat * b;
-        const QVector3D tC = *mat * c;
-
-        float t = 0.f;
-        QVector3D uvw;
-        bool intersects = intersectsSegmentTriangle(m_ray, tC, tB, tA, uvw, t);
-        if (intersects) {
-            QCollisionQueryResult::Hit queryResult;
-            queryResult.m_intersection = m_ray.point(t * m_ray.distance());
-            queryResult.m_distance = m_ray.projectedDistance(queryResult.m_intersection);
-            queryResult.m_entityId = m_root->peerId();
-            queryResult.m_vertexIndex[0] = andx;
-            queryResult.m_vertexIndex[1] = bndx;
-            queryResult.m_vertexIndex[2] = cndx;
-            hits.push_back(queryResult);
-        }
-
-        m_triangleIndex++;
-    }
-
-    // Note: a, b, c in clockwise order
-    // RealTime Collision Detection page 192
-    bool intersectsSegmentTriangle(const QRay3D &ray,
-                                   const QVector3D &a,
-                                   const QVector3D &b,
-                                   const QVector3D &c,
-                                   QVector3D &uvw,
-                                   float &t)
-    {
-        const QVector3D ab = b - a;
-        const QVector3D ac = c - a;
-        const QVector3D qp = (ray.origin() - ray.point(ray.distance()));
-
-        const QVector3D n = QVector3D::crossProduct(ab, ac);
-        const float d = QVector3D::dotProduct(qp, n);
-
-        if (d <= 0.0f && 0 == (m_faceOrientationPickingMode & QPickingSettings::BackFace))
-            return false;
-
-        const QVector3D ap = ray.origin() - a;
-        t = QVector3D::dotProduct(ap, n);
-
-        if (t < 0.0f || t > d)
-            return false;
-
-        const QVector3D e = QVector3D::crossProduct(qp, ap);
-        uvw.setY(QVector3D::dotProduct(ac, e));
-
-        if (uvw.y() < 0.0f || uvw.y() > d)
-            return false;
-
-        uvw.setZ(-QVector3D::dotProduct(ab, e));
-
-        if (uvw.z() < 0.0f || uvw.y() + uvw.z() > d)
-            return false;
-
-        const float ood = 1.0f / d;
-        t *= ood;
-        uvw.setY(uvw.y() * ood);
-        uvw.setZ(uvw.z() * ood);
-        uvw.setX(1.0f - uvw.y() - uvw.z());
-
-        return true;
-    }
-};
+    const bool hasPicker = parentHasPicker || !entity->componentHandle<ObjectPicker, 16>().isNull();
+    if (hasPicker)
+        entities.push_back(entity->handle());
+    const auto children = entity->children();
+    for (Entity *child : children)
+        gatherPickableEntities(child, hasPicker, entities);
+}
 
 struct AbstractCollisionGathererFunctor
 {
@@ -276,7 +169,7 @@ struct AbstractCollisionGathererFunctor
     Renderer *m_renderer;
     QRay3D m_ray;
 
-    typedef CollisionVisitor::HitList result_type;
+    typedef HitList result_type;
 
     result_type operator ()(const Entity *entity) const
     {
@@ -332,21 +225,55 @@ struct TriangleCollisionGathererFunctor : public AbstractCollisionGathererFuncto
         if (!gRenderer)
             return result;
 
-        if (rayHitsEntity(rayCasting, entity)) {
-            CollisionVisitor visitor(m_renderer->nodeManagers(), entity, m_ray, m_pickBackFacingTriangles);
-            visitor.apply(gRenderer, entity->peerId());
-            result = visitor.hits;
+        if (!rayHitsEntity(rayCasting, entity))
+            return result;
 
-            struct
-            {
-                bool operator()(const result_type::value_type &a, const result_type::value_type &b)
-                {
-                    return a.m_distance < b.m_distance;
-                }
-            } compareHitsDistance;
-            std::sort(result.begin(), result.end(), compareHitsDistance);
+        bool invertible = false;
+        const QMatrix4x4 &worldTransform = *entity->worldTransform();
+        const QMatrix4x4 inverseWorldTransform = worldTransform.inverted(&invertible);
+        if (!invertible)
+            return result;
+
+        TriangleBoundingVolumeHierarchyPtr triangleHierarchy = gRenderer->triangleVolumeHierarchy();
+        if (!triangleHierarchy) {
+            triangleHierarchy = TriangleBoundingVolumeHierarchy::create(m_renderer->nodeManagers(), gRenderer, entity->peerId());
+            gRenderer->setTriangleVolumeHierarchy(triangleHierarchy);
         }
 
+        // Bring the ray in object space once rather than transforming every
+        // triangle, the segment parameter of a hit is the same in both spaces
+        const QVector3D origin = inverseWorldTransform * m_ray.origin();
+        const QVector3D end = inverseWorldTransform * m_ray.point(m_ray.distance());
+        const QRay3D segment(origin, end - origin, 1.0f);
+        const bool flipWinding = worldTransform.determinant() < 0.0f;
+
+        const auto intersections = triangleHierarchy->intersect(segment,
+                                                                m_pickBackFacingTriangles & QPickingSettings::BackFace,
+                                                                flipWinding);
+        const auto &triangles = triangleHierarchy->triangles();
+        result.reserve(intersections.size());
+        for (const TriangleBoundingVolumeHierarchy::Intersection &intersection : intersections) {
+            const TriangleBoundingVolumeHierarchy::Triangle &triangle = triangles.at(intersection.triangle);
+            QCollisionQueryResult::Hit queryResult;
+            queryResult.m_intersection = m_ray.point(intersection.t * m_ray.distance());
+            queryResult.m_distance = m_ray.projectedDistance(queryResult.m_intersection);
+            queryResult.m_entityId = entity->peerId();
+            queryResult.m_triangleIndex = triangle.index;
+            queryResult.m_vertexIndex[0] = triangle.vertexIndices[0];
+            queryResult.m_vertexIndex[1] = triangle.vertexIndices[1];
+            queryResult.m_vertexIndex[2] = triangle.vertexIndices[2];
+            result.push_back(queryResult);
+        }
+
+        struct
+        {
+            bool operator()(const result_type::value_type &a, const result_type::value_type &b)
+            {
+                return a.m_distance < b.m_distance;
+            }
+        } compareHitsDistance;
+        std::sort(result.begin(), result.end(), compareHitsDistance);
+
         return result;
     }
 
@@ -357,7 +284,7 @@ struct TriangleCollisionGathererFunctor : public AbstractCollisionGathererFuncto
     }
 };
 
-CollisionVisitor::HitList reduceToFirstHit(CollisionVisitor::HitList &result, const CollisionVisitor::HitList &intermediate)
+HitList reduceToFirstHit(HitList &result, const HitList &intermediate)
 {
     if (!intermediate.empty()) {
         if (result.empty())
@@ -377,7 +304,7 @@ CollisionVisitor::HitList reduceToFirstHit(CollisionVisitor::HitList &result, co
 }
 
 // Unordered
-CollisionVisitor::HitList reduceToAllHits(CollisionVisitor::HitList &results, const CollisionVisitor::HitList &intermediate)
+HitList reduceToAllHits(HitList &results, const HitList &intermediate)
 {
     if (!intermediate.empty())
         results << intermediate;
@@ -390,6 +317,8 @@ PickBoundingVolumeJob::PickBoundingVolumeJob(Renderer *renderer)
     : m_renderer(renderer)
     , m_manager(nullptr)
     , m_node(nullptr)
+    , m_entityHierarchyDirty(1)
+    , m_entityCount(0)
 {
     SET_JOB_RUN_STAT_TYPE(this, JobTypes::PickBoundingVolume, 0);
 }
@@ -397,6 +326,7 @@ PickBoundingVolumeJob::PickBoundingVolumeJob(Renderer *renderer)
 void PickBoundingVolumeJob::setRoot(Entity *root)
 {
     m_node = root;
+    markEntityHierarchyDirty();
 }
 
 QRay3D PickBoundingVolumeJob::intersectionRay(const QPoint &pos, const QMatrix4x4 &viewMatrix, const QMatrix4x4 &projectionMatrix, const QRect &viewport)
@@ -416,6 +346,11 @@ void PickBoundingVolumeJob::setManagers(NodeManagers *manager)
     m_manager = manager;
 }
 
+void PickBoundingVolumeJob::markEntityHierarchyDirty()
+{
+    m_entityHierarchyDirty.storeRelease(1);
+}
+
 void PickBoundingVolumeJob::run()
 {
     const auto mouseEvents = m_renderer->pendingPickingEvents();
@@ -455,8 +390,8 @@ void PickBoundingVolumeJob::run()
                 return;
         }
 
-        // Gather the entities for the frame
-        EntityGatherer entitiesGatherer(m_node);
+        // Update the hierarchy of pickable entities for the frame
+        updateEntityHierarchy();
 
         for (const QMouseEvent &event : mouseEvents) {
             QPickEvent::Buttons eventButton = QPickEvent::NoButton;
@@ -495,18 +430,19 @@ void PickBoundingVolumeJob::run()
                 typedef AbstractCollisionGathererFunctor::result_type HitList;
                 HitList sphereHits;
                 QRay3D ray = rayForViewportAndCamera(vca.area, event.pos(), vca.viewport, vca.cameraId);
+                const QVector<Entity *> entities = entitiesAlongRay(ray);
                 auto reducerOp = m_renderer->settings() && m_renderer->settings()->pickResultMode() == QPickingSettings::AllPicks ? reduceToAllHits : reduceToFirstHit;
                 if (m_renderer->settings() && m_renderer->settings()->pickMethod() == QPickingSettings::TrianglePicking) {
                     TriangleCollisionGathererFunctor gathererFunctor;
                     gathererFunctor.m_renderer = m_renderer;
                     gathererFunctor.m_ray = ray;
                     gathererFunctor.m_pickBackFacingTriangles = m_renderer->settings()->faceOrientationPickingMode();
-                    sphereHits = QtConcurrent::blockingMappedReduced<HitList>(entitiesGatherer.entities(), gathererFunctor, reducerOp);
+                    sphereHits = QtConcurrent::blockingMappedReduced<HitList>(entities, gathererFunctor, reducerOp);
                 } else {
                     EntityCollisionGathererFunctor gathererFunctor;
                     gathererFunctor.m_renderer = m_renderer;
                     gathererFunctor.m_ray = ray;
-                    sphereHits = QtConcurrent::blockingMappedReduced<HitList>(entitiesGatherer.entities(), gathererFunctor, reducerOp);
+                    sphereHits = QtConcurrent::blockingMappedReduced<HitList>(entities, gathererFunctor, reducerOp);
                 }
 
                 // If we have hits
@@ -672,6 +608,53 @@ QRay3D PickBoundingVolumeJob::rayForViewportAndCamera(const QSize &area,
     return ray;
 }
 
+void PickBoundingVolumeJob::updateEntityHierarchy()
+{
+    EntityManager *entityManager = m_manager->renderNodesManager();
+
+    // Only rebuild the tree when entities or their components may have
+    // changed, moving entities only requires refitting the bounds
+    const bool rebuild = m_entityHierarchyDirty.fetchAndStoreAcquire(0) != 0
+            || entityManager->count() != m_entityCount;
+    if (rebuild) {
+        m_entityCount = entityManager->count();
+        m_pickableEntities.clear();
+        if (m_node != nullptr)
+            gatherPickableEntities(m_node, false, m_pickableEntities);
+    }
+
+    QVector<BoundingBox> bounds;
+    bounds.reserve(m_pickableEntities.size());
+    for (const HEntity &handle : qAsConst(m_pickableEntities)) {
+        const Entity *entity = entityManager->data(handle);
+        if (entity == nullptr) {
+            bounds.push_back(BoundingBox());
+            continue;
+        }
+        const Sphere *sphere = entity->worldBoundingVolume();
+        const QVector3D radius(sphere->radius(), sphere->radius(), sphere->radius());
+        bounds.push_back(BoundingBox(sphere->center() - radius, sphere->center() + radius));
+    }
+
+    if (rebuild)
+        m_entityHierarchy.build(bounds);
+    else
+        m_entityHierarchy.refit(bounds);
+}
+
+QVector<Entity *> PickBoundingVolumeJob::entitiesAlongRay(const QRay3D &ray) const
+{
+    EntityManager *entityManager = m_manager->renderNodesManager();
+    QVector<Entity *> entities;
+    m_entityHierarchy.traverse(ray.origin(), ray.direction(), std::numeric_limits<float>::infinity(),
+                               [&] (int index) {
+        Entity *entity = entityManager->data(m_pickableEntities.at(index));
+        if (entity != nullptr)
+            entities.push_back(entity);
+    });
+    return entities;
+}
+
 void PickBoundingVolumeJob::clearPreviouslyHoveredPickers()
 {
     for (const HObjectPicker pickHandle : qAsConst(m_hoveredPickersToClear)) {
@@ -56,6 +56,7 @@
 #include <Qt3DRender/private/handle_types_p.h>
 #include <Qt3DRender/private/qboundingvolumeprovider_p.h>
 #include <Qt3DRender/private/qcollisionqueryresult_p.h>
+#include <Qt3DRender/private/boundingvolumehierarchy_p.h>
 #include <QMouseEvent>
 #include <QSharedPointer>
 
@@ -87,6 +88,10 @@ public:
                                   const QMatrix4x4 &projectionMatrix,
                                   const QRect &viewport);
     void setManagers(NodeManagers *manager);
+    // Entities, their transforms or their components have changed
+    void markEntityHierarchyDirty();
+    void updateEntityHierarchy();
+    QVector<Entity *> entitiesAlongRay(const QRay3D &ray) const;
 protected:
     void run() Q_DECL_FINAL;
 
@@ -104,9 +109,16 @@ private:
                                    const QRectF &relativeViewport,
                                    Qt3DCore::QNodeId cameraId) const;
     void clearPreviouslyHoveredPickers();
+
     HObjectPicker m_currentPicker;
     QVector<HObjectPicker> m_hoveredPickers;
     QVector<HObjectPicker> m_hoveredPickersToClear;
+
+    // Entities which have an ObjectPicker or a parent with one
+    QVector<HEntity> m_pickableEntities;
+    BoundingVolumeHierarchy m_entityHierarchy;
+    QAtomicInt m_entityHierarchyDirty;
+    int m_entityCount;
 };
 
 typedef QSharedPointer<PickBoundingVolumeJob> PickBoundingVolumeJobPtr;
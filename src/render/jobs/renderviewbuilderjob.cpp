@@ -68,10 +68,11 @@ void RenderViewBuilderJob::run()
         gatherLightsTime = timer.nsecsElapsed();
         timer.restart();
 #endif
+    m_standardUniformData.clear();
     if (!m_renderView->isCompute())
-        m_commands = m_renderView->buildDrawRenderCommands(m_renderables);
+        m_commands = m_renderView->buildDrawRenderCommands(m_renderables, &m_standardUniformData);
     else
-        m_commands = m_renderView->buildComputeRenderCommands(m_renderables);
+        m_commands = m_renderView->buildComputeRenderCommands(m_renderables, &m_standardUniformData);
 #if defined(QT3D_RENDER_VIEW_JOB_TIMINGS)
         buildCommandsTime = timer.nsecsElapsed();
         timer.restart();
@@ -74,6 +74,7 @@ public:
     inline void setIndex(int index) Q_DECL_NOTHROW { m_index = index; }
     inline void setRenderables(const QVector<Entity *> &renderables) Q_DECL_NOTHROW { m_renderables = renderables; }
     QVector<RenderCommand *> &commands() Q_DECL_NOTHROW { return m_commands; }
+    QByteArray &standardUniformData() Q_DECL_NOTHROW { return m_standardUniformData; }
 
     void run() Q_DECL_FINAL;
 
@@ -83,6 +84,7 @@ private:
     int m_index;
     QVector<Entity *> m_renderables;
     QVector<RenderCommand *> m_commands;
+    QByteArray m_standardUniformData;
 };
 
 typedef QSharedPointer<RenderViewBuilderJob> RenderViewBuilderJobPtr;
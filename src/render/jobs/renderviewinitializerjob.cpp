@@ -89,6 +89,7 @@ void RenderViewInitializerJob::run()
 
     // RenderView should allocate heap resources using only the currentFrameAllocator
     m_renderView->setRenderer(m_renderer);
+    m_renderView->setStandardUniformBlockAlignment(m_renderer->standardUniformBlockAlignment());
 
     // Populate the renderview's configuration from the framegraph
     setRenderViewConfigFromFrameGraphLeafNode(m_renderView, m_fgLeaf);
@@ -422,6 +422,66 @@ void addToRenderStateSet(RenderStateSet *stateSet,
         stateSet->addState(manager->lookupResource(stateId)->impl());
 }
 
+/*!
+    \internal
+    Appends a zeroed range for a standard uniform block of \a blockSize bytes
+    to \a standardUniformData and returns its offset. Ranges are padded to
+    \a alignment, GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, so that each of them
+    can be bound with glBindBufferRange.
+*/
+int appendStandardUniformBlock(QByteArray *standardUniformData, int blockSize, int alignment)
+{
+    const int offset = standardUniformData->size();
+    const int alignedSize = (blockSize + alignment - 1) / alignment * alignment;
+    standardUniformData->resize(offset + alignedSize);
+    memset(standardUniformData->data() + offset, 0, alignedSize);
+    return offset;
+}
+
+/*!
+    \internal
+    Writes the standard uniform \a value at the std140 location of \a uniform
+    in \a blockData. Returns false, leaving the block untouched, when the
+    member is an array, doesn't match the value or lies outside the block.
+*/
+bool writeStandardUniform(char *blockData, int blockSize, const ShaderUniform &uniform, const UniformValue &value)
+{
+    // Standard uniforms are never arrays
+    if (uniform.m_offset < 0 || uniform.m_size > 1)
+        return false;
+
+    const float *values = value.constData<float>();
+    if (uniform.m_type == GL_FLOAT_MAT3 || uniform.m_type == GL_FLOAT_MAT4) {
+        // Columns, rows for row_major matrices, are matrixStride bytes apart
+        const int dimension = uniform.m_type == GL_FLOAT_MAT3 ? 3 : 4;
+        const int vectorSize = dimension * int(sizeof(float));
+        if (value.byteSize() != dimension * vectorSize || uniform.m_matrixStride < vectorSize
+                || uniform.m_offset + (dimension - 1) * uniform.m_matrixStride + vectorSize > blockSize)
+            return false;
+        for (int i = 0; i < dimension; ++i) {
+            char *vectorData = blockData + uniform.m_offset + i * uniform.m_matrixStride;
+            if (uniform.m_rowMajor) {
+                // Values are column-major
+                float row[4];
+                for (int column = 0; column < dimension; ++column)
+                    row[column] = values[column * dimension + i];
+                memcpy(vectorData, row, vectorSize);
+            } else {
+                memcpy(vectorData, values + i * dimension, vectorSize);
+            }
+        }
+        return true;
+    }
+
+    // Scalars and vectors only take their own size, a vec3 may be followed by a float
+    const int byteSize = int(uniform.m_rawByteSize);
+    if (uniform.m_matrixStride > 0 || value.byteSize() > 4 * int(sizeof(float))
+            || byteSize <= 0 || byteSize > value.byteSize() || uniform.m_offset + byteSize > blockSize)
+        return false;
+    memcpy(blockData + uniform.m_offset, values, byteSize);
+    return true;
+}
+
 namespace {
 
 const QString blockArray = QStringLiteral("[%1]");
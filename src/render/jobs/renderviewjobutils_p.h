@@ -151,6 +151,14 @@ Q_AUTOTEST_EXPORT void addToRenderStateSet(RenderStateSet *stateSet,
                                            const QVector<Qt3DCore::QNodeId> stateIds,
                                            RenderStateManager *manager);
 
+Q_AUTOTEST_EXPORT int appendStandardUniformBlock(QByteArray *standardUniformData,
+                                                 int blockSize,
+                                                 int alignment);
+Q_AUTOTEST_EXPORT bool writeStandardUniform(char *blockData,
+                                            int blockSize,
+                                            const ShaderUniform &uniform,
+                                            const UniformValue &value);
+
 typedef QHash<int, QVariant> UniformBlockValueBuilderHash;
 
 struct Q_AUTOTEST_EXPORT UniformBlockValueBuilder
@@ -24,6 +24,7 @@ HEADERS += \
     $$PWD/renderpass_p.h \
     $$PWD/shader_p.h \
     $$PWD/shaderdata_p.h \
+    $$PWD/shaderdatalayout_p.h \
     $$PWD/technique_p.h \
     $$PWD/qgraphicsapifilter.h \
     $$PWD/qgraphicsapifilter_p.h \
@@ -45,6 +46,7 @@ SOURCES += \
     $$PWD/renderpass.cpp \
     $$PWD/shader.cpp \
     $$PWD/shaderdata.cpp \
+    $$PWD/shaderdatalayout.cpp \
     $$PWD/technique.cpp \
     $$PWD/qgraphicsapifilter.cpp \
     $$PWD/shadercache.cpp
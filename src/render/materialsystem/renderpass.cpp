@@ -47,6 +47,8 @@
 #include <Qt3DRender/private/qrenderpass_p.h>
 #include <Qt3DRender/private/renderstates_p.h>
 #include <Qt3DRender/private/renderstateset_p.h>
+#include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/nodemanagers_p.h>
 
 #include <Qt3DCore/qpropertyupdatedchange.h>
 #include <Qt3DCore/qpropertynodeaddedchange.h>
@@ -85,6 +87,7 @@ void RenderPass::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &c
     for (const auto &renderStateId : qAsConst(data.renderStateIds))
         addRenderState(renderStateId);
     m_shaderUuid = data.shaderId;
+    setShaderReferencesDirty();
 }
 
 void RenderPass::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
@@ -127,10 +130,18 @@ void RenderPass::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
         break;
     }
 
+    setShaderReferencesDirty();
     BackendNode::sceneChangeEvent(e);
     markDirty(AbstractRenderer::AllDirty);
 }
 
+// The renderer only looks for shaders to load in the techniques when they changed
+void RenderPass::setShaderReferencesDirty()
+{
+    if (m_renderer != nullptr && m_renderer->nodeManagers() != nullptr)
+        m_renderer->nodeManagers()->shaderManager()->setShaderReferencesDirty();
+}
+
 Qt3DCore::QNodeId RenderPass::shaderProgram() const
 {
     return m_shaderUuid;
@@ -89,6 +89,7 @@ public:
     inline bool hasRenderStates() const { return !m_renderStates.empty(); }
 
 private:
+    void setShaderReferencesDirty();
     void appendFilterKey(Qt3DCore::QNodeId filterKeyId);
     void removeFilterKey(Qt3DCore::QNodeId filterKeyId);
 
@@ -49,7 +49,10 @@
 #include <Qt3DRender/private/graphicscontext_p.h>
 #include <Qt3DRender/private/qshaderprogram_p.h>
 #include <Qt3DRender/private/stringtoint_p.h>
+#include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/nodemanagers_p.h>
 #include <Qt3DCore/qpropertyupdatedchange.h>
+#include <algorithm>
 
 QT_BEGIN_NAMESPACE
 
@@ -61,6 +64,7 @@ namespace Render {
 Shader::Shader()
     : BackendNode()
     , m_isLoaded(false)
+    , m_linkFailed(false)
     , m_dna(0)
     , m_graphicsContext(nullptr)
 {
@@ -86,6 +90,7 @@ void Shader::cleanup()
 
     QBackendNode::setEnabled(false);
     m_isLoaded = false;
+    resetLinkStatus();
     m_dna = 0;
     m_oldDna = 0;
     m_uniformsNames.clear();
@@ -94,6 +99,7 @@ void Shader::cleanup()
     m_uniforms.clear();
     m_attributes.clear();
     m_uniformBlocks.clear();
+    clearShaderDataLayouts();
 }
 
 void Shader::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &change)
@@ -111,7 +117,16 @@ void Shader::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &chang
     m_shaderCode[QShaderProgram::Fragment] = data.fragmentShaderCode;
     m_shaderCode[QShaderProgram::Compute] = data.computeShaderCode;
     m_isLoaded = false;
+    resetLinkStatus();
     updateDNA();
+    addToShadersToLoad();
+}
+
+// Lets the renderer know the shader has to be (re)loaded
+void Shader::addToShadersToLoad()
+{
+    if (m_renderer != nullptr && m_renderer->nodeManagers() != nullptr)
+        m_renderer->nodeManagers()->shaderManager()->addShaderToLoad(peerId());
 }
 
 void Shader::setGraphicsContext(GraphicsContext *context)
@@ -176,8 +191,11 @@ void Shader::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
             m_shaderCode[QShaderProgram::Compute] = propertyValue.toByteArray();
             m_isLoaded = false;
         }
-        if (!m_isLoaded)
+        if (!m_isLoaded) {
+            resetLinkStatus();
             updateDNA();
+            addToShadersToLoad();
+        }
         markDirty(AbstractRenderer::AllDirty);
     }
 
@@ -326,6 +344,7 @@ void Shader::initializeUniforms(const QVector<ShaderUniform> &uniformsDescriptio
         }
     }
     m_uniformBlockIndexToShaderUniforms.insert(-1, activeUniformsInDefaultBlock);
+    clearShaderDataLayouts();
 }
 
 void Shader::initializeAttributes(const QVector<ShaderAttribute> &attributesDescription)
@@ -357,9 +376,11 @@ void Shader::initializeUniformBlocks(const QVector<ShaderUniformBlock> &uniformB
         const QVector<ShaderUniform>::const_iterator uniformsEnd = m_uniforms.end();
 
         QVector<QString>::const_iterator uniformNamesIt = m_uniformsNames.begin();
-        const QVector<QString>::const_iterator uniformNamesEnd = m_attributesNames.end();
+        const QVector<QString>::const_iterator uniformNamesEnd = m_uniformsNames.end();
 
         QHash<QString, ShaderUniform> activeUniformsInBlock;
+        QVector<ShaderUniformBlockMember> layout;
+        uint layoutHash = qHash(uniformBlockDescription[i].m_size);
 
         while (uniformsIt != uniformsEnd && uniformNamesIt != uniformNamesEnd) {
             if (uniformsIt->m_blockIndex == uniformBlockDescription[i].m_index) {
@@ -367,13 +388,47 @@ void Shader::initializeUniformBlocks(const QVector<ShaderUniformBlock> &uniformB
                 if (!m_uniformBlockNames[i].isEmpty() && !uniformName.startsWith(m_uniformBlockNames[i]))
                     uniformName = m_uniformBlockNames[i] + QLatin1Char('.') + *uniformNamesIt;
                 activeUniformsInBlock.insert(uniformName, *uniformsIt);
+                // Order independent so that blocks declared by different
+                // shaders can be compared
+                uint uniformHash = qHash(uniformName);
+                uniformHash = qHash(uint(uniformsIt->m_type), uniformHash);
+                uniformHash = qHash(uniformsIt->m_size, uniformHash);
+                uniformHash = qHash(uniformsIt->m_offset, uniformHash);
+                uniformHash = qHash(uniformsIt->m_arrayStride, uniformHash);
+                uniformHash = qHash(uniformsIt->m_matrixStride, uniformHash);
+                layoutHash += uniformHash;
+                const ShaderUniformBlockMember member = { StringToInt::lookupId(uniformName), uniformsIt->m_type,
+                                                          uniformsIt->m_size, uniformsIt->m_offset,
+                                                          uniformsIt->m_arrayStride, uniformsIt->m_matrixStride };
+                layout.push_back(member);
                 qCDebug(Shaders) << "Active Uniform Block " << uniformName << " in block " << m_uniformBlockNames[i] << " at index " << uniformsIt->m_blockIndex;
             }
             ++uniformsIt;
             ++uniformNamesIt;
         }
+        std::sort(layout.begin(), layout.end(),
+                  [] (const ShaderUniformBlockMember &a, const ShaderUniformBlockMember &b) {
+            return a.m_offset < b.m_offset;
+        });
+        m_uniformBlocks[i].m_layoutHash = layoutHash;
+        m_uniformBlocks[i].m_layout = layout;
         m_uniformBlockIndexToShaderUniforms.insert(uniformBlockDescription[i].m_index, activeUniformsInBlock);
     }
+    clearShaderDataLayouts();
+}
+
+void Shader::setLinkFailed(const QString &log)
+{
+    QMutexLocker lock(&m_mutex);
+    m_linkFailed = true;
+    m_log = log;
+}
+
+void Shader::resetLinkStatus()
+{
+    QMutexLocker lock(&m_mutex);
+    m_linkFailed = false;
+    m_log.clear();
 }
 
 void Shader::initializeShaderStorageBlocks(const QVector<ShaderStorageBlock> &shaderStorageBlockDescription)
@@ -413,6 +468,37 @@ void Shader::initialize(const Shader &other)
     m_shaderStorageBlockNames = other.m_shaderStorageBlockNames;
     m_shaderStorageBlocks = other.m_shaderStorageBlocks;
     m_isLoaded = other.m_isLoaded;
+    clearShaderDataLayouts();
+}
+
+ShaderDataLayout Shader::shaderDataLayout(ShaderDataManager *manager,
+                                          ShaderData *shaderData,
+                                          int blockNameId,
+                                          int blockIndex)
+{
+    const QPair<QNodeId, int> key(shaderData->peerId(), blockNameId);
+    {
+        QReadLocker lock(&m_shaderDataLayoutsLock);
+        const auto it = m_shaderDataLayouts.constFind(key);
+        if (it != m_shaderDataLayouts.cend() && it->isUpToDate(manager))
+            return it.value();
+    }
+
+    // Only happens the first time a ShaderData is used with this shader or
+    // when the ShaderData structure changed
+    const ShaderDataLayout layout = ShaderDataLayout::compile(manager,
+                                                              shaderData,
+                                                              StringToInt::lookupString(blockNameId),
+                                                              activeUniformsForUniformBlock(blockIndex));
+    QWriteLocker lock(&m_shaderDataLayoutsLock);
+    m_shaderDataLayouts.insert(key, layout);
+    return layout;
+}
+
+void Shader::clearShaderDataLayouts()
+{
+    QWriteLocker lock(&m_shaderDataLayoutsLock);
+    m_shaderDataLayouts.clear();
 }
 
 } // namespace Render
@@ -54,7 +54,9 @@
 #include <Qt3DRender/private/backendnode_p.h>
 #include <Qt3DRender/private/shaderparameterpack_p.h>
 #include <Qt3DRender/private/shadervariables_p.h>
+#include <Qt3DRender/private/shaderdatalayout_p.h>
 #include <QMutex>
+#include <QReadWriteLock>
 #include <QVector>
 
 QT_BEGIN_NAMESPACE
@@ -101,6 +103,10 @@ public:
     void sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e) Q_DECL_OVERRIDE;
     bool isLoaded() const { QMutexLocker lock(&m_mutex); return m_isLoaded; }
     void setLoaded(bool loaded) { QMutexLocker lock(&m_mutex); m_isLoaded = loaded; }
+    // Set when the program couldn't be linked, until the shader code changes.
+    // The shader then stays unloaded and its commands are never issued
+    bool hasLinkFailed() const { QMutexLocker lock(&m_mutex); return m_linkFailed; }
+    QString log() const { QMutexLocker lock(&m_mutex); return m_log; }
     ProgramDNA dna() const Q_DECL_NOTHROW { return m_dna; }
 
     inline QVector<ShaderUniform> uniforms() const { return m_uniforms; }
@@ -118,6 +124,14 @@ public:
     ShaderStorageBlock storageBlockForBlockNameId(int blockNameId);
     ShaderStorageBlock storageBlockForBlockName(const QString &blockName);
 
+    // Layout of a ShaderData for the uniforms of the block blockIndex
+    // (-1 for the default block) prefixed with the name of blockNameId.
+    // Called by RenderView jobs (several concurrent threads)
+    ShaderDataLayout shaderDataLayout(ShaderDataManager *manager,
+                                      ShaderData *shaderData,
+                                      int blockNameId,
+                                      int blockIndex = -1);
+
 private:
     void initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &change) Q_DECL_FINAL;
 
@@ -142,19 +156,29 @@ private:
 
     QVector<QByteArray> m_shaderCode;
 
+    // Keyed by ShaderData id and block name id
+    QHash<QPair<Qt3DCore::QNodeId, int>, ShaderDataLayout> m_shaderDataLayouts;
+    mutable QReadWriteLock m_shaderDataLayoutsLock;
+
     bool m_isLoaded;
+    bool m_linkFailed;
+    QString m_log;
     ProgramDNA m_dna;
     ProgramDNA m_oldDna;
     mutable QMutex m_mutex;
     GraphicsContext *m_graphicsContext;
 
     void updateDNA();
+    void addToShadersToLoad();
+    void clearShaderDataLayouts();
 
     // Private so that only GraphicContext can call it
     void initializeUniforms(const QVector<ShaderUniform> &uniformsDescription);
     void initializeAttributes(const QVector<ShaderAttribute> &attributesDescription);
     void initializeUniformBlocks(const QVector<ShaderUniformBlock> &uniformBlockDescription);
     void initializeShaderStorageBlocks(const QVector<ShaderStorageBlock> &shaderStorageBlockDescription);
+    void setLinkFailed(const QString &log);
+    void resetLinkStatus();
 
     void initialize(const Shader &other);
 
@@ -37,6 +37,13 @@
 #include "shadercache_p.h"
 
 #include <QtCore/QMutexLocker>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <Qt3DRender/private/renderlogging_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -151,6 +158,173 @@ QOpenGLShaderProgram *ShaderCache::getShaderProgramForDNA(ProgramDNA dna) const
     return m_programHash.value(dna, nullptr);
 }
 
+namespace {
+
+const quint32 programBinaryMagic = 0x51334442; // Q3DB
+const quint32 programBinaryVersion = 1;
+
+} // anonymous
+
+/*!
+ * \internal
+ *
+ * Reads and validates all the program binaries previously stored in \a directory
+ * for the driver identified by \a driverKey. Files that can't be read or were
+ * written for another version of the format are removed.
+ */
+void ShaderCache::loadDiskCache(const QString &directory, const QByteArray &driverKey)
+{
+    m_programBinaries.clear();
+    m_driverKey = driverKey;
+    // Binaries of different drivers are kept apart
+    m_diskCacheDirectory = directory + QLatin1Char('/')
+            + QString::fromLatin1(QCryptographicHash::hash(driverKey, QCryptographicHash::Sha1).toHex().left(16));
+
+    QDir dir(m_diskCacheDirectory);
+    if (!dir.exists() && !dir.mkpath(QStringLiteral("."))) {
+        qCWarning(Shaders) << "Failed to create shader cache directory" << m_diskCacheDirectory;
+        m_diskCacheDirectory.clear();
+        return;
+    }
+
+    const QStringList fileNames = dir.entryList(QStringList() << QStringLiteral("*.bin"), QDir::Files);
+    for (const QString &fileName : fileNames) {
+        QFile file(dir.filePath(fileName));
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+
+        QDataStream stream(&file);
+        quint32 magic = 0;
+        quint32 version = 0;
+        QByteArray fileDriverKey;
+        QByteArray key;
+        quint32 format = 0;
+        QByteArray data;
+        quint16 checksum = 0;
+        stream >> magic >> version;
+        if (magic == programBinaryMagic && version == programBinaryVersion)
+            stream >> fileDriverKey >> key >> format >> data >> checksum;
+
+        if (stream.status() != QDataStream::Ok || magic != programBinaryMagic
+                || version != programBinaryVersion || fileDriverKey != driverKey
+                || data.isEmpty() || checksum != qChecksum(data.constData(), data.size())) {
+            qCDebug(Shaders) << "Removing invalid program binary" << fileName;
+            file.close();
+            file.remove();
+            continue;
+        }
+
+        ProgramBinary binary;
+        binary.format = format;
+        binary.data = data;
+        m_programBinaries.insert(key, binary);
+    }
+    qCDebug(Shaders) << "Loaded" << m_programBinaries.size() << "program binaries from" << m_diskCacheDirectory;
+}
+
+/*!
+ * \internal
+ *
+ * Retrieves the program binary stored for \a key, returns false if there is none.
+ */
+bool ShaderCache::programBinary(const QByteArray &key, uint *format, QByteArray *binary) const
+{
+    const auto it = m_programBinaries.constFind(key);
+    if (it == m_programBinaries.cend())
+        return false;
+    *format = it->format;
+    *binary = it->data;
+    return true;
+}
+
+/*!
+ * \internal
+ *
+ * Stores the program \a binary of \a format under \a key, in memory and on disk.
+ */
+void ShaderCache::insertProgramBinary(const QByteArray &key, uint format, const QByteArray &binary)
+{
+    if (!isDiskCacheLoaded() || binary.isEmpty())
+        return;
+
+    ProgramBinary programBinary;
+    programBinary.format = format;
+    programBinary.data = binary;
+    m_programBinaries.insert(key, programBinary);
+
+    // Written to a temporary file first, a process reading
+    // the cache never sees a partially written binary
+    QSaveFile file(programBinaryFileName(key));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    QDataStream stream(&file);
+    stream << programBinaryMagic << programBinaryVersion << m_driverKey << key
+           << quint32(format) << binary << qChecksum(binary.constData(), binary.size());
+    if (!file.commit())
+        qCWarning(Shaders) << "Failed to write program binary" << file.fileName();
+}
+
+/*!
+ * \internal
+ *
+ * Forgets the program binary stored under \a key, called when the driver rejected it.
+ */
+void ShaderCache::removeProgramBinary(const QByteArray &key)
+{
+    if (m_programBinaries.remove(key) > 0)
+        QFile::remove(programBinaryFileName(key));
+}
+
+/*!
+ * \internal
+ *
+ * Returns the key under which the program binary for a shader is stored.
+ * The DNA alone isn't enough to tell programs apart across runs, the
+ * sources and fragment outputs are hashed as well.
+ */
+QByteArray ShaderCache::programBinaryKey(ProgramDNA dna, const QVector<QByteArray> &shaderCode,
+                                         const QHash<QString, int> &fragOutputs)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(reinterpret_cast<const char *>(&dna), sizeof(dna));
+    for (const QByteArray &code : shaderCode) {
+        const quint32 size = code.size();
+        hash.addData(reinterpret_cast<const char *>(&size), sizeof(size));
+        hash.addData(code);
+    }
+    QStringList outputs;
+    for (auto it = fragOutputs.cbegin(), end = fragOutputs.cend(); it != end; ++it)
+        outputs.push_back(it.key() + QLatin1Char('=') + QString::number(it.value()));
+    outputs.sort();
+    hash.addData(outputs.join(QLatin1Char(';')).toUtf8());
+    return hash.result().toHex();
+}
+
+/*!
+ * \internal
+ *
+ * Returns the directory program binaries are stored in. It can be changed with
+ * QT3DRENDER_SHADER_CACHE_DIR, setting QT3DRENDER_DISABLE_SHADER_DISK_CACHE
+ * disables the cache in which case an empty string is returned.
+ */
+QString ShaderCache::defaultDiskCacheDirectory()
+{
+    if (qEnvironmentVariableIsSet("QT3DRENDER_DISABLE_SHADER_DISK_CACHE"))
+        return QString();
+    const QString directory = QString::fromLocal8Bit(qgetenv("QT3DRENDER_SHADER_CACHE_DIR"));
+    if (!directory.isEmpty())
+        return directory;
+    const QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheLocation.isEmpty())
+        return QString();
+    return cacheLocation + QStringLiteral("/qt3dshadercache");
+}
+
+QString ShaderCache::programBinaryFileName(const QByteArray &key) const
+{
+    return m_diskCacheDirectory + QLatin1Char('/') + QString::fromLatin1(key) + QStringLiteral(".bin");
+}
+
 } // namespace Render
 } // namespace Qt3DRender
 
@@ -54,6 +54,7 @@
 #include <QtCore/qhash.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qvector.h>
+#include <QtCore/qstring.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -80,7 +81,26 @@ public:
     // Only ever used from the OpenGL submission thread
     QOpenGLShaderProgram *getShaderProgramForDNA(ProgramDNA dna) const;
 
+    // Persistent cache of linked program binaries, only ever used from the OpenGL submission thread
+    void loadDiskCache(const QString &directory, const QByteArray &driverKey);
+    bool isDiskCacheLoaded() const { return !m_diskCacheDirectory.isEmpty(); }
+    bool programBinary(const QByteArray &key, uint *format, QByteArray *binary) const;
+    void insertProgramBinary(const QByteArray &key, uint format, const QByteArray &binary);
+    void removeProgramBinary(const QByteArray &key);
+
+    static QByteArray programBinaryKey(ProgramDNA dna, const QVector<QByteArray> &shaderCode,
+                                       const QHash<QString, int> &fragOutputs);
+    static QString defaultDiskCacheDirectory();
+
 private:
+    struct ProgramBinary
+    {
+        uint format;
+        QByteArray data;
+    };
+
+    QString programBinaryFileName(const QByteArray &key) const;
+
     // Only ever used from the OpenGL submission thread
     QHash<ProgramDNA, QOpenGLShaderProgram *> m_programHash;
 
@@ -89,6 +109,10 @@ private:
     QVector<ProgramDNA> m_pendingRemoval;
     QMutex m_refsMutex;
 
+    QHash<QByteArray, ProgramBinary> m_programBinaries;
+    QString m_diskCacheDirectory;
+    QByteArray m_driverKey;
+
 #if defined(QT_BUILD_INTERNAL)
     friend class tst_ShaderCache;
 #endif
@@ -62,12 +62,32 @@ namespace {
 
 const int qNodeIdTypeId = qMetaTypeId<Qt3DCore::QNodeId>();
 
+bool hasSameLayout(const QVariant &a, const QVariant &b)
+{
+    if (a.userType() != b.userType())
+        return false;
+    if (a.userType() == qNodeIdTypeId)
+        return a.value<Qt3DCore::QNodeId>() == b.value<Qt3DCore::QNodeId>();
+    if (a.userType() == QMetaType::QVariantList) {
+        const QVariantList listA = a.value<QVariantList>();
+        const QVariantList listB = b.value<QVariantList>();
+        if (listA.size() != listB.size())
+            return false;
+        for (int i = 0, m = listA.size(); i < m; ++i) {
+            if (!hasSameLayout(listA.at(i), listB.at(i)))
+                return false;
+        }
+    }
+    return true;
+}
+
 }
 
 QVector<Qt3DCore::QNodeId> ShaderData::m_updatedShaderData;
 
 ShaderData::ShaderData()
     : m_managers(nullptr)
+    , m_layoutRevision(0)
 {
 }
 
@@ -244,6 +264,9 @@ void ShaderData::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
 
         // Note we aren't notified about nested QShaderData in this call
         // only scalar / vec properties
+        const auto previousValue = m_originalProperties.constFind(propertyName);
+        if (previousValue == m_originalProperties.cend() || !hasSameLayout(previousValue.value(), propertyValue))
+            ++m_layoutRevision;
         m_originalProperties.insert(propertyName, propertyValue);
         BackendNode::markDirty(AbstractRenderer::AllDirty);
     }
@@ -273,6 +296,7 @@ Qt3DCore::QBackendNode *RenderShaderDataFunctor::get(Qt3DCore::QNodeId id) const
 void RenderShaderDataFunctor::destroy(Qt3DCore::QNodeId id) const
 {
     m_managers->shaderDataManager()->releaseResource(id);
+    m_managers->shaderDataManager()->addShaderDataToRelease(id);
 }
 
 } // namespace Render
@@ -88,6 +88,10 @@ public:
     // Call by RenderViewJob
     void markDirty();
 
+    // Changes when properties are added, change type or refer to other
+    // ShaderData, so that layouts compiled from the properties get rebuilt
+    uint layoutRevision() const { return m_layoutRevision; }
+
     TransformType propertyTransformType(const QString &name) const;
     QVariant getTransformedProperty(const QString &name, const QMatrix4x4 &viewMatrix);
 
@@ -117,6 +121,7 @@ protected:
     QMatrix4x4 m_worldMatrix;
     QMatrix4x4 m_viewMatrix;
     NodeManagers *m_managers;
+    uint m_layoutRevision;
 
     void clearUpdatedProperties();
     static ShaderData *lookupResource(NodeManagers *managers, Qt3DCore::QNodeId id);
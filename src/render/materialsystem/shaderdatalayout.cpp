@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "shaderdatalayout_p.h"
+#include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/shaderdata_p.h>
+#include <Qt3DRender/private/stringtoint_p.h>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt3DCore;
+
+namespace Qt3DRender {
+
+namespace Render {
+
+namespace {
+
+const int qNodeIdTypeId = qMetaTypeId<QNodeId>();
+
+} // anonymous
+
+ShaderDataLayout ShaderDataLayout::compile(ShaderDataManager *manager,
+                                           ShaderData *shaderData,
+                                           const QString &blockName,
+                                           const QHash<QString, ShaderUniform> &uniforms)
+{
+    ShaderDataLayout layout;
+    layout.compileNode(manager, shaderData, blockName, uniforms);
+    return layout;
+}
+
+void ShaderDataLayout::compileNode(ShaderDataManager *manager,
+                                   ShaderData *shaderData,
+                                   const QString &prefix,
+                                   const QHash<QString, ShaderUniform> &uniforms)
+{
+    // Nested ShaderData are appended after their parent, the index has to be
+    // used rather than a reference
+    const int nodeIndex = m_nodes.size();
+    Node node;
+    node.shaderDataId = shaderData->peerId();
+    node.revision = shaderData->layoutRevision();
+    m_nodes.push_back(node);
+
+    // In the end, values are either scalar or a scalar array
+    // Composed elements (structs, structs array) are simplified into simple scalars
+    const QHash<QString, QVariant> properties = shaderData->properties();
+    for (auto it = properties.cbegin(), end = properties.cend(); it != end; ++it) {
+        const QString &propertyName = it.key();
+        const QVariant &value = it.value();
+        const QString memberName = prefix + QLatin1Char('.') + propertyName;
+
+        if (value.userType() == QMetaType::QVariantList) {
+            const QVariantList list = value.value<QVariantList>();
+            if (list.isEmpty())
+                continue;
+            if (list.first().userType() == qNodeIdTypeId) { // Array of struct memberName[i].structMember
+                for (int i = 0; i < list.size(); ++i) {
+                    ShaderData *nested = manager->lookupResource(list.at(i).value<QNodeId>());
+                    if (nested != nullptr)
+                        compileNode(manager, nested, memberName + QLatin1Char('[') + QString::number(i) + QLatin1Char(']'), uniforms);
+                }
+                continue;
+            }
+            // Array of scalar/vec memberName[0]
+            const auto uniformIt = uniforms.constFind(memberName + QLatin1String("[0]"));
+            if (uniformIt != uniforms.cend()) {
+                Member member;
+                member.propertyName = propertyName;
+                member.uniform = uniformIt.value();
+                member.uniform.m_nameId = StringToInt::lookupId(uniformIt.key());
+                member.transformed = false;
+                m_nodes[nodeIndex].members.push_back(member);
+            }
+        } else if (value.userType() == qNodeIdTypeId) { // Struct memberName.structMember
+            ShaderData *nested = manager->lookupResource(value.value<QNodeId>());
+            if (nested != nullptr)
+                compileNode(manager, nested, memberName, uniforms);
+        } else { // Scalar / Vec
+            const auto uniformIt = uniforms.constFind(memberName);
+            if (uniformIt != uniforms.cend()) {
+                Member member;
+                member.propertyName = propertyName;
+                member.uniform = uniformIt.value();
+                member.uniform.m_nameId = StringToInt::lookupId(uniformIt.key());
+                member.transformed = shaderData->propertyTransformType(propertyName) != ShaderData::NoTransform;
+                m_nodes[nodeIndex].members.push_back(member);
+            }
+        }
+    }
+}
+
+bool ShaderDataLayout::isUpToDate(ShaderDataManager *manager) const
+{
+    for (const Node &node : m_nodes) {
+        const ShaderData *shaderData = manager->lookupResource(node.shaderDataId);
+        if (shaderData == nullptr || shaderData->layoutRevision() != node.revision)
+            return false;
+    }
+    return true;
+}
+
+QVector<QVariant> ShaderDataLayout::values(ShaderDataManager *manager, const QMatrix4x4 &viewMatrix) const
+{
+    QVector<QVariant> values;
+    values.reserve(memberCount());
+    for (const Node &node : m_nodes) {
+        ShaderData *shaderData = manager->lookupResource(node.shaderDataId);
+        if (shaderData == nullptr) {
+            // Keep the values aligned with the members
+            values.resize(values.size() + node.members.size());
+            continue;
+        }
+        const QHash<QString, QVariant> properties = shaderData->properties();
+        for (const Member &member : node.members) {
+            values.push_back(member.transformed
+                             ? shaderData->getTransformedProperty(member.propertyName, viewMatrix)
+                             : properties.value(member.propertyName));
+        }
+    }
+    return values;
+}
+
+int ShaderDataLayout::memberCount() const
+{
+    int count = 0;
+    for (const Node &node : m_nodes)
+        count += node.members.size();
+    return count;
+}
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
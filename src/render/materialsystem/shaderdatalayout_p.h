@@ -0,0 +1,123 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QT3DRENDER_RENDER_SHADERDATALAYOUT_P_H
+#define QT3DRENDER_RENDER_SHADERDATALAYOUT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <Qt3DCore/qnodeid.h>
+#include <Qt3DRender/private/shadervariables_p.h>
+#include <QHash>
+#include <QVector>
+#include <QMatrix4x4>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+class ShaderData;
+class ShaderDataManager;
+
+// Maps the properties of a ShaderData, and of the ShaderData nested in it,
+// onto the active uniforms of a shader. Uniform names are only built when
+// the layout is compiled, values are then set by uniform name id.
+class Q_AUTOTEST_EXPORT ShaderDataLayout
+{
+public:
+    struct Member
+    {
+        QString propertyName;
+        ShaderUniform uniform;
+        bool transformed;
+    };
+
+    struct Node
+    {
+        Qt3DCore::QNodeId shaderDataId;
+        uint revision;
+        QVector<Member> members;
+    };
+
+    // blockName is the struct or uniform block name members are prefixed with,
+    // uniforms the active uniforms of the block as returned by
+    // Shader::activeUniformsForUniformBlock
+    static ShaderDataLayout compile(ShaderDataManager *manager,
+                                    ShaderData *shaderData,
+                                    const QString &blockName,
+                                    const QHash<QString, ShaderUniform> &uniforms);
+
+    // False once one of the ShaderData was destroyed or changed structure
+    bool isUpToDate(ShaderDataManager *manager) const;
+
+    // Current values of the members, in the order of the nodes and of their
+    // members. Transformed properties are expressed relative to viewMatrix
+    QVector<QVariant> values(ShaderDataManager *manager, const QMatrix4x4 &viewMatrix) const;
+    int memberCount() const;
+
+    bool isEmpty() const { return m_nodes.isEmpty(); }
+    const QVector<Node> &nodes() const { return m_nodes; }
+
+private:
+    void compileNode(ShaderDataManager *manager,
+                     ShaderData *shaderData,
+                     const QString &prefix,
+                     const QHash<QString, ShaderUniform> &uniforms);
+
+    QVector<Node> m_nodes;
+};
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_SHADERDATALAYOUT_P_H
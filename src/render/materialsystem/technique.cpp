@@ -47,6 +47,8 @@
 #include <Qt3DRender/private/filterkey_p.h>
 #include <Qt3DRender/private/qtechnique_p.h>
 #include <Qt3DRender/private/shader_p.h>
+#include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/nodemanagers_p.h>
 #include <Qt3DCore/private/qchangearbiter_p.h>
 #include <Qt3DCore/qpropertyupdatedchange.h>
 #include <Qt3DCore/qpropertynodeaddedchange.h>
@@ -88,6 +90,7 @@ void Technique::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &ch
     m_filterKeyList = data.filterKeyIds;
     m_parameterPack.setParameters(data.parameterIds);
     m_renderPasses = data.renderPassIds;
+    setShaderReferencesDirty();
 }
 
 void Technique::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
@@ -127,10 +130,18 @@ void Technique::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
     default:
         break;
     }
+    setShaderReferencesDirty();
     markDirty(AbstractRenderer::AllDirty);
     BackendNode::sceneChangeEvent(e);
 }
 
+// The renderer only looks for shaders to load in the techniques when they changed
+void Technique::setShaderReferencesDirty()
+{
+    if (m_renderer != nullptr && m_renderer->nodeManagers() != nullptr)
+        m_renderer->nodeManagers()->shaderManager()->setShaderReferencesDirty();
+}
+
 QVector<Qt3DCore::QNodeId> Technique::parameters() const
 {
     return m_parameterPack.parameters();
@@ -95,6 +95,7 @@ public:
 
 private:
     void initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &change) Q_DECL_FINAL;
+    void setShaderReferencesDirty();
 
     GraphicsApiFilterData m_graphicsApiFilterData;
     ParameterPack m_parameterPack;
@@ -69,6 +69,16 @@ QList<QMouseEvent> PickEventFilter::pendingEvents()
     return pendingEvents;
 }
 
+/*!
+    \internal
+    Called from the aspect thread.
+*/
+bool PickEventFilter::hasPendingEvents() const
+{
+    QMutexLocker locker(&m_mutex);
+    return !m_pendingEvents.isEmpty();
+}
+
 /*!
     \internal
     Called from the main thread.
@@ -69,13 +69,14 @@ public:
     ~PickEventFilter();
 
     QList<QMouseEvent> pendingEvents();
+    bool hasPendingEvents() const;
 
 protected:
     bool eventFilter(QObject *obj, QEvent *e) Q_DECL_FINAL;
 
 private:
     QList<QMouseEvent> m_pendingEvents;
-    QMutex m_mutex;
+    mutable QMutex m_mutex;
 };
 
 } // Render
@@ -62,6 +62,10 @@ namespace Qt3DRender {
     Pick queries are performed on mouse press and mouse release.
     If drag is enabled, queries also happen on each mouse move while any button is pressed.
     If hover is enabled, queries happen on every mouse move even if no button is pressed.
+
+    Only entities having a QObjectPicker, or a parent entity with one, are
+    considered by the queries. Other entities don't occlude the entities lying
+    behind them.
     \sa QPickingSettings
 
     \note Instances of this component shouldn't be shared, not respecting that
@@ -40,9 +40,8 @@
 
 #include "renderstateset_p.h"
 
-#include <bitset>
-
 #include <QDebug>
+#include <QtCore/qalgorithms.h>
 #include <QOpenGLContext>
 
 #include <Qt3DRender/private/graphicscontext_p.h>
@@ -92,8 +91,40 @@ QT_BEGIN_NAMESPACE
 namespace Qt3DRender {
 namespace Render {
 
+namespace {
+
+// Several states of these types, one per clip plane or draw buffer, can be
+// part of the same set
+Q_DECL_CONSTEXPR StateMaskSet MultiInstanceStates = ClipPlaneMask | BlendEquationArgumentsMask;
+
+// Changing these states makes drivers revalidate the pipeline, they are
+// weighted heavier than the other ones when ordering the commands
+Q_DECL_CONSTEXPR StateMaskSet ExpensiveStates = BlendStateMask
+        | BlendEquationArgumentsMask
+        | DepthTestStateMask
+        | StencilTestStateMask
+        | StencilOpMask
+        | AlphaCoverageStateMask
+        | MSAAEnabledStateMask;
+Q_DECL_CONSTEXPR int ExpensiveStateCost = 3;
+Q_DECL_CONSTEXPR int StateCost = 1;
+
+inline int weightedStateCount(StateMaskSet states)
+{
+    return ExpensiveStateCost * int(qPopulationCount(states & ExpensiveStates))
+            + StateCost * int(qPopulationCount(states & ~ExpensiveStates));
+}
+
+inline int stateIndex(StateMask type)
+{
+    return int(qCountTrailingZeroBits(quint32(type)));
+}
+
+} // anonymous
+
 RenderStateSet::RenderStateSet()
     : m_stateMask(0)
+    , m_states()
 {
 }
 
@@ -104,7 +135,10 @@ RenderStateSet::~RenderStateSet()
 template<>
 void RenderStateSet::addState<StateVariant>(const StateVariant &ds)
 {
-    m_states.push_back(ds);
+    if (ds.type & MultiInstanceStates)
+        m_multiStates.push_back(ds);
+    else
+        m_states[stateIndex(ds.type)] = ds;
     m_stateMask |= ds.type;
 }
 
@@ -113,28 +147,11 @@ int RenderStateSet::changeCost(RenderStateSet *previousState)
     if (previousState == this)
         return 0;
 
-    int cost = 0;
-
-    // first, find cost of any resets
-    StateMaskSet invOurState = ~stateMask();
-    StateMaskSet stateToReset = previousState->stateMask() & invOurState;
-
-    std::bitset<64> bs(stateToReset);
-    cost += int(bs.count());
-
-    // now, find out how many states we're changing
-    for (const StateVariant &ds : qAsConst(m_states)) {
-        // if the other state contains matching, then doesn't
-        // contribute to cost at all
-        if (previousState->contains(ds))
-            continue;
-
-        // flat cost for now; could be replaced with a cost() method on
-        // RenderState
-        cost += 2;
-    }
-
-    return cost;
+    // States which have to be reset or set, plus the common ones whose
+    // values differ
+    const StateMaskSet statesToChange = (previousState->stateMask() ^ stateMask())
+            | changedStates(previousState);
+    return weightedStateCount(statesToChange);
 }
 
 void RenderStateSet::apply(GraphicsContext *gc)
@@ -157,10 +174,25 @@ void RenderStateSet::apply(GraphicsContext *gc)
 
     // Apply states that weren't in the previous state or that have
     // different values
-    for (const StateVariant &ds : qAsConst(m_states)) {
-        if (previousStates && previousStates->contains(ds))
+    const StateMaskSet statesToApply = previousStates
+            ? (stateMask() & ~previousStates->stateMask()) | changedStates(previousStates)
+            : stateMask();
+    StateMaskSet singleStates = stateMask() & ~MultiInstanceStates;
+    while (singleStates != 0) {
+        const int index = int(qCountTrailingZeroBits(singleStates));
+        const bool changed = (statesToApply & (StateMaskSet(1) << index)) != 0;
+        if (changed)
+            m_states[index].apply(gc);
+        gc->countStateChange(GraphicsContext::RenderStateChange, changed);
+        singleStates &= singleStates - 1;
+    }
+    for (const StateVariant &ds : qAsConst(m_multiStates)) {
+        if (previousStates && previousStates->containsMultiState(ds)) {
+            gc->countStateChange(GraphicsContext::RenderStateChange, false);
             continue;
+        }
         ds.apply(gc);
+        gc->countStateChange(GraphicsContext::RenderStateChange, true);
     }
 }
 
@@ -171,7 +203,34 @@ StateMaskSet RenderStateSet::stateMask() const
 
 void RenderStateSet::merge(RenderStateSet *other)
 {
-    m_stateMask |= other->stateMask();
+    // The states of this set override the ones of other
+    const StateMaskSet missingStates = other->stateMask() & ~m_stateMask;
+    StateMaskSet singleStates = missingStates & ~MultiInstanceStates;
+    while (singleStates != 0) {
+        const int index = int(qCountTrailingZeroBits(singleStates));
+        m_states[index] = other->m_states[index];
+        singleStates &= singleStates - 1;
+    }
+    if (missingStates & MultiInstanceStates) {
+        for (const StateVariant &ds : qAsConst(other->m_multiStates)) {
+            if (ds.type & missingStates)
+                m_multiStates.push_back(ds);
+        }
+    }
+    m_stateMask |= missingStates;
+}
+
+bool RenderStateSet::operator==(const RenderStateSet &other) const
+{
+    if (m_stateMask != other.m_stateMask || m_multiStates.size() != other.m_multiStates.size())
+        return false;
+    if (changedStates(&other) != 0)
+        return false;
+    for (const StateVariant &ds : qAsConst(m_multiStates)) {
+        if (!other.containsMultiState(ds))
+            return false;
+    }
+    return true;
 }
 
 void RenderStateSet::resetMasked(StateMaskSet maskOfStatesToReset, GraphicsContext *gc)
@@ -232,19 +291,39 @@ void RenderStateSet::resetMasked(StateMaskSet maskOfStatesToReset, GraphicsConte
         funcs->glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 }
 
-bool RenderStateSet::contains(const StateVariant &ds) const
+bool RenderStateSet::containsMultiState(const StateVariant &ds) const
 {
     // trivial reject using the state mask bits
     if (!(ds.type & stateMask()))
         return false;
 
-    for (const StateVariant &rs : m_states) {
+    for (const StateVariant &rs : m_multiStates) {
         if (rs == ds)
             return true;
     }
     return false;
 }
 
+StateMaskSet RenderStateSet::changedStates(const RenderStateSet *previousState) const
+{
+    StateMaskSet changed = 0;
+    StateMaskSet commonStates = stateMask() & previousState->stateMask();
+    StateMaskSet singleStates = commonStates & ~MultiInstanceStates;
+    while (singleStates != 0) {
+        const int index = int(qCountTrailingZeroBits(singleStates));
+        if (m_states[index] != previousState->m_states[index])
+            changed |= StateMaskSet(1) << index;
+        singleStates &= singleStates - 1;
+    }
+    if (commonStates & MultiInstanceStates) {
+        for (const StateVariant &ds : m_multiStates) {
+            if (!previousState->containsMultiState(ds))
+                changed |= ds.type;
+        }
+    }
+    return changed;
+}
+
 StateVariant RenderStateSet::initializeStateFromPeer(const Qt3DRender::QRenderStateCreatedChangeBasePtr change)
 {
     switch (change->renderStateType()) {
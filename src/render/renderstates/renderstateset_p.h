@@ -68,7 +68,10 @@ namespace Render {
 class GraphicsContext;
 class RenderState;
 
-class RenderStateSet
+// Holds one slot per state type, indexed by the bit of the type in the state
+// mask, except for clip planes and blend equation arguments of which a set can
+// hold several (one per plane or draw buffer)
+class Q_AUTOTEST_EXPORT RenderStateSet
 {
 public:
     RenderStateSet();
@@ -92,7 +95,9 @@ public:
     void apply(GraphicsContext* gc);
 
     StateMaskSet stateMask() const;
+    // Copies the states of other whose type isn't in this set
     void merge(RenderStateSet *other);
+    bool operator==(const RenderStateSet &other) const;
     void resetMasked(StateMaskSet maskOfStatesToReset, GraphicsContext* gc);
 
     template<class State, typename ... Args>
@@ -107,14 +112,18 @@ public:
 
 private:
     /**
-     * @brief contains - check if this set contains a matching piece of state
+     * @brief containsMultiState - check if this set contains a matching clip
+     * plane or blend equation arguments state
      * @param ds
      * @return
      */
-    bool contains(const StateVariant &ds) const;
+    bool containsMultiState(const StateVariant &ds) const;
+    // States of the types set in the mask whose value differs in previousState
+    StateMaskSet changedStates(const RenderStateSet *previousState) const;
 
     StateMaskSet m_stateMask;
-    QVector<StateVariant> m_states;
+    StateVariant m_states[StateTypeCount];
+    QVector<StateVariant> m_multiStates;
 };
 
 template<>
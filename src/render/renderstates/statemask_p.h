@@ -82,6 +82,9 @@ enum StateMask
     BlendEquationArgumentsMask  = 1 << 18,
 };
 
+// Number of StateMask values, the index of a state type is the index of its bit
+const int StateTypeCount = 19;
+
 } // namespace Render
 } // namespace Qt3DRender
 
@@ -43,12 +43,33 @@
 #include <Qt3DCore/private/qabstractframeadvanceservice_p_p.h>
 #include <QSemaphore>
 #include <QElapsedTimer>
+#include <QMutex>
+#include <QThread>
 
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DRender {
 namespace Render {
 
+namespace {
+
+const qint64 MinimumPacingMargin = 1000000;    // 1ms
+const qint64 MaximumPacingDelay = 33000000;    // 33ms
+
+// Moving average which follows the changes that shorten the pacing delay
+// right away and the ones that lengthen it slowly, so that a misprediction
+// doesn't cost more than a frame or two
+qint64 followDuration(qint64 average, qint64 sample, bool followIncreases)
+{
+    if (average == 0)
+        return sample;
+    if ((sample > average) == followIncreases)
+        return (average + sample) / 2;
+    return average + (sample - average) / 8;
+}
+
+} // anonymous
+
 class VSyncFrameAdvanceServicePrivate Q_DECL_FINAL : public Qt3DCore::QAbstractFrameAdvanceServicePrivate
 {
 public:
@@ -56,14 +77,42 @@ public:
         : QAbstractFrameAdvanceServicePrivate(QStringLiteral("Renderer Aspect Frame Advance Service - aligned with vsync"))
         , m_semaphore(0)
         , m_elapsedTimeSincePreviousFrame(0)
+        , m_pacingEnabled(!qEnvironmentVariableIsSet("QT3DRENDER_DISABLE_FRAME_PACING"))
+        , m_stopped(0)
+        , m_frameStartTime(-1)
+        , m_releaseTime(-1)
     {
     }
 
     QSemaphore m_semaphore;
     QElapsedTimer m_elapsed;
     quint64 m_elapsedTimeSincePreviousFrame;
+    bool m_pacingEnabled;
+    QAtomicInt m_stopped;
+
+    // Aspect thread
+    qint64 m_frameStartTime;
+
+    // Guards the members below, written by both threads
+    mutable QMutex m_pacingMutex;
+    qint64 m_releaseTime;
+    VSyncFrameAdvanceService::FramePacing m_pacing;
 };
 
+/*!
+ \class Qt3DRender::Render::VSyncFrameAdvanceService
+ \internal
+
+ Lets the aspect thread start a frame when the renderer is ready for one.
+
+ The service measures how long the aspect thread takes to run the jobs of a
+ frame and how long the renderer keeps submitting once it has let the aspect
+ thread go. When the renderer is the bottleneck, the start of the jobs is
+ delayed so that they complete just before the renderer needs the frame.
+ Changes and input events are then picked up as late as possible, which
+ shortens the time it takes them to reach the display. Pacing can be disabled
+ by setting QT3DRENDER_DISABLE_FRAME_PACING.
+ */
 VSyncFrameAdvanceService::VSyncFrameAdvanceService()
     : QAbstractFrameAdvanceService(*new VSyncFrameAdvanceServicePrivate())
 {
@@ -77,11 +126,30 @@ VSyncFrameAdvanceService::~VSyncFrameAdvanceService()
 qint64 VSyncFrameAdvanceService::waitForNextFrame()
 {
     Q_D(VSyncFrameAdvanceService);
+    const qint64 jobsEndTime = d->m_elapsed.nsecsElapsed();
     d->m_semaphore.acquire(1);
 
+    qint64 delay = 0;
+    {
+        QMutexLocker locker(&d->m_pacingMutex);
+        if (d->m_frameStartTime >= 0)
+            d->m_pacing.jobsDuration = followDuration(d->m_pacing.jobsDuration,
+                                                      jobsEndTime - d->m_frameStartTime,
+                                                      true);
+        if (d->m_pacingEnabled && !d->m_stopped.load())
+            delay = pacingDelay(d->m_pacing.jobsDuration, d->m_pacing.submissionDuration);
+        d->m_pacing.delay = delay;
+    }
+
+    if (delay > 0) {
+        qCDebug(VSyncAdvanceService) << "Delaying jobs by" << delay << "nsecs";
+        QThread::usleep(delay / 1000);
+    }
+
     const quint64 currentTime = d->m_elapsed.nsecsElapsed();
     qCDebug(VSyncAdvanceService) << "Elapsed nsecs since last call " << currentTime - d->m_elapsedTimeSincePreviousFrame;
     d->m_elapsedTimeSincePreviousFrame = currentTime;
+    d->m_frameStartTime = currentTime;
     return currentTime;
 }
 
@@ -100,17 +168,88 @@ void VSyncFrameAdvanceService::start()
 void VSyncFrameAdvanceService::stop()
 {
     Q_D(VSyncFrameAdvanceService);
+    d->m_stopped.store(1);
     d->m_semaphore.release(1);
     qCDebug(VSyncAdvanceService) << "Terminating VSyncFrameAdvanceService";
 }
 
+// Aspect Thread
+void VSyncFrameAdvanceService::resume()
+{
+    Q_D(VSyncFrameAdvanceService);
+    // The time spent idle isn't part of the duration of the jobs
+    if (d->m_frameStartTime >= 0)
+        d->m_frameStartTime = d->m_elapsed.nsecsElapsed();
+}
+
 // Render Thread
 void VSyncFrameAdvanceService::proceedToNextFrame()
 {
     Q_D(VSyncFrameAdvanceService);
+    {
+        QMutexLocker locker(&d->m_pacingMutex);
+        d->m_releaseTime = d->m_elapsed.isValid() ? d->m_elapsed.nsecsElapsed() : -1;
+    }
     d->m_semaphore.release(1);
 }
 
+/*!
+ \internal
+
+ Called by the renderer once it is done submitting a frame, right before it
+ starts waiting for the next one. The time elapsed since the renderer last
+ let the aspect thread proceed is the budget the jobs of a frame have.
+ */
+// Render Thread
+void VSyncFrameAdvanceService::frameSubmitted()
+{
+    Q_D(VSyncFrameAdvanceService);
+    QMutexLocker locker(&d->m_pacingMutex);
+    if (d->m_releaseTime < 0)
+        return;
+    d->m_pacing.submissionDuration = followDuration(d->m_pacing.submissionDuration,
+                                                    d->m_elapsed.nsecsElapsed() - d->m_releaseTime,
+                                                    false);
+    d->m_releaseTime = -1;
+}
+
+VSyncFrameAdvanceService::FramePacing VSyncFrameAdvanceService::framePacing() const
+{
+    Q_D(const VSyncFrameAdvanceService);
+    QMutexLocker locker(&d->m_pacingMutex);
+    return d->m_pacing;
+}
+
+void VSyncFrameAdvanceService::setPacingEnabled(bool enabled)
+{
+    Q_D(VSyncFrameAdvanceService);
+    QMutexLocker locker(&d->m_pacingMutex);
+    d->m_pacingEnabled = enabled;
+}
+
+bool VSyncFrameAdvanceService::isPacingEnabled() const
+{
+    Q_D(const VSyncFrameAdvanceService);
+    QMutexLocker locker(&d->m_pacingMutex);
+    return d->m_pacingEnabled;
+}
+
+/*!
+ \internal
+
+ Returns how long the jobs of a frame taking \a jobsDuration can be delayed
+ when the renderer keeps submitting for \a submissionDuration after letting
+ the aspect thread proceed. Returns 0 when the aspect thread is the
+ bottleneck or when nothing has been measured yet.
+ */
+qint64 VSyncFrameAdvanceService::pacingDelay(qint64 jobsDuration, qint64 submissionDuration)
+{
+    if (jobsDuration <= 0 || submissionDuration <= 0)
+        return 0;
+    const qint64 margin = qMax(MinimumPacingMargin, submissionDuration / 8);
+    return qBound(qint64(0), submissionDuration - jobsDuration - margin, MaximumPacingDelay);
+}
+
 } // namespace Render
 } // namespace Qt3DRender
 
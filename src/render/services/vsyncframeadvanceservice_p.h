@@ -70,8 +70,30 @@ public:
     qint64 waitForNextFrame() Q_DECL_FINAL;
     void start() Q_DECL_FINAL;
     void stop() Q_DECL_FINAL;
+    void resume() Q_DECL_FINAL;
 
     void proceedToNextFrame();
+    void frameSubmitted();
+
+    struct FramePacing
+    {
+        FramePacing()
+            : jobsDuration(0)
+            , submissionDuration(0)
+            , delay(0)
+        {}
+
+        // Smoothed durations and delay applied to the last frame, in nsecs
+        qint64 jobsDuration;
+        qint64 submissionDuration;
+        qint64 delay;
+    };
+
+    FramePacing framePacing() const;
+    void setPacingEnabled(bool enabled);
+    bool isPacingEnabled() const;
+
+    static qint64 pacingDelay(qint64 jobsDuration, qint64 submissionDuration);
 
 private:
     Q_DECLARE_PRIVATE(VSyncFrameAdvanceService)
@@ -43,6 +43,7 @@
 #include "qtexturedata.h"
 #include "qtexture.h"
 #include "qtexture_p.h"
+#include "qtextureimagedata_p.h"
 #include <QFileInfo>
 #include <qendian.h>
 
@@ -431,7 +432,8 @@ int bitCount(quint32 n)
 enum CompressedFormatExtension {
     None = 0,
     DDS,
-    PKM
+    PKM,
+    KTX
 };
 
 CompressedFormatExtension texturedCompressedFormat(const QString &source)
@@ -441,6 +443,8 @@ CompressedFormatExtension texturedCompressedFormat(const QString &source)
         return PKM;
     if (suffix == QStringLiteral("dds"))
         return DDS;
+    if (suffix == QStringLiteral("ktx") || suffix == QStringLiteral("ktx2"))
+        return KTX;
     return None;
 }
 
@@ -621,6 +625,468 @@ QTextureImageDataPtr setDdsFile(const QString &source)
     return imageData;
 }
 
+// KTX and KTX2 containers, as produced by f.ex. toktx or PVRTexTool
+
+struct Ktx1Header
+{
+    char identifier[12];
+    quint32 endianness;
+    quint32 glType;
+    quint32 glTypeSize;
+    quint32 glFormat;
+    quint32 glInternalFormat;
+    quint32 glBaseInternalFormat;
+    quint32 pixelWidth;
+    quint32 pixelHeight;
+    quint32 pixelDepth;
+    quint32 numberOfArrayElements;
+    quint32 numberOfFaces;
+    quint32 numberOfMipmapLevels;
+    quint32 bytesOfKeyValueData;
+};
+
+struct Ktx2Header
+{
+    char identifier[12];
+    quint32 vkFormat;
+    quint32 typeSize;
+    quint32 pixelWidth;
+    quint32 pixelHeight;
+    quint32 pixelDepth;
+    quint32 layerCount;
+    quint32 faceCount;
+    quint32 levelCount;
+    quint32 supercompressionScheme;
+    quint32 dfdByteOffset;
+    quint32 dfdByteLength;
+    quint32 kvdByteOffset;
+    quint32 kvdByteLength;
+    quint64 sgdByteOffset;
+    quint64 sgdByteLength;
+};
+
+struct Ktx2LevelIndex
+{
+    quint64 byteOffset;
+    quint64 byteLength;
+    quint64 uncompressedByteLength;
+};
+
+const char ktx1Identifier[] = { '\xAB', 'K', 'T', 'X', ' ', '1', '1', '\xBB', '\r', '\n', '\x1A', '\n' };
+const char ktx2Identifier[] = { '\xAB', 'K', 'T', 'X', ' ', '2', '0', '\xBB', '\r', '\n', '\x1A', '\n' };
+const quint32 ktxEndianness = 0x04030201;
+
+struct KtxFormatInfo
+{
+    quint32 glInternalFormat; // same value as the matching QOpenGLTexture::TextureFormat
+    quint32 vkFormat;         // 0 if the format can't be stored in KTX2
+    QOpenGLTexture::PixelFormat pixelFormat;
+    QOpenGLTexture::PixelType pixelType;
+    int blockWidth;
+    int blockHeight;
+    int blockSize;
+    bool compressed;
+};
+
+const KtxFormatInfo ktxFormats[] = {
+// uncompressed formats
+{ 0x8229 /* GL_R8 */,               9, QOpenGLTexture::Red,  QOpenGLTexture::UInt8,   1, 1,  1, false },
+{ 0x822B /* GL_RG8 */,             16, QOpenGLTexture::RG,   QOpenGLTexture::UInt8,   1, 1,  2, false },
+{ 0x8051 /* GL_RGB8 */,            23, QOpenGLTexture::RGB,  QOpenGLTexture::UInt8,   1, 1,  3, false },
+{ 0x8058 /* GL_RGBA8 */,           37, QOpenGLTexture::RGBA, QOpenGLTexture::UInt8,   1, 1,  4, false },
+{ 0x8C43 /* GL_SRGB8_ALPHA8 */,    43, QOpenGLTexture::RGBA, QOpenGLTexture::UInt8,   1, 1,  4, false },
+{ 0x881A /* GL_RGBA16F */,         97, QOpenGLTexture::RGBA, QOpenGLTexture::Float16, 1, 1,  8, false },
+{ 0x8814 /* GL_RGBA32F */,        109, QOpenGLTexture::RGBA, QOpenGLTexture::Float32, 1, 1, 16, false },
+
+// BCn formats
+{ QOpenGLTexture::RGB_DXT1,                131, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4,  8, true },
+{ QOpenGLTexture::SRGB_DXT1,               132, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4,  8, true },
+{ QOpenGLTexture::RGBA_DXT1,               133, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4,  8, true },
+{ QOpenGLTexture::SRGB_Alpha_DXT1,         134, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4,  8, true },
+{ QOpenGLTexture::RGBA_DXT3,               135, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+{ QOpenGLTexture::SRGB_Alpha_DXT3,         136, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+{ QOpenGLTexture::RGBA_DXT5,               137, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+{ QOpenGLTexture::SRGB_Alpha_DXT5,         138, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+{ QOpenGLTexture::R_ATI1N_UNorm,           139, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4,  8, true },
+{ QOpenGLTexture::R_ATI1N_SNorm,           140, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4,  8, true },
+{ QOpenGLTexture::RG_ATI2N_UNorm,          141, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+{ QOpenGLTexture::RG_ATI2N_SNorm,          142, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+{ QOpenGLTexture::RGB_BP_UNSIGNED_FLOAT,   143, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+{ QOpenGLTexture::RGB_BP_SIGNED_FLOAT,     144, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+{ QOpenGLTexture::RGB_BP_UNorm,            145, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+{ QOpenGLTexture::SRGB_BP_UNorm,           146, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+
+// ETC and EAC formats
+{ QOpenGLTexture::RGB8_ETC1,                       0, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4,  8, true },
+{ QOpenGLTexture::RGB8_ETC2,                     147, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4,  8, true },
+{ QOpenGLTexture::SRGB8_ETC2,                    148, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4,  8, true },
+{ QOpenGLTexture::RGB8_PunchThrough_Alpha1_ETC2, 149, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4,  8, true },
+{ QOpenGLTexture::SRGB8_PunchThrough_Alpha1_ETC2, 150, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4,  8, true },
+{ QOpenGLTexture::RGBA8_ETC2_EAC,                151, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+{ QOpenGLTexture::SRGB8_Alpha8_ETC2_EAC,         152, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+{ QOpenGLTexture::R11_EAC_UNorm,                 153, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4,  8, true },
+{ QOpenGLTexture::R11_EAC_SNorm,                 154, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4,  8, true },
+{ QOpenGLTexture::RG11_EAC_UNorm,                155, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+{ QOpenGLTexture::RG11_EAC_SNorm,                156, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 4, 4, 16, true },
+
+// ASTC formats, GL_COMPRESSED_RGBA_ASTC_* and GL_COMPRESSED_SRGB8_ALPHA8_ASTC_*
+{ 0x93B0, 157, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  4,  4, 16, true },
+{ 0x93D0, 158, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  4,  4, 16, true },
+{ 0x93B1, 159, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  5,  4, 16, true },
+{ 0x93D1, 160, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  5,  4, 16, true },
+{ 0x93B2, 161, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  5,  5, 16, true },
+{ 0x93D2, 162, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  5,  5, 16, true },
+{ 0x93B3, 163, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  6,  5, 16, true },
+{ 0x93D3, 164, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  6,  5, 16, true },
+{ 0x93B4, 165, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  6,  6, 16, true },
+{ 0x93D4, 166, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  6,  6, 16, true },
+{ 0x93B5, 167, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  8,  5, 16, true },
+{ 0x93D5, 168, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  8,  5, 16, true },
+{ 0x93B6, 169, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  8,  6, 16, true },
+{ 0x93D6, 170, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  8,  6, 16, true },
+{ 0x93B7, 171, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  8,  8, 16, true },
+{ 0x93D7, 172, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType,  8,  8, 16, true },
+{ 0x93B8, 173, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 10,  5, 16, true },
+{ 0x93D8, 174, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 10,  5, 16, true },
+{ 0x93B9, 175, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 10,  6, 16, true },
+{ 0x93D9, 176, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 10,  6, 16, true },
+{ 0x93BA, 177, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 10,  8, 16, true },
+{ 0x93DA, 178, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 10,  8, 16, true },
+{ 0x93BB, 179, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 10, 10, 16, true },
+{ 0x93DB, 180, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 10, 10, 16, true },
+{ 0x93BC, 181, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 12, 10, 16, true },
+{ 0x93DC, 182, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 12, 10, 16, true },
+{ 0x93BD, 183, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 12, 12, 16, true },
+{ 0x93DD, 184, QOpenGLTexture::NoSourceFormat, QOpenGLTexture::NoPixelType, 12, 12, 16, true },
+};
+
+const KtxFormatInfo *ktxFormatFromGL(quint32 glInternalFormat)
+{
+    for (const KtxFormatInfo &info : ktxFormats) {
+        if (info.glInternalFormat == glInternalFormat)
+            return &info;
+    }
+    return nullptr;
+}
+
+const KtxFormatInfo *ktxFormatFromVk(quint32 vkFormat)
+{
+    for (const KtxFormatInfo &info : ktxFormats) {
+        if (vkFormat != 0 && info.vkFormat == vkFormat)
+            return &info;
+    }
+    return nullptr;
+}
+
+// Describes the images of a KTX file, which are stored level by level
+// whereas QTextureImageData expects them layer by layer, then face by face
+struct KtxImageLayout
+{
+    const KtxFormatInfo *formatInfo;
+    QOpenGLTexture::Target target;
+    int width;
+    int height;
+    int depth;
+    int layers;
+    int faces;
+    int mipLevels;
+    int rowAlignment;   // KTX1 pads uncompressed rows to 4 bytes, KTX2 doesn't
+    int swapSize;       // size of the components to byte swap, 1 if none
+
+    int levelSize(int level) const
+    {
+        const int w = qMax(width >> level, 1);
+        const int h = qMax(height >> level, 1);
+        const int d = qMax(depth >> level, 1);
+        return ((w + formatInfo->blockWidth - 1) / formatInfo->blockWidth) *
+               ((h + formatInfo->blockHeight - 1) / formatInfo->blockHeight) *
+               formatInfo->blockSize * d;
+    }
+
+    // Size of a single layer / face image of the given level in the file
+    qint64 sourceImageSize(int level) const
+    {
+        if (formatInfo->compressed || rowAlignment <= 1)
+            return levelSize(level);
+        const int w = qMax(width >> level, 1);
+        const int h = qMax(height >> level, 1);
+        const int d = qMax(depth >> level, 1);
+        const int rowSize = w * formatInfo->blockSize;
+        const int rowPitch = (rowSize + rowAlignment - 1) / rowAlignment * rowAlignment;
+        return qint64(rowPitch) * h * d;
+    }
+};
+
+template<typename T>
+void byteSwap(char *data, int size)
+{
+    for (T *it = reinterpret_cast<T *>(data), *end = it + size / sizeof(T); it != end; ++it)
+        *it = qbswap(*it);
+}
+
+// Copies one layer / face image of a level from the file into its final place
+void copyKtxImage(const KtxImageLayout &layout, int level, const uchar *source, char *destination)
+{
+    const int size = layout.levelSize(level);
+    if (layout.formatInfo->compressed || layout.sourceImageSize(level) == size) {
+        memcpy(destination, source, size);
+    } else {
+        // Strip the row padding
+        const int w = qMax(layout.width >> level, 1);
+        const int rows = qMax(layout.height >> level, 1) * qMax(layout.depth >> level, 1);
+        const int rowSize = w * layout.formatInfo->blockSize;
+        const int rowPitch = (rowSize + layout.rowAlignment - 1) / layout.rowAlignment * layout.rowAlignment;
+        for (int row = 0; row < rows; ++row)
+            memcpy(destination + row * rowSize, source + row * rowPitch, rowSize);
+    }
+
+    if (layout.swapSize == 2)
+        byteSwap<quint16>(destination, size);
+    else if (layout.swapSize == 4)
+        byteSwap<quint32>(destination, size);
+}
+
+QTextureImageDataPtr createKtxImageData(const KtxImageLayout &layout, const QByteArray &data)
+{
+    QTextureImageDataPtr imageData = QTextureImageDataPtr::create();
+    imageData->setData(data, layout.formatInfo->blockSize, layout.formatInfo->compressed);
+    QTextureImageDataPrivate *dataPrivate = QTextureImageDataPrivate::get(imageData.data());
+    dataPrivate->m_compressedBlockWidth = layout.formatInfo->blockWidth;
+    dataPrivate->m_compressedBlockHeight = layout.formatInfo->blockHeight;
+
+    imageData->setTarget(layout.target);
+    imageData->setMipLevels(layout.mipLevels);
+    imageData->setFormat(static_cast<QOpenGLTexture::TextureFormat>(layout.formatInfo->glInternalFormat));
+    imageData->setPixelType(layout.formatInfo->pixelType);
+    imageData->setPixelFormat(layout.formatInfo->pixelFormat);
+    imageData->setLayers(layout.layers);
+    imageData->setDepth(layout.depth);
+    imageData->setWidth(layout.width);
+    imageData->setHeight(layout.height);
+    imageData->setFaces(layout.faces);
+    return imageData;
+}
+
+QOpenGLTexture::Target ktxTarget(int height, int depth, int faces, bool isArray)
+{
+    if (depth > 1)
+        return QOpenGLTexture::Target3D;
+    if (faces == 6)
+        return isArray ? QOpenGLTexture::TargetCubeMapArray : QOpenGLTexture::TargetCubeMap;
+    if (height == 0)
+        return isArray ? QOpenGLTexture::Target1DArray : QOpenGLTexture::Target1D;
+    return isArray ? QOpenGLTexture::Target2DArray : QOpenGLTexture::Target2D;
+}
+
+QTextureImageDataPtr setKtx1Data(const QString &source, const uchar *contents, qint64 size)
+{
+    QTextureImageDataPtr imageData;
+    Ktx1Header header;
+    if (size < qint64(sizeof header))
+        return imageData;
+    memcpy(&header, contents, sizeof header);
+
+    // Files written on a big endian host store everything in reverse order
+    const bool swap = header.endianness != ktxEndianness;
+    if (swap && qbswap(header.endianness) != ktxEndianness) {
+        qWarning() << "Invalid endianness in" << source;
+        return imageData;
+    }
+    auto value = [swap] (quint32 v) { return swap ? qbswap(v) : v; };
+
+    const quint32 glType = value(header.glType);
+    const quint32 glTypeSize = value(header.glTypeSize);
+    const KtxFormatInfo *formatInfo = ktxFormatFromGL(value(header.glInternalFormat));
+    if (formatInfo == nullptr || formatInfo->compressed != (glType == 0)) {
+        qWarning() << "Unrecognized pixel format in" << source;
+        return imageData;
+    }
+
+    KtxImageLayout layout;
+    layout.formatInfo = formatInfo;
+    layout.width = value(header.pixelWidth);
+    layout.height = qMax(value(header.pixelHeight), 1U);
+    layout.depth = qMax(value(header.pixelDepth), 1U);
+    layout.layers = qMax(value(header.numberOfArrayElements), 1U);
+    layout.faces = value(header.numberOfFaces);
+    // 0 mip levels means the mip chain is to be generated at runtime
+    layout.mipLevels = qMax(value(header.numberOfMipmapLevels), 1U);
+    layout.rowAlignment = 4;
+    layout.swapSize = swap && (glTypeSize == 2 || glTypeSize == 4) ? int(glTypeSize) : 1;
+    layout.target = ktxTarget(value(header.pixelHeight), layout.depth, layout.faces,
+                              value(header.numberOfArrayElements) > 0);
+
+    if (layout.width <= 0 || (layout.faces != 1 && layout.faces != 6)) {
+        qWarning() << "Invalid dimensions in" << source;
+        return imageData;
+    }
+
+    qint64 totalSize = 0;
+    for (int level = 0; level < layout.mipLevels; ++level)
+        totalSize += layout.levelSize(level);
+    totalSize *= layout.layers * layout.faces;
+    QByteArray data(int(totalSize), Qt::Uninitialized);
+
+    const int faceSize = int(totalSize / (layout.layers * layout.faces));
+    const int layerSize = faceSize * layout.faces;
+    // Non array cube maps store each face with its own padding
+    const bool cubePadding = layout.faces == 6 && value(header.numberOfArrayElements) == 0;
+
+    qint64 offset = sizeof header + value(header.bytesOfKeyValueData);
+    int levelOffset = 0;
+    for (int level = 0; level < layout.mipLevels; ++level) {
+        if (offset + 4 > size)
+            break;
+        quint32 imageSize;
+        memcpy(&imageSize, contents + offset, sizeof imageSize);
+        imageSize = value(imageSize);
+        offset += 4;
+
+        const qint64 sourceImageSize = layout.sourceImageSize(level);
+        const qint64 expectedSize = cubePadding ? sourceImageSize : sourceImageSize * layout.layers * layout.faces;
+        if (imageSize < expectedSize) {
+            qWarning() << "Unexpected image size (got" << imageSize << ", expecting" << expectedSize << ") in" << source;
+            return imageData;
+        }
+
+        for (int layer = 0; layer < layout.layers; ++layer) {
+            for (int face = 0; face < layout.faces; ++face) {
+                if (offset + sourceImageSize > size) {
+                    qWarning() << "Unexpected end of data in" << source;
+                    return imageData;
+                }
+                copyKtxImage(layout, level, contents + offset,
+                             data.data() + layer * layerSize + face * faceSize + levelOffset);
+                offset += sourceImageSize;
+                if (cubePadding)
+                    offset = (offset + 3) & ~qint64(3);
+            }
+        }
+        // Skip the extra bytes of the level and its padding
+        if (!cubePadding)
+            offset += imageSize - expectedSize;
+        offset = (offset + 3) & ~qint64(3);
+        levelOffset += layout.levelSize(level);
+    }
+
+    if (levelOffset != faceSize) {
+        qWarning() << "Unexpected end of data in" << source;
+        return imageData;
+    }
+
+    return createKtxImageData(layout, data);
+}
+
+QTextureImageDataPtr setKtx2Data(const QString &source, const uchar *contents, qint64 size)
+{
+    QTextureImageDataPtr imageData;
+    Ktx2Header header;
+    if (size < qint64(sizeof header))
+        return imageData;
+    memcpy(&header, contents, sizeof header);
+
+    if (qFromLittleEndian(header.supercompressionScheme) != 0) {
+        qWarning() << "Supercompressed KTX2 files are not supported" << source;
+        return imageData;
+    }
+
+    const KtxFormatInfo *formatInfo = ktxFormatFromVk(qFromLittleEndian(header.vkFormat));
+    if (formatInfo == nullptr) {
+        qWarning() << "Unrecognized pixel format in" << source;
+        return imageData;
+    }
+
+    KtxImageLayout layout;
+    layout.formatInfo = formatInfo;
+    layout.width = qFromLittleEndian(header.pixelWidth);
+    layout.height = qMax(qFromLittleEndian(header.pixelHeight), 1U);
+    layout.depth = qMax(qFromLittleEndian(header.pixelDepth), 1U);
+    layout.layers = qMax(qFromLittleEndian(header.layerCount), 1U);
+    layout.faces = qFromLittleEndian(header.faceCount);
+    layout.mipLevels = qMax(qFromLittleEndian(header.levelCount), 1U);
+    layout.rowAlignment = 1;
+    layout.swapSize = 1;
+    layout.target = ktxTarget(qFromLittleEndian(header.pixelHeight), layout.depth, layout.faces,
+                              qFromLittleEndian(header.layerCount) > 0);
+
+    if (layout.width <= 0 || (layout.faces != 1 && layout.faces != 6)) {
+        qWarning() << "Invalid dimensions in" << source;
+        return imageData;
+    }
+
+    const qint64 levelIndexOffset = sizeof header;
+    if (levelIndexOffset + qint64(sizeof(Ktx2LevelIndex)) * layout.mipLevels > size) {
+        qWarning() << "Unexpected end of data in" << source;
+        return imageData;
+    }
+
+    qint64 totalSize = 0;
+    for (int level = 0; level < layout.mipLevels; ++level)
+        totalSize += layout.levelSize(level);
+    totalSize *= layout.layers * layout.faces;
+    QByteArray data(int(totalSize), Qt::Uninitialized);
+
+    const int faceSize = int(totalSize / (layout.layers * layout.faces));
+    const int layerSize = faceSize * layout.faces;
+
+    int levelOffset = 0;
+    for (int level = 0; level < layout.mipLevels; ++level) {
+        Ktx2LevelIndex levelIndex;
+        memcpy(&levelIndex, contents + levelIndexOffset + level * sizeof levelIndex, sizeof levelIndex);
+        const quint64 byteOffset = qFromLittleEndian(levelIndex.byteOffset);
+        const quint64 byteLength = qFromLittleEndian(levelIndex.byteLength);
+        const qint64 imageSize = layout.levelSize(level);
+
+        if (byteLength < quint64(imageSize * layout.layers * layout.faces) || byteOffset + byteLength > quint64(size)) {
+            qWarning() << "Unexpected data size for level" << level << "in" << source;
+            return imageData;
+        }
+
+        const uchar *levelData = contents + byteOffset;
+        for (int layer = 0; layer < layout.layers; ++layer) {
+            for (int face = 0; face < layout.faces; ++face) {
+                copyKtxImage(layout, level, levelData,
+                             data.data() + layer * layerSize + face * faceSize + levelOffset);
+                levelData += imageSize;
+            }
+        }
+        levelOffset += imageSize;
+    }
+
+    return createKtxImageData(layout, data);
+}
+
+QTextureImageDataPtr setKtxFile(const QString &source)
+{
+    QTextureImageDataPtr imageData;
+    QFile f(source);
+    if (!f.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open" << source;
+        return imageData;
+    }
+
+    // Map the file so that the images are copied only once, straight into
+    // the QTextureImageData. Fallback to reading it for non mappable devices
+    QByteArray contents;
+    qint64 size = f.size();
+    const uchar *data = f.map(0, size);
+    if (data == nullptr) {
+        contents = f.readAll();
+        data = reinterpret_cast<const uchar *>(contents.constData());
+        size = contents.size();
+    }
+
+    if (size >= qint64(sizeof ktx1Identifier)) {
+        if (!memcmp(data, ktx1Identifier, sizeof ktx1Identifier))
+            imageData = setKtx1Data(source, data, size);
+        else if (!memcmp(data, ktx2Identifier, sizeof ktx2Identifier))
+            imageData = setKtx2Data(source, data, size);
+        else
+            qWarning() << "Invalid KTX identifier in" << source;
+    }
+    return imageData;
+}
+
 } // anonynous
 
 QTextureImageDataPtr TextureLoadingHelper::loadTextureData(const QUrl &url, bool allow3D, bool mirrored)
@@ -636,6 +1102,9 @@ QTextureImageDataPtr TextureLoadingHelper::loadTextureData(const QUrl &url, bool
         case PKM:
             textureData = setPkmFile(source);
             break;
+        case KTX:
+            textureData = setKtxFile(source);
+            break;
         default:
             QImage img;
             if (img.load(source)) {
@@ -54,6 +54,8 @@ QTextureImageDataPrivate::QTextureImageDataPrivate()
     , m_faces(-1)
     , m_mipLevels(-1)
     , m_blockSize(-1)
+    , m_compressedBlockWidth(4)
+    , m_compressedBlockHeight(4)
     , m_target(QOpenGLTexture::Target2D)
     , m_format(QOpenGLTexture::RGBA8_UNorm)
     , m_pixelFormat(QOpenGLTexture::RGBA)
@@ -116,7 +118,8 @@ int QTextureImageDataPrivate::mipmapLevelSize(int level) const
     int d = qMax(m_depth >> level, 1);
 
     if (m_isCompressed)
-        return ((w + 3) / 4) * ((h + 3) / 4) * m_blockSize * d;
+        return ((w + m_compressedBlockWidth - 1) / m_compressedBlockWidth) *
+               ((h + m_compressedBlockHeight - 1) / m_compressedBlockHeight) * m_blockSize * d;
     else
         return w * h * m_blockSize * d;
 }
@@ -169,6 +172,8 @@ void QTextureImageData::cleanup() Q_DECL_NOTHROW
     d->m_faces = -1;
     d->m_mipLevels = -1;
     d->m_blockSize = 0;
+    d->m_compressedBlockWidth = 4;
+    d->m_compressedBlockHeight = 4;
     d->m_isCompressed = false;
     d->m_data.clear();
 }
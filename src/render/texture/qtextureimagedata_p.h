@@ -75,6 +75,9 @@ public:
     int m_faces;
     int m_mipLevels;
     int m_blockSize;
+    // Texels covered by a block of compressed data, 4x4 for all but ASTC
+    int m_compressedBlockWidth;
+    int m_compressedBlockHeight;
 
     QOpenGLTexture::Target m_target;
     QOpenGLTexture::TextureFormat m_format;
@@ -95,6 +95,8 @@ Texture::Texture()
     , m_isDirty(false)
     , m_filtersAndWrapUpdated(false)
     , m_dataUploadRequired(false)
+    , m_pendingMipLevel(-1)
+    , m_uploadMipLevels(1)
     , m_textureDNA(0)
     , m_textureManager(nullptr)
     , m_textureImageManager(nullptr)
@@ -138,6 +140,9 @@ void Texture::cleanup()
     m_isDirty = false;
     m_filtersAndWrapUpdated = false;
     m_dataUploadRequired = false;
+    m_pendingMipLevel = -1;
+    m_uploadMipLevels = 1;
+    m_glShareKey.clear();
     m_textureDNA = 0;
     m_textureImages.clear();
     m_textureManager = nullptr;
@@ -178,7 +183,7 @@ void Texture::initializeFromPeer(const Qt3DCore::QNodeCreatedChangeBasePtr &chan
     // I think, and do it consistently with other types that refer to other nodes.
     //data.textureImageIds
 
-    m_isDirty = true;
+    setDirty();
 }
 
 // RenderTread
@@ -200,11 +205,18 @@ QOpenGLTexture *Texture::getOrCreateGLTexture()
 
     QMutexLocker lock(&m_lock);
     if (m_isDirty) {
-        delete m_gl;
-        m_gl = nullptr;
+        destroyGLTexture();
         m_isDirty = false;
     }
 
+    // A texture shared with other textures must not be modified,
+    // we need our own unless we were the last one using it
+    if (m_gl != nullptr && !m_glShareKey.isEmpty() && (m_filtersAndWrapUpdated || m_dataUploadRequired)) {
+        if (!m_textureDataManager->releaseSharedGLTexture(m_gl))
+            m_gl = nullptr;
+        m_glShareKey.clear();
+    }
+
     // If the texture exists, we just update it and return
     if (m_gl != nullptr) {
 
@@ -220,9 +232,24 @@ QOpenGLTexture *Texture::getOrCreateGLTexture()
         if (refreshDNA)
             updateDNA();
 
+        shareGLTexture();
         return m_gl;
     }
 
+    // Reuse the GL texture of a texture built from the same data
+    // and with the same parameters if there is one
+    if (isGLTextureShareable()) {
+        const QVector<quint32> shareKey = glTextureShareKey();
+        m_gl = m_textureDataManager->acquireSharedGLTexture(shareKey);
+        if (m_gl != nullptr) {
+            m_glShareKey = shareKey;
+            m_filtersAndWrapUpdated = false;
+            m_dataUploadRequired = false;
+            updateDNA();
+            return m_gl;
+        }
+    }
+
     // Builds a new Texture, the texture was never created or it was destroyed
     // because it was dirty
     m_gl = buildGLTexture();
@@ -238,11 +265,14 @@ QOpenGLTexture *Texture::getOrCreateGLTexture()
     m_filtersAndWrapUpdated = false;
 
     // Upload textures data the first time
+    m_pendingMipLevel = -1;
     updateAndLoadTextureImage();
 
     // Update DNA
     updateDNA();
 
+    shareGLTexture();
+
     // Ideally we might want to abstract that and use the GraphicsContext as a wrapper
     // around that.
 #if defined(QT3D_RENDER_ASPECT_OPENGL_DEBUG)
@@ -256,6 +286,62 @@ QOpenGLTexture *Texture::getOrCreateGLTexture()
     return m_gl;
 }
 
+// RenderThread
+void Texture::destroyGLTexture()
+{
+    // Other textures may still be using a shared texture
+    if (!m_glShareKey.isEmpty()) {
+        if (!m_textureDataManager->releaseSharedGLTexture(m_gl))
+            m_gl = nullptr;
+        m_glShareKey.clear();
+    }
+    delete m_gl;
+    m_gl = nullptr;
+}
+
+// Only textures whose content entirely comes from QTextureGenerator data
+// can be shared, the data handles being shared by content already
+bool Texture::isGLTextureShareable() const
+{
+    return m_textureImages.isEmpty() && !m_textureDataHandles.isEmpty();
+}
+
+QVector<quint32> Texture::glTextureShareKey() const
+{
+    QVector<quint32> key;
+    key.reserve(m_textureDataHandles.size() + 17);
+    for (const HTextureData textureDataHandle : m_textureDataHandles)
+        key.push_back(textureDataHandle.handle());
+
+    quint32 maximumAnisotropy;
+    memcpy(&maximumAnisotropy, &m_maximumAnisotropy, sizeof(maximumAnisotropy));
+
+    key << quint32(m_width) << quint32(m_height) << quint32(m_depth)
+        << quint32(m_layers) << quint32(m_samples) << quint32(m_mipLevels)
+        << quint32(m_generateMipMaps) << quint32(m_target) << quint32(m_format)
+        << quint32(m_magnificationFilter) << quint32(m_minificationFilter)
+        << quint32(m_wrapModeX) << quint32(m_wrapModeY) << quint32(m_wrapModeZ)
+        << maximumAnisotropy << quint32(m_comparisonFunction) << quint32(m_comparisonMode);
+    return key;
+}
+
+// RenderThread
+// Offers a fully uploaded texture to the other textures built from the same data
+void Texture::shareGLTexture()
+{
+    if (m_gl == nullptr || !m_glShareKey.isEmpty() || m_dataUploadRequired || !isGLTextureShareable())
+        return;
+
+    qint64 size = 0;
+    for (const HTextureData textureDataHandle : qAsConst(m_textureDataHandles)) {
+        QTextureImageData *data = m_textureDataManager->data(textureDataHandle);
+        if (data != nullptr)
+            size += TextureDecodeQueue::byteSize(data);
+    }
+    m_glShareKey = glTextureShareKey();
+    m_textureDataManager->addSharedGLTexture(m_glShareKey, m_gl, size);
+}
+
 // RenderThread
 QOpenGLTexture *Texture::buildGLTexture()
 {
@@ -348,37 +434,38 @@ QOpenGLTexture *Texture::buildGLTexture()
 }
 
 // RenderThread
-void Texture::setToGLTexture(QTextureImageData *imgData)
+// Uploads a single mip level of all the layers and faces of imgData
+// and returns the number of bytes that were uploaded
+qint64 Texture::setToGLTexture(QTextureImageData *imgData, int level)
 {
     Q_ASSERT(m_gl && m_gl->isCreated() && m_gl->isStorageAllocated());
 
     const int layers = imgData->layers();
     const int faces = imgData->faces();
-    const int mipLevels = m_generateMipMaps ? 1 : imgData->mipLevels();
+    qint64 uploadedBytes = 0;
 
     for (int layer = 0; layer < layers; layer++) {
         for (int face = 0; face < faces; face++) {
-            for (int level = 0; level < mipLevels; level++) {
-                // ensure we don't accidently cause a detach / copy of the raw bytes
-                const QByteArray &bytes(imgData->data(layer, face, level));
-
-                if (imgData->isCompressed()) {
-                    m_gl->setCompressedData(level,
-                                            layer,
-                                            static_cast<QOpenGLTexture::CubeMapFace>(QOpenGLTexture::CubeMapPositiveX + face),
-                                            bytes.size(),
-                                            bytes.constData());
-                } else {
-                    QOpenGLPixelTransferOptions uploadOptions;
-                    uploadOptions.setAlignment(1);
-                    m_gl->setData(level,
-                                  layer,
-                                  static_cast<QOpenGLTexture::CubeMapFace>(QOpenGLTexture::CubeMapPositiveX + face),
-                                  imgData->pixelFormat(),
-                                  imgData->pixelType(),
-                                  bytes.constData(),
-                                  &uploadOptions);
-                }
+            // ensure we don't accidently cause a detach / copy of the raw bytes
+            const QByteArray &bytes(imgData->data(layer, face, level));
+            uploadedBytes += bytes.size();
+
+            if (imgData->isCompressed()) {
+                m_gl->setCompressedData(level,
+                                        layer,
+                                        static_cast<QOpenGLTexture::CubeMapFace>(QOpenGLTexture::CubeMapPositiveX + face),
+                                        bytes.size(),
+                                        bytes.constData());
+            } else {
+                QOpenGLPixelTransferOptions uploadOptions;
+                uploadOptions.setAlignment(1);
+                m_gl->setData(level,
+                              layer,
+                              static_cast<QOpenGLTexture::CubeMapFace>(QOpenGLTexture::CubeMapPositiveX + face),
+                              imgData->pixelFormat(),
+                              imgData->pixelType(),
+                              bytes.constData(),
+                              &uploadOptions);
             }
         }
     }
@@ -393,6 +480,61 @@ void Texture::setToGLTexture(QTextureImageData *imgData)
             qWarning() << Q_FUNC_INFO << err;
     }
 #endif
+
+    return uploadedBytes;
+}
+
+// RenderThread
+// Uploads the QTexImageData set by the QTextureGenerator starting from the
+// smallest mip level. Once the upload budget of a pass is spent, the remaining
+// levels are uploaded on the next frames while the base level of the texture
+// points to the largest level available so far. Returns true once all
+// levels have been uploaded.
+bool Texture::uploadGeneratedTextureData()
+{
+    if (m_textureDataHandles.isEmpty())
+        return true;
+
+    if (m_pendingMipLevel < 0) {
+        m_uploadMipLevels = 1;
+        if (!m_generateMipMaps) {
+            for (const HTextureData textureDataHandle : qAsConst(m_textureDataHandles)) {
+                QTextureImageData *data = m_textureDataManager->data(textureDataHandle);
+                if (data != nullptr)
+                    m_uploadMipLevels = qMax(m_uploadMipLevels, data->mipLevels());
+            }
+        }
+        m_pendingMipLevel = m_uploadMipLevels - 1;
+    }
+
+    // Bytes uploaded per pass before deferring the larger levels to the next frame
+    static const qint64 uploadBudget = []() -> qint64 {
+        bool ok = false;
+        const qint64 budget = qgetenv("QT3DRENDER_TEXTURE_UPLOAD_BUDGET").toLongLong(&ok);
+        return ok ? budget : qint64(16) * 1024 * 1024;
+    }();
+
+    qint64 uploadedBytes = 0;
+    while (m_pendingMipLevel >= 0) {
+        for (const HTextureData textureDataHandle : qAsConst(m_textureDataHandles)) {
+            QTextureImageData *data = m_textureDataManager->data(textureDataHandle);
+            if (data != nullptr && m_pendingMipLevel < (m_generateMipMaps ? 1 : data->mipLevels()))
+                uploadedBytes += setToGLTexture(data, m_pendingMipLevel);
+        }
+        --m_pendingMipLevel;
+        if (uploadBudget > 0 && uploadedBytes >= uploadBudget)
+            break;
+    }
+
+    if (m_uploadMipLevels > 1)
+        m_gl->setMipBaseLevel(m_pendingMipLevel + 1);
+
+    if (m_pendingMipLevel >= 0)
+        return false;
+
+    for (const HTextureData textureDataHandle : qAsConst(m_textureDataHandles))
+        m_textureDataManager->decodeQueue()->releasePendingUpload(textureDataHandle);
+    return true;
 }
 
 // RenderThread
@@ -499,11 +641,20 @@ bool Texture::isTextureReset() const
     return m_isDirty;
 }
 
+// Flags the GL texture for recreation, the renderer only
+// visits the textures that were flagged
+void Texture::setDirty()
+{
+    m_isDirty = true;
+    if (m_textureManager != nullptr)
+        m_textureManager->addTextureToUpdate(peerId());
+}
+
 void Texture::setTarget(QAbstractTexture::Target target)
 {
     if (target != m_target) {
         m_target = target;
-        m_isDirty = true;
+        setDirty();
     }
 }
 
@@ -511,15 +662,15 @@ void Texture::setSize(int width, int height, int depth)
 {
     if (width != m_width) {
         m_width = width;
-        m_isDirty |= true;
+        setDirty();
     }
     if (height != m_height) {
         m_height = height;
-        m_isDirty |= true;
+        setDirty();
     }
     if (depth != m_depth) {
         m_depth = depth;
-        m_isDirty |= true;
+        setDirty();
     }
 }
 
@@ -527,7 +678,7 @@ void Texture::setFormat(QAbstractTexture::TextureFormat format)
 {
     if (format != m_format) {
         m_format = format;
-        m_isDirty |= true;
+        setDirty();
     }
 }
 
@@ -535,7 +686,7 @@ void Texture::setMipLevels(int mipLevels)
 {
     if (mipLevels != m_mipLevels) {
         m_mipLevels = mipLevels;
-        m_isDirty = true;
+        setDirty();
     }
 }
 
@@ -543,7 +694,7 @@ void Texture::setLayers(int layers)
 {
     if (layers != m_layers) {
         m_layers = layers;
-        m_isDirty = true;
+        setDirty();
     }
 }
 
@@ -591,7 +742,8 @@ void Texture::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
         } else if (propertyChange->propertyName() == QByteArrayLiteral("mipmaps")) {
             const bool oldMipMaps = m_generateMipMaps;
             m_generateMipMaps = propertyChange->value().toBool();
-            m_isDirty |= (oldMipMaps != m_generateMipMaps);
+            if (oldMipMaps != m_generateMipMaps)
+                setDirty();
         } else if (propertyChange->propertyName() == QByteArrayLiteral("minificationFilter")) {
             QAbstractTexture::Filter oldMinFilter = m_minificationFilter;
             m_minificationFilter = static_cast<QAbstractTexture::Filter>(propertyChange->value().toInt());
@@ -617,7 +769,8 @@ void Texture::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
         } else if (propertyChange->propertyName() == QByteArrayLiteral("target")) {
             QAbstractTexture::Target oldTarget = m_target;
             m_target = static_cast<QAbstractTexture::Target>(propertyChange->value().toInt());
-            m_isDirty |= (oldTarget != m_target);
+            if (oldTarget != m_target)
+                setDirty();
         } else if (propertyChange->propertyName() == QByteArrayLiteral("maximumAnisotropy")) {
             float oldMaximumAnisotropy = m_maximumAnisotropy;
             m_maximumAnisotropy = propertyChange->value().toFloat();
@@ -633,11 +786,13 @@ void Texture::sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e)
         } else if (propertyChange->propertyName() == QByteArrayLiteral("layers")) {
             const int oldLayers = m_layers;
             m_layers = propertyChange->value().toInt();
-            m_isDirty |= (oldLayers != m_layers);
+            if (oldLayers != m_layers)
+                setDirty();
         } else if (propertyChange->propertyName() == QByteArrayLiteral("samples")) {
             const int oldSamples = m_samples;
             m_samples = propertyChange->value().toInt();
-            m_isDirty |= (oldSamples != m_samples);
+            if (oldSamples != m_samples)
+                setDirty();
         }
 
         // TO DO: Handle the textureGenerator change
@@ -695,11 +850,7 @@ void Texture::setTextureDataManager(TextureDataManager *manager)
 void Texture::updateAndLoadTextureImage()
 {
     // Upload all QTexImageData set by the QTextureGenerator
-    for (const HTextureData textureDataHandle : qAsConst(m_textureDataHandles)) {
-        QTextureImageData *data = m_textureDataManager->data(textureDataHandle);
-        if (data != Q_NULLPTR)
-            setToGLTexture(data);
-    }
+    const bool generatedDataUploaded = uploadGeneratedTextureData();
 
     // Upload all QTexImageData references by the TextureImages
     QVector<TextureImageDNA> dnas;
@@ -713,13 +864,15 @@ void Texture::updateAndLoadTextureImage()
             QTextureImageData *data = m_textureDataManager->data(img->textureDataHandle());
             if (data != nullptr) {
                 setToGLTexture(img, data);
+                m_textureDataManager->decodeQueue()->releasePendingUpload(img->textureDataHandle());
                 dnas.append(img->dna());
                 img->unsetDirty();
             }
         }
     }
 
-    m_dataUploadRequired = false;
+    // Keep uploading the remaining mip levels on the next frames
+    m_dataUploadRequired = !generatedDataUploaded;
 }
 
 void Texture::addTextureImageData(HTextureImage handle)
@@ -735,6 +888,7 @@ void Texture::removeTextureImageData(HTextureImage handle)
 void Texture::requestTextureDataUpdate()
 {
     m_dataUploadRequired = true;
+    m_pendingMipLevel = -1;
 }
 
 // Will request a new jobs, if one of the texture data has changed
@@ -786,10 +940,12 @@ void Texture::addTextureDataHandle(HTextureData handle)
 void Texture::releaseTextureDataHandles()
 {
     if (m_textureDataHandles.size() > 0) {
-        m_isDirty = true;
+        setDirty();
         Q_ASSERT(m_textureDataManager);
-        for (HTextureData textureData : qAsConst(m_textureDataHandles))
-            m_textureDataManager->release(textureData);
+        for (HTextureData textureData : qAsConst(m_textureDataHandles)) {
+            m_textureDataManager->decodeQueue()->releasePendingUpload(textureData);
+            m_textureDataManager->releaseTextureData(textureData);
+        }
         m_textureDataHandles.clear();
         // Request a new upload to the GPU
         requestTextureDataUpdate();
@@ -9,6 +9,7 @@ HEADERS += \
     $$PWD/qtexturewrapmode.h \
     $$PWD/texture_p.h \
     $$PWD/texturedatamanager_p.h \
+    $$PWD/texturedecodequeue_p.h \
     $$PWD/textureimage_p.h \
     $$PWD/qabstracttexture.h \
     $$PWD/qabstracttexture_p.h \
@@ -28,6 +29,7 @@ SOURCES += \
     $$PWD/qtexturewrapmode.cpp \
     $$PWD/texture.cpp \
     $$PWD/texturedatamanager.cpp \
+    $$PWD/texturedecodequeue.cpp \
     $$PWD/textureimage.cpp \
     $$PWD/qabstracttexture.cpp \
     $$PWD/qtexture.cpp \
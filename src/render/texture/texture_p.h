@@ -131,8 +131,14 @@ private:
 
     QOpenGLTexture *m_gl;
 
+    void setDirty();
     QOpenGLTexture *buildGLTexture();
-    void setToGLTexture(QTextureImageData *imgData);
+    void destroyGLTexture();
+    bool isGLTextureShareable() const;
+    QVector<quint32> glTextureShareKey() const;
+    void shareGLTexture();
+    bool uploadGeneratedTextureData();
+    qint64 setToGLTexture(QTextureImageData *imgData, int level);
     void setToGLTexture(TextureImage *rImg, QTextureImageData *imgData);
     void updateWrapAndFilters();
 
@@ -161,6 +167,9 @@ private:
     bool m_isDirty;
     bool m_filtersAndWrapUpdated;
     bool m_dataUploadRequired;
+    int m_pendingMipLevel;
+    int m_uploadMipLevels;
+    QVector<quint32> m_glShareKey;
 
     mutable QMutex m_lock;
     TextureDNA m_textureDNA;
@@ -39,15 +39,57 @@
 
 #include "texturedatamanager_p.h"
 #include <Qt3DRender/qtextureimagedatagenerator.h>
+#include <Qt3DRender/private/qtextureimagedata_p.h>
+#include <Qt3DRender/private/renderlogging_p.h>
 QT_BEGIN_NAMESPACE
 
 namespace Qt3DRender {
 
 namespace Render {
 
+namespace {
+
+uint contentHash(const QTextureImageData &data)
+{
+    const QTextureImageDataPrivate *d = QTextureImageDataPrivate::get(const_cast<QTextureImageData *>(&data));
+    uint seed = qHash(d->m_data);
+    seed = qHash(d->m_width, seed);
+    seed = qHash(d->m_height, seed);
+    seed = qHash(d->m_depth, seed);
+    seed = qHash(d->m_layers, seed);
+    seed = qHash(d->m_faces, seed);
+    seed = qHash(d->m_mipLevels, seed);
+    seed = qHash(int(d->m_format), seed);
+    return seed;
+}
+
+bool hasSameContent(const QTextureImageData &a, const QTextureImageData &b)
+{
+    const QTextureImageDataPrivate *da = QTextureImageDataPrivate::get(const_cast<QTextureImageData *>(&a));
+    const QTextureImageDataPrivate *db = QTextureImageDataPrivate::get(const_cast<QTextureImageData *>(&b));
+    return da->m_width == db->m_width
+            && da->m_height == db->m_height
+            && da->m_depth == db->m_depth
+            && da->m_layers == db->m_layers
+            && da->m_faces == db->m_faces
+            && da->m_mipLevels == db->m_mipLevels
+            && da->m_blockSize == db->m_blockSize
+            && da->m_compressedBlockWidth == db->m_compressedBlockWidth
+            && da->m_compressedBlockHeight == db->m_compressedBlockHeight
+            && da->m_target == db->m_target
+            && da->m_format == db->m_format
+            && da->m_pixelFormat == db->m_pixelFormat
+            && da->m_pixelType == db->m_pixelType
+            && da->m_isCompressed == db->m_isCompressed
+            && da->m_data == db->m_data;
+}
+
+} // anonymous
+
 
 TextureDataManager::TextureDataManager()
     : m_mutex(QMutex::Recursive)
+    , m_decodeQueue(this)
 {}
 
 // Called from AspectThread sync
@@ -126,8 +168,9 @@ void TextureDataManager::assignFunctorToTextureImage(const QTextureImageDataGene
             // get rid of the functor
             if (imageHandles.isEmpty()) {
                 // We need to release the texture image data
+                // Functors sharing the same data each hold a reference on it
                 HTextureData textureDataHandle = textureDataFromFunctor(functor);
-                if (!m_textureHandlesToRelease.contains(textureDataHandle))
+                if (!textureDataHandle.isNull())
                     m_textureHandlesToRelease.push_back(textureDataHandle);
                 // Remove functor
                 removeTextureDataFunctor(functor);
@@ -151,6 +194,124 @@ void TextureDataManager::assignFunctorToTextureImage(const QTextureImageDataGene
         m_texturesImagesPerFunctor.push_back(qMakePair(newFunctor, QVector<HTextureImage>() << imageHandle));
 }
 
+// Called from LoadTextureDataJob and decoding threads
+// Returns the handle of data holding the same content if there is one,
+// in which case the new data is dropped. Each call holds a reference that
+// is given back by releaseTextureData
+HTextureData TextureDataManager::addTextureData(const QTextureImageData &data, bool *shared)
+{
+    QMutexLocker lock(&m_mutex);
+    const uint hash = contentHash(data);
+
+    for (auto it = m_textureDataByContent.constFind(hash);
+         it != m_textureDataByContent.constEnd() && it.key() == hash; ++it) {
+        QTextureImageData *existingData = this->data(it.value());
+        if (existingData != nullptr && hasSameContent(*existingData, data)) {
+            SharedTextureData &sharedData = m_sharedTextureData[it.value().handle()];
+            ++sharedData.refCount;
+            qCDebug(Jobs) << Q_FUNC_INFO << "Sharing" << sharedData.size << "bytes of texture data";
+            if (shared)
+                *shared = true;
+            return it.value();
+        }
+    }
+
+    const HTextureData textureDataHandle = acquire();
+    *this->data(textureDataHandle) = data;
+
+    SharedTextureData sharedData;
+    sharedData.handle = textureDataHandle;
+    sharedData.contentHash = hash;
+    sharedData.refCount = 1;
+    sharedData.size = QTextureImageDataPrivate::get(const_cast<QTextureImageData *>(&data))->m_data.size();
+    m_sharedTextureData.insert(textureDataHandle.handle(), sharedData);
+    m_textureDataByContent.insert(hash, textureDataHandle);
+
+    if (shared)
+        *shared = false;
+    return textureDataHandle;
+}
+
+void TextureDataManager::releaseTextureData(HTextureData textureDataHandle)
+{
+    if (textureDataHandle.isNull())
+        return;
+
+    QMutexLocker lock(&m_mutex);
+    const auto it = m_sharedTextureData.find(textureDataHandle.handle());
+    if (it != m_sharedTextureData.end()) {
+        if (--it->refCount > 0)
+            return;
+        m_textureDataByContent.remove(it->contentHash, textureDataHandle);
+        m_sharedTextureData.erase(it);
+    }
+    release(textureDataHandle);
+}
+
+// Called from RenderThread
+// Returns a GL texture holding the data and parameters described by key,
+// the caller then holds a reference on it
+QOpenGLTexture *TextureDataManager::acquireSharedGLTexture(const QVector<quint32> &key)
+{
+    QMutexLocker lock(&m_mutex);
+    for (SharedGLTexture &sharedTexture : m_sharedGLTextures) {
+        if (sharedTexture.key == key) {
+            ++sharedTexture.refCount;
+            qCDebug(Jobs) << Q_FUNC_INFO << "Sharing" << sharedTexture.size << "bytes of GL texture";
+            return sharedTexture.glTexture;
+        }
+    }
+    return nullptr;
+}
+
+// Called from RenderThread
+void TextureDataManager::addSharedGLTexture(const QVector<quint32> &key, QOpenGLTexture *glTexture, qint64 size)
+{
+    QMutexLocker lock(&m_mutex);
+    SharedGLTexture sharedTexture;
+    sharedTexture.key = key;
+    sharedTexture.glTexture = glTexture;
+    sharedTexture.refCount = 1;
+    sharedTexture.size = size;
+    m_sharedGLTextures.push_back(sharedTexture);
+}
+
+// Called from RenderThread
+// Returns true if the caller was the last user of glTexture and now owns it
+bool TextureDataManager::releaseSharedGLTexture(QOpenGLTexture *glTexture)
+{
+    QMutexLocker lock(&m_mutex);
+    for (int i = 0, m = m_sharedGLTextures.size(); i < m; ++i) {
+        SharedGLTexture &sharedTexture = m_sharedGLTextures[i];
+        if (sharedTexture.glTexture == glTexture) {
+            if (--sharedTexture.refCount > 0)
+                return false;
+            m_sharedGLTextures.remove(i);
+            return true;
+        }
+    }
+    return true;
+}
+
+TextureDataManager::SharingStatistics TextureDataManager::sharingStatistics() const
+{
+    QMutexLocker lock(&m_mutex);
+    SharingStatistics statistics = { 0, 0, 0, 0 };
+    for (const SharedTextureData &sharedData : m_sharedTextureData) {
+        if (sharedData.refCount > 1) {
+            ++statistics.sharedTextureDataCount;
+            statistics.textureDataBytesSaved += (sharedData.refCount - 1) * sharedData.size;
+        }
+    }
+    for (const SharedGLTexture &sharedTexture : m_sharedGLTextures) {
+        if (sharedTexture.refCount > 1) {
+            ++statistics.sharedGLTextureCount;
+            statistics.glTextureBytesSaved += (sharedTexture.refCount - 1) * sharedTexture.size;
+        }
+    }
+    return statistics;
+}
+
 QMutex *TextureDataManager::mutex() const
 {
     return &m_mutex;
@@ -160,8 +321,10 @@ QMutex *TextureDataManager::mutex() const
 // No need to lock
 void TextureDataManager::cleanup()
 {
-   for (int i = 0, m = m_textureHandlesToRelease.size(); i < m; ++i)
-       release(m_textureHandlesToRelease[i]);
+   for (int i = 0, m = m_textureHandlesToRelease.size(); i < m; ++i) {
+       m_decodeQueue.releasePendingUpload(m_textureHandlesToRelease[i]);
+       releaseTextureData(m_textureHandlesToRelease[i]);
+   }
    m_textureHandlesToRelease.clear();
 }
 
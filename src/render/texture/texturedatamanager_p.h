@@ -55,12 +55,16 @@
 #include <Qt3DRender/qtexture.h>
 #include <Qt3DRender/qtextureimagedata.h>
 #include <Qt3DRender/private/handle_types_p.h>
+#include <Qt3DRender/private/texturedecodequeue_p.h>
 
 #include <QPair>
+#include <QHash>
 #include <Qt3DCore/qnodeid.h>
 
 QT_BEGIN_NAMESPACE
 
+class QOpenGLTexture;
+
 namespace Qt3DRender {
 
 namespace Render {
@@ -68,7 +72,7 @@ namespace Render {
 typedef QPair<QTextureImageDataGeneratorPtr, QVector<HTextureImage> > FunctorImageHandlesPair;
 typedef QPair<QTextureImageDataGeneratorPtr, HTextureData> FunctorTextureDataPair;
 
-class TextureDataManager : public Qt3DCore::QResourceManager<QTextureImageData,
+class Q_AUTOTEST_EXPORT TextureDataManager : public Qt3DCore::QResourceManager<QTextureImageData,
                                                          Qt3DCore::QNodeId,
                                                          16,
                                                          Qt3DCore::ArrayAllocatingPolicy,
@@ -86,15 +90,57 @@ public:
 
     void assignFunctorToTextureImage(const QTextureImageDataGeneratorPtr &functor, HTextureImage imageHandle);
 
+    // Texture data is shared by content, whatever generator produced it
+    HTextureData addTextureData(const QTextureImageData &data, bool *shared = nullptr);
+    void releaseTextureData(HTextureData textureDataHandle);
+
+    // GL textures built from identical data with identical parameters are shared
+    QOpenGLTexture *acquireSharedGLTexture(const QVector<quint32> &key);
+    void addSharedGLTexture(const QVector<quint32> &key, QOpenGLTexture *glTexture, qint64 size);
+    bool releaseSharedGLTexture(QOpenGLTexture *glTexture);
+
+    struct SharingStatistics
+    {
+        int sharedTextureDataCount;
+        qint64 textureDataBytesSaved;
+        int sharedGLTextureCount;
+        qint64 glTextureBytesSaved;
+    };
+    SharingStatistics sharingStatistics() const;
+
     QMutex *mutex() const;
     void cleanup();
 
+    inline TextureDecodeQueue *decodeQueue() { return &m_decodeQueue; }
+
 private:
+    struct SharedTextureData
+    {
+        HTextureData handle;
+        uint contentHash;
+        int refCount;
+        qint64 size;
+    };
+
+    struct SharedGLTexture
+    {
+        QVector<quint32> key;
+        QOpenGLTexture *glTexture;
+        int refCount;
+        qint64 size;
+    };
+
+
     QVector<Qt3DCore::QNodeId> m_texturesPending;
     QVector<FunctorTextureDataPair> m_textureDataFunctors;
     QVector<FunctorImageHandlesPair> m_texturesImagesPerFunctor;
     mutable QMutex m_mutex;
     QVector<HTextureData> m_textureHandlesToRelease;
+    QHash<quint32, SharedTextureData> m_sharedTextureData;
+    QMultiHash<uint, HTextureData> m_textureDataByContent;
+    QVector<SharedGLTexture> m_sharedGLTextures;
+    // Last so that the decoding threads are done before anything else is destroyed
+    TextureDecodeQueue m_decodeQueue;
 };
 
 } // namespace Render
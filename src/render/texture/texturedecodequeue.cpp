@@ -0,0 +1,479 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "texturedecodequeue_p.h"
+#include <Qt3DRender/qtextureimagedata.h>
+#include <Qt3DRender/qtexturedata.h>
+#include <Qt3DRender/private/texturedatamanager_p.h>
+#include <Qt3DRender/private/qtextureimagedata_p.h>
+#include <Qt3DRender/private/renderlogging_p.h>
+#include <QRunnable>
+#include <QThread>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+namespace Render {
+
+namespace {
+
+const float DefaultTexturePriority = std::numeric_limits<float>::max();
+
+qint64 defaultMemoryBudget()
+{
+    // Bytes of decoded texture data allowed to wait for an upload before
+    // the decoding threads stop picking up new requests
+    bool ok = false;
+    const qint64 budget = qgetenv("QT3DRENDER_TEXTURE_DECODE_BUDGET").toLongLong(&ok);
+    return ok && budget > 0 ? budget : qint64(256) * 1024 * 1024;
+}
+
+int defaultThreadCount()
+{
+    bool ok = false;
+    const int threadCount = qEnvironmentVariableIntValue("QT3DRENDER_TEXTURE_DECODE_THREADS", &ok);
+    if (ok && threadCount > 0)
+        return threadCount;
+    // Leave most of the cores to the aspect jobs
+    return qMax(1, QThread::idealThreadCount() / 2);
+}
+
+} // anonymous
+
+class TextureDecodeQueue::Worker : public QRunnable
+{
+public:
+    explicit Worker(TextureDecodeQueue *queue)
+        : m_queue(queue)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        m_queue->processRequests();
+    }
+
+private:
+    TextureDecodeQueue *m_queue;
+};
+
+TextureDecodeQueue::TextureDecodeQueue(TextureDataManager *manager)
+    : m_manager(manager)
+    , m_pendingRequests(0)
+    , m_memoryBudget(defaultMemoryBudget())
+    , m_residentBytes(0)
+    , m_frame(0)
+    , m_nextSerial(1)
+    , m_activeWorkers(0)
+    , m_shuttingDown(false)
+{
+    m_threadPool.setMaxThreadCount(defaultThreadCount());
+}
+
+TextureDecodeQueue::~TextureDecodeQueue()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_shuttingDown = true;
+        m_requests.clear();
+    }
+    m_threadPool.waitForDone();
+}
+
+// Called from LoadTextureDataJob threads with the TextureDataManager mutex held
+// Returns false if the generator previously failed to provide any data
+bool TextureDecodeQueue::enqueue(const QTextureImageDataGeneratorPtr &generator, Qt3DCore::QNodeId textureId)
+{
+    QMutexLocker lock(&m_mutex);
+    for (const QTextureImageDataGeneratorPtr &failed : qAsConst(m_failedImageGenerators)) {
+        if (*failed == *generator)
+            return false;
+    }
+
+    Request *request = findRequest(m_inFlight, generator);
+    if (request == nullptr)
+        request = findRequest(m_requests, generator);
+    if (request == nullptr) {
+        Request newRequest;
+        newRequest.imageGenerator = generator;
+        newRequest.serial = m_nextSerial++;
+        m_requests.push_back(newRequest);
+        request = &m_requests.last();
+    }
+    if (!request->textureIds.contains(textureId))
+        request->textureIds.push_back(textureId);
+
+    updatePendingCount();
+    scheduleWorkers();
+    return true;
+}
+
+// Called from LoadTextureDataJob threads
+void TextureDecodeQueue::enqueue(const QTextureGeneratorPtr &generator, Qt3DCore::QNodeId textureId)
+{
+    QMutexLocker lock(&m_mutex);
+    Request *request = findRequest(m_inFlight, generator);
+    if (request == nullptr)
+        request = findRequest(m_requests, generator);
+    if (request == nullptr) {
+        Request newRequest;
+        newRequest.textureGenerator = generator;
+        newRequest.serial = m_nextSerial++;
+        m_requests.push_back(newRequest);
+        request = &m_requests.last();
+    }
+    if (!request->textureIds.contains(textureId))
+        request->textureIds.push_back(textureId);
+
+    updatePendingCount();
+    scheduleWorkers();
+}
+
+// Called from LoadTextureDataJob threads
+// Returns true if the generator of the texture has completed, data is null
+// if the generator failed to produce anything
+bool TextureDecodeQueue::takeTextureData(Qt3DCore::QNodeId textureId,
+                                         const QTextureGeneratorPtr &generator,
+                                         QTextureDataPtr *data)
+{
+    QMutexLocker lock(&m_mutex);
+    const auto it = m_textureResults.find(textureId);
+    if (it == m_textureResults.end())
+        return false;
+
+    const TextureResult result = it.value();
+    m_textureResults.erase(it);
+    m_residentBytes -= result.bytes;
+    scheduleWorkers();
+
+    // The generator was changed while we were decoding, drop the result
+    if (!(*result.generator == *generator))
+        return false;
+
+    *data = result.data;
+    return true;
+}
+
+// Called from LoadTextureDataJob threads when the texture was destroyed or
+// doesn't use a texture generator anymore. Its decoded data would otherwise
+// never be taken and count against the memory budget forever
+void TextureDecodeQueue::removeTexture(Qt3DCore::QNodeId textureId)
+{
+    QMutexLocker lock(&m_mutex);
+    const auto it = m_textureResults.find(textureId);
+    if (it != m_textureResults.end()) {
+        m_residentBytes -= it->bytes;
+        m_textureResults.erase(it);
+    }
+
+    // Requests only made for that texture don't need to be decoded anymore
+    for (int i = m_requests.size() - 1; i >= 0; --i) {
+        QVector<Qt3DCore::QNodeId> &textureIds = m_requests[i].textureIds;
+        if (textureIds.removeOne(textureId) && textureIds.isEmpty())
+            m_requests.remove(i);
+    }
+    for (Request &request : m_inFlight)
+        request.textureIds.removeOne(textureId);
+    m_decodedTextures.removeOne(textureId);
+    m_texturePriorities.remove(textureId);
+
+    updatePendingCount();
+    scheduleWorkers();
+}
+
+// Called from LoadTextureDataJob threads
+void TextureDecodeQueue::trackPendingUpload(HTextureData handle, qint64 bytes)
+{
+    QMutexLocker lock(&m_mutex);
+    m_pendingUploads.push_back(qMakePair(handle, bytes));
+    m_residentBytes += bytes;
+}
+
+// Called from RenderView jobs
+void TextureDecodeQueue::setTexturePriority(Qt3DCore::QNodeId textureId, float priority)
+{
+    QMutexLocker lock(&m_mutex);
+    auto it = m_texturePriorities.find(textureId);
+    if (it == m_texturePriorities.end()) {
+        TexturePriority texturePriority;
+        texturePriority.priority = priority;
+        texturePriority.frame = m_frame;
+        m_texturePriorities.insert(textureId, texturePriority);
+    } else if (it->frame != m_frame) {
+        // Forget what was reported by previous frames
+        it->priority = priority;
+        it->frame = m_frame;
+    } else {
+        it->priority = qMin(it->priority, priority);
+    }
+}
+
+// Called from AspectThread prepare jobs
+QVector<Qt3DCore::QNodeId> TextureDecodeQueue::takeDecodedTextures()
+{
+    QMutexLocker lock(&m_mutex);
+    ++m_frame;
+    QVector<Qt3DCore::QNodeId> decodedTextures = std::move(m_decodedTextures);
+    m_decodedTextures.clear();
+    return decodedTextures;
+}
+
+// Called from AspectThread
+bool TextureDecodeQueue::hasDecodedTextures() const
+{
+    QMutexLocker lock(&m_mutex);
+    return !m_decodedTextures.isEmpty();
+}
+
+// Called from RenderThread
+void TextureDecodeQueue::releasePendingUpload(HTextureData handle)
+{
+    QMutexLocker lock(&m_mutex);
+    for (int i = 0, m = m_pendingUploads.size(); i < m; ++i) {
+        if (m_pendingUploads.at(i).first == handle) {
+            m_residentBytes -= m_pendingUploads.at(i).second;
+            m_pendingUploads.remove(i);
+            scheduleWorkers();
+            break;
+        }
+    }
+}
+
+void TextureDecodeQueue::setMemoryBudget(qint64 bytes)
+{
+    QMutexLocker lock(&m_mutex);
+    m_memoryBudget = bytes;
+    scheduleWorkers();
+}
+
+qint64 TextureDecodeQueue::memoryBudget() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_memoryBudget;
+}
+
+qint64 TextureDecodeQueue::residentBytes() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_residentBytes;
+}
+
+void TextureDecodeQueue::setMaxThreadCount(int threadCount)
+{
+    m_threadPool.setMaxThreadCount(qMax(1, threadCount));
+}
+
+int TextureDecodeQueue::maxThreadCount() const
+{
+    return m_threadPool.maxThreadCount();
+}
+
+void TextureDecodeQueue::waitForDone()
+{
+    m_threadPool.waitForDone();
+}
+
+qint64 TextureDecodeQueue::byteSize(const QTextureImageData *data)
+{
+    return QTextureImageDataPrivate::get(const_cast<QTextureImageData *>(data))->m_data.size();
+}
+
+// Called from the decoding threads
+void TextureDecodeQueue::processRequests()
+{
+    QMutexLocker lock(&m_mutex);
+    while (!m_shuttingDown && !m_requests.isEmpty() && m_residentBytes < m_memoryBudget) {
+        const Request request = m_requests.takeAt(nextRequestIndex());
+        m_inFlight.push_back(request);
+
+        lock.unlock();
+        decode(request);
+        lock.relock();
+    }
+    --m_activeWorkers;
+}
+
+// Called from the decoding threads without the queue mutex held
+void TextureDecodeQueue::decode(const Request &request)
+{
+    qCDebug(Jobs) << Q_FUNC_INFO << QThread::currentThread();
+
+    TextureResult textureResult;
+    HTextureData textureDataHandle;
+    qint64 bytes = 0;
+    bool failed = false;
+
+    if (request.imageGenerator) {
+        const QTextureImageDataPtr dataPtr = request.imageGenerator->operator ()();
+        if (dataPtr.isNull()) {
+            qCDebug(Jobs) << Q_FUNC_INFO << "Texture has no raw data";
+            failed = true;
+        } else {
+            // Save the QTextureImageDataPtr with it's functor as a key
+            QMutexLocker managerLock(m_manager->mutex());
+            if (m_manager->textureDataFromFunctor(request.imageGenerator).isNull()) {
+                // Another generator may already have produced the same data
+                bool shared = false;
+                const HTextureData handle = m_manager->addTextureData(*dataPtr, &shared);
+                m_manager->addTextureDataForFunctor(handle, request.imageGenerator);
+                if (!shared) {
+                    textureDataHandle = handle;
+                    bytes = byteSize(dataPtr.data());
+                }
+            }
+        }
+    } else {
+        textureResult.generator = request.textureGenerator;
+        textureResult.data = request.textureGenerator->operator ()();
+        if (textureResult.data) {
+            const QVector<QTextureImageDataPtr> imageData = textureResult.data->imageData();
+            for (const QTextureImageDataPtr &image : imageData)
+                bytes += byteSize(image.data());
+        }
+    }
+
+    QMutexLocker lock(&m_mutex);
+    // Texture ids may have been appended while we were decoding
+    QVector<Qt3DCore::QNodeId> textureIds;
+    for (int i = 0, m = m_inFlight.size(); i < m; ++i) {
+        if (m_inFlight.at(i).serial == request.serial) {
+            textureIds = m_inFlight.at(i).textureIds;
+            m_inFlight.remove(i);
+            break;
+        }
+    }
+
+    if (failed)
+        m_failedImageGenerators.push_back(request.imageGenerator);
+
+    if (!textureDataHandle.isNull()) {
+        m_pendingUploads.push_back(qMakePair(textureDataHandle, bytes));
+        m_residentBytes += bytes;
+    } else if (request.textureGenerator) {
+        // The decoded data is shared by all the textures, only account for it once
+        for (int i = 0, m = textureIds.size(); i < m; ++i) {
+            TextureResult &result = m_textureResults[textureIds.at(i)];
+            m_residentBytes -= result.bytes;
+            result = textureResult;
+            result.bytes = (i == 0) ? bytes : 0;
+            m_residentBytes += result.bytes;
+        }
+    }
+
+    for (const Qt3DCore::QNodeId textureId : qAsConst(textureIds)) {
+        m_texturePriorities.remove(textureId);
+        if (!m_decodedTextures.contains(textureId))
+            m_decodedTextures.push_back(textureId);
+    }
+    updatePendingCount();
+}
+
+// Called with the queue mutex held
+void TextureDecodeQueue::scheduleWorkers()
+{
+    if (m_shuttingDown || m_residentBytes >= m_memoryBudget)
+        return;
+    const int maxWorkers = qMin(m_threadPool.maxThreadCount(), m_requests.size());
+    while (m_activeWorkers < maxWorkers) {
+        ++m_activeWorkers;
+        m_threadPool.start(new Worker(this));
+    }
+}
+
+// Called with the queue mutex held
+int TextureDecodeQueue::nextRequestIndex() const
+{
+    // Requests are few, a linear scan is cheaper than maintaining a heap
+    // whose keys change every frame. Ties are served in submission order.
+    int bestIndex = 0;
+    float bestPriority = requestPriority(m_requests.first());
+    for (int i = 1, m = m_requests.size(); i < m; ++i) {
+        const float priority = requestPriority(m_requests.at(i));
+        if (priority < bestPriority) {
+            bestPriority = priority;
+            bestIndex = i;
+        }
+    }
+    return bestIndex;
+}
+
+// Called with the queue mutex held
+float TextureDecodeQueue::requestPriority(const Request &request) const
+{
+    float priority = DefaultTexturePriority;
+    for (const Qt3DCore::QNodeId textureId : request.textureIds) {
+        const auto it = m_texturePriorities.constFind(textureId);
+        if (it != m_texturePriorities.constEnd())
+            priority = qMin(priority, it->priority);
+    }
+    return priority;
+}
+
+TextureDecodeQueue::Request *TextureDecodeQueue::findRequest(QVector<Request> &requests,
+                                                             const QTextureImageDataGeneratorPtr &generator)
+{
+    for (Request &request : requests) {
+        if (request.imageGenerator && *request.imageGenerator == *generator)
+            return &request;
+    }
+    return nullptr;
+}
+
+TextureDecodeQueue::Request *TextureDecodeQueue::findRequest(QVector<Request> &requests,
+                                                             const QTextureGeneratorPtr &generator)
+{
+    for (Request &request : requests) {
+        if (request.textureGenerator && *request.textureGenerator == *generator)
+            return &request;
+    }
+    return nullptr;
+}
+
+void TextureDecodeQueue::updatePendingCount()
+{
+    m_pendingRequests.store(m_requests.size() + m_inFlight.size());
+}
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
@@ -0,0 +1,177 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QT3DRENDER_RENDER_TEXTUREDECODEQUEUE_H
+#define QT3DRENDER_RENDER_TEXTUREDECODEQUEUE_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <Qt3DCore/qnodeid.h>
+#include <Qt3DRender/qtextureimagedatagenerator.h>
+#include <Qt3DRender/qtexturegenerator.h>
+#include <Qt3DRender/private/handle_types_p.h>
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QMutex>
+#include <QThreadPool>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+class QTextureImageData;
+
+namespace Render {
+
+class TextureDataManager;
+
+// Decodes texture generators on a dedicated thread pool so that loading
+// large images never stalls a frame. Requests are deduplicated by generator,
+// served in priority order (textures closest to the camera in the current
+// frame first) and decoding pauses while more than memoryBudget() bytes of
+// decoded data are waiting to be uploaded.
+class Q_AUTOTEST_EXPORT TextureDecodeQueue
+{
+public:
+    explicit TextureDecodeQueue(TextureDataManager *manager);
+    ~TextureDecodeQueue();
+
+    // Called from LoadTextureDataJob threads
+    bool enqueue(const QTextureImageDataGeneratorPtr &generator, Qt3DCore::QNodeId textureId);
+    void enqueue(const QTextureGeneratorPtr &generator, Qt3DCore::QNodeId textureId);
+    bool takeTextureData(Qt3DCore::QNodeId textureId, const QTextureGeneratorPtr &generator, QTextureDataPtr *data);
+    void removeTexture(Qt3DCore::QNodeId textureId);
+    void trackPendingUpload(HTextureData handle, qint64 bytes);
+
+    // Called from RenderView jobs
+    inline bool hasPendingRequests() const { return m_pendingRequests.load() > 0; }
+    void setTexturePriority(Qt3DCore::QNodeId textureId, float priority);
+
+    // Called from AspectThread prepare jobs
+    QVector<Qt3DCore::QNodeId> takeDecodedTextures();
+    bool hasDecodedTextures() const;
+
+    // Called from RenderThread once the data is on the GPU
+    void releasePendingUpload(HTextureData handle);
+
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const;
+    qint64 residentBytes() const;
+
+    void setMaxThreadCount(int threadCount);
+    int maxThreadCount() const;
+    void waitForDone();
+
+    static qint64 byteSize(const QTextureImageData *data);
+
+private:
+    struct Request
+    {
+        Request() : serial(0) {}
+
+        QTextureImageDataGeneratorPtr imageGenerator;
+        QTextureGeneratorPtr textureGenerator;
+        QVector<Qt3DCore::QNodeId> textureIds;
+        quint64 serial;
+    };
+
+    struct TextureResult
+    {
+        TextureResult() : bytes(0) {}
+
+        QTextureGeneratorPtr generator;
+        QTextureDataPtr data;
+        qint64 bytes;
+    };
+
+    struct TexturePriority
+    {
+        float priority;
+        quint64 frame;
+    };
+
+    class Worker;
+    friend class Worker;
+
+    void processRequests();
+    void decode(const Request &request);
+    void scheduleWorkers();
+    int nextRequestIndex() const;
+    float requestPriority(const Request &request) const;
+    Request *findRequest(QVector<Request> &requests, const QTextureImageDataGeneratorPtr &generator);
+    Request *findRequest(QVector<Request> &requests, const QTextureGeneratorPtr &generator);
+    void updatePendingCount();
+
+    TextureDataManager *m_manager;
+    mutable QMutex m_mutex;
+    QThreadPool m_threadPool;
+    QVector<Request> m_requests;
+    QVector<Request> m_inFlight;
+    QVector<Qt3DCore::QNodeId> m_decodedTextures;
+    QVector<QTextureImageDataGeneratorPtr> m_failedImageGenerators;
+    QHash<Qt3DCore::QNodeId, TextureResult> m_textureResults;
+    QHash<Qt3DCore::QNodeId, TexturePriority> m_texturePriorities;
+    QVector<QPair<HTextureData, qint64> > m_pendingUploads;
+    QAtomicInt m_pendingRequests;
+    qint64 m_memoryBudget;
+    qint64 m_residentBytes;
+    quint64 m_frame;
+    quint64 m_nextSerial;
+    int m_activeWorkers;
+    bool m_shuttingDown;
+};
+
+} // namespace Render
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
+
+#endif // QT3DRENDER_RENDER_TEXTUREDECODEQUEUE_H
@@ -6,6 +6,7 @@ SUBDIRS = \
     quick3d \
     cmake \
     input \
+    logic \
     extras
 
 installed_cmake.depends = cmake
@@ -51,6 +51,7 @@ private slots:
     void heavyDutyMultiThreadedAccessRelease();
     void maximumNumberOfResources();
     void activeHandles();
+    void acquireHandlesByBatch();
 };
 
 class tst_ArrayResource
@@ -461,6 +462,24 @@ void tst_DynamicArrayPolicy::activeHandles()
     }
 }
 
+void tst_DynamicArrayPolicy::acquireHandlesByBatch()
+{
+    // GIVEN
+    Qt3DCore::QResourceManager<tst_ArrayResource, uint> manager;
+    tst_ArrayResource *existing = manager.getOrCreateResource(2U);
+
+    // WHEN
+    manager.getOrAcquireHandles(QVector<uint>() << 1U << 2U << 3U);
+
+    // THEN
+    QCOMPARE(manager.activeHandles().size(), 3);
+    QCOMPARE(manager.lookupResource(2U), existing);
+    QVERIFY(manager.lookupResource(1U) != nullptr);
+    QVERIFY(manager.lookupResource(3U) != nullptr);
+    QCOMPARE(manager.getOrCreateResource(1U), manager.lookupResource(1U));
+    QCOMPARE(manager.activeHandles().size(), 3);
+}
+
 
 
 
@@ -31,6 +31,13 @@
 #include <Qt3DCore/qaspectengine.h>
 #include <Qt3DCore/qentity.h>
 #include <Qt3DCore/qtransform.h>
+#include <Qt3DCore/private/qabstractaspect_p.h>
+#include <Qt3DCore/private/qaspectengine_p.h>
+#include <Qt3DCore/private/qaspectmanager_p.h>
+#include <Qt3DCore/private/qaspectthread_p.h>
+#include <Qt3DCore/private/qeventfilterservice_p.h>
+#include <Qt3DCore/private/qservicelocator_p.h>
+#include <QtGui/QKeyEvent>
 
 using namespace Qt3DCore;
 
@@ -102,6 +109,75 @@ private: \
     } \
 };
 
+class InputEventAspectPrivate : public QAbstractAspectPrivate
+{
+public:
+    bool isIdle() Q_DECL_OVERRIDE
+    {
+        return m_pendingInputEvents.load() == 0;
+    }
+
+    QAtomicInt m_pendingInputEvents;
+    QAtomicInt m_frameCount;
+};
+
+// Queues key events like the input aspect does, with a lower priority than
+// the filter of the aspect manager waking up the simulation loop
+class InputEventAspect : public QAbstractAspect
+{
+    Q_OBJECT
+public:
+    explicit InputEventAspect(QObject *parent = 0)
+        : QAbstractAspect(*new InputEventAspectPrivate, parent)
+        , m_d(static_cast<InputEventAspectPrivate *>(QAbstractAspectPrivate::get(this)))
+        , m_eventFilter(new KeyEventFilter(m_d))
+    {}
+
+    int frameCount() const
+    {
+        return m_d->m_frameCount.load();
+    }
+
+private:
+    class KeyEventFilter : public QObject
+    {
+    public:
+        explicit KeyEventFilter(InputEventAspectPrivate *aspectPrivate)
+            : m_aspectPrivate(aspectPrivate)
+        {}
+
+        bool eventFilter(QObject *, QEvent *e) Q_DECL_FINAL
+        {
+            if (e->type() == QEvent::KeyPress)
+                m_aspectPrivate->m_pendingInputEvents.ref();
+            return false;
+        }
+
+    private:
+        InputEventAspectPrivate *m_aspectPrivate;
+    };
+
+    void onRegistered() Q_DECL_OVERRIDE
+    {
+        m_d->services()->eventFilterService()->registerEventFilter(m_eventFilter.data(), 512);
+    }
+
+    void onUnregistered() Q_DECL_OVERRIDE
+    {
+        m_d->services()->eventFilterService()->unregisterEventFilter(m_eventFilter.data());
+    }
+
+    QVector<QAspectJobPtr> jobsToExecute(qint64) Q_DECL_OVERRIDE
+    {
+        m_d->m_pendingInputEvents.fetchAndStoreOrdered(0);
+        m_d->m_frameCount.ref();
+        return QVector<QAspectJobPtr>();
+    }
+
+    InputEventAspectPrivate *m_d;
+    QScopedPointer<KeyEventFilter> m_eventFilter;
+};
+
 FAKE_ASPECT(FakeAspect)
 FAKE_ASPECT(FakeAspect2)
 FAKE_ASPECT(FakeAspect3)
@@ -213,6 +289,46 @@ private Q_SLOTS:
         // Nothing particular happen on exit, especially no crash
     }
 
+    void shouldIdleUntilInputEventIsQueued()
+    {
+        if (qEnvironmentVariableIsSet("QT3D_DISABLE_IDLE_FRAMES"))
+            QSKIP("Idle frames are disabled");
+
+        // GIVEN
+        QObject eventSource;
+        QAspectEngine engine;
+        InputEventAspect *aspect = new InputEventAspect;
+        engine.registerAspect(aspect);
+        QAspectManager *aspectManager = QAspectEnginePrivate::get(&engine)->m_aspectThread->aspectManager();
+        aspectManager->serviceLocator()->eventFilterService()->initialize(&eventSource);
+
+        // WHEN
+        engine.setRootEntity(QEntityPtr(new QEntity));
+
+        // THEN
+        // the first frame is executed...
+        QTRY_VERIFY(aspect->frameCount() > 0);
+
+        // ... and no other one while the aspect has nothing to do
+        QTest::qWait(100);
+        const int idleFrameCount = aspect->frameCount();
+        QTest::qWait(200);
+        QCOMPARE(aspect->frameCount(), idleFrameCount);
+
+        // WHEN
+        QKeyEvent keyEvent(QEvent::KeyPress, Qt::Key_A, Qt::NoModifier);
+        QCoreApplication::sendEvent(&eventSource, &keyEvent);
+
+        // THEN
+        // the event is queued before the simulation loop is woken up
+        QTRY_COMPARE(aspect->frameCount(), idleFrameCount + 1);
+        QTest::qWait(100);
+        QCOMPARE(aspect->frameCount(), idleFrameCount + 1);
+
+        // WHEN
+        engine.setRootEntity(QEntityPtr());
+    }
+
     void shouldRegisterAspectsByName()
     {
         // GIVEN
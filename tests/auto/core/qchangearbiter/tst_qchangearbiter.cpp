@@ -46,6 +46,11 @@
 #include <Qt3DCore/private/qsceneobserverinterface_p.h>
 #include <Qt3DCore/private/qnode_p.h>
 #include <Qt3DCore/private/qbackendnode_p.h>
+#include <Qt3DCore/private/qabstractaspect_p.h>
+#include <Qt3DCore/private/qaspectjobmanager_p.h>
+#include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
+#include <Qt3DCore/qabstractaspect.h>
+#include <QMutex>
 #include <QThread>
 #include <QWaitCondition>
 
@@ -60,6 +65,7 @@ private slots:
     void unregisterSceneObservers();
     void distributeFrontendChanges();
     void distributeBackendChanges();
+    void createConcurrentBackendNodes();
 };
 
 class AllChangesChange : public Qt3DCore::QSceneChange
@@ -794,6 +800,149 @@ void tst_QChangeArbiter::distributeBackendChanges()
     Qt3DCore::QChangeArbiter::destroyThreadLocalChangeQueue(arbiter.data());
 }
 
+class tst_ConcurrentComponentA : public Qt3DCore::QComponent
+{
+    Q_OBJECT
+};
+
+class tst_ConcurrentComponentB : public Qt3DCore::QComponent
+{
+    Q_OBJECT
+};
+
+class tst_ConcurrentBackendNode : public Qt3DCore::QBackendNode
+{
+public:
+    void sceneChangeEvent(const Qt3DCore::QSceneChangePtr &e) Q_DECL_OVERRIDE
+    {
+        m_lastChanges << e;
+    }
+
+    QList<Qt3DCore::QSceneChangePtr> m_lastChanges;
+};
+
+class tst_ConcurrentMapper : public Qt3DCore::QConcurrentBackendNodeMapper
+{
+public:
+    ~tst_ConcurrentMapper()
+    {
+        qDeleteAll(m_nodes);
+    }
+
+    Qt3DCore::QBackendNode *create(const Qt3DCore::QNodeCreatedChangeBasePtr &change) const Q_DECL_OVERRIDE
+    {
+        QMutexLocker lock(&m_mutex);
+        tst_ConcurrentBackendNode *node = new tst_ConcurrentBackendNode();
+        m_nodes.insert(change->subjectId(), node);
+        return node;
+    }
+
+    Qt3DCore::QBackendNode *get(Qt3DCore::QNodeId id) const Q_DECL_OVERRIDE
+    {
+        QMutexLocker lock(&m_mutex);
+        return m_nodes.value(id);
+    }
+
+    void destroy(Qt3DCore::QNodeId id) const Q_DECL_OVERRIDE
+    {
+        QMutexLocker lock(&m_mutex);
+        delete m_nodes.take(id);
+    }
+
+    int count() const
+    {
+        QMutexLocker lock(&m_mutex);
+        return m_nodes.size();
+    }
+
+private:
+    mutable QMutex m_mutex;
+    mutable QHash<Qt3DCore::QNodeId, tst_ConcurrentBackendNode *> m_nodes;
+};
+
+class tst_ConcurrentAspect : public Qt3DCore::QAbstractAspect
+{
+public:
+    tst_ConcurrentAspect()
+        : m_mapperA(new tst_ConcurrentMapper)
+        , m_mapperB(new tst_ConcurrentMapper)
+    {
+        Qt3DCore::QAbstractAspectPrivate *d = Qt3DCore::QAbstractAspectPrivate::get(this);
+        d->registerConcurrentBackendType<tst_ConcurrentComponentA>(m_mapperA);
+        d->registerConcurrentBackendType<tst_ConcurrentComponentB>(m_mapperB);
+    }
+
+    QSharedPointer<tst_ConcurrentMapper> m_mapperA;
+    QSharedPointer<tst_ConcurrentMapper> m_mapperB;
+};
+
+void tst_QChangeArbiter::createConcurrentBackendNodes()
+{
+    // GIVEN
+    QScopedPointer<Qt3DCore::QAspectJobManager> jobManager(new Qt3DCore::QAspectJobManager());
+    jobManager->initialize();
+    QScopedPointer<Qt3DCore::QChangeArbiter> arbiter(new Qt3DCore::QChangeArbiter());
+    QScopedPointer<Qt3DCore::QScene> scene(new Qt3DCore::QScene());
+    arbiter->setScene(scene.data());
+    scene->setArbiter(arbiter.data());
+    arbiter->initialize(jobManager.data());
+    Qt3DCore::QChangeArbiter::createThreadLocalChangeQueue(arbiter.data());
+
+    tst_ConcurrentAspect aspect;
+    Qt3DCore::QAbstractAspectPrivate *aspectPrivate = Qt3DCore::QAbstractAspectPrivate::get(&aspect);
+    aspectPrivate->m_jobManager = jobManager.data();
+    aspectPrivate->m_arbiter = arbiter.data();
+    arbiter->registerSceneObserver(aspectPrivate);
+
+    // More nodes than fit in a single batch, so that several jobs are
+    // created while the arbiter is locked by the change distribution
+    Qt3DCore::QEntity subtree;
+    QVector<Qt3DCore::QComponent *> components;
+    for (int i = 0; i < 600; ++i)
+        components.push_back(new tst_ConcurrentComponentA());
+    for (int i = 0; i < 10; ++i)
+        components.push_back(new tst_ConcurrentComponentB());
+    for (Qt3DCore::QComponent *component : qAsConst(components))
+        component->setParent(&subtree);
+
+    // WHEN
+    {
+        Qt3DCore::QNodeCreatedChangeGenerator generator(&subtree);
+        const QVector<Qt3DCore::QNodeCreatedChangeBasePtr> creationChanges = generator.creationChanges();
+        for (const Qt3DCore::QNodeCreatedChangeBasePtr &change : creationChanges) {
+            // There is no frontend to deliver to
+            change->setDeliveryFlags(Qt3DCore::QSceneChange::BackendNodes);
+            arbiter->sceneChangeEventWithLock(change);
+        }
+    }
+    arbiter->syncChanges();
+
+    // THEN
+    QCOMPARE(aspect.m_mapperA->count(), 600);
+    QCOMPARE(aspect.m_mapperB->count(), 10);
+
+    // WHEN
+    for (Qt3DCore::QComponent *component : { components.first(), components.last() }) {
+        Qt3DCore::QPropertyUpdatedChangePtr change(new Qt3DCore::QPropertyUpdatedChange(component->id()));
+        change->setDeliveryFlags(Qt3DCore::QSceneChange::BackendNodes);
+        change->setPropertyName("enabled");
+        change->setValue(false);
+        arbiter->sceneChangeEventWithLock(change);
+    }
+    arbiter->syncChanges();
+
+    // THEN
+    const auto backendA = static_cast<tst_ConcurrentBackendNode *>(aspect.m_mapperA->get(components.first()->id()));
+    const auto backendB = static_cast<tst_ConcurrentBackendNode *>(aspect.m_mapperB->get(components.last()->id()));
+    QVERIFY(backendA != nullptr);
+    QVERIFY(backendB != nullptr);
+    QCOMPARE(backendA->m_lastChanges.size(), 1);
+    QCOMPARE(backendB->m_lastChanges.size(), 1);
+
+    arbiter->unregisterSceneObserver(aspectPrivate);
+    Qt3DCore::QChangeArbiter::destroyThreadLocalChangeQueue(arbiter.data());
+}
+
 QTEST_GUILESS_MAIN(tst_QChangeArbiter)
 
 #include "tst_qchangearbiter.moc"
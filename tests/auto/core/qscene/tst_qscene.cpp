@@ -47,8 +47,11 @@ private slots:
     void addNodeObservable();
     void removeObservable();
     void removeNodeObservable();
+    void addAndRemoveNodeObservables();
+    void lookupNodes();
     void addChildNode();
     void removeChildNode();
+    void removeChildSubtree();
     void addEntityForComponent();
     void removeEntityForComponent();
     void hasEntityForComponent();
@@ -204,6 +207,74 @@ void tst_QScene::removeObservable()
     QVERIFY(scene->nodeIdFromObservable(observables.at(0)) == Qt3DCore::QNodeId());
 }
 
+void tst_QScene::addAndRemoveNodeObservables()
+{
+    // GIVEN
+    QVector<Qt3DCore::QNode *> nodes;
+    for (int i = 0; i < 100; i++)
+        nodes.append(new tst_Node());
+
+    QList<tst_Observable *> observables;
+    for (int i = 0; i < 10; i++)
+        observables.append(new tst_Observable());
+
+    Qt3DCore::QScene *scene = new Qt3DCore::QScene;
+    scene->setArbiter(new tst_LockableObserver);
+
+    // WHEN
+    scene->addObservables(nodes);
+    for (int i = 0; i < 10; i++)
+        scene->addObservable(observables.at(i), nodes.at(i)->id());
+
+    // THEN
+    for (Qt3DCore::QNode *n : qAsConst(nodes))
+        QVERIFY(n == scene->lookupNode(n->id()));
+    for (int i = 0; i < 10; i++)
+        QVERIFY(scene->nodeIdFromObservable(observables.at(i)) == nodes.at(i)->id());
+
+    // WHEN
+    const QVector<Qt3DCore::QNode *> removedNodes = nodes.mid(0, 50);
+    scene->removeObservables(removedNodes);
+
+    // THEN
+    for (int i = 0; i < nodes.size(); i++) {
+        Qt3DCore::QNode *n = nodes.at(i);
+        QCOMPARE(scene->lookupNode(n->id()), i < 50 ? nullptr : n);
+        QVERIFY(scene->lookupObservables(n->id()).isEmpty());
+    }
+    for (int i = 0; i < 10; i++)
+        QVERIFY(scene->nodeIdFromObservable(observables.at(i)) == Qt3DCore::QNodeId());
+}
+
+void tst_QScene::lookupNodes()
+{
+    // GIVEN
+    QVector<Qt3DCore::QNode *> nodes;
+    QVector<Qt3DCore::QNodeId> ids;
+    for (int i = 0; i < 100; i++) {
+        nodes.append(new tst_Node());
+        ids.append(nodes.last()->id());
+    }
+    // Not in the scene
+    Qt3DCore::QNode *strayNode = new tst_Node();
+    ids.insert(42, strayNode->id());
+
+    Qt3DCore::QScene *scene = new Qt3DCore::QScene;
+
+    // WHEN
+    scene->addObservables(nodes);
+    const QVector<Qt3DCore::QNode *> lookedUpNodes = scene->lookupNodes(ids);
+
+    // THEN
+    QCOMPARE(lookedUpNodes.size(), ids.size());
+    for (int i = 0; i < ids.size(); i++) {
+        if (i == 42)
+            QVERIFY(lookedUpNodes.at(i) == nullptr);
+        else
+            QCOMPARE(lookedUpNodes.at(i)->id(), ids.at(i));
+    }
+}
+
 void tst_QScene::removeNodeObservable()
 {
     // GIVEN
@@ -313,6 +384,44 @@ void tst_QScene::removeChildNode()
     }
 }
 
+void tst_QScene::removeChildSubtree()
+{
+    // GIVEN
+    Qt3DCore::QScene *scene = new Qt3DCore::QScene;
+
+    QList<Qt3DCore::QNode *> nodes;
+
+    Qt3DCore::QNode *root = new tst_Node;
+    Qt3DCore::QNodePrivate::get(root)->setScene(scene);
+    scene->addObservable(root);
+
+    for (int i = 0; i < 10; i++) {
+        Qt3DCore::QNode *child = new tst_Node;
+        if (nodes.isEmpty())
+            child->setParent(root);
+        else
+            child->setParent(nodes.last());
+        nodes.append(child);
+    }
+
+    // THEN
+    for (Qt3DCore::QNode *n : qAsConst(nodes)) {
+        QVERIFY(scene->lookupNode(n->id()) == n);
+        QVERIFY(Qt3DCore::QNodePrivate::get(n)->scene() == scene);
+    }
+
+    // WHEN
+    nodes.first()->setParent(Q_NODE_NULLPTR);
+    QCoreApplication::processEvents();
+
+    // THEN
+    QVERIFY(scene->lookupNode(root->id()) == root);
+    for (Qt3DCore::QNode *n : qAsConst(nodes)) {
+        QVERIFY(scene->lookupNode(n->id()) == nullptr);
+        QVERIFY(Qt3DCore::QNodePrivate::get(n)->scene() == nullptr);
+    }
+}
+
 void tst_QScene::addEntityForComponent()
 {
     // GIVEN
@@ -0,0 +1,12 @@
+TEMPLATE = app
+
+TARGET = tst_backendframeaction
+
+QT += core-private 3dcore 3dcore-private 3dlogic 3dlogic-private testlib
+
+CONFIG += testcase
+
+SOURCES += tst_backendframeaction.cpp
+
+include(../../core/common/common.pri)
+include(../../render/commons/commons.pri)
@@ -0,0 +1,218 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QTest>
+#include <qbackendnodetester.h>
+#include <Qt3DCore/qpropertyupdatedchange.h>
+#include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
+#include <Qt3DLogic/qbackendframeaction.h>
+#include <Qt3DLogic/private/backendframeaction_p.h>
+#include <Qt3DLogic/private/manager_p.h>
+#include <Qt3DLogic/private/managers_p.h>
+
+class TestCallback : public Qt3DLogic::QBackendFrameCallback
+{
+public:
+    TestCallback()
+        : calls(0)
+        , lastDt(0.0f)
+    {}
+
+    void operator()(float dt) Q_DECL_OVERRIDE
+    {
+        ++calls;
+        lastDt = dt;
+    }
+
+    int calls;
+    float lastDt;
+};
+
+class tst_BackendFrameAction : public Qt3DCore::QBackendNodeTester
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void checkInitialState()
+    {
+        // GIVEN
+        Qt3DLogic::Logic::BackendFrameAction backendFrameAction;
+
+        // THEN
+        QVERIFY(backendFrameAction.peerId().isNull());
+        QCOMPARE(backendFrameAction.isEnabled(), false);
+        QVERIFY(backendFrameAction.callback().isNull());
+        QVERIFY(backendFrameAction.logicManager() == nullptr);
+    }
+
+    void checkInitializeFromPeer()
+    {
+        // GIVEN
+        Qt3DLogic::Logic::Manager manager;
+        Qt3DLogic::QBackendFrameAction frameAction;
+        const Qt3DLogic::QBackendFrameCallbackPtr callback(new TestCallback);
+        frameAction.setCallback(callback);
+
+        {
+            // WHEN
+            Qt3DLogic::Logic::BackendFrameAction backendFrameAction;
+            backendFrameAction.setManager(&manager);
+            simulateInitialization(&frameAction, &backendFrameAction);
+
+            // THEN
+            QCOMPARE(backendFrameAction.peerId(), frameAction.id());
+            QCOMPARE(backendFrameAction.isEnabled(), true);
+            QCOMPARE(backendFrameAction.callback(), callback);
+            QCOMPARE(manager.isIdle(), false);
+        }
+        {
+            // WHEN
+            frameAction.setEnabled(false);
+            Qt3DLogic::Logic::BackendFrameAction backendFrameAction;
+            backendFrameAction.setManager(&manager);
+            simulateInitialization(&frameAction, &backendFrameAction);
+
+            // THEN
+            QCOMPARE(backendFrameAction.peerId(), frameAction.id());
+            QCOMPARE(backendFrameAction.isEnabled(), false);
+        }
+    }
+
+    void checkSceneChangeEvents()
+    {
+        // GIVEN
+        Qt3DLogic::Logic::BackendFrameAction backendFrameAction;
+        const Qt3DLogic::QBackendFrameCallbackPtr callback(new TestCallback);
+
+        {
+            // WHEN
+            const auto change = Qt3DCore::QPropertyUpdatedChangePtr::create(Qt3DCore::QNodeId());
+            change->setPropertyName("enabled");
+            change->setValue(true);
+            backendFrameAction.sceneChangeEvent(change);
+
+            // THEN
+            QCOMPARE(backendFrameAction.isEnabled(), true);
+        }
+        {
+            // WHEN
+            const auto change = Qt3DCore::QPropertyUpdatedChangePtr::create(Qt3DCore::QNodeId());
+            change->setPropertyName("callback");
+            change->setValue(QVariant::fromValue(callback));
+            backendFrameAction.sceneChangeEvent(change);
+
+            // THEN
+            QCOMPARE(backendFrameAction.callback(), callback);
+        }
+        {
+            // WHEN
+            const auto change = Qt3DCore::QPropertyUpdatedChangePtr::create(Qt3DCore::QNodeId());
+            change->setPropertyName("callback");
+            change->setValue(QVariant::fromValue(Qt3DLogic::QBackendFrameCallbackPtr()));
+            backendFrameAction.sceneChangeEvent(change);
+
+            // THEN
+            QVERIFY(backendFrameAction.callback().isNull());
+        }
+    }
+
+    void checkTrigger()
+    {
+        // GIVEN
+        Qt3DLogic::Logic::Manager manager;
+        Qt3DLogic::QBackendFrameAction frameAction;
+        TestCallback *testCallback = new TestCallback;
+        frameAction.setCallback(Qt3DLogic::QBackendFrameCallbackPtr(testCallback));
+        Qt3DLogic::Logic::BackendFrameAction backendFrameAction;
+        backendFrameAction.setManager(&manager);
+        simulateInitialization(&frameAction, &backendFrameAction);
+
+        // WHEN
+        backendFrameAction.trigger(0.25f);
+
+        // THEN
+        QCOMPARE(testCallback->calls, 1);
+        QCOMPARE(testCallback->lastDt, 0.25f);
+
+        // WHEN
+        backendFrameAction.setEnabled(false);
+        backendFrameAction.trigger(0.5f);
+
+        // THEN
+        QCOMPARE(testCallback->calls, 1);
+
+        // WHEN
+        backendFrameAction.setEnabled(true);
+        const auto change = Qt3DCore::QPropertyUpdatedChangePtr::create(Qt3DCore::QNodeId());
+        change->setPropertyName("callback");
+        change->setValue(QVariant::fromValue(Qt3DLogic::QBackendFrameCallbackPtr()));
+        backendFrameAction.sceneChangeEvent(change);
+        backendFrameAction.trigger(0.5f);
+
+        // THEN
+        QCOMPARE(testCallback->calls, 1);
+    }
+
+    void checkFunctor()
+    {
+        // GIVEN
+        Qt3DLogic::Logic::Manager manager;
+        Qt3DLogic::Logic::BackendFrameActionFunctor functor(&manager);
+        Qt3DLogic::QBackendFrameAction frameAction;
+        Qt3DCore::QNodeCreatedChangeGenerator creationChangeGenerator(&frameAction);
+        const Qt3DCore::QNodeCreatedChangeBasePtr change = creationChangeGenerator.creationChanges().first();
+
+        // WHEN
+        auto backendFrameAction = static_cast<Qt3DLogic::Logic::BackendFrameAction *>(functor.create(change));
+
+        // THEN
+        QVERIFY(backendFrameAction != nullptr);
+        QCOMPARE(backendFrameAction->logicManager(), &manager);
+        QCOMPARE(functor.get(frameAction.id()), backendFrameAction);
+        QCOMPARE(manager.backendFrameActionManager()->lookupResource(frameAction.id()), backendFrameAction);
+
+        // WHEN
+        simulateInitialization(&frameAction, backendFrameAction);
+
+        // THEN
+        QCOMPARE(manager.isIdle(), false);
+
+        // WHEN
+        functor.destroy(frameAction.id());
+
+        // THEN
+        QCOMPARE(manager.isIdle(), true);
+        QVERIFY(functor.get(frameAction.id()) == nullptr);
+    }
+};
+
+QTEST_MAIN(tst_BackendFrameAction)
+
+#include "tst_backendframeaction.moc"
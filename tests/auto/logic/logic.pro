@@ -0,0 +1,8 @@
+TEMPLATE = subdirs
+
+qtConfig(private_tests) {
+    SUBDIRS += \
+        qbackendframeaction \
+        backendframeaction \
+        logicmanager
+}
@@ -0,0 +1,270 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QTest>
+#include <QtTest/QSignalSpy>
+#include <qbackendnodetester.h>
+#include <Qt3DCore/private/qabstractaspect_p.h>
+#include <Qt3DCore/private/qaspectmanager_p.h>
+#include <Qt3DCore/private/qscene_p.h>
+#include <Qt3DLogic/qbackendframeaction.h>
+#include <Qt3DLogic/qframeaction.h>
+#include <Qt3DLogic/qlogicaspect.h>
+#include <Qt3DLogic/private/backendframeaction_p.h>
+#include <Qt3DLogic/private/executor_p.h>
+#include <Qt3DLogic/private/handler_p.h>
+#include <Qt3DLogic/private/manager_p.h>
+#include <Qt3DLogic/private/managers_p.h>
+
+class TestCallback : public Qt3DLogic::QBackendFrameCallback
+{
+public:
+    TestCallback()
+        : calls(0)
+        , lastDt(0.0f)
+    {}
+
+    void operator()(float dt) Q_DECL_OVERRIDE
+    {
+        ++calls;
+        lastDt = dt;
+    }
+
+    int calls;
+    float lastDt;
+};
+
+class tst_LogicManager : public Qt3DCore::QBackendNodeTester
+{
+    Q_OBJECT
+
+private:
+    void addBackendFrameAction(Qt3DLogic::Logic::Manager *manager, Qt3DLogic::QBackendFrameAction *frameAction)
+    {
+        Qt3DLogic::Logic::BackendFrameAction *backendFrameAction = manager->backendFrameActionManager()->getOrCreateResource(frameAction->id());
+        backendFrameAction->setManager(manager);
+        simulateInitialization(frameAction, backendFrameAction);
+    }
+
+    void addFrameAction(Qt3DLogic::Logic::Manager *manager, Qt3DLogic::QFrameAction *frameAction)
+    {
+        Qt3DLogic::Logic::Handler *handler = manager->logicHandlerManager()->getOrCreateResource(frameAction->id());
+        handler->setManager(manager);
+        simulateInitialization(frameAction, handler);
+    }
+
+private Q_SLOTS:
+
+    void checkInitialState()
+    {
+        // GIVEN
+        Qt3DLogic::Logic::Manager manager;
+
+        // THEN
+        QCOMPARE(manager.isIdle(), true);
+        QCOMPARE(manager.isBlocking(), true);
+    }
+
+    void checkAsyncModeFromEnvironment()
+    {
+        // GIVEN
+        qputenv("QT3DLOGIC_ASYNC_FRAME_ACTIONS", "1");
+        Qt3DLogic::Logic::Manager manager;
+        qunsetenv("QT3DLOGIC_ASYNC_FRAME_ACTIONS");
+
+        // THEN
+        QCOMPARE(manager.isBlocking(), false);
+    }
+
+    void checkAppendAndRemoveBackendFrameAction()
+    {
+        // GIVEN
+        Qt3DLogic::Logic::Manager manager;
+        Qt3DLogic::QBackendFrameAction frameAction1;
+        Qt3DLogic::QBackendFrameAction frameAction2;
+
+        // WHEN
+        addBackendFrameAction(&manager, &frameAction1);
+        addBackendFrameAction(&manager, &frameAction2);
+
+        // THEN
+        QCOMPARE(manager.isIdle(), false);
+        QVERIFY(manager.backendFrameActionManager()->lookupResource(frameAction1.id()) != nullptr);
+        QVERIFY(manager.backendFrameActionManager()->lookupResource(frameAction2.id()) != nullptr);
+
+        // WHEN
+        manager.removeBackendFrameAction(frameAction1.id());
+
+        // THEN
+        QCOMPARE(manager.isIdle(), false);
+        QVERIFY(manager.backendFrameActionManager()->lookupResource(frameAction1.id()) == nullptr);
+        QVERIFY(manager.backendFrameActionManager()->lookupResource(frameAction2.id()) != nullptr);
+
+        // WHEN
+        manager.removeBackendFrameAction(frameAction1.id());
+        manager.removeBackendFrameAction(frameAction2.id());
+
+        // THEN
+        QCOMPARE(manager.isIdle(), true);
+        QVERIFY(manager.backendFrameActionManager()->lookupResource(frameAction2.id()) == nullptr);
+    }
+
+    void checkTriggerBackendFrameActions()
+    {
+        // GIVEN
+        Qt3DCore::QAspectManager aspectManager;
+        aspectManager.enterSimulationLoop();
+        Qt3DLogic::QLogicAspect aspect;
+        Qt3DCore::QAbstractAspectPrivate::get(&aspect)->m_aspectManager = &aspectManager;
+
+        Qt3DLogic::Logic::Executor executor;
+        Qt3DLogic::Logic::Manager manager;
+        manager.setLogicAspect(&aspect);
+        manager.setExecutor(&executor);
+
+        Qt3DLogic::QBackendFrameAction frameAction;
+        TestCallback *callback = new TestCallback;
+        frameAction.setCallback(Qt3DLogic::QBackendFrameCallbackPtr(callback));
+        addBackendFrameAction(&manager, &frameAction);
+
+        // WHEN
+        // Without any QFrameAction, blocking mode doesn't wait on the main thread
+        manager.setDeltaTime(0.25f);
+        manager.triggerLogicFrameUpdates();
+
+        // THEN
+        QCOMPARE(callback->calls, 1);
+        QCOMPARE(callback->lastDt, 0.25f);
+
+        // WHEN
+        manager.removeBackendFrameAction(frameAction.id());
+        manager.triggerLogicFrameUpdates();
+
+        // THEN
+        QCOMPARE(callback->calls, 1);
+    }
+
+    void checkAsyncFrameUpdates()
+    {
+        // GIVEN
+        Qt3DCore::QAspectManager aspectManager;
+        aspectManager.enterSimulationLoop();
+        Qt3DLogic::QLogicAspect aspect;
+        Qt3DCore::QAbstractAspectPrivate::get(&aspect)->m_aspectManager = &aspectManager;
+
+        Qt3DCore::QScene scene;
+        Qt3DLogic::Logic::Executor executor;
+        executor.setScene(&scene);
+        Qt3DLogic::Logic::Manager manager;
+        manager.setLogicAspect(&aspect);
+        manager.setExecutor(&executor);
+        manager.setBlocking(false);
+
+        Qt3DLogic::QFrameAction frameAction;
+        scene.addObservable(&frameAction);
+        addFrameAction(&manager, &frameAction);
+        QSignalSpy spy(&frameAction, SIGNAL(triggered(float)));
+
+        Qt3DLogic::QBackendFrameAction backendFrameAction;
+        TestCallback *callback = new TestCallback;
+        backendFrameAction.setCallback(Qt3DLogic::QBackendFrameCallbackPtr(callback));
+        addBackendFrameAction(&manager, &backendFrameAction);
+
+        // WHEN
+        manager.setDeltaTime(0.25f);
+        manager.triggerLogicFrameUpdates();
+        manager.triggerLogicFrameUpdates();
+
+        // THEN
+        // The backend frame actions don't wait for the main thread
+        QCOMPARE(callback->calls, 2);
+        QCOMPARE(spy.count(), 0);
+
+        // WHEN
+        QCoreApplication::processEvents();
+
+        // THEN
+        // The frames missed by the main thread are coalesced
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.last().first().toFloat(), 0.5f);
+
+        // WHEN
+        QCoreApplication::processEvents();
+
+        // THEN
+        QCOMPARE(spy.count(), 1);
+
+        // WHEN
+        manager.triggerLogicFrameUpdates();
+        QCoreApplication::processEvents();
+
+        // THEN
+        QCOMPARE(callback->calls, 3);
+        QCOMPARE(spy.count(), 2);
+        QCOMPARE(spy.last().first().toFloat(), 0.25f);
+    }
+
+    void checkNoUpdatesWhenShuttingDown()
+    {
+        // GIVEN
+        Qt3DCore::QAspectManager aspectManager;
+        Qt3DLogic::QLogicAspect aspect;
+        Qt3DCore::QAbstractAspectPrivate::get(&aspect)->m_aspectManager = &aspectManager;
+
+        Qt3DCore::QScene scene;
+        Qt3DLogic::Logic::Executor executor;
+        executor.setScene(&scene);
+        Qt3DLogic::Logic::Manager manager;
+        manager.setLogicAspect(&aspect);
+        manager.setExecutor(&executor);
+
+        Qt3DLogic::QFrameAction frameAction;
+        scene.addObservable(&frameAction);
+        addFrameAction(&manager, &frameAction);
+        QSignalSpy spy(&frameAction, SIGNAL(triggered(float)));
+
+        Qt3DLogic::QBackendFrameAction backendFrameAction;
+        TestCallback *callback = new TestCallback;
+        backendFrameAction.setCallback(Qt3DLogic::QBackendFrameCallbackPtr(callback));
+        addBackendFrameAction(&manager, &backendFrameAction);
+
+        // WHEN
+        // The simulation loop isn't running, blocking would deadlock
+        manager.triggerLogicFrameUpdates();
+        QCoreApplication::processEvents();
+
+        // THEN
+        QCOMPARE(callback->calls, 0);
+        QCOMPARE(spy.count(), 0);
+    }
+};
+
+QTEST_MAIN(tst_LogicManager)
+
+#include "tst_logicmanager.moc"
@@ -0,0 +1,140 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QTest>
+#include <Qt3DLogic/qbackendframeaction.h>
+#include <Qt3DLogic/private/qbackendframeaction_p.h>
+#include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
+#include <Qt3DCore/qnodecreatedchange.h>
+#include <Qt3DCore/qpropertyupdatedchange.h>
+#include "testpostmanarbiter.h"
+
+class TestCallback : public Qt3DLogic::QBackendFrameCallback
+{
+public:
+    void operator()(float dt) Q_DECL_OVERRIDE
+    {
+        Q_UNUSED(dt);
+    }
+};
+
+class tst_QBackendFrameAction : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void checkDefaultConstruction()
+    {
+        // GIVEN
+        Qt3DLogic::QBackendFrameAction frameAction;
+
+        // THEN
+        QVERIFY(frameAction.callback().isNull());
+    }
+
+    void checkPropertyChanges()
+    {
+        // GIVEN
+        Qt3DLogic::QBackendFrameAction frameAction;
+        const Qt3DLogic::QBackendFrameCallbackPtr callback(new TestCallback);
+
+        // WHEN
+        frameAction.setCallback(callback);
+
+        // THEN
+        QCOMPARE(frameAction.callback(), callback);
+
+        // WHEN
+        frameAction.setCallback(Qt3DLogic::QBackendFrameCallbackPtr());
+
+        // THEN
+        QVERIFY(frameAction.callback().isNull());
+    }
+
+    void checkCreationData()
+    {
+        // GIVEN
+        Qt3DLogic::QBackendFrameAction frameAction;
+        const Qt3DLogic::QBackendFrameCallbackPtr callback(new TestCallback);
+        frameAction.setCallback(callback);
+
+        // WHEN
+        Qt3DCore::QNodeCreatedChangeGenerator creationChangeGenerator(&frameAction);
+        const QVector<Qt3DCore::QNodeCreatedChangeBasePtr> creationChanges = creationChangeGenerator.creationChanges();
+
+        // THEN
+        QCOMPARE(creationChanges.size(), 1);
+
+        const auto creationChangeData = qSharedPointerCast<Qt3DCore::QNodeCreatedChange<Qt3DLogic::QBackendFrameActionData>>(creationChanges.first());
+        const Qt3DLogic::QBackendFrameActionData cloneData = creationChangeData->data;
+
+        QCOMPARE(creationChangeData->subjectId(), frameAction.id());
+        QCOMPARE(creationChangeData->isNodeEnabled(), true);
+        QCOMPARE(creationChangeData->metaObject(), frameAction.metaObject());
+        QCOMPARE(cloneData.callback, callback);
+    }
+
+    void checkCallbackUpdate()
+    {
+        // GIVEN
+        TestArbiter arbiter;
+        Qt3DLogic::QBackendFrameAction frameAction;
+        arbiter.setArbiterOnNode(&frameAction);
+        const Qt3DLogic::QBackendFrameCallbackPtr callback(new TestCallback);
+
+        {
+            // WHEN
+            frameAction.setCallback(callback);
+            QCoreApplication::processEvents();
+
+            // THEN
+            QCOMPARE(arbiter.events.size(), 1);
+            const auto change = arbiter.events.first().staticCast<Qt3DCore::QPropertyUpdatedChange>();
+            QCOMPARE(change->propertyName(), "callback");
+            QCOMPARE(change->value().value<Qt3DLogic::QBackendFrameCallbackPtr>(), callback);
+            QCOMPARE(change->type(), Qt3DCore::PropertyUpdated);
+
+            arbiter.events.clear();
+        }
+
+        {
+            // WHEN
+            frameAction.setCallback(callback);
+            QCoreApplication::processEvents();
+
+            // THEN
+            QCOMPARE(arbiter.events.size(), 0);
+        }
+    }
+};
+
+QTEST_MAIN(tst_QBackendFrameAction)
+
+#include "tst_qbackendframeaction.moc"
@@ -0,0 +1,235 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <Qt3DRender/private/boundingvolumehierarchy_p.h>
+#include <Qt3DRender/private/qray3d_p.h>
+
+using namespace Qt3DRender;
+using namespace Qt3DRender::Render;
+
+namespace {
+
+BoundingBox unitBoxAt(const QVector3D &center)
+{
+    const QVector3D halfExtent(0.5f, 0.5f, 0.5f);
+    return BoundingBox(center - halfExtent, center + halfExtent);
+}
+
+// Row of unit boxes along the x axis, every 2 units
+QVector<BoundingBox> boxRow(int count)
+{
+    QVector<BoundingBox> boxes;
+    for (int i = 0; i < count; ++i)
+        boxes.push_back(unitBoxAt(QVector3D(2.0f * i, 0.0f, 0.0f)));
+    return boxes;
+}
+
+QVector<int> traverse(const BoundingVolumeHierarchy &hierarchy,
+                      const QVector3D &origin,
+                      const QVector3D &direction,
+                      float maxDistance = std::numeric_limits<float>::infinity())
+{
+    QVector<int> primitives;
+    hierarchy.traverse(origin, direction, maxDistance, [&primitives] (int primitive) {
+        primitives.push_back(primitive);
+    });
+    std::sort(primitives.begin(), primitives.end());
+    return primitives;
+}
+
+TriangleBoundingVolumeHierarchy::Triangle triangleAt(float z, uint index)
+{
+    // Clockwise when seen from +z, as the TrianglesVisitor reports front faces
+    TriangleBoundingVolumeHierarchy::Triangle triangle;
+    triangle.vertices[0] = QVector3D(-1.0f, -1.0f, z);
+    triangle.vertices[1] = QVector3D(0.0f, 1.0f, z);
+    triangle.vertices[2] = QVector3D(1.0f, -1.0f, z);
+    triangle.vertexIndices[0] = 3 * index;
+    triangle.vertexIndices[1] = 3 * index + 1;
+    triangle.vertexIndices[2] = 3 * index + 2;
+    triangle.index = index;
+    return triangle;
+}
+
+} // anonymous
+
+class tst_BoundingVolumeHierarchy : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void checkInitialState()
+    {
+        // GIVEN
+        BoundingVolumeHierarchy hierarchy;
+
+        // THEN
+        QVERIFY(hierarchy.isEmpty());
+        QCOMPARE(hierarchy.nodeCount(), 0);
+        QVERIFY(traverse(hierarchy, QVector3D(), QVector3D(1.0f, 0.0f, 0.0f)).isEmpty());
+    }
+
+    void checkBuild()
+    {
+        // GIVEN
+        BoundingVolumeHierarchy hierarchy;
+
+        // WHEN
+        hierarchy.build(boxRow(100));
+
+        // THEN
+        QVERIFY(!hierarchy.isEmpty());
+        QCOMPARE(hierarchy.primitiveCount(), 100);
+        QVERIFY(hierarchy.nodeCount() > 1);
+
+        // WHEN
+        hierarchy.clear();
+
+        // THEN
+        QVERIFY(hierarchy.isEmpty());
+        QCOMPARE(hierarchy.primitiveCount(), 0);
+    }
+
+    void checkTraversal()
+    {
+        // GIVEN
+        BoundingVolumeHierarchy hierarchy;
+        hierarchy.build(boxRow(100));
+
+        // WHEN
+        const QVector<int> crossingBox42 = traverse(hierarchy, QVector3D(84.0f, 10.0f, 0.0f), QVector3D(0.0f, -1.0f, 0.0f));
+
+        // THEN
+        QCOMPARE(crossingBox42, QVector<int>() << 42);
+
+        // WHEN
+        const QVector<int> pointingAway = traverse(hierarchy, QVector3D(84.0f, 10.0f, 0.0f), QVector3D(0.0f, 1.0f, 0.0f));
+
+        // THEN
+        QVERIFY(pointingAway.isEmpty());
+
+        // WHEN
+        const QVector<int> tooShort = traverse(hierarchy, QVector3D(84.0f, 10.0f, 0.0f), QVector3D(0.0f, -1.0f, 0.0f), 5.0f);
+
+        // THEN
+        QVERIFY(tooShort.isEmpty());
+
+        // WHEN
+        const QVector<int> alongRow = traverse(hierarchy, QVector3D(-10.0f, 0.0f, 0.0f), QVector3D(1.0f, 0.0f, 0.0f), 15.0f);
+
+        // THEN
+        QCOMPARE(alongRow, QVector<int>() << 0 << 1 << 2);
+    }
+
+    void checkRefit()
+    {
+        // GIVEN
+        BoundingVolumeHierarchy hierarchy;
+        QVector<BoundingBox> boxes = boxRow(100);
+        hierarchy.build(boxes);
+        const int nodeCount = hierarchy.nodeCount();
+
+        // WHEN
+        boxes[42] = unitBoxAt(QVector3D(0.0f, 0.0f, 50.0f));
+        hierarchy.refit(boxes);
+
+        // THEN
+        QCOMPARE(hierarchy.nodeCount(), nodeCount);
+        QVERIFY(traverse(hierarchy, QVector3D(84.0f, 10.0f, 0.0f), QVector3D(0.0f, -1.0f, 0.0f)).isEmpty());
+        QCOMPARE(traverse(hierarchy, QVector3D(0.0f, 10.0f, 50.0f), QVector3D(0.0f, -1.0f, 0.0f)),
+                 QVector<int>() << 42);
+    }
+
+    void checkEmptyBoxesAreSkipped()
+    {
+        // GIVEN
+        BoundingVolumeHierarchy hierarchy;
+        QVector<BoundingBox> boxes = boxRow(10);
+        boxes[3] = BoundingBox();
+
+        // WHEN
+        hierarchy.build(boxes);
+
+        // THEN
+        QCOMPARE(traverse(hierarchy, QVector3D(-10.0f, 0.0f, 0.0f), QVector3D(1.0f, 0.0f, 0.0f)),
+                 QVector<int>() << 0 << 1 << 2 << 4 << 5 << 6 << 7 << 8 << 9);
+    }
+
+    void checkTriangleIntersection()
+    {
+        // GIVEN
+        TriangleBoundingVolumeHierarchy hierarchy;
+        QVector<TriangleBoundingVolumeHierarchy::Triangle> triangles;
+        for (int i = 0; i < 20; ++i)
+            triangles.push_back(triangleAt(-float(i), i));
+        hierarchy.build(triangles);
+
+        // WHEN
+        const QRay3D segment(QVector3D(0.0f, 0.0f, 1.0f), QVector3D(0.0f, 0.0f, -1.0f), 6.0f);
+        auto intersections = hierarchy.intersect(segment, false, false);
+        std::sort(intersections.begin(), intersections.end(),
+                  [] (const TriangleBoundingVolumeHierarchy::Intersection &a,
+                      const TriangleBoundingVolumeHierarchy::Intersection &b) {
+            return a.t < b.t;
+        });
+
+        // THEN
+        QCOMPARE(intersections.size(), 6);
+        for (int i = 0; i < intersections.size(); ++i) {
+            const TriangleBoundingVolumeHierarchy::Triangle &triangle = hierarchy.triangles().at(intersections.at(i).triangle);
+            QCOMPARE(triangle.index, uint(i));
+            QCOMPARE(triangle.vertexIndices[0], uint(3 * i));
+            QVERIFY(qAbs(segment.point(intersections.at(i).t * segment.distance()).z() + float(i)) < 1.0e-5f);
+        }
+    }
+
+    void checkTriangleFaceOrientation()
+    {
+        // GIVEN
+        TriangleBoundingVolumeHierarchy hierarchy;
+        hierarchy.build(QVector<TriangleBoundingVolumeHierarchy::Triangle>() << triangleAt(0.0f, 0));
+        const QRay3D fromFront(QVector3D(0.0f, 0.0f, 1.0f), QVector3D(0.0f, 0.0f, -1.0f), 2.0f);
+        const QRay3D fromBack(QVector3D(0.0f, 0.0f, -1.0f), QVector3D(0.0f, 0.0f, 1.0f), 2.0f);
+
+        // THEN
+        QCOMPARE(hierarchy.intersect(fromFront, false, false).size(), 1);
+        QCOMPARE(hierarchy.intersect(fromBack, false, false).size(), 0);
+        QCOMPARE(hierarchy.intersect(fromBack, true, false).size(), 1);
+
+        // WHEN mirrored by the world transform
+        // THEN
+        QCOMPARE(hierarchy.intersect(fromFront, false, true).size(), 0);
+        QCOMPARE(hierarchy.intersect(fromBack, false, true).size(), 1);
+    }
+};
+
+QTEST_APPLESS_MAIN(tst_BoundingVolumeHierarchy)
+
+#include "tst_boundingvolumehierarchy.moc"
@@ -89,6 +89,9 @@ private Q_SLOTS:
         QCOMPARE(renderBuffer.data(), buffer.data());
         QCOMPARE(renderBuffer.dataGenerator(), buffer.dataGenerator());
         QVERIFY(*renderBuffer.dataGenerator() == *buffer.dataGenerator());
+        QVERIFY(bufferManager.hasBuffersToUpload());
+        QCOMPARE(bufferManager.takeBuffersToUpload(), QVector<Qt3DCore::QNodeId>() << buffer.id());
+        QVERIFY(!bufferManager.hasBuffersToUpload());
     }
 
     void checkInitialAndCleanedUpState()
@@ -252,6 +255,84 @@ private Q_SLOTS:
         renderBuffer.unsetDirty();
         QVERIFY(!renderBuffer.isDirty());
     }
+
+    void checkChangedRanges()
+    {
+        // GIVEN
+        const QByteArray oldData(4096, 'a');
+        QByteArray newData = oldData;
+        newData[10] = 'b';
+        newData[300] = 'b';
+        newData[3000] = 'b';
+
+        // WHEN
+        const QVector<Qt3DRender::QBufferUpdate> ranges = Qt3DRender::Render::Buffer::changedRanges(oldData, newData);
+
+        // THEN
+        // Blocks 0 and 1 are merged, block 11 is on its own
+        QCOMPARE(ranges.size(), 2);
+        QCOMPARE(ranges.at(0).offset, 0);
+        QCOMPARE(ranges.at(0).data, newData.mid(0, 512));
+        QCOMPARE(ranges.at(1).offset, 2816);
+        QCOMPARE(ranges.at(1).data, newData.mid(2816, 256));
+        QVERIFY(Qt3DRender::Render::Buffer::changedRanges(oldData, oldData).isEmpty());
+    }
+
+    void checkDataChangesUploadChangedRanges()
+    {
+        // GIVEN
+        TestRenderer renderer;
+        Qt3DRender::Render::Buffer renderBuffer;
+        renderBuffer.setRenderer(&renderer);
+        QByteArray data(4096, 'a');
+
+        Qt3DCore::QPropertyUpdatedChangePtr updateChange(new Qt3DCore::QPropertyUpdatedChange(Qt3DCore::QNodeId()));
+        updateChange->setValue(data);
+        updateChange->setPropertyName("data");
+        renderBuffer.sceneChangeEvent(updateChange);
+
+        // THEN
+        QVERIFY(renderBuffer.isDirty());
+        QVERIFY(renderBuffer.isFullUploadRequired());
+        renderBuffer.unsetDirty();
+
+        // WHEN
+        data[1000] = 'b';
+        updateChange.reset(new Qt3DCore::QPropertyUpdatedChange(Qt3DCore::QNodeId()));
+        updateChange->setValue(data);
+        updateChange->setPropertyName("data");
+        renderBuffer.sceneChangeEvent(updateChange);
+
+        // THEN
+        QVERIFY(renderBuffer.isDirty());
+        QVERIFY(!renderBuffer.isFullUploadRequired());
+        QCOMPARE(renderBuffer.pendingBufferUpdates().size(), 1);
+        QCOMPARE(renderBuffer.pendingBufferUpdates().first().offset, 768);
+        QCOMPARE(renderBuffer.data(), data);
+        renderBuffer.pendingBufferUpdates().clear();
+        renderBuffer.unsetDirty();
+
+        // WHEN
+        updateChange.reset(new Qt3DCore::QPropertyUpdatedChange(Qt3DCore::QNodeId()));
+        updateChange->setValue(data);
+        updateChange->setPropertyName("data");
+        renderBuffer.sceneChangeEvent(updateChange);
+
+        // THEN
+        QVERIFY(!renderBuffer.isDirty());
+
+        // WHEN
+        data.fill('c');
+        updateChange.reset(new Qt3DCore::QPropertyUpdatedChange(Qt3DCore::QNodeId()));
+        updateChange->setValue(data);
+        updateChange->setPropertyName("data");
+        renderBuffer.sceneChangeEvent(updateChange);
+
+        // THEN
+        QVERIFY(renderBuffer.isDirty());
+        QVERIFY(renderBuffer.isFullUploadRequired());
+        QVERIFY(renderBuffer.pendingBufferUpdates().isEmpty());
+    }
 };
 
 
@@ -57,6 +57,7 @@ public:
     bool isRunning() const Q_DECL_OVERRIDE { return true; }
     bool shouldRender() Q_DECL_OVERRIDE { return true; }
     void skipNextFrame() Q_DECL_OVERRIDE {}
+    bool isIdle() Q_DECL_OVERRIDE { return false; }
     QVector<Qt3DCore::QAspectJobPtr> renderBinJobs() Q_DECL_OVERRIDE { return QVector<Qt3DCore::QAspectJobPtr>(); }
     Qt3DCore::QAspectJobPtr pickBoundingVolumeJob() Q_DECL_OVERRIDE { return Qt3DCore::QAspectJobPtr(); }
     void setSceneRoot(Qt3DCore::QBackendNodeFactory *factory, Qt3DRender::Render::Entity *root) Q_DECL_OVERRIDE { Q_UNUSED(factory);  Q_UNUSED(root); }
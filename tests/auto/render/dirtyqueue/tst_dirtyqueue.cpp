@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QTest>
+#include <Qt3DRender/private/dirtyqueue_p.h>
+#include <QThread>
+
+namespace {
+
+class PushingThread : public QThread
+{
+public:
+    PushingThread(Qt3DRender::Render::DirtyQueue<int> *queue, int first, int count)
+        : m_queue(queue)
+        , m_first(first)
+        , m_count(count)
+    {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = m_first, m = m_first + m_count; i < m; ++i)
+            m_queue->push(i);
+    }
+
+private:
+    Qt3DRender::Render::DirtyQueue<int> *m_queue;
+    int m_first;
+    int m_count;
+};
+
+} // anonymous
+
+class tst_DirtyQueue : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void checkInitialState()
+    {
+        // GIVEN
+        Qt3DRender::Render::DirtyQueue<int> queue;
+
+        // THEN
+        QVERIFY(queue.isEmpty());
+        QVERIFY(queue.takeAll().isEmpty());
+    }
+
+    void checkTakeAllKeepsPushOrder()
+    {
+        // GIVEN
+        Qt3DRender::Render::DirtyQueue<int> queue;
+
+        // WHEN
+        queue.push(3);
+        queue.push(1);
+        queue.push(3);
+
+        // THEN
+        QVERIFY(!queue.isEmpty());
+        QCOMPARE(queue.takeAll(), QVector<int>() << 3 << 1 << 3);
+        QVERIFY(queue.isEmpty());
+
+        // WHEN
+        queue.push(2);
+        queue.clear();
+
+        // THEN
+        QVERIFY(queue.isEmpty());
+    }
+
+    void checkConcurrentPush()
+    {
+        // GIVEN
+        const int countPerThread = 10000;
+        Qt3DRender::Render::DirtyQueue<int> queue;
+        QVector<PushingThread *> threads;
+        for (int i = 0; i < 4; ++i)
+            threads.push_back(new PushingThread(&queue, i * countPerThread, countPerThread));
+
+        // WHEN
+        for (PushingThread *thread : qAsConst(threads))
+            thread->start();
+        QVector<int> values;
+        for (PushingThread *thread : qAsConst(threads)) {
+            thread->wait();
+            values += queue.takeAll();
+        }
+        values += queue.takeAll();
+        qDeleteAll(threads);
+
+        // THEN
+        QCOMPARE(values.size(), 4 * countPerThread);
+        std::sort(values.begin(), values.end());
+        for (int i = 0, m = values.size(); i < m; ++i)
+            QCOMPARE(values.at(i), i);
+    }
+};
+
+QTEST_MAIN(tst_DirtyQueue)
+
+#include "tst_dirtyqueue.moc"
@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QTest>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <QtCore/QScopedPointer>
+#include <Qt3DCore/QEntity>
+#include <Qt3DRender/private/qsceneimporter_p.h>
+#include <Qt3DRender/private/qsceneimportfactory_p.h>
+
+namespace {
+
+const quint32 glbMagic = 0x46546C67; // "glTF"
+const quint32 glbHeaderSize = 20;
+
+const char sceneJson[] =
+        "{"
+        "\"scene\": \"defaultScene\","
+        "\"scenes\": { \"defaultScene\": { \"nodes\": [ \"node\" ] } },"
+        "\"nodes\": { \"node\": { \"name\": \"node\" } }"
+        "}";
+
+void appendUInt32(QByteArray &data, quint32 value)
+{
+    uchar bytes[4];
+    qToLittleEndian(value, bytes);
+    data.append(reinterpret_cast<const char *>(bytes), 4);
+}
+
+QByteArray binaryGLTF(quint32 length, quint32 contentLength, const QByteArray &content, const QByteArray &body)
+{
+    QByteArray data;
+    appendUInt32(data, glbMagic);
+    appendUInt32(data, 1);
+    appendUInt32(data, length);
+    appendUInt32(data, contentLength);
+    appendUInt32(data, 0);
+    data += content;
+    data += body;
+    return data;
+}
+
+} // anonymous
+
+class tst_GLTFImporter : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void checkBinaryGLTF_data()
+    {
+        QTest::addColumn<QByteArray>("data");
+        QTest::addColumn<bool>("loaded");
+
+        const QByteArray content(sceneJson);
+        const QByteArray body(16, '\0');
+        const quint32 length = glbHeaderSize + content.size() + body.size();
+
+        QTest::newRow("valid") << binaryGLTF(length, content.size(), content, body) << true;
+        QTest::newRow("empty body") << binaryGLTF(length - body.size(), content.size(), content, QByteArray()) << true;
+        QTest::newRow("truncated") << binaryGLTF(length, content.size(), content, body).left(length - 1) << false;
+        QTest::newRow("length below header") << binaryGLTF(8, content.size(), content, body) << false;
+        QTest::newRow("content beyond length") << binaryGLTF(length, length, content, body) << false;
+        QTest::newRow("header only") << binaryGLTF(glbHeaderSize, 0, QByteArray(), QByteArray()) << false;
+    }
+
+    void checkBinaryGLTF()
+    {
+        // GIVEN
+        QFETCH(QByteArray, data);
+        QFETCH(bool, loaded);
+
+        QScopedPointer<Qt3DRender::QSceneImporter> importer(Qt3DRender::QSceneImportFactory::create(QStringLiteral("gltf"), QStringList()));
+        if (importer.isNull())
+            QSKIP("The glTF scene importer plugin is not available");
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.path() + QStringLiteral("/scene.glb");
+        {
+            QFile file(path);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            QCOMPARE(file.write(data), qint64(data.size()));
+        }
+
+        // WHEN
+        importer->setSource(QUrl::fromLocalFile(path));
+        QScopedPointer<Qt3DCore::QEntity> scene(importer->scene());
+
+        // THEN
+        QCOMPARE(!scene.isNull(), loaded);
+        if (loaded)
+            QCOMPARE(scene->childNodes().size(), 1);
+    }
+};
+
+QTEST_MAIN(tst_GLTFImporter)
+
+#include "tst_gltfimporter.moc"
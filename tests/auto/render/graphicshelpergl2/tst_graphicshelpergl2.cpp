@@ -175,6 +175,14 @@ private Q_SLOTS:
         // Not supported by GL2
     }
 
+    void bindBufferRange()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, OpenGL 2.0 functions not supported");
+
+        // Not supported by GL2
+    }
+
     void bindFragDataLocation()
     {
         if (!m_initializationSuccessful)
@@ -871,6 +879,8 @@ private Q_SLOTS:
         SUPPORTS_FEATURE(GraphicsHelperInterface::Compute, false);
         SUPPORTS_FEATURE(GraphicsHelperInterface::DrawBuffersBlend, false);
         SUPPORTS_FEATURE(GraphicsHelperInterface::Tessellation, false);
+        SUPPORTS_FEATURE(GraphicsHelperInterface::InstancedArrays, false);
+        SUPPORTS_FEATURE(GraphicsHelperInterface::MultiDrawIndirect, false);
     }
 
 
@@ -244,6 +244,44 @@ private Q_SLOTS:
         m_func->glDeleteBuffers(1, &bufferId);
     }
 
+    void bindBufferRange()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, OpenGL 3.3 Core functions not supported");
+
+        // GIVEN
+        GLuint bufferId = 0;
+        // WHEN
+        m_func->glGenBuffers(1, &bufferId);
+        // THEN
+        QVERIFY(bufferId != 0);
+
+        // GIVEN
+        GLint offsetAlignment = 0;
+        m_func->glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+        m_func->glBindBuffer(GL_UNIFORM_BUFFER, bufferId);
+        m_func->glBufferData(GL_UNIFORM_BUFFER, 2 * offsetAlignment, nullptr, GL_DYNAMIC_DRAW);
+
+        // WHEN
+        m_glHelper.bindBufferRange(GL_UNIFORM_BUFFER, 2, bufferId, offsetAlignment, 64);
+        // THEN
+        const GLint error = m_func->glGetError();
+        QVERIFY(error == 0);
+        GLint boundToPointBufferId = 0;
+        m_func->glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, 2, &boundToPointBufferId);
+        QVERIFY(boundToPointBufferId == GLint(bufferId));
+        GLint64 boundOffset = 0;
+        GLint64 boundSize = 0;
+        m_func->glGetInteger64i_v(GL_UNIFORM_BUFFER_START, 2, &boundOffset);
+        m_func->glGetInteger64i_v(GL_UNIFORM_BUFFER_SIZE, 2, &boundSize);
+        QCOMPARE(boundOffset, GLint64(offsetAlignment));
+        QCOMPARE(boundSize, GLint64(64));
+
+        // Restore to sane state
+        m_func->glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        m_func->glDeleteBuffers(1, &bufferId);
+    }
+
     void bindFragDataLocation()
     {
         if (!m_initializationSuccessful)
@@ -1165,6 +1203,8 @@ private Q_SLOTS:
         SUPPORTS_FEATURE(GraphicsHelperInterface::ShaderStorageObject, false);
         SUPPORTS_FEATURE(GraphicsHelperInterface::Compute, false);
         SUPPORTS_FEATURE(GraphicsHelperInterface::DrawBuffersBlend, false);
+        SUPPORTS_FEATURE(GraphicsHelperInterface::InstancedArrays, true);
+        SUPPORTS_FEATURE(GraphicsHelperInterface::MultiDrawIndirect, false);
         // Tesselation could be true or false depending on extensions so not tested
     }
 
@@ -269,6 +269,44 @@ private Q_SLOTS:
         m_func->glDeleteBuffers(1, &bufferId);
     }
 
+    void bindBufferRange()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, OpenGL 4.3 Core functions not supported");
+
+        // GIVEN
+        GLuint bufferId = 0;
+        // WHEN
+        m_func->glGenBuffers(1, &bufferId);
+        // THEN
+        QVERIFY(bufferId != 0);
+
+        // GIVEN
+        GLint offsetAlignment = 0;
+        m_func->glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+        m_func->glBindBuffer(GL_UNIFORM_BUFFER, bufferId);
+        m_func->glBufferData(GL_UNIFORM_BUFFER, 2 * offsetAlignment, nullptr, GL_DYNAMIC_DRAW);
+
+        // WHEN
+        m_glHelper.bindBufferRange(GL_UNIFORM_BUFFER, 2, bufferId, offsetAlignment, 64);
+        // THEN
+        const GLint error = m_func->glGetError();
+        QVERIFY(error == 0);
+        GLint boundToPointBufferId = 0;
+        m_func->glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, 2, &boundToPointBufferId);
+        QVERIFY(boundToPointBufferId == GLint(bufferId));
+        GLint64 boundOffset = 0;
+        GLint64 boundSize = 0;
+        m_func->glGetInteger64i_v(GL_UNIFORM_BUFFER_START, 2, &boundOffset);
+        m_func->glGetInteger64i_v(GL_UNIFORM_BUFFER_SIZE, 2, &boundSize);
+        QCOMPARE(boundOffset, GLint64(offsetAlignment));
+        QCOMPARE(boundSize, GLint64(64));
+
+        // Restore to sane state
+        m_func->glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        m_func->glDeleteBuffers(1, &bufferId);
+    }
+
     void bindFragDataLocation()
     {
         if (!m_initializationSuccessful)
@@ -1001,6 +1039,49 @@ private Q_SLOTS:
         QCOMPARE(maxCount, m_glHelper.maxClipPlaneCount());
     }
 
+    void multiDrawElementsIndirect()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, OpenGL 4.3 Core functions not supported");
+
+        // GIVEN
+        QOpenGLShaderProgram shaderProgram;
+        shaderProgram.addShaderFromSourceCode(QOpenGLShader::Vertex, vertCode);
+        shaderProgram.addShaderFromSourceCode(QOpenGLShader::Fragment, fragCodeFragOutputs);
+        QVERIFY(shaderProgram.link());
+        m_func->glUseProgram(shaderProgram.programId());
+
+        GLuint vao = 0;
+        GLuint buffers[2] = { 0, 0 };
+        m_func->glGenVertexArrays(1, &vao);
+        m_func->glGenBuffers(2, buffers);
+        m_func->glBindVertexArray(vao);
+
+        const GLushort indices[] = { 0, 1, 2, 0, 2, 3 };
+        m_func->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[0]);
+        m_func->glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+        // count, instanceCount, firstIndex, baseVertex, baseInstance
+        const GLuint draws[] = { 3, 1, 0, 0, 0,
+                                 3, 2, 3, 0, 1 };
+        m_func->glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffers[1]);
+        m_func->glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(draws), draws, GL_STATIC_DRAW);
+
+        // WHEN
+        m_glHelper.multiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_SHORT, nullptr, 2, 0);
+
+        // THEN
+        const GLint error = m_func->glGetError();
+        QVERIFY(error == 0);
+
+        // Restore to sane state
+        m_func->glBindVertexArray(0);
+        m_func->glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        m_func->glDeleteBuffers(2, buffers);
+        m_func->glDeleteVertexArrays(1, &vao);
+        m_func->glUseProgram(0);
+    }
+
     void programUniformBlock()
     {
         if (!m_initializationSuccessful)
@@ -1258,7 +1339,7 @@ private Q_SLOTS:
 
     void supportsFeature()
     {
-        for (int i = 0; i <= GraphicsHelperInterface::DrawBuffersBlend; ++i)
+        for (int i = 0; i <= GraphicsHelperInterface::MultiDrawIndirect; ++i)
             QVERIFY(m_glHelper.supportsFeature(static_cast<GraphicsHelperInterface::Feature>(i)));
     }
 
@@ -0,0 +1,25 @@
+TEMPLATE = app
+
+TARGET = tst_ktxtextures
+
+CONFIG += testcase
+
+SOURCES += tst_ktxtextures.cpp
+
+OTHER_FILES = \
+    data/15x15x1-1-rgb.ktx \
+    data/16x16x1-1-etc2.ktx \
+    data/16x16x1-1-rgba-nomips.ktx \
+    data/16x16x1-1-rgba.ktx \
+    data/16x16x1-1-rgba.ktx2 \
+    data/16x16x1-1-supercompressed.ktx2 \
+    data/16x16x1-6-bc1.ktx \
+    data/16x16x1-6-bc7.ktx2 \
+    data/16x16x4-1-etc2-array.ktx2 \
+    data/16x16x4-1-etc2eac-array.ktx \
+    data/32x32x1-1-astc8x8.ktx \
+    data/32x32x1-1-astc8x8.ktx2
+
+TESTDATA = data/*
+
+QT += core-private 3dcore 3dcore-private 3drender 3drender-private testlib
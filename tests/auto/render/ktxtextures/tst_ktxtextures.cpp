@@ -0,0 +1,152 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QTest>
+#include <Qt3DRender/qtextureimagedata.h>
+#include <Qt3DRender/private/qtexture_p.h>
+#include <Qt3DRender/private/qtextureimagedata_p.h>
+#include <QRegularExpression>
+
+namespace {
+
+// The test files fill every image with a value identifying its level, layer and face
+char expectedValue(int level, int layer, int face)
+{
+    return char((level * 32 + layer * 6 + face + 1) & 0xff);
+}
+
+} // anonymous
+
+class tst_KtxTextures : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void ktxImageData();
+    void ktxMipLayout();
+    void ktxUnsupported();
+};
+
+void tst_KtxTextures::ktxImageData()
+{
+    const struct TextureInfo {
+        const char *source;
+        int width;
+        int height;
+        int layers;
+        int faces;
+        int mipmapLevels;
+        QOpenGLTexture::Target target;
+        QOpenGLTexture::TextureFormat format;
+        bool compressed;
+    } textures[] = {
+        { "data/16x16x1-1-rgba-nomips.ktx",      16, 16, 1, 1, 1, QOpenGLTexture::Target2D,      QOpenGLTexture::RGBA8_UNorm, false },
+        { "data/16x16x1-1-rgba.ktx",             16, 16, 1, 1, 5, QOpenGLTexture::Target2D,      QOpenGLTexture::RGBA8_UNorm, false },
+        { "data/15x15x1-1-rgb.ktx",              15, 15, 1, 1, 4, QOpenGLTexture::Target2D,      QOpenGLTexture::RGB8_UNorm, false },
+        { "data/16x16x1-1-etc2.ktx",             16, 16, 1, 1, 5, QOpenGLTexture::Target2D,      QOpenGLTexture::RGB8_ETC2, true },
+        { "data/16x16x1-6-bc1.ktx",              16, 16, 1, 6, 5, QOpenGLTexture::TargetCubeMap, QOpenGLTexture::RGBA_DXT1, true },
+        { "data/16x16x4-1-etc2eac-array.ktx",    16, 16, 4, 1, 5, QOpenGLTexture::Target2DArray, QOpenGLTexture::RGBA8_ETC2_EAC, true },
+        { "data/32x32x1-1-astc8x8.ktx",          32, 32, 1, 1, 6, QOpenGLTexture::Target2D,      QOpenGLTexture::TextureFormat(0x93B7), true },
+        { "data/16x16x1-1-rgba.ktx2",            16, 16, 1, 1, 5, QOpenGLTexture::Target2D,      QOpenGLTexture::RGBA8_UNorm, false },
+        { "data/16x16x1-6-bc7.ktx2",             16, 16, 1, 6, 5, QOpenGLTexture::TargetCubeMap, QOpenGLTexture::RGB_BP_UNorm, true },
+        { "data/16x16x4-1-etc2-array.ktx2",      16, 16, 4, 1, 5, QOpenGLTexture::Target2DArray, QOpenGLTexture::RGB8_ETC2, true },
+        { "data/32x32x1-1-astc8x8.ktx2",         32, 32, 1, 1, 6, QOpenGLTexture::Target2D,      QOpenGLTexture::TextureFormat(0x93B7), true },
+    };
+
+    for (unsigned i = 0; i < sizeof(textures)/sizeof(*textures); i++) {
+        const TextureInfo *texture = &textures[i];
+
+        Qt3DRender::QTextureImageDataPtr data = Qt3DRender::TextureLoadingHelper::loadTextureData(QUrl::fromLocalFile(QFINDTESTDATA(texture->source)), true, false);
+
+        QVERIFY(data);
+        QCOMPARE(data->width(), texture->width);
+        QCOMPARE(data->height(), texture->height);
+        QCOMPARE(data->depth(), 1);
+        QCOMPARE(data->layers(), texture->layers);
+        QCOMPARE(data->faces(), texture->faces);
+        QCOMPARE(data->mipLevels(), texture->mipmapLevels);
+        QCOMPARE(data->target(), texture->target);
+        QCOMPARE(data->format(), texture->format);
+        QCOMPARE(data->isCompressed(), texture->compressed);
+
+        // Images are reordered from the level major order of the files
+        for (int level = 0; level < texture->mipmapLevels; ++level) {
+            for (int layer = 0; layer < texture->layers; ++layer) {
+                for (int face = 0; face < texture->faces; ++face) {
+                    const QByteArray bytes = data->data(layer, face, level);
+                    QVERIFY(!bytes.isEmpty());
+                    QCOMPARE(bytes.count(expectedValue(level, layer, face)), bytes.size());
+                }
+            }
+        }
+    }
+}
+
+void tst_KtxTextures::ktxMipLayout()
+{
+    const struct LayoutInfo {
+        const char *source;
+        int levelSizes[6];
+    } layouts[] = {
+        // Rows of uncompressed images are no longer padded to 4 bytes
+        { "data/15x15x1-1-rgb.ktx",         { 15 * 15 * 3, 7 * 7 * 3, 3 * 3 * 3, 1 * 1 * 3, 0, 0 } },
+        { "data/16x16x1-1-etc2.ktx",        { 128, 32, 8, 8, 8, 0 } },
+        { "data/16x16x1-6-bc7.ktx2",        { 256, 64, 16, 16, 16, 0 } },
+        // ASTC blocks cover 8x8 texels
+        { "data/32x32x1-1-astc8x8.ktx",     { 256, 64, 16, 16, 16, 16 } },
+        { "data/32x32x1-1-astc8x8.ktx2",    { 256, 64, 16, 16, 16, 16 } },
+    };
+
+    for (unsigned i = 0; i < sizeof(layouts)/sizeof(*layouts); i++) {
+        const LayoutInfo *layout = &layouts[i];
+
+        Qt3DRender::QTextureImageDataPtr data = Qt3DRender::TextureLoadingHelper::loadTextureData(QUrl::fromLocalFile(QFINDTESTDATA(layout->source)), true, false);
+
+        QVERIFY(data);
+        int totalSize = 0;
+        for (int level = 0; level < data->mipLevels(); ++level) {
+            QCOMPARE(data->data(0, 0, level).size(), layout->levelSizes[level]);
+            totalSize += layout->levelSizes[level];
+        }
+        QCOMPARE(data->data().size(), layout->levelSizes[0]);
+        QCOMPARE(totalSize * data->layers() * data->faces(), Qt3DRender::QTextureImageDataPrivate::get(data.data())->m_data.size());
+    }
+}
+
+void tst_KtxTextures::ktxUnsupported()
+{
+    // Supercompressed payloads would need to be inflated first
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("^Supercompressed KTX2 files are not supported")));
+    Qt3DRender::QTextureImageDataPtr data = Qt3DRender::TextureLoadingHelper::loadTextureData(QUrl::fromLocalFile(QFINDTESTDATA("data/16x16x1-1-supercompressed.ktx2")), true, false);
+
+    QVERIFY(!data);
+}
+
+QTEST_APPLESS_MAIN(tst_KtxTextures)
+
+#include "tst_ktxtextures.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = app
+
+TARGET = tst_objloader
+
+QT += 3dcore 3dcore-private 3drender 3drender-private testlib
+
+CONFIG += testcase
+
+SOURCES += tst_objloader.cpp
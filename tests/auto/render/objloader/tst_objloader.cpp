@@ -0,0 +1,283 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QTest>
+#include <QtCore/QBuffer>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <Qt3DRender/private/objloader_p.h>
+
+namespace {
+
+const char triangle[] =
+        "v 0 0 0\n"
+        "v 1 0 0\n"
+        "v 0 1 0\n"
+        "vt 0 0\n"
+        "vt 1 0\n"
+        "vt 0 1\n"
+        "vn 0 0 1\n";
+
+bool loadFromData(Qt3DRender::ObjLoader &loader, const QByteArray &data)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    return loader.load(&buffer);
+}
+
+bool writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(data) == data.size();
+}
+
+QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+QByteArray floatBytes(float value)
+{
+    return QByteArray(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+} // anonymous
+
+class tst_ObjLoader : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void checkAllAttributes()
+    {
+        // GIVEN
+        Qt3DRender::ObjLoader loader;
+
+        // WHEN
+        const bool loaded = loadFromData(loader, QByteArray(triangle) + "f 1/1/1 2/2/1 3/3/1\n");
+
+        // THEN
+        QVERIFY(loaded);
+        QCOMPARE(loader.vertices(), QVector<QVector3D>() << QVector3D(0.0f, 0.0f, 0.0f)
+                 << QVector3D(1.0f, 0.0f, 0.0f) << QVector3D(0.0f, 1.0f, 0.0f));
+        QCOMPARE(loader.textureCoordinates(), QVector<QVector2D>() << QVector2D(0.0f, 0.0f)
+                 << QVector2D(1.0f, 0.0f) << QVector2D(0.0f, 1.0f));
+        QCOMPARE(loader.normals(), QVector<QVector3D>(3, QVector3D(0.0f, 0.0f, 1.0f)));
+        QCOMPARE(loader.tangents().size(), 3);
+        QCOMPARE(loader.indices(), QVector<unsigned int>() << 0 << 1 << 2);
+    }
+
+    void checkRelativeIndices()
+    {
+        // GIVEN
+        Qt3DRender::ObjLoader absoluteLoader;
+        Qt3DRender::ObjLoader relativeLoader;
+
+        // WHEN
+        QVERIFY(loadFromData(absoluteLoader, QByteArray(triangle) + "f 1/1/1 2/2/1 3/3/1\n"));
+        QVERIFY(loadFromData(relativeLoader, QByteArray(triangle) + "f -3/-3/-1 -2/-2/-1 -1/-1/-1\n"));
+
+        // THEN
+        QCOMPARE(relativeLoader.vertices(), absoluteLoader.vertices());
+        QCOMPARE(relativeLoader.textureCoordinates(), absoluteLoader.textureCoordinates());
+        QCOMPARE(relativeLoader.normals(), absoluteLoader.normals());
+        QCOMPARE(relativeLoader.indices(), absoluteLoader.indices());
+    }
+
+    void checkRelativeIndicesAcrossChunks()
+    {
+        // GIVEN
+        Qt3DRender::ObjLoader loader;
+        QByteArray data("v 0 0 0\nv 1 0 0\nv 0 1 0\n");
+        // Enough lines for the face to be parsed in another chunk than the vertices
+        const QByteArray comment = QByteArray(63, '#') + '\n';
+        for (int i = 0; i < (2 << 20) / comment.size(); ++i)
+            data += comment;
+        data += "f -3 -2 -1\n";
+
+        // WHEN
+        const bool loaded = loadFromData(loader, data);
+
+        // THEN
+        QVERIFY(loaded);
+        QCOMPARE(loader.vertices(), QVector<QVector3D>() << QVector3D(0.0f, 0.0f, 0.0f)
+                 << QVector3D(1.0f, 0.0f, 0.0f) << QVector3D(0.0f, 1.0f, 0.0f));
+        QCOMPARE(loader.indices(), QVector<unsigned int>() << 0 << 1 << 2);
+    }
+
+    void checkInvalidIndicesAreSkipped()
+    {
+        // GIVEN
+        Qt3DRender::ObjLoader loader;
+
+        // WHEN
+        const bool loaded = loadFromData(loader, QByteArray(triangle)
+                                         + "f 1 2 4\n"
+                                         + "f -4 -2 -1\n"
+                                         + "f 0 1 2\n"
+                                         + "f -3 -2 -1\n");
+
+        // THEN
+        QVERIFY(loaded);
+        QCOMPARE(loader.vertices().size(), 3);
+        QCOMPARE(loader.indices(), QVector<unsigned int>() << 0 << 1 << 2);
+    }
+
+    void checkMissingNormals()
+    {
+        // GIVEN
+        Qt3DRender::ObjLoader loader;
+
+        // WHEN
+        const bool loaded = loadFromData(loader, "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n");
+
+        // THEN
+        // normals are generated from the faces
+        QVERIFY(loaded);
+        QVERIFY(loader.hasNormals());
+        QCOMPARE(loader.normals(), QVector<QVector3D>(3, QVector3D(0.0f, 0.0f, 1.0f)));
+        QVERIFY(!loader.hasTextureCoordinates());
+        QVERIFY(!loader.hasTangents());
+    }
+
+    void checkMissingTextureCoordinates()
+    {
+        // GIVEN
+        Qt3DRender::ObjLoader loader;
+
+        // WHEN
+        const bool loaded = loadFromData(loader, "v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 1 0 0\nf 1//1 2//1 3//1\n");
+
+        // THEN
+        QVERIFY(loaded);
+        QCOMPARE(loader.normals(), QVector<QVector3D>(3, QVector3D(1.0f, 0.0f, 0.0f)));
+        QVERIFY(!loader.hasTextureCoordinates());
+        QVERIFY(!loader.hasTangents());
+    }
+
+    void checkCacheRoundTrip()
+    {
+        // GIVEN
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString objPath = dir.path() + QStringLiteral("/mesh.obj");
+        const QString cachePath = dir.path() + QStringLiteral("/cache");
+        QVERIFY(writeFile(objPath, "v 0 0 0\nv 1234.5 0 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 0 1\nf 1/1 2/2 3/3\n"));
+
+        Qt3DRender::ObjLoader loader;
+        loader.setCacheDirectory(cachePath);
+
+        // WHEN
+        QVERIFY(loader.load(objPath));
+
+        // THEN
+        const QStringList cacheFiles = QDir(cachePath).entryList(QStringList() << QStringLiteral("*.objcache"));
+        QCOMPARE(cacheFiles.size(), 1);
+
+        // WHEN
+        Qt3DRender::ObjLoader cachedLoader;
+        cachedLoader.setCacheDirectory(cachePath);
+        QVERIFY(cachedLoader.load(objPath));
+
+        // THEN
+        QCOMPARE(cachedLoader.vertices(), loader.vertices());
+        QCOMPARE(cachedLoader.normals(), loader.normals());
+        QCOMPARE(cachedLoader.textureCoordinates(), loader.textureCoordinates());
+        QCOMPARE(cachedLoader.tangents(), loader.tangents());
+        QCOMPARE(cachedLoader.indices(), loader.indices());
+
+        // WHEN
+        // the cached position is modified
+        const QString cacheFilePath = QDir(cachePath).filePath(cacheFiles.first());
+        QByteArray cache = readFile(cacheFilePath);
+        const int offset = cache.indexOf(floatBytes(1234.5f));
+        QVERIFY(offset > 0);
+        cache.replace(offset, int(sizeof(float)), floatBytes(4321.5f));
+        QVERIFY(writeFile(cacheFilePath, cache));
+
+        Qt3DRender::ObjLoader modifiedLoader;
+        modifiedLoader.setCacheDirectory(cachePath);
+        QVERIFY(modifiedLoader.load(objPath));
+
+        // THEN
+        // the mesh is read from the cache rather than from the source
+        QCOMPARE(modifiedLoader.vertices().at(1), QVector3D(4321.5f, 0.0f, 0.0f));
+    }
+
+    void checkCacheInvalidation()
+    {
+        // GIVEN
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString objPath = dir.path() + QStringLiteral("/mesh.obj");
+        const QString cachePath = dir.path() + QStringLiteral("/cache");
+        QVERIFY(writeFile(objPath, "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n"));
+        {
+            Qt3DRender::ObjLoader loader;
+            loader.setCacheDirectory(cachePath);
+            QVERIFY(loader.load(objPath));
+        }
+
+        // WHEN
+        // the source changes
+        QVERIFY(writeFile(objPath, "v 0 0 0\nv 2 0 0\nv 0 2 0\nv 2 2 0\nf 1 2 3\nf 2 4 3\n"));
+        Qt3DRender::ObjLoader loader;
+        loader.setCacheDirectory(cachePath);
+        QVERIFY(loader.load(objPath));
+
+        // THEN
+        QCOMPARE(loader.vertices().size(), 4);
+        QCOMPARE(loader.indices().size(), 6);
+
+        // WHEN
+        // the cache is truncated
+        const QStringList cacheFiles = QDir(cachePath).entryList(QStringList() << QStringLiteral("*.objcache"));
+        QCOMPARE(cacheFiles.size(), 1);
+        const QString cacheFilePath = QDir(cachePath).filePath(cacheFiles.first());
+        const QByteArray cache = readFile(cacheFilePath);
+        QVERIFY(writeFile(cacheFilePath, cache.left(cache.size() - 4)));
+
+        Qt3DRender::ObjLoader truncatedLoader;
+        truncatedLoader.setCacheDirectory(cachePath);
+        QVERIFY(truncatedLoader.load(objPath));
+
+        // THEN
+        // the source is parsed again
+        QCOMPARE(truncatedLoader.vertices(), loader.vertices());
+        QCOMPARE(truncatedLoader.indices(), loader.indices());
+    }
+};
+
+QTEST_MAIN(tst_ObjLoader)
+
+#include "tst_objloader.moc"
@@ -0,0 +1,176 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QTest>
+#include <Qt3DCore/qentity.h>
+#include <Qt3DCore/private/qnodecreatedchangegenerator_p.h>
+#include <Qt3DCore/private/qaspectjobmanager_p.h>
+
+#include <Qt3DRender/qobjectpicker.h>
+#include <Qt3DRender/qrenderaspect.h>
+#include <Qt3DRender/private/qrenderaspect_p.h>
+#include <Qt3DRender/private/nodemanagers_p.h>
+#include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/entity_p.h>
+#include <Qt3DRender/private/sphere_p.h>
+#include <Qt3DRender/private/pickboundingvolumejob_p.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace Qt3DRender {
+
+class TestAspect : public Qt3DRender::QRenderAspect
+{
+public:
+    TestAspect(Qt3DCore::QNode *root)
+        : Qt3DRender::QRenderAspect(Qt3DRender::QRenderAspect::Synchronous)
+        , m_jobManager(new Qt3DCore::QAspectJobManager())
+    {
+        Qt3DCore::QAbstractAspectPrivate::get(this)->m_jobManager = m_jobManager.data();
+        QRenderAspect::onRegistered();
+
+        const Qt3DCore::QNodeCreatedChangeGenerator generator(root);
+        const QVector<Qt3DCore::QNodeCreatedChangeBasePtr> creationChanges = generator.creationChanges();
+
+        for (const Qt3DCore::QNodeCreatedChangeBasePtr change : creationChanges)
+            d_func()->createBackendNode(change);
+    }
+
+    ~TestAspect()
+    {
+        QRenderAspect::onUnregistered();
+    }
+
+    Qt3DRender::Render::NodeManagers *nodeManagers() const
+    {
+        return d_func()->m_renderer->nodeManagers();
+    }
+
+    Qt3DRender::Render::Entity *entity(Qt3DCore::QNodeId id) const
+    {
+        return nodeManagers()->renderNodesManager()->lookupResource(id);
+    }
+
+    void onRegistered() { QRenderAspect::onRegistered(); }
+    void onUnregistered() { QRenderAspect::onUnregistered(); }
+
+private:
+    QScopedPointer<Qt3DCore::QAspectJobManager> m_jobManager;
+};
+
+} // namespace Qt3DRender
+
+QT_END_NAMESPACE
+
+namespace {
+
+Qt3DCore::QEntity *createEntity(Qt3DCore::QEntity *parent, bool pickable)
+{
+    Qt3DCore::QEntity *entity = new Qt3DCore::QEntity(parent);
+    if (pickable)
+        entity->addComponent(new Qt3DRender::QObjectPicker(entity));
+    return entity;
+}
+
+void setWorldBoundingVolume(Qt3DRender::TestAspect *aspect, Qt3DCore::QEntity *entity, const QVector3D &center)
+{
+    Qt3DRender::Render::Sphere *sphere = aspect->entity(entity->id())->worldBoundingVolume();
+    sphere->setCenter(center);
+    sphere->setRadius(1.0f);
+}
+
+QVector<Qt3DCore::QNodeId> sorted(QVector<Qt3DCore::QNodeId> ids)
+{
+    std::sort(ids.begin(), ids.end(), [] (Qt3DCore::QNodeId a, Qt3DCore::QNodeId b) { return a.id() < b.id(); });
+    return ids;
+}
+
+QVector<Qt3DCore::QNodeId> peerIds(const QVector<Qt3DRender::Render::Entity *> &entities)
+{
+    QVector<Qt3DCore::QNodeId> ids;
+    for (const Qt3DRender::Render::Entity *entity : entities)
+        ids.push_back(entity->peerId());
+    return sorted(ids);
+}
+
+} // anonymous
+
+class tst_PickBoundingVolumeJob : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void checkOnlyPickableEntitiesAlongRay()
+    {
+        // GIVEN
+        Qt3DCore::QEntity *rootEntity = new Qt3DCore::QEntity();
+        // An entity without picker in front of the pickable ones...
+        Qt3DCore::QEntity *occluder = createEntity(rootEntity, false);
+        Qt3DCore::QEntity *pickable = createEntity(rootEntity, true);
+        // ... the child of a pickable entity is pickable too
+        Qt3DCore::QEntity *pickableChild = createEntity(pickable, false);
+        Qt3DCore::QEntity *pickableAside = createEntity(rootEntity, true);
+
+        QScopedPointer<Qt3DRender::TestAspect> aspect(new Qt3DRender::TestAspect(rootEntity));
+        setWorldBoundingVolume(aspect.data(), rootEntity, QVector3D(0.0f, 0.0f, 20.0f));
+        setWorldBoundingVolume(aspect.data(), occluder, QVector3D(0.0f, 0.0f, -5.0f));
+        setWorldBoundingVolume(aspect.data(), pickable, QVector3D(0.0f, 0.0f, -10.0f));
+        setWorldBoundingVolume(aspect.data(), pickableChild, QVector3D(0.0f, 0.0f, -15.0f));
+        setWorldBoundingVolume(aspect.data(), pickableAside, QVector3D(10.0f, 0.0f, -10.0f));
+
+        Qt3DRender::Render::PickBoundingVolumeJob pickJob(nullptr);
+        pickJob.setManagers(aspect->nodeManagers());
+        pickJob.setRoot(aspect->entity(rootEntity->id()));
+
+        // WHEN
+        pickJob.updateEntityHierarchy();
+        const QVector<Qt3DRender::Render::Entity *> entities =
+                pickJob.entitiesAlongRay(Qt3DRender::QRay3D(QVector3D(), QVector3D(0.0f, 0.0f, -1.0f), 100.0f));
+
+        // THEN
+        QVector<Qt3DCore::QNodeId> expectedIds;
+        expectedIds << pickable->id() << pickableChild->id();
+        QCOMPARE(peerIds(entities), sorted(expectedIds));
+
+        // WHEN
+        // the entity aside moves in front of the ray
+        setWorldBoundingVolume(aspect.data(), pickableAside, QVector3D(0.0f, 0.0f, -20.0f));
+        pickJob.updateEntityHierarchy();
+        const QVector<Qt3DRender::Render::Entity *> movedEntities =
+                pickJob.entitiesAlongRay(Qt3DRender::QRay3D(QVector3D(), QVector3D(0.0f, 0.0f, -1.0f), 100.0f));
+
+        // THEN
+        expectedIds << pickableAside->id();
+        QCOMPARE(peerIds(movedEntities), sorted(expectedIds));
+    }
+};
+
+QTEST_MAIN(tst_PickBoundingVolumeJob)
+
+#include "tst_pickboundingvolumejob.moc"
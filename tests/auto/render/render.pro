@@ -13,6 +13,7 @@ qtConfig(private_tests) {
         material \
         vsyncframeadvanceservice \
         meshfunctors \
+        objloader \
         qmaterial \
         qattribute \
         qbuffer \
@@ -45,7 +46,14 @@ qtConfig(private_tests) {
         qdefaultmeshes \
         trianglesextractor \
         triangleboundingvolume \
+        boundingvolumehierarchy \
+        pickboundingvolumejob \
         ddstextures \
+        ktxtextures \
+        texturedecodequeue \
+        texturedatamanager \
+        dirtyqueue \
+        renderstateset \
         shadercache \
         layerfiltering \
         filterentitybycomponent \
@@ -59,8 +67,11 @@ qtConfig(private_tests) {
         qcameralens \
         qcomputecommand \
         loadscenejob \
+        gltfimporter \
         qrendercapture \
         uniform \
+        vertexarrayobject \
+        shadercompiler \
         graphicshelpergl3_3 \
         graphicshelpergl3_2 \
         graphicshelpergl2
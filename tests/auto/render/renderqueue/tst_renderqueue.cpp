@@ -47,6 +47,10 @@ private Q_SLOTS:
     void checkTimeToSubmit();
     void concurrentQueueAccess();
     void resetQueue();
+    void checkPreparedState();
+    void ringFramesInFlight();
+    void ringFrameIndices();
+    void ringRenderViews();
 };
 
 
@@ -232,6 +236,172 @@ void tst_RenderQueue::resetQueue()
     }
 }
 
+void tst_RenderQueue::checkPreparedState()
+{
+    // GIVEN
+    Qt3DRender::Render::RenderQueue renderQueue;
+
+    // THEN
+    QVERIFY(!renderQueue.isPrepared());
+    QVERIFY(!renderQueue.isSubmittable());
+
+    // WHEN
+    renderQueue.setPrepared(true);
+
+    // THEN
+    QVERIFY(renderQueue.isPrepared());
+    QVERIFY(renderQueue.isSubmittable());
+
+    // WHEN
+    renderQueue.reset();
+    renderQueue.setPrepared(false);
+
+    // THEN
+    QVERIFY(renderQueue.isPrepared());
+    QVERIFY(!renderQueue.isSubmittable());
+
+    // WHEN
+    renderQueue.reset();
+
+    // THEN
+    QVERIFY(!renderQueue.isPrepared());
+    QVERIFY(!renderQueue.isSubmittable());
+}
+
+void tst_RenderQueue::ringFramesInFlight()
+{
+    // GIVEN
+    Qt3DRender::Render::RenderQueueRing defaultRing;
+    Qt3DRender::Render::RenderQueueRing smallRing(0);
+    Qt3DRender::Render::RenderQueueRing largeRing(8);
+
+    // THEN
+    QCOMPARE(defaultRing.framesInFlight(), 2);
+    QCOMPARE(smallRing.framesInFlight(), 1);
+    QCOMPARE(largeRing.framesInFlight(), int(Qt3DRender::Render::RenderQueueRing::MaxFramesInFlight));
+
+    for (int framesInFlight = 1; framesInFlight <= 3; ++framesInFlight) {
+        // GIVEN
+        Qt3DRender::Render::RenderQueueRing ring(framesInFlight);
+
+        // THEN
+        QCOMPARE(ring.queuedFrameCount(), 0);
+        QVERIFY(ring.oldestQueue() == nullptr);
+        QVERIFY(ring.newestQueue() == nullptr);
+
+        // WHEN
+        QVector<Qt3DRender::Render::RenderQueue *> queues;
+        for (int i = 0; i < framesInFlight; ++i) {
+            QVERIFY(ring.canBeginFrame());
+            queues.push_back(ring.beginFrame());
+        }
+
+        // THEN
+        QVERIFY(!ring.canBeginFrame());
+        QCOMPARE(ring.queuedFrameCount(), framesInFlight);
+        QCOMPARE(ring.oldestQueue(), queues.first());
+        QCOMPARE(ring.newestQueue(), queues.last());
+        for (int i = 1; i < framesInFlight; ++i)
+            QVERIFY(!queues.mid(0, i).contains(queues.at(i)));
+
+        // WHEN
+        ring.releaseOldestFrame();
+
+        // THEN
+        QVERIFY(ring.canBeginFrame());
+        QCOMPARE(ring.queuedFrameCount(), framesInFlight - 1);
+
+        // WHEN
+        Qt3DRender::Render::RenderQueue *reused = ring.beginFrame();
+
+        // THEN
+        QCOMPARE(reused, queues.first());
+        QCOMPARE(ring.newestQueue(), reused);
+    }
+}
+
+void tst_RenderQueue::ringFrameIndices()
+{
+    // GIVEN
+    Qt3DRender::Render::RenderQueueRing ring(3);
+
+    // WHEN
+    for (quint64 frameIndex = 0; frameIndex < 10; ++frameIndex) {
+        Qt3DRender::Render::RenderQueue *renderQueue = ring.beginFrame();
+        renderQueue->setTargetRenderViewCount(1);
+        renderQueue->queueRenderView(nullptr, 0);
+        renderQueue->setPrepared(true);
+
+        // THEN
+        QCOMPARE(renderQueue->frameIndex(), frameIndex);
+        QCOMPARE(ring.nextFrameIndex(), frameIndex + 1);
+        QCOMPARE(ring.newestQueue(), renderQueue);
+
+        // WHEN
+        if (ring.queuedFrameCount() == ring.framesInFlight()) {
+            const quint64 oldestIndex = ring.oldestQueue()->frameIndex();
+            ring.releaseOldestFrame();
+
+            // THEN
+            QCOMPARE(ring.oldestQueue()->frameIndex(), oldestIndex + 1);
+        }
+    }
+
+    // THEN
+    QCOMPARE(ring.queuedFrameCount(), 2);
+    QCOMPARE(ring.oldestQueue()->frameIndex(), quint64(8));
+    QCOMPARE(ring.newestQueue()->frameIndex(), quint64(9));
+
+    // WHEN
+    ring.releaseOldestFrame();
+
+    // THEN
+    QCOMPARE(ring.oldestQueue(), ring.newestQueue());
+    QVERIFY(ring.oldestQueue()->isPrepared());
+
+    // WHEN
+    ring.reset();
+
+    // THEN
+    QCOMPARE(ring.queuedFrameCount(), 0);
+    QCOMPARE(ring.nextFrameIndex(), quint64(10));
+    QVERIFY(!ring.beginFrame()->isPrepared());
+}
+
+void tst_RenderQueue::ringRenderViews()
+{
+    // GIVEN
+    Qt3DRender::Render::RenderQueueRing ring(3);
+    QVector<Qt3DRender::Render::RenderView *> renderViews;
+    for (int i = 0; i < 5; ++i)
+        renderViews.push_back(new Qt3DRender::Render::RenderView());
+
+    // WHEN
+    Qt3DRender::Render::RenderQueue *firstQueue = ring.beginFrame();
+    firstQueue->setTargetRenderViewCount(2);
+    firstQueue->queueRenderView(renderViews.at(1), 1);
+    firstQueue->queueRenderView(renderViews.at(0), 0);
+
+    Qt3DRender::Render::RenderQueue *secondQueue = ring.beginFrame();
+    secondQueue->setTargetRenderViewCount(3);
+    secondQueue->queueRenderView(renderViews.at(2), 0);
+    secondQueue->queueRenderView(renderViews.at(3), 1);
+    secondQueue->queueRenderView(renderViews.at(4), 2);
+
+    // THEN
+    QVERIFY(firstQueue->isFrameQueueComplete());
+    QVERIFY(secondQueue->isFrameQueueComplete());
+    QCOMPARE(ring.renderViews(), renderViews);
+
+    // WHEN
+    ring.releaseOldestFrame();
+
+    // THEN
+    QCOMPARE(ring.renderViews(), renderViews.mid(2));
+
+    qDeleteAll(renderViews);
+}
+
 QTEST_APPLESS_MAIN(tst_RenderQueue)
 
 #include "tst_renderqueue.moc"
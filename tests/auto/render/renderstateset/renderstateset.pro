@@ -0,0 +1,9 @@
+TEMPLATE = app
+
+TARGET = tst_renderstateset
+
+QT += core-private 3dcore 3dcore-private 3drender 3drender-private testlib
+
+CONFIG += testcase
+
+SOURCES += tst_renderstateset.cpp
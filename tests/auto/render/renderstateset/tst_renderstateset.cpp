@@ -0,0 +1,128 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QTest>
+#include <Qt3DRender/private/renderstateset_p.h>
+#include <Qt3DRender/private/renderstates_p.h>
+
+using namespace Qt3DRender::Render;
+
+class tst_RenderStateSet : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void checkAddState()
+    {
+        // GIVEN
+        RenderStateSet stateSet;
+
+        // WHEN
+        stateSet.addState(RenderStateSet::createState<DepthTest>(GL_LESS));
+        stateSet.addState(RenderStateSet::createState<ClipPlane>(0, QVector3D(0.0f, 1.0f, 0.0f), 0.0f));
+        stateSet.addState(RenderStateSet::createState<ClipPlane>(1, QVector3D(1.0f, 0.0f, 0.0f), 0.0f));
+
+        // THEN
+        QCOMPARE(stateSet.stateMask(), StateMaskSet(DepthTestStateMask | ClipPlaneMask));
+    }
+
+    void checkMergeKeepsOwnStates()
+    {
+        // GIVEN
+        RenderStateSet defaultStates;
+        defaultStates.addState(RenderStateSet::createState<DepthTest>(GL_LESS));
+        defaultStates.addState(RenderStateSet::createState<CullFace>(GL_BACK));
+
+        RenderStateSet passStates;
+        passStates.addState(RenderStateSet::createState<DepthTest>(GL_LEQUAL));
+
+        RenderStateSet expectedStates;
+        expectedStates.addState(RenderStateSet::createState<DepthTest>(GL_LEQUAL));
+        expectedStates.addState(RenderStateSet::createState<CullFace>(GL_BACK));
+
+        // WHEN
+        passStates.merge(&defaultStates);
+
+        // THEN
+        QCOMPARE(passStates.stateMask(), StateMaskSet(DepthTestStateMask | CullFaceStateMask));
+        QVERIFY(passStates == expectedStates);
+        QVERIFY(!(passStates == defaultStates));
+    }
+
+    void checkEquality()
+    {
+        // GIVEN
+        RenderStateSet a;
+        a.addState(RenderStateSet::createState<ClipPlane>(0, QVector3D(0.0f, 1.0f, 0.0f), 0.0f));
+        a.addState(RenderStateSet::createState<ClipPlane>(1, QVector3D(1.0f, 0.0f, 0.0f), 0.0f));
+        RenderStateSet b;
+        b.addState(RenderStateSet::createState<ClipPlane>(1, QVector3D(1.0f, 0.0f, 0.0f), 0.0f));
+        b.addState(RenderStateSet::createState<ClipPlane>(0, QVector3D(0.0f, 1.0f, 0.0f), 0.0f));
+        RenderStateSet c;
+        c.addState(RenderStateSet::createState<ClipPlane>(0, QVector3D(0.0f, 1.0f, 0.0f), 0.0f));
+
+        // THEN
+        QVERIFY(a == b);
+        QVERIFY(!(a == c));
+    }
+
+    void checkChangeCost()
+    {
+        // GIVEN
+        RenderStateSet previous;
+        previous.addState(RenderStateSet::createState<DepthTest>(GL_LESS));
+        previous.addState(RenderStateSet::createState<CullFace>(GL_BACK));
+
+        RenderStateSet same;
+        same.addState(RenderStateSet::createState<CullFace>(GL_BACK));
+        same.addState(RenderStateSet::createState<DepthTest>(GL_LESS));
+
+        RenderStateSet cullChanged;
+        cullChanged.addState(RenderStateSet::createState<DepthTest>(GL_LESS));
+        cullChanged.addState(RenderStateSet::createState<CullFace>(GL_FRONT));
+
+        RenderStateSet depthChanged;
+        depthChanged.addState(RenderStateSet::createState<DepthTest>(GL_LEQUAL));
+        depthChanged.addState(RenderStateSet::createState<CullFace>(GL_BACK));
+
+        RenderStateSet depthRemoved;
+        depthRemoved.addState(RenderStateSet::createState<CullFace>(GL_BACK));
+
+        // THEN
+        QCOMPARE(previous.changeCost(&previous), 0);
+        QCOMPARE(same.changeCost(&previous), 0);
+        QVERIFY(cullChanged.changeCost(&previous) > 0);
+        // Depth test changes are weighted heavier than culling ones
+        QVERIFY(depthChanged.changeCost(&previous) > cullChanged.changeCost(&previous));
+        QCOMPARE(depthRemoved.changeCost(&previous), depthChanged.changeCost(&previous));
+    }
+};
+
+QTEST_APPLESS_MAIN(tst_RenderStateSet)
+
+#include "tst_renderstateset.moc"
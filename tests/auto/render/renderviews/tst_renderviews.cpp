@@ -28,8 +28,15 @@
 
 #include <QtTest/QTest>
 #include <private/renderview_p.h>
+#include <private/rendercommand_p.h>
+#include <private/stringtoint_p.h>
 #include <private/qframeallocator_p.h>
 #include <private/qframeallocator_p_p.h>
+#include <private/renderstateset_p.h>
+#include <private/renderstates_p.h>
+#include <private/renderviewjobutils_p.h>
+#include <private/shadervariables_p.h>
+#include <QtGui/qgenericmatrix.h>
 
 class tst_RenderViews : public QObject
 {
@@ -48,6 +55,445 @@ private Q_SLOTS:
 
     }
 
+    void checkInstancedCommandMerging()
+    {
+        // GIVEN
+        Qt3DRender::Render::RenderView renderView;
+        const int modelMatrixId = Qt3DRender::Render::StringToInt::lookupId(QLatin1String("modelMatrix"));
+        const int colorId = Qt3DRender::Render::StringToInt::lookupId(QLatin1String("color"));
+        QVector<Qt3DRender::Render::RenderCommand *> commands;
+
+        for (int i = 0; i < 4; ++i) {
+            Qt3DRender::Render::RenderCommand *command = new Qt3DRender::Render::RenderCommand();
+            command->m_isValid = true;
+            command->m_shaderDna = 883;
+            command->m_instanceAttributeLocation = 3;
+            command->m_instanceCount = 1;
+            command->m_instanceTransform.translate(float(i), 0.0f, 0.0f);
+            command->m_parameterPack.setUniform(modelMatrixId, Qt3DRender::Render::UniformValue(command->m_instanceTransform));
+            // The last command differs by a parameter other than its transform
+            command->m_parameterPack.setUniform(colorId, Qt3DRender::Render::UniformValue(i < 3 ? 1.0f : 0.5f));
+            commands.push_back(command);
+        }
+        renderView.setCommands(commands);
+
+        // WHEN
+        renderView.mergeInstancedCommands(true);
+
+        // THEN
+        QCOMPARE(renderView.commands().size(), 2);
+        QCOMPARE(renderView.commands().at(0), commands.at(0));
+        QCOMPARE(renderView.commands().at(0)->m_instanceCount, 3);
+        QCOMPARE(renderView.commands().at(0)->m_instanceTransformCount, 3);
+        QCOMPARE(renderView.commands().at(0)->m_instanceDataOffset, 0);
+        QCOMPARE(renderView.commands().at(1), commands.at(3));
+        QCOMPARE(renderView.commands().at(1)->m_instanceCount, 1);
+        QCOMPARE(renderView.commands().at(1)->m_instanceTransformCount, 1);
+        QCOMPARE(renderView.commands().at(1)->m_instanceDataOffset, 3 * 16 * int(sizeof(float)));
+        QCOMPARE(renderView.instanceData().size(), 4 * 16 * int(sizeof(float)));
+
+        const float *transforms = reinterpret_cast<const float *>(renderView.instanceData().constData());
+        for (int i = 0; i < 4; ++i)
+            QCOMPARE(transforms[i * 16 + 12], float(i));
+    }
+
+    void checkSortedCommandsMergedIntoOneInstancedDraw()
+    {
+        // GIVEN
+        Qt3DRender::Render::RenderView renderView;
+        const int modelMatrixId = Qt3DRender::Render::StringToInt::lookupId(QLatin1String("modelMatrix"));
+        const int colorId = Qt3DRender::Render::StringToInt::lookupId(QLatin1String("color"));
+        QVector<Qt3DRender::Render::RenderCommand *> commands;
+
+        for (int i = 0; i < 5; ++i) {
+            Qt3DRender::Render::RenderCommand *command = new Qt3DRender::Render::RenderCommand();
+            command->m_isValid = true;
+            command->m_shaderDna = 883;
+            command->m_instanceAttributeLocation = 3;
+            command->m_instanceCount = 1;
+            // The first two commands share their transform
+            command->m_instanceTransform.translate(float(qMax(i, 1)), 0.0f, 0.0f);
+            command->m_parameterPack.setUniform(modelMatrixId, Qt3DRender::Render::UniformValue(command->m_instanceTransform));
+            command->m_parameterPack.setUniform(colorId, Qt3DRender::Render::UniformValue(1.0f));
+            commands.push_back(command);
+        }
+        renderView.setCommands(commands);
+
+        // WHEN
+        renderView.sort();
+        renderView.mergeInstancedCommands(true);
+        renderView.packIndirectDraws(true);
+        renderView.minimizeUniformChanges();
+
+        // THEN
+        QCOMPARE(renderView.commands().size(), 1);
+        Qt3DRender::Render::RenderCommand *command = renderView.commands().first();
+        QCOMPARE(command->m_instanceCount, 5);
+        QCOMPARE(command->m_instanceTransformCount, 5);
+        QCOMPARE(command->m_instanceDataOffset, 0);
+        QCOMPARE(command->m_parameterPack.uniforms().size(), 2);
+        QCOMPARE(renderView.instanceData().size(), 5 * 16 * int(sizeof(float)));
+
+        const float *transforms = reinterpret_cast<const float *>(renderView.instanceData().constData());
+        QVector<float> translations;
+        for (int i = 0; i < 5; ++i)
+            translations.push_back(transforms[i * 16 + 12]);
+        std::sort(translations.begin(), translations.end());
+        QCOMPARE(translations, QVector<float>() << 1.0f << 1.0f << 2.0f << 3.0f << 4.0f);
+    }
+
+    void checkRepeatedUniformsDroppedAfterMerging()
+    {
+        // GIVEN
+        Qt3DRender::Render::RenderView renderView;
+        const int modelMatrixId = Qt3DRender::Render::StringToInt::lookupId(QLatin1String("modelMatrix"));
+        const int colorId = Qt3DRender::Render::StringToInt::lookupId(QLatin1String("color"));
+        QVector<Qt3DRender::Render::RenderCommand *> commands;
+
+        for (int i = 0; i < 3; ++i) {
+            Qt3DRender::Render::RenderCommand *command = new Qt3DRender::Render::RenderCommand();
+            command->m_isValid = true;
+            command->m_shaderDna = 883;
+            // Not instanced, each command sets its own transform
+            command->m_instanceTransform.translate(float(i), 0.0f, 0.0f);
+            command->m_parameterPack.setUniform(modelMatrixId, Qt3DRender::Render::UniformValue(command->m_instanceTransform));
+            command->m_parameterPack.setUniform(colorId, Qt3DRender::Render::UniformValue(1.0f));
+            commands.push_back(command);
+        }
+        renderView.setCommands(commands);
+
+        // WHEN
+        renderView.sort();
+        renderView.mergeInstancedCommands(true);
+        renderView.minimizeUniformChanges();
+
+        // THEN
+        QCOMPARE(renderView.commands().size(), 3);
+        QCOMPARE(renderView.commands().at(0)->m_parameterPack.uniforms().size(), 2);
+        for (int i = 1; i < 3; ++i) {
+            const Qt3DRender::Render::PackUniformHash &uniforms = renderView.commands().at(i)->m_parameterPack.uniforms();
+            QCOMPARE(uniforms.size(), 1);
+            QVERIFY(uniforms.contains(modelMatrixId));
+        }
+    }
+
+    void checkStateSetsInterned()
+    {
+        // GIVEN
+        Qt3DRender::Render::RenderView renderView;
+        Qt3DRender::Render::RenderStateSet *a = new Qt3DRender::Render::RenderStateSet();
+        a->addState(Qt3DRender::Render::RenderStateSet::createState<Qt3DRender::Render::DepthTest>(GL_LESS));
+        Qt3DRender::Render::RenderStateSet *b = new Qt3DRender::Render::RenderStateSet();
+        b->addState(Qt3DRender::Render::RenderStateSet::createState<Qt3DRender::Render::DepthTest>(GL_LESS));
+        Qt3DRender::Render::RenderStateSet *c = new Qt3DRender::Render::RenderStateSet();
+        c->addState(Qt3DRender::Render::RenderStateSet::createState<Qt3DRender::Render::DepthTest>(GL_GREATER));
+
+        // WHEN
+        int idA = 0;
+        int idB = 0;
+        int idC = 0;
+        Qt3DRender::Render::RenderStateSet *internedA = renderView.internStateSet(a, &idA);
+        Qt3DRender::Render::RenderStateSet *internedB = renderView.internStateSet(b, &idB);
+        Qt3DRender::Render::RenderStateSet *internedC = renderView.internStateSet(c, &idC);
+
+        // THEN
+        QCOMPARE(internedA, a);
+        QCOMPARE(internedB, a);
+        QCOMPARE(internedC, c);
+        QCOMPARE(idA, 1);
+        QCOMPARE(idB, idA);
+        QCOMPARE(idC, 2);
+    }
+
+    void checkInstancedCommandsNotMergedWithoutInstancedArrays()
+    {
+        // GIVEN
+        Qt3DRender::Render::RenderView renderView;
+        QVector<Qt3DRender::Render::RenderCommand *> commands;
+
+        for (int i = 0; i < 2; ++i) {
+            Qt3DRender::Render::RenderCommand *command = new Qt3DRender::Render::RenderCommand();
+            command->m_isValid = true;
+            command->m_instanceAttributeLocation = 3;
+            command->m_instanceCount = 1;
+            commands.push_back(command);
+        }
+        renderView.setCommands(commands);
+
+        // WHEN
+        renderView.mergeInstancedCommands(false);
+
+        // THEN
+        QCOMPARE(renderView.commands().size(), 2);
+        QCOMPARE(renderView.commands().at(1)->m_instanceDataOffset, 16 * int(sizeof(float)));
+        QCOMPARE(renderView.instanceData().size(), 2 * 16 * int(sizeof(float)));
+    }
+
+    void checkInstancedCommandsMergedOnlyWithSameShaderDataBlocks()
+    {
+        // GIVEN
+        Qt3DRender::Render::RenderView renderView;
+        const Qt3DCore::QNodeId shaderDataId = Qt3DCore::QNodeId::createId();
+        QVector<Qt3DRender::Render::RenderCommand *> commands;
+
+        for (int i = 0; i < 3; ++i) {
+            Qt3DRender::Render::RenderCommand *command = new Qt3DRender::Render::RenderCommand();
+            command->m_isValid = true;
+            command->m_shaderDna = 883;
+            command->m_instanceAttributeLocation = 3;
+            command->m_instanceCount = 1;
+            Qt3DRender::Render::BlockToUBO block;
+            block.m_blockIndex = 0;
+            block.m_shaderDataID = shaderDataId;
+            block.m_blockSize = 16;
+            // The last command uses different ShaderData values
+            block.m_values.push_back(QVariant(i < 2 ? 1.0f : 0.5f));
+            command->m_parameterPack.setUniformBuffer(block);
+            commands.push_back(command);
+        }
+        renderView.setCommands(commands);
+
+        // WHEN
+        renderView.mergeInstancedCommands(true);
+
+        // THEN
+        QCOMPARE(renderView.commands().size(), 2);
+        QCOMPARE(renderView.commands().at(0)->m_instanceCount, 2);
+        QCOMPARE(renderView.commands().at(1), commands.at(2));
+        QCOMPARE(renderView.commands().at(1)->m_instanceCount, 1);
+    }
+
+    void checkInstancedCommandsMergedOnlyWithSameDraw()
+    {
+        // GIVEN
+        Qt3DRender::Render::RenderView renderView;
+        QVector<Qt3DRender::Render::RenderCommand *> commands;
+
+        for (int i = 0; i < 3; ++i) {
+            Qt3DRender::Render::RenderCommand *command = new Qt3DRender::Render::RenderCommand();
+            command->m_isValid = true;
+            command->m_shaderDna = 883;
+            command->m_instanceAttributeLocation = 3;
+            command->m_instanceCount = 1;
+            command->m_drawIndexed = true;
+            command->m_indexAttributeDataType = GL_UNSIGNED_SHORT;
+            command->m_primitiveCount = 6;
+            // The last command draws another range of the index buffer
+            command->m_indexAttributeByteOffset = (i < 2) ? 0 : 6 * sizeof(GLushort);
+            commands.push_back(command);
+        }
+        renderView.setCommands(commands);
+
+        // WHEN
+        renderView.mergeInstancedCommands(true);
+
+        // THEN
+        QCOMPARE(renderView.commands().size(), 2);
+        QCOMPARE(renderView.commands().at(0)->m_instanceCount, 2);
+        QCOMPARE(renderView.commands().at(1), commands.at(2));
+        QCOMPARE(renderView.commands().at(1)->m_instanceCount, 1);
+    }
+
+    void checkIndirectDrawPacking()
+    {
+        // GIVEN
+        Qt3DRender::Render::RenderView renderView;
+        QVector<Qt3DRender::Render::RenderCommand *> commands;
+
+        for (int i = 0; i < 3; ++i) {
+            Qt3DRender::Render::RenderCommand *command = new Qt3DRender::Render::RenderCommand();
+            command->m_isValid = true;
+            command->m_shaderDna = 883;
+            command->m_instanceAttributeLocation = 3;
+            command->m_instanceCount = 1;
+            command->m_drawIndexed = true;
+            command->m_indexAttributeDataType = GL_UNSIGNED_SHORT;
+            command->m_primitiveType = Qt3DRender::QGeometryRenderer::Triangles;
+            command->m_primitiveCount = 6;
+            command->m_indexAttributeByteOffset = i * 6 * sizeof(GLushort);
+            // The last command isn't indexed and can't be packed
+            command->m_drawIndexed = (i < 2);
+            commands.push_back(command);
+        }
+        renderView.setCommands(commands);
+        renderView.mergeInstancedCommands(true);
+
+        // WHEN
+        renderView.packIndirectDraws(true);
+
+        // THEN
+        QCOMPARE(renderView.commands().size(), 2);
+        QCOMPARE(renderView.commands().at(0)->m_indirectDrawOffset, 0);
+        QCOMPARE(renderView.commands().at(0)->m_indirectDrawCount, 2);
+        QCOMPARE(renderView.commands().at(1)->m_indirectDrawCount, 0);
+        QCOMPARE(renderView.indirectDrawData().size(), 2 * int(sizeof(Qt3DRender::Render::DrawElementsIndirectCommand)));
+
+        const Qt3DRender::Render::DrawElementsIndirectCommand *draws =
+                reinterpret_cast<const Qt3DRender::Render::DrawElementsIndirectCommand *>(renderView.indirectDrawData().constData());
+        QCOMPARE(draws[0].count, 6U);
+        QCOMPARE(draws[0].firstIndex, 0U);
+        QCOMPARE(draws[0].baseInstance, 0U);
+        QCOMPARE(draws[1].firstIndex, 6U);
+        QCOMPARE(draws[1].baseInstance, 1U);
+    }
+
+    void checkSortedCommandsPackedIntoOneMultiDraw()
+    {
+        // GIVEN
+        Qt3DRender::Render::RenderView renderView;
+        const int modelMatrixId = Qt3DRender::Render::StringToInt::lookupId(QLatin1String("modelMatrix"));
+        const int colorId = Qt3DRender::Render::StringToInt::lookupId(QLatin1String("color"));
+        QVector<Qt3DRender::Render::RenderCommand *> commands;
+
+        for (int i = 0; i < 3; ++i) {
+            Qt3DRender::Render::RenderCommand *command = new Qt3DRender::Render::RenderCommand();
+            command->m_isValid = true;
+            command->m_shaderDna = 883;
+            command->m_instanceAttributeLocation = 3;
+            command->m_instanceCount = 1;
+            command->m_drawIndexed = true;
+            command->m_indexAttributeDataType = GL_UNSIGNED_SHORT;
+            command->m_primitiveType = Qt3DRender::QGeometryRenderer::Triangles;
+            command->m_primitiveCount = 6;
+            command->m_indexAttributeByteOffset = i * 6 * sizeof(GLushort);
+            command->m_instanceTransform.translate(float(i), 0.0f, 0.0f);
+            command->m_parameterPack.setUniform(modelMatrixId, Qt3DRender::Render::UniformValue(command->m_instanceTransform));
+            command->m_parameterPack.setUniform(colorId, Qt3DRender::Render::UniformValue(1.0f));
+            commands.push_back(command);
+        }
+        renderView.setCommands(commands);
+
+        // WHEN
+        renderView.sort();
+        renderView.mergeInstancedCommands(true);
+        renderView.packIndirectDraws(true);
+        renderView.minimizeUniformChanges();
+
+        // THEN
+        QCOMPARE(renderView.commands().size(), 1);
+        QCOMPARE(renderView.commands().first()->m_indirectDrawOffset, 0);
+        QCOMPARE(renderView.commands().first()->m_indirectDrawCount, 3);
+        QCOMPARE(renderView.indirectDrawData().size(), 3 * int(sizeof(Qt3DRender::Render::DrawElementsIndirectCommand)));
+    }
+
+    void checkStandardUniformBlockStd140Layout()
+    {
+        // GIVEN
+        // layout(std140) uniform qt3d_StandardUniforms {
+        //     vec3 eyePosition; float time; mat3 modelNormalMatrix;
+        //     mat4 modelMatrix; float weights[4];
+        // };
+        const int blockSize = 192;
+        const int alignment = 256;
+        QByteArray standardUniformData;
+
+        Qt3DRender::Render::ShaderUniform eyePosition;
+        eyePosition.m_type = GL_FLOAT_VEC3;
+        eyePosition.m_size = 1;
+        eyePosition.m_offset = 0;
+        eyePosition.m_rawByteSize = 12;
+
+        Qt3DRender::Render::ShaderUniform time;
+        time.m_type = GL_FLOAT;
+        time.m_size = 1;
+        time.m_offset = 12;
+        time.m_rawByteSize = 4;
+
+        Qt3DRender::Render::ShaderUniform normalMatrix;
+        normalMatrix.m_type = GL_FLOAT_MAT3;
+        normalMatrix.m_size = 1;
+        normalMatrix.m_offset = 16;
+        normalMatrix.m_matrixStride = 16;
+        normalMatrix.m_rawByteSize = 48;
+
+        Qt3DRender::Render::ShaderUniform modelMatrix;
+        modelMatrix.m_type = GL_FLOAT_MAT4;
+        modelMatrix.m_size = 1;
+        modelMatrix.m_offset = 64;
+        modelMatrix.m_matrixStride = 16;
+        modelMatrix.m_rawByteSize = 64;
+
+        Qt3DRender::Render::ShaderUniform weights;
+        weights.m_type = GL_FLOAT;
+        weights.m_size = 4;
+        weights.m_offset = 128;
+        weights.m_arrayStride = 16;
+        weights.m_rawByteSize = 64;
+
+        const float normalValues[] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f };
+        const QMatrix3x3 normal(normalValues);
+        QMatrix4x4 model;
+        model.translate(1.0f, 2.0f, 3.0f);
+        model.rotate(45.0f, 0.0f, 1.0f, 0.0f);
+        const auto floatAt = [&] (int offset) {
+            float value;
+            memcpy(&value, standardUniformData.constData() + offset, sizeof(float));
+            return value;
+        };
+
+        // WHEN
+        const int firstOffset = Qt3DRender::Render::appendStandardUniformBlock(&standardUniformData, blockSize, alignment);
+        const int secondOffset = Qt3DRender::Render::appendStandardUniformBlock(&standardUniformData, blockSize, alignment);
+
+        // THEN
+        QCOMPARE(firstOffset, 0);
+        QCOMPARE(secondOffset, alignment);
+        QCOMPARE(standardUniformData.size(), 2 * alignment);
+
+        // WHEN
+        char *blockData = standardUniformData.data() + firstOffset;
+        QVERIFY(Qt3DRender::Render::writeStandardUniform(blockData, blockSize, time, Qt3DRender::Render::UniformValue(0.5f)));
+        QVERIFY(Qt3DRender::Render::writeStandardUniform(blockData, blockSize, eyePosition, Qt3DRender::Render::UniformValue(QVector3D(1.0f, 2.0f, 3.0f))));
+        QVERIFY(Qt3DRender::Render::writeStandardUniform(blockData, blockSize, normalMatrix, Qt3DRender::Render::UniformValue(normal)));
+        QVERIFY(Qt3DRender::Render::writeStandardUniform(blockData, blockSize, modelMatrix, Qt3DRender::Render::UniformValue(model)));
+
+        // THEN
+        // The vec3 leaves the float packed after it untouched
+        QCOMPARE(floatAt(0), 1.0f);
+        QCOMPARE(floatAt(4), 2.0f);
+        QCOMPARE(floatAt(8), 3.0f);
+        QCOMPARE(floatAt(12), 0.5f);
+        // mat3 columns are padded to the matrix stride
+        for (int column = 0; column < 3; ++column) {
+            for (int row = 0; row < 3; ++row)
+                QCOMPARE(floatAt(16 + column * 16 + row * 4), normal(row, column));
+            QCOMPARE(floatAt(16 + column * 16 + 12), 0.0f);
+        }
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row)
+                QCOMPARE(floatAt(64 + column * 16 + row * 4), model(row, column));
+        }
+
+        // WHEN
+        modelMatrix.m_rowMajor = true;
+        blockData = standardUniformData.data() + secondOffset;
+        QVERIFY(Qt3DRender::Render::writeStandardUniform(blockData, blockSize, modelMatrix, Qt3DRender::Render::UniformValue(model)));
+
+        // THEN
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column)
+                QCOMPARE(floatAt(secondOffset + 64 + row * 16 + column * 4), model(row, column));
+        }
+
+        // WHEN
+        const QByteArray before = standardUniformData;
+        blockData = standardUniformData.data() + firstOffset;
+        Qt3DRender::Render::ShaderUniform vectorModelMatrix = modelMatrix;
+        vectorModelMatrix.m_type = GL_FLOAT_VEC4;
+        vectorModelMatrix.m_matrixStride = 0;
+        vectorModelMatrix.m_rawByteSize = 16;
+
+        // THEN
+        // Arrays, mismatching types and members outside of the block are rejected
+        QVERIFY(!Qt3DRender::Render::writeStandardUniform(blockData, blockSize, weights, Qt3DRender::Render::UniformValue(1.0f)));
+        QVERIFY(!Qt3DRender::Render::writeStandardUniform(blockData, blockSize, vectorModelMatrix, Qt3DRender::Render::UniformValue(model)));
+        QVERIFY(!Qt3DRender::Render::writeStandardUniform(blockData, blockSize, modelMatrix, Qt3DRender::Render::UniformValue(normal)));
+        QVERIFY(!Qt3DRender::Render::writeStandardUniform(blockData, 100, modelMatrix, Qt3DRender::Render::UniformValue(model)));
+        QCOMPARE(standardUniformData, before);
+        for (int offset = 128; offset < blockSize; offset += 4)
+            QCOMPARE(floatAt(offset), 0.0f);
+    }
+
     void checkRenderViewDoesNotLeak()
     {
         QSKIP("Allocated Disabled");
@@ -31,6 +31,7 @@
 #include <Qt3DCore/qdynamicpropertyupdatedchange.h>
 #include <Qt3DRender/private/renderviewjobutils_p.h>
 #include <Qt3DRender/private/shaderdata_p.h>
+#include <Qt3DRender/private/shaderdatalayout_p.h>
 #include <Qt3DRender/private/managers_p.h>
 #include <Qt3DRender/private/stringtoint_p.h>
 #include <Qt3DRender/qshaderdata.h>
@@ -49,6 +50,9 @@ private Q_SLOTS:
     void topLevelDynamicProperties();
     void transformedProperties();
     void shouldNotifyDynamicPropertyChanges();
+    void compiledStructLayout_data();
+    void compiledStructLayout();
+    void compiledLayoutBecomesStale();
 
 private:
     void initBackendShaderData(Qt3DRender::QShaderData *frontend,
@@ -560,6 +564,80 @@ void tst_RenderViewUtils::shouldNotifyDynamicPropertyChanges()
     QCOMPARE(change->value().toFloat(), 883.0f);
 }
 
+void tst_RenderViewUtils::compiledStructLayout_data()
+{
+    topLevelStructValue_data();
+}
+
+void tst_RenderViewUtils::compiledStructLayout()
+{
+    // GIVEN
+    QFETCH(StructShaderData *, shaderData);
+    QFETCH(QString, blockName);
+    QScopedPointer<Qt3DRender::Render::ShaderDataManager> manager(new Qt3DRender::Render::ShaderDataManager());
+
+    // WHEN
+    initBackendShaderData(shaderData, manager.data());
+
+    // THEN
+    Qt3DRender::Render::ShaderData *backendShaderData = manager->lookupResource(shaderData->id());
+    QVERIFY(backendShaderData != nullptr);
+
+    // WHEN
+    const QHash<QString, Qt3DRender::Render::ShaderUniform> uniforms = shaderData->buildUniformMap(blockName);
+    const QHash<QString, QVariant> expectedValues = shaderData->buildUniformMapValues(blockName);
+    const Qt3DRender::Render::ShaderDataLayout layout =
+            Qt3DRender::Render::ShaderDataLayout::compile(manager.data(), backendShaderData, blockName, uniforms);
+
+    // THEN
+    QVERIFY(layout.isUpToDate(manager.data()));
+
+    QCOMPARE(layout.memberCount(), uniforms.count());
+
+    // WHEN
+    const QVector<QVariant> values = layout.values(manager.data(), QMatrix4x4());
+
+    // THEN
+    QCOMPARE(values.size(), layout.memberCount());
+    int valueIndex = 0;
+    for (const Qt3DRender::Render::ShaderDataLayout::Node &node : layout.nodes()) {
+        Qt3DRender::Render::ShaderData *nodeData = manager->lookupResource(node.shaderDataId);
+        QVERIFY(nodeData != nullptr);
+        for (const Qt3DRender::Render::ShaderDataLayout::Member &member : node.members) {
+            const QString uniformName = Qt3DRender::Render::StringToInt::lookupString(member.uniform.m_nameId);
+            QVERIFY(uniforms.contains(uniformName));
+            QVERIFY(!member.transformed);
+            QCOMPARE(values.at(valueIndex++), expectedValues.value(uniformName));
+        }
+    }
+}
+
+void tst_RenderViewUtils::compiledLayoutBecomesStale()
+{
+    // GIVEN
+    QScopedPointer<StructShaderData> shaderData(new StructShaderData());
+    QScopedPointer<Qt3DRender::Render::ShaderDataManager> manager(new Qt3DRender::Render::ShaderDataManager());
+    initBackendShaderData(shaderData.data(), manager.data());
+    Qt3DRender::Render::ShaderData *backendShaderData = manager->lookupResource(shaderData->id());
+    QVERIFY(backendShaderData != nullptr);
+
+    // WHEN
+    const Qt3DRender::Render::ShaderDataLayout layout =
+            Qt3DRender::Render::ShaderDataLayout::compile(manager.data(), backendShaderData,
+                                                          QStringLiteral("Block"),
+                                                          shaderData->buildUniformMap(QStringLiteral("Block")));
+
+    // THEN
+    QVERIFY(!layout.isEmpty());
+    QVERIFY(layout.isUpToDate(manager.data()));
+
+    // WHEN
+    manager->releaseResource(shaderData->id());
+
+    // THEN
+    QVERIFY(!layout.isUpToDate(manager.data()));
+}
+
 QTEST_MAIN(tst_RenderViewUtils)
 
 #include "tst_renderviewutils.moc"
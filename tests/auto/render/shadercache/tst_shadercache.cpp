@@ -32,6 +32,9 @@
 #include <QtGui/qopenglshaderprogram.h>
 #include <QtCore/qobject.h>
 #include <QtCore/qpointer.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qtemporarydir.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -50,6 +53,11 @@ private Q_SLOTS:
     void removeRef();
     void purge();
     void destruction();
+    void programBinaryKey();
+    void storeProgramBinary();
+    void programBinaryDriverMismatch();
+    void removeCorruptProgramBinary();
+    void removeProgramBinary();
 };
 
 void tst_ShaderCache::insert()
@@ -243,6 +251,135 @@ void tst_ShaderCache::destruction()
     QCOMPARE(progPointerB.isNull(), true);
 }
 
+void tst_ShaderCache::programBinaryKey()
+{
+    // GIVEN
+    const QVector<QByteArray> code = { QByteArrayLiteral("void main() {}"), QByteArrayLiteral("void main() { }") };
+    const QHash<QString, int> outputs = { { QStringLiteral("fragColor"), 0 } };
+
+    // THEN
+    const QByteArray key = ShaderCache::programBinaryKey(ProgramDNA(42), code, outputs);
+    QVERIFY(!key.isEmpty());
+    QCOMPARE(ShaderCache::programBinaryKey(ProgramDNA(42), code, outputs), key);
+    QVERIFY(ShaderCache::programBinaryKey(ProgramDNA(43), code, outputs) != key);
+    QVERIFY(ShaderCache::programBinaryKey(ProgramDNA(42), { code.first(), QByteArrayLiteral("void main() {  }") }, outputs) != key);
+    QVERIFY(ShaderCache::programBinaryKey(ProgramDNA(42), code, { { QStringLiteral("fragColor"), 1 } }) != key);
+}
+
+void tst_ShaderCache::storeProgramBinary()
+{
+    // GIVEN
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray key = QByteArrayLiteral("abcdef");
+    const QByteArray binary = QByteArrayLiteral("program binary");
+
+    {
+        ShaderCache cache;
+        uint format = 0;
+        QByteArray data;
+        QCOMPARE(cache.isDiskCacheLoaded(), false);
+
+        // WHEN
+        cache.loadDiskCache(dir.path(), QByteArrayLiteral("driver"));
+        cache.insertProgramBinary(key, 0x1234, binary);
+
+        // THEN
+        QCOMPARE(cache.isDiskCacheLoaded(), true);
+        QVERIFY(cache.programBinary(key, &format, &data));
+        QCOMPARE(format, 0x1234U);
+        QCOMPARE(data, binary);
+    }
+
+    // WHEN
+    ShaderCache cache;
+    cache.loadDiskCache(dir.path(), QByteArrayLiteral("driver"));
+
+    // THEN
+    uint format = 0;
+    QByteArray data;
+    QVERIFY(cache.programBinary(key, &format, &data));
+    QCOMPARE(format, 0x1234U);
+    QCOMPARE(data, binary);
+    QCOMPARE(cache.programBinary(QByteArrayLiteral("123456"), &format, &data), false);
+}
+
+void tst_ShaderCache::programBinaryDriverMismatch()
+{
+    // GIVEN
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray key = QByteArrayLiteral("abcdef");
+    {
+        ShaderCache cache;
+        cache.loadDiskCache(dir.path(), QByteArrayLiteral("driver"));
+        cache.insertProgramBinary(key, 0x1234, QByteArrayLiteral("program binary"));
+    }
+
+    // WHEN
+    ShaderCache cache;
+    cache.loadDiskCache(dir.path(), QByteArrayLiteral("updated driver"));
+
+    // THEN
+    uint format = 0;
+    QByteArray data;
+    QCOMPARE(cache.programBinary(key, &format, &data), false);
+}
+
+void tst_ShaderCache::removeCorruptProgramBinary()
+{
+    // GIVEN
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray key = QByteArrayLiteral("abcdef");
+    QString fileName;
+    {
+        ShaderCache cache;
+        cache.loadDiskCache(dir.path(), QByteArrayLiteral("driver"));
+        cache.insertProgramBinary(key, 0x1234, QByteArrayLiteral("program binary"));
+        fileName = cache.programBinaryFileName(key);
+    }
+    QVERIFY(QFile::exists(fileName));
+
+    // WHEN
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        file.seek(file.size() - 4);
+        file.write("xxxx");
+    }
+    ShaderCache cache;
+    cache.loadDiskCache(dir.path(), QByteArrayLiteral("driver"));
+
+    // THEN
+    uint format = 0;
+    QByteArray data;
+    QCOMPARE(cache.programBinary(key, &format, &data), false);
+    QCOMPARE(QFile::exists(fileName), false);
+}
+
+void tst_ShaderCache::removeProgramBinary()
+{
+    // GIVEN
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray key = QByteArrayLiteral("abcdef");
+    ShaderCache cache;
+    cache.loadDiskCache(dir.path(), QByteArrayLiteral("driver"));
+    cache.insertProgramBinary(key, 0x1234, QByteArrayLiteral("program binary"));
+    const QString fileName = cache.programBinaryFileName(key);
+    QVERIFY(QFile::exists(fileName));
+
+    // WHEN
+    cache.removeProgramBinary(key);
+
+    // THEN
+    uint format = 0;
+    QByteArray data;
+    QCOMPARE(cache.programBinary(key, &format, &data), false);
+    QCOMPARE(QFile::exists(fileName), false);
+}
+
 } // namespace Render
 } // namespace Qt3DRender
 
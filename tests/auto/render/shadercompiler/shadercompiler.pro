@@ -0,0 +1,11 @@
+TEMPLATE = app
+
+TARGET = tst_shadercompiler
+
+QT += core-private 3dcore 3dcore-private 3drender 3drender-private testlib
+
+CONFIG += testcase
+
+SOURCES += tst_shadercompiler.cpp
+
+include(../../core/common/common.pri)
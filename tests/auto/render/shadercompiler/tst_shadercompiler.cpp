@@ -0,0 +1,384 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QTest>
+#include <qbackendnodetester.h>
+#include <Qt3DRender/qshaderprogram.h>
+#include <Qt3DCore/qpropertyupdatedchange.h>
+#include <Qt3DRender/private/graphicscontext_p.h>
+#include <Qt3DRender/private/managers_p.h>
+#include <Qt3DRender/private/nodemanagers_p.h>
+#include <Qt3DRender/private/platformsurfacefilter_p.h>
+#include <Qt3DRender/private/rendercommand_p.h>
+#include <Qt3DRender/private/renderer_p.h>
+#include <Qt3DRender/private/renderqueue_p.h>
+#include <Qt3DRender/private/rendersettings_p.h>
+#include <Qt3DRender/private/renderview_p.h>
+#include <Qt3DRender/private/shader_p.h>
+#include <Qt3DRender/private/shadercompiler_p.h>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLShaderProgram>
+#include <QWindow>
+
+using namespace Qt3DRender::Render;
+
+namespace {
+
+const QByteArray vertexShaderCode = QByteArrayLiteral(
+            "attribute vec4 vertexPosition;\n"
+            "void main() { gl_Position = vertexPosition; }\n");
+
+const QByteArray fragmentShaderCode = QByteArrayLiteral(
+            "#ifdef GL_ES\n"
+            "precision mediump float;\n"
+            "#endif\n"
+            "void main() { gl_FragColor = vec4(1.0); }\n");
+
+ShaderCompiler::Request compileRequest(ProgramDNA dna, const QByteArray &vertexCode, const QByteArray &fragmentCode)
+{
+    ShaderCompiler::Request request;
+    request.dna = dna;
+    request.shaderCode.resize(Qt3DRender::QShaderProgram::Compute + 1);
+    request.shaderCode[Qt3DRender::QShaderProgram::Vertex] = vertexCode;
+    request.shaderCode[Qt3DRender::QShaderProgram::Fragment] = fragmentCode;
+    return request;
+}
+
+} // anonymous
+
+class tst_ShaderCompiler : public Qt3DCore::QBackendNodeTester
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void init()
+    {
+        m_window.reset(new QWindow);
+        m_window->setSurfaceType(QWindow::OpenGLSurface);
+        m_window->setGeometry(0, 0, 10, 10);
+        m_window->create();
+
+        m_glContext.reset(new QOpenGLContext);
+        m_initializationSuccessful = m_glContext->create();
+        if (!m_initializationSuccessful) {
+            qWarning() << "Failed to create OpenGL context";
+            return;
+        }
+
+        m_offscreenSurface.reset(new QOffscreenSurface);
+        m_offscreenSurface->setFormat(m_glContext->format());
+        m_offscreenSurface->create();
+    }
+
+    void cleanup()
+    {
+        m_offscreenSurface.reset();
+        m_glContext.reset();
+        m_window.reset();
+    }
+
+    void checkCompileProgram()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, no OpenGL context");
+
+        // GIVEN
+        QVERIFY(m_glContext->makeCurrent(m_window.data()));
+
+        {
+            // WHEN
+            const ShaderCompiler::Result result = ShaderCompiler::compileProgram(m_glContext.data(), compileRequest(883, vertexShaderCode, fragmentShaderCode));
+            QScopedPointer<QOpenGLShaderProgram> program(result.program);
+
+            // THEN
+            QCOMPARE(result.dna, ProgramDNA(883));
+            QVERIFY(program != nullptr);
+            QVERIFY(program->isLinked());
+            QCOMPARE(result.binaryRejected, false);
+            QVERIFY(result.binary.isEmpty());
+        }
+        {
+            // WHEN
+            const ShaderCompiler::Result result = ShaderCompiler::compileProgram(m_glContext.data(), compileRequest(884, vertexShaderCode, QByteArrayLiteral("not a shader")));
+
+            // THEN
+            QCOMPARE(result.dna, ProgramDNA(884));
+            QVERIFY(result.program == nullptr);
+        }
+
+        m_glContext->doneCurrent();
+    }
+
+    void checkAsynchronousCompilation()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, no OpenGL context");
+
+        // GIVEN
+        ShaderCompiler compiler;
+        QVERIFY(m_glContext->makeCurrent(m_window.data()));
+        if (!compiler.create(m_glContext.data(), m_offscreenSurface.data()))
+            QSKIP("No context sharing with the submission context");
+
+        // THEN
+        QVERIFY(compiler.isCreated());
+        QVERIFY(compiler.takeResults().isEmpty());
+
+        // WHEN
+        compiler.compile(compileRequest(883, vertexShaderCode, fragmentShaderCode));
+        compiler.compile(compileRequest(884, vertexShaderCode, QByteArrayLiteral("not a shader")));
+
+        QVector<ShaderCompiler::Result> results;
+        QTRY_COMPARE((results += compiler.takeResults()).size(), 2);
+
+        // THEN
+        const ShaderCompiler::Result &linked = results.at(0).dna == 883 ? results.at(0) : results.at(1);
+        const ShaderCompiler::Result &failed = results.at(0).dna == 883 ? results.at(1) : results.at(0);
+        QScopedPointer<QOpenGLShaderProgram> program(linked.program);
+        QCOMPARE(linked.dna, ProgramDNA(883));
+        QVERIFY(program != nullptr);
+        QVERIFY(program->isLinked());
+        // Handed back to the thread that created the compiler
+        QCOMPARE(program->thread(), QThread::currentThread());
+        QCOMPARE(failed.dna, ProgramDNA(884));
+        QVERIFY(failed.program == nullptr);
+
+        // WHEN
+        compiler.destroy();
+
+        // THEN
+        QVERIFY(!compiler.isCreated());
+    }
+
+    void checkPendingProgramsAreCollected()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, no OpenGL context");
+
+        // GIVEN
+        NodeManagers nodeManagers;
+        Renderer renderer(Qt3DRender::QRenderAspect::Synchronous);
+        renderer.setNodeManagers(&nodeManagers);
+        GraphicsContext ctx;
+        ctx.setRenderer(&renderer);
+        ctx.setOpenGLContext(m_glContext.data());
+        QVERIFY(ctx.beginDrawing(m_window.data()));
+        if (!ctx.startShaderCompiler(m_offscreenSurface.data()))
+            QSKIP("No context sharing with the submission context");
+
+        Qt3DRender::QShaderProgram shaderProgram;
+        shaderProgram.setVertexShaderCode(vertexShaderCode);
+        shaderProgram.setFragmentShaderCode(fragmentShaderCode);
+        Shader *shader = nodeManagers.shaderManager()->getOrCreateResource(shaderProgram.id());
+        simulateInitialization(&shaderProgram, shader);
+
+        // WHEN
+        ctx.loadShader(shader);
+        ctx.loadShader(shader);
+
+        // THEN
+        // The Shader stays unloaded until its program is collected
+        QVERIFY(!shader->isLoaded());
+        QVERIFY(!ctx.isShaderProgramReady(shader->dna()));
+
+        // WHEN
+        QTRY_VERIFY((ctx.collectCompiledShaders(), ctx.isShaderProgramReady(shader->dna())));
+
+        // THEN
+        QVERIFY(shader->isLoaded());
+        QVERIFY(shader->attributesNames().contains(QStringLiteral("vertexPosition")));
+
+        // WHEN
+        ctx.activateShader(shader->dna());
+
+        // THEN
+        QVERIFY(ctx.activeShader() != nullptr);
+        QVERIFY(ctx.activeShader()->isLinked());
+
+        ctx.endDrawing(false);
+    }
+
+    void checkFrameIsRenderedAgainWhileProgramIsPending()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, no OpenGL context");
+
+        // GIVEN
+        NodeManagers nodeManagers;
+        RenderSettings settings;
+        Renderer renderer(Qt3DRender::QRenderAspect::Synchronous);
+        renderer.setNodeManagers(&nodeManagers);
+        renderer.setSettings(&settings);
+        renderer.setOpenGLContext(m_glContext.data());
+        renderer.initialize();
+
+        PlatformSurfaceFilter surfaceFilter;
+        surfaceFilter.setSurface(m_window.data());
+
+        Qt3DRender::QShaderProgram shaderProgram;
+        shaderProgram.setComputeShaderCode(QByteArrayLiteral("void main() {}\n"));
+        Shader *shader = nodeManagers.shaderManager()->getOrCreateResource(shaderProgram.id());
+        simulateInitialization(&shaderProgram, shader);
+
+        {
+            // WHEN
+            RenderCommand *command = new RenderCommand;
+            command->m_type = RenderCommand::Compute;
+            command->m_shader = nodeManagers.shaderManager()->lookupHandle(shaderProgram.id());
+            command->m_shaderDna = shader->dna();
+            QVector<RenderCommand *> commands;
+            commands.push_back(command);
+
+            QScopedPointer<RenderView> renderView(new RenderView);
+            renderView->setSurface(m_window.data());
+            renderView->setSurfaceSize(m_window->size());
+            renderView->setCommands(commands);
+
+            RenderQueue renderQueue;
+            renderQueue.setTargetRenderViewCount(1);
+            renderQueue.queueRenderView(renderView.data(), 0);
+            QVERIFY(renderer.prepareFrame(&renderQueue, true));
+            renderer.submitRenderViews(renderQueue.nextFrameQueue());
+
+            // THEN
+            // The program was never loaded, the command couldn't be issued
+            QVERIFY(!shader->isLoaded());
+            QCOMPARE(renderer.shouldRender(), true);
+        }
+        {
+            // WHEN
+            QScopedPointer<RenderView> renderView(new RenderView);
+            renderView->setSurface(m_window.data());
+            renderView->setSurfaceSize(m_window->size());
+
+            RenderQueue renderQueue;
+            renderQueue.setTargetRenderViewCount(1);
+            renderQueue.queueRenderView(renderView.data(), 0);
+            QVERIFY(renderer.prepareFrame(&renderQueue, true));
+            renderer.submitRenderViews(renderQueue.nextFrameQueue());
+
+            // THEN
+            QCOMPARE(renderer.shouldRender(), false);
+        }
+
+        renderer.shutdown();
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    }
+
+    void checkFrameIsNotRenderedAgainForProgramFailingToLink()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, no OpenGL context");
+
+        // GIVEN
+        NodeManagers nodeManagers;
+        RenderSettings settings;
+        Renderer renderer(Qt3DRender::QRenderAspect::Synchronous);
+        renderer.setNodeManagers(&nodeManagers);
+        renderer.setSettings(&settings);
+
+        Qt3DRender::QShaderProgram shaderProgram;
+        shaderProgram.setComputeShaderCode(QByteArrayLiteral("not a shader"));
+        Shader *shader = nodeManagers.shaderManager()->getOrCreateResource(shaderProgram.id());
+        shader->setRenderer(&renderer);
+        simulateInitialization(&shaderProgram, shader);
+
+        {
+            // WHEN
+            GraphicsContext ctx;
+            ctx.setRenderer(&renderer);
+            ctx.setOpenGLContext(m_glContext.data());
+            QVERIFY(ctx.beginDrawing(m_window.data()));
+            ctx.loadShader(shader);
+            ctx.endDrawing(false);
+
+            // THEN
+            QVERIFY(!shader->isLoaded());
+            QVERIFY(shader->hasLinkFailed());
+            QVERIFY(!ctx.isShaderProgramReady(shader->dna()));
+        }
+
+        renderer.setOpenGLContext(m_glContext.data());
+        renderer.initialize();
+
+        PlatformSurfaceFilter surfaceFilter;
+        surfaceFilter.setSurface(m_window.data());
+
+        {
+            // WHEN
+            RenderCommand *command = new RenderCommand;
+            command->m_type = RenderCommand::Compute;
+            command->m_shader = nodeManagers.shaderManager()->lookupHandle(shaderProgram.id());
+            command->m_shaderDna = shader->dna();
+            QVector<RenderCommand *> commands;
+            commands.push_back(command);
+
+            QScopedPointer<RenderView> renderView(new RenderView);
+            renderView->setSurface(m_window.data());
+            renderView->setSurfaceSize(m_window->size());
+            renderView->setCommands(commands);
+
+            RenderQueue renderQueue;
+            renderQueue.setTargetRenderViewCount(1);
+            renderQueue.queueRenderView(renderView.data(), 0);
+            QVERIFY(renderer.prepareFrame(&renderQueue, true));
+            renderer.submitRenderViews(renderQueue.nextFrameQueue());
+
+            // THEN
+            // The command is never going to be issued, the frame is correct
+            QCOMPARE(renderer.shouldRender(), false);
+        }
+        {
+            // WHEN
+            Qt3DCore::QPropertyUpdatedChangePtr change(new Qt3DCore::QPropertyUpdatedChange(shaderProgram.id()));
+            change->setPropertyName("computeShaderCode");
+            change->setValue(QByteArrayLiteral("void main() {}\n"));
+            shader->sceneChangeEvent(change);
+
+            // THEN
+            QVERIFY(!shader->hasLinkFailed());
+            QVERIFY(shader->log().isEmpty());
+        }
+
+        renderer.shutdown();
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    }
+
+private:
+    QScopedPointer<QWindow> m_window;
+    QScopedPointer<QOpenGLContext> m_glContext;
+    QScopedPointer<QOffscreenSurface> m_offscreenSurface;
+    bool m_initializationSuccessful = false;
+};
+
+QTEST_MAIN(tst_ShaderCompiler)
+
+#include "tst_shadercompiler.moc"
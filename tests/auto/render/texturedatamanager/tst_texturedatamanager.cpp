@@ -0,0 +1,158 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QTest>
+#include <Qt3DRender/qtextureimagedata.h>
+#include <Qt3DRender/private/texturedatamanager_p.h>
+
+namespace {
+
+Qt3DRender::QTextureImageData createImageData(char fill, int width = 4)
+{
+    Qt3DRender::QTextureImageData data;
+    data.setWidth(width);
+    data.setHeight(1);
+    data.setData(QByteArray(width * 4, fill), 4);
+    return data;
+}
+
+QOpenGLTexture *fakeGLTexture(quintptr value)
+{
+    // Never dereferenced by the manager
+    return reinterpret_cast<QOpenGLTexture *>(value);
+}
+
+} // anonymous
+
+class tst_TextureDataManager : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void checkDataSharedByContent()
+    {
+        // GIVEN
+        Qt3DRender::Render::TextureDataManager manager;
+        bool shared = true;
+
+        // WHEN
+        const Qt3DRender::Render::HTextureData a = manager.addTextureData(createImageData('a'), &shared);
+
+        // THEN
+        QVERIFY(!a.isNull());
+        QVERIFY(!shared);
+
+        // WHEN
+        const Qt3DRender::Render::HTextureData b = manager.addTextureData(createImageData('a'), &shared);
+
+        // THEN
+        QCOMPARE(b, a);
+        QVERIFY(shared);
+        QCOMPARE(manager.sharingStatistics().sharedTextureDataCount, 1);
+        QCOMPARE(manager.sharingStatistics().textureDataBytesSaved, qint64(16));
+
+        // WHEN
+        const Qt3DRender::Render::HTextureData c = manager.addTextureData(createImageData('c'), &shared);
+        const Qt3DRender::Render::HTextureData d = manager.addTextureData(createImageData('a', 8), &shared);
+
+        // THEN
+        QVERIFY(c != a);
+        QVERIFY(d != a);
+        QVERIFY(!shared);
+        QCOMPARE(manager.sharingStatistics().sharedTextureDataCount, 1);
+    }
+
+    void checkDataReleasedWithLastReference()
+    {
+        // GIVEN
+        Qt3DRender::Render::TextureDataManager manager;
+        const Qt3DRender::Render::HTextureData a = manager.addTextureData(createImageData('a'));
+        const Qt3DRender::Render::HTextureData b = manager.addTextureData(createImageData('a'));
+
+        // WHEN
+        manager.releaseTextureData(a);
+
+        // THEN
+        QVERIFY(manager.data(b) != nullptr);
+        QCOMPARE(manager.data(b)->width(), 4);
+        QCOMPARE(manager.sharingStatistics().sharedTextureDataCount, 0);
+
+        // WHEN
+        manager.releaseTextureData(b);
+
+        // THEN
+        QVERIFY(manager.data(b) == nullptr);
+
+        // WHEN
+        bool shared = true;
+        const Qt3DRender::Render::HTextureData c = manager.addTextureData(createImageData('a'), &shared);
+
+        // THEN
+        QVERIFY(!c.isNull());
+        QVERIFY(!shared);
+    }
+
+    void checkGLTextureSharing()
+    {
+        // GIVEN
+        Qt3DRender::Render::TextureDataManager manager;
+        const QVector<quint32> key = QVector<quint32>() << 1 << 64 << 64;
+        const QVector<quint32> otherKey = QVector<quint32>() << 1 << 64 << 32;
+        QOpenGLTexture *glTexture = fakeGLTexture(0x10);
+
+        // THEN
+        QVERIFY(manager.acquireSharedGLTexture(key) == nullptr);
+
+        // WHEN
+        manager.addSharedGLTexture(key, glTexture, 1024);
+
+        // THEN
+        QVERIFY(manager.acquireSharedGLTexture(otherKey) == nullptr);
+        QCOMPARE(manager.acquireSharedGLTexture(key), glTexture);
+        QCOMPARE(manager.acquireSharedGLTexture(key), glTexture);
+        QCOMPARE(manager.sharingStatistics().sharedGLTextureCount, 1);
+        QCOMPARE(manager.sharingStatistics().glTextureBytesSaved, qint64(2048));
+
+        // WHEN
+        const bool firstReleaseOwns = manager.releaseSharedGLTexture(glTexture);
+        const bool secondReleaseOwns = manager.releaseSharedGLTexture(glTexture);
+        const bool lastReleaseOwns = manager.releaseSharedGLTexture(glTexture);
+
+        // THEN
+        QVERIFY(!firstReleaseOwns);
+        QVERIFY(!secondReleaseOwns);
+        QVERIFY(lastReleaseOwns);
+        QVERIFY(manager.acquireSharedGLTexture(key) == nullptr);
+        QCOMPARE(manager.sharingStatistics().sharedGLTextureCount, 0);
+    }
+};
+
+QTEST_MAIN(tst_TextureDataManager)
+
+#include "tst_texturedatamanager.moc"
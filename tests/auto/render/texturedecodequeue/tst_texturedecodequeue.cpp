@@ -0,0 +1,308 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QTest>
+#include <Qt3DRender/qtextureimagedata.h>
+#include <Qt3DRender/qtextureimagedatagenerator.h>
+#include <Qt3DRender/qtexturedata.h>
+#include <Qt3DRender/qtexturegenerator.h>
+#include <Qt3DRender/private/texturedatamanager_p.h>
+#include <Qt3DRender/private/texturedecodequeue_p.h>
+#include <QMutex>
+#include <QSemaphore>
+
+namespace {
+
+QMutex decodeOrderMutex;
+QStringList decodeOrder;
+
+class TestImageGenerator : public Qt3DRender::QTextureImageDataGenerator
+{
+public:
+    explicit TestImageGenerator(const QString &name, int size = 16,
+                                QSemaphore *gate = nullptr)
+        : m_name(name)
+        , m_size(size)
+        , m_gate(gate)
+    {}
+
+    Qt3DRender::QTextureImageDataPtr operator ()() Q_DECL_OVERRIDE
+    {
+        if (m_gate)
+            m_gate->acquire();
+        {
+            QMutexLocker lock(&decodeOrderMutex);
+            decodeOrder.push_back(m_name);
+        }
+        if (m_size == 0)
+            return Qt3DRender::QTextureImageDataPtr();
+
+        Qt3DRender::QTextureImageDataPtr data = Qt3DRender::QTextureImageDataPtr::create();
+        data->setWidth(m_size / 4);
+        data->setHeight(1);
+        data->setData(QByteArray(m_size, 'x'), 4);
+        return data;
+    }
+
+    bool operator ==(const Qt3DRender::QTextureImageDataGenerator &other) const Q_DECL_OVERRIDE
+    {
+        const TestImageGenerator *otherFunctor = Qt3DRender::functor_cast<TestImageGenerator>(&other);
+        return otherFunctor != nullptr && otherFunctor->m_name == m_name;
+    }
+
+    QT3D_FUNCTOR(TestImageGenerator)
+
+private:
+    QString m_name;
+    int m_size;
+    QSemaphore *m_gate;
+};
+
+class TestTextureGenerator : public Qt3DRender::QTextureGenerator
+{
+public:
+    explicit TestTextureGenerator(const QString &name, int size = 16)
+        : m_name(name)
+        , m_size(size)
+    {}
+
+    Qt3DRender::QTextureDataPtr operator ()() Q_DECL_OVERRIDE
+    {
+        {
+            QMutexLocker lock(&decodeOrderMutex);
+            decodeOrder.push_back(m_name);
+        }
+        Qt3DRender::QTextureImageDataPtr imageData = Qt3DRender::QTextureImageDataPtr::create();
+        imageData->setWidth(m_size / 4);
+        imageData->setHeight(1);
+        imageData->setData(QByteArray(m_size, 'x'), 4);
+        Qt3DRender::QTextureDataPtr data = Qt3DRender::QTextureDataPtr::create();
+        data->addImageData(imageData);
+        return data;
+    }
+
+    bool operator ==(const Qt3DRender::QTextureGenerator &other) const Q_DECL_OVERRIDE
+    {
+        const TestTextureGenerator *otherFunctor = Qt3DRender::functor_cast<TestTextureGenerator>(&other);
+        return otherFunctor != nullptr && otherFunctor->m_name == m_name;
+    }
+
+    QT3D_FUNCTOR(TestTextureGenerator)
+
+private:
+    QString m_name;
+    int m_size;
+};
+
+} // anonymous
+
+class tst_TextureDecodeQueue : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void init()
+    {
+        decodeOrder.clear();
+    }
+
+    void checkDecodesInBackground()
+    {
+        // GIVEN
+        Qt3DRender::Render::TextureDataManager manager;
+        Qt3DRender::Render::TextureDecodeQueue *queue = manager.decodeQueue();
+        const Qt3DCore::QNodeId textureId = Qt3DCore::QNodeId::createId();
+        const Qt3DRender::QTextureImageDataGeneratorPtr generator(new TestImageGenerator(QStringLiteral("a"), 64));
+
+        // WHEN
+        QVERIFY(queue->enqueue(generator, textureId));
+        queue->waitForDone();
+
+        // THEN
+        const Qt3DRender::Render::HTextureData handle = manager.textureDataFromFunctor(generator);
+        QVERIFY(!handle.isNull());
+        QCOMPARE(manager.data(handle)->data().size(), 64);
+        QVERIFY(queue->hasDecodedTextures());
+        QCOMPARE(queue->takeDecodedTextures(), QVector<Qt3DCore::QNodeId>() << textureId);
+        QVERIFY(!queue->hasDecodedTextures());
+        QCOMPARE(queue->residentBytes(), qint64(64));
+        QVERIFY(!queue->hasPendingRequests());
+
+        // WHEN
+        queue->releasePendingUpload(handle);
+
+        // THEN
+        QCOMPARE(queue->residentBytes(), qint64(0));
+        QVERIFY(queue->takeDecodedTextures().isEmpty());
+    }
+
+    void checkDeduplicatesGenerators()
+    {
+        // GIVEN
+        Qt3DRender::Render::TextureDataManager manager;
+        Qt3DRender::Render::TextureDecodeQueue *queue = manager.decodeQueue();
+        QSemaphore gate;
+        const Qt3DCore::QNodeId textureId1 = Qt3DCore::QNodeId::createId();
+        const Qt3DCore::QNodeId textureId2 = Qt3DCore::QNodeId::createId();
+
+        // WHEN
+        queue->enqueue(Qt3DRender::QTextureImageDataGeneratorPtr(new TestImageGenerator(QStringLiteral("a"), 16, &gate)), textureId1);
+        queue->enqueue(Qt3DRender::QTextureImageDataGeneratorPtr(new TestImageGenerator(QStringLiteral("a"), 16, &gate)), textureId2);
+        gate.release(2);
+        queue->waitForDone();
+
+        // THEN
+        QCOMPARE(decodeOrder, QStringList() << QStringLiteral("a"));
+        const QVector<Qt3DCore::QNodeId> decoded = queue->takeDecodedTextures();
+        QCOMPARE(decoded.size(), 2);
+        QVERIFY(decoded.contains(textureId1));
+        QVERIFY(decoded.contains(textureId2));
+    }
+
+    void checkServesHighestPriorityFirst()
+    {
+        // GIVEN
+        Qt3DRender::Render::TextureDataManager manager;
+        Qt3DRender::Render::TextureDecodeQueue *queue = manager.decodeQueue();
+        queue->setMaxThreadCount(1);
+        QSemaphore gate;
+        const Qt3DCore::QNodeId textureId1 = Qt3DCore::QNodeId::createId();
+        const Qt3DCore::QNodeId textureId2 = Qt3DCore::QNodeId::createId();
+        const Qt3DCore::QNodeId textureId3 = Qt3DCore::QNodeId::createId();
+        const Qt3DCore::QNodeId textureId4 = Qt3DCore::QNodeId::createId();
+
+        // WHEN
+        // The first request keeps the only decoding thread busy
+        queue->enqueue(Qt3DRender::QTextureImageDataGeneratorPtr(new TestImageGenerator(QStringLiteral("blocking"), 16, &gate)), textureId1);
+        queue->enqueue(Qt3DRender::QTextureImageDataGeneratorPtr(new TestImageGenerator(QStringLiteral("unseen"))), textureId2);
+        queue->enqueue(Qt3DRender::QTextureImageDataGeneratorPtr(new TestImageGenerator(QStringLiteral("far"))), textureId3);
+        queue->enqueue(Qt3DRender::QTextureImageDataGeneratorPtr(new TestImageGenerator(QStringLiteral("near"))), textureId4);
+        queue->setTexturePriority(textureId3, 100.0f);
+        queue->setTexturePriority(textureId4, 50.0f);
+        queue->setTexturePriority(textureId4, 10.0f);
+        QVERIFY(queue->hasPendingRequests());
+        gate.release();
+        queue->waitForDone();
+
+        // THEN
+        QCOMPARE(decodeOrder, QStringList() << QStringLiteral("blocking")
+                                            << QStringLiteral("near")
+                                            << QStringLiteral("far")
+                                            << QStringLiteral("unseen"));
+    }
+
+    void checkRespectsMemoryBudget()
+    {
+        // GIVEN
+        Qt3DRender::Render::TextureDataManager manager;
+        Qt3DRender::Render::TextureDecodeQueue *queue = manager.decodeQueue();
+        queue->setMaxThreadCount(1);
+        queue->setMemoryBudget(32);
+        const Qt3DRender::QTextureImageDataGeneratorPtr generator1(new TestImageGenerator(QStringLiteral("a"), 64));
+        const Qt3DRender::QTextureImageDataGeneratorPtr generator2(new TestImageGenerator(QStringLiteral("b"), 64));
+
+        // WHEN
+        queue->enqueue(generator1, Qt3DCore::QNodeId::createId());
+        queue->enqueue(generator2, Qt3DCore::QNodeId::createId());
+        queue->waitForDone();
+
+        // THEN
+        QCOMPARE(decodeOrder, QStringList() << QStringLiteral("a"));
+        QCOMPARE(queue->residentBytes(), qint64(64));
+        QVERIFY(queue->hasPendingRequests());
+
+        // WHEN
+        queue->releasePendingUpload(manager.textureDataFromFunctor(generator1));
+        queue->waitForDone();
+
+        // THEN
+        QCOMPARE(decodeOrder, QStringList() << QStringLiteral("a") << QStringLiteral("b"));
+        QVERIFY(!queue->hasPendingRequests());
+    }
+
+    void checkDropsDataOfRemovedTextures()
+    {
+        // GIVEN
+        Qt3DRender::Render::TextureDataManager manager;
+        Qt3DRender::Render::TextureDecodeQueue *queue = manager.decodeQueue();
+        queue->setMaxThreadCount(1);
+        queue->setMemoryBudget(32);
+        const Qt3DRender::QTextureGeneratorPtr generator1(new TestTextureGenerator(QStringLiteral("a"), 64));
+        const Qt3DRender::QTextureGeneratorPtr generator2(new TestTextureGenerator(QStringLiteral("b"), 64));
+        const Qt3DCore::QNodeId textureId1 = Qt3DCore::QNodeId::createId();
+        const Qt3DCore::QNodeId textureId2 = Qt3DCore::QNodeId::createId();
+
+        // WHEN
+        queue->enqueue(generator1, textureId1);
+        queue->enqueue(generator2, textureId2);
+        queue->waitForDone();
+
+        // THEN
+        // a blocks the decoding of b until its data is taken
+        QCOMPARE(decodeOrder, QStringList() << QStringLiteral("a"));
+        QCOMPARE(queue->residentBytes(), qint64(64));
+        QVERIFY(queue->hasPendingRequests());
+
+        // WHEN
+        // the texture of a is destroyed before its data was taken
+        queue->removeTexture(textureId1);
+        queue->waitForDone();
+
+        // THEN
+        QCOMPARE(decodeOrder, QStringList() << QStringLiteral("a") << QStringLiteral("b"));
+        QVERIFY(!queue->hasPendingRequests());
+        Qt3DRender::QTextureDataPtr data;
+        QVERIFY(!queue->takeTextureData(textureId1, generator1, &data));
+        QVERIFY(queue->takeTextureData(textureId2, generator2, &data));
+        QVERIFY(!data.isNull());
+        QCOMPARE(queue->residentBytes(), qint64(0));
+    }
+
+    void checkRemembersFailedGenerators()
+    {
+        // GIVEN
+        Qt3DRender::Render::TextureDataManager manager;
+        Qt3DRender::Render::TextureDecodeQueue *queue = manager.decodeQueue();
+        const Qt3DRender::QTextureImageDataGeneratorPtr generator(new TestImageGenerator(QStringLiteral("broken"), 0));
+        const Qt3DCore::QNodeId textureId = Qt3DCore::QNodeId::createId();
+
+        // WHEN
+        QVERIFY(queue->enqueue(generator, textureId));
+        queue->waitForDone();
+
+        // THEN
+        QVERIFY(manager.textureDataFromFunctor(generator).isNull());
+        QCOMPARE(queue->takeDecodedTextures(), QVector<Qt3DCore::QNodeId>() << textureId);
+        QVERIFY(!queue->enqueue(generator, textureId));
+    }
+};
+
+QTEST_MAIN(tst_TextureDecodeQueue)
+
+#include "tst_texturedecodequeue.moc"
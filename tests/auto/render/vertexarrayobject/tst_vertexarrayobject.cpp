@@ -0,0 +1,140 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QTest>
+#include <Qt3DRender/private/graphicscontext_p.h>
+#include <Qt3DRender/private/openglvertexarrayobject_p.h>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QOpenGLVertexArrayObject>
+#include <QWindow>
+
+#ifndef GL_VERTEX_ARRAY_BINDING
+#define GL_VERTEX_ARRAY_BINDING 0x85B5
+#endif
+
+using namespace Qt3DRender::Render;
+
+class tst_VertexArrayObject : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void init()
+    {
+        m_window.reset(new QWindow);
+        m_window->setSurfaceType(QWindow::OpenGLSurface);
+        m_window->setGeometry(0, 0, 10, 10);
+        m_window->create();
+
+        m_glContext.reset(new QOpenGLContext);
+        m_initializationSuccessful = m_glContext->create();
+        if (!m_initializationSuccessful)
+            qWarning() << "Failed to create OpenGL context";
+    }
+
+    void cleanup()
+    {
+        m_glContext.reset();
+        m_window.reset();
+    }
+
+    void checkBindElision()
+    {
+        if (!m_initializationSuccessful)
+            QSKIP("Initialization failed, no OpenGL context");
+
+        // GIVEN
+        GraphicsContext ctx;
+        ctx.setOpenGLContext(m_glContext.data());
+        QVERIFY(ctx.beginDrawing(m_window.data()));
+        if (!ctx.supportsVAO())
+            QSKIP("VAOs not supported");
+
+        OpenGLVertexArrayObject vaoA;
+        OpenGLVertexArrayObject vaoB;
+        for (OpenGLVertexArrayObject *vao : { &vaoA, &vaoB }) {
+            vao->setGraphicsContext(&ctx);
+            vao->setVao(new QOpenGLVertexArrayObject);
+            vao->create();
+        }
+        ctx.resetStateChangeCounters();
+
+        // WHEN
+        vaoA.bind();
+        vaoA.bind();
+
+        // THEN
+        QCOMPARE(ctx.issuedStateChanges(GraphicsContext::VertexArrayStateChange), 1);
+        QCOMPARE(ctx.skippedStateChanges(GraphicsContext::VertexArrayStateChange), 1);
+        QCOMPARE(boundVertexArray(), vaoA.vao()->objectId());
+
+        // WHEN
+        vaoB.bind();
+
+        // THEN
+        QCOMPARE(ctx.issuedStateChanges(GraphicsContext::VertexArrayStateChange), 2);
+        QCOMPARE(boundVertexArray(), vaoB.vao()->objectId());
+
+        // WHEN releasing a VAO which isn't the bound one
+        vaoA.release();
+        vaoB.bind();
+
+        // THEN the release unbound vaoB, which has to be bound again
+        QCOMPARE(ctx.issuedStateChanges(GraphicsContext::VertexArrayStateChange), 3);
+        QCOMPARE(boundVertexArray(), vaoB.vao()->objectId());
+
+        // WHEN starting a new frame
+        QVERIFY(ctx.beginDrawing(m_window.data()));
+        vaoB.bind();
+
+        // THEN
+        QCOMPARE(ctx.issuedStateChanges(GraphicsContext::VertexArrayStateChange), 4);
+        QCOMPARE(boundVertexArray(), vaoB.vao()->objectId());
+
+        vaoB.release();
+        QCOMPARE(boundVertexArray(), GLuint(0));
+    }
+
+private:
+    GLuint boundVertexArray() const
+    {
+        GLint vao = 0;
+        m_glContext->functions()->glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vao);
+        return GLuint(vao);
+    }
+
+    QScopedPointer<QWindow> m_window;
+    QScopedPointer<QOpenGLContext> m_glContext;
+    bool m_initializationSuccessful = false;
+};
+
+QTEST_MAIN(tst_VertexArrayObject)
+
+#include "tst_vertexarrayobject.moc"
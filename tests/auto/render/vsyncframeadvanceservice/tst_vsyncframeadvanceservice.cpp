@@ -74,6 +74,109 @@ private Q_SLOTS:
         QVERIFY(t.elapsed() >= 950);
     }
 
+    void checkPacingDelay()
+    {
+        // GIVEN
+        typedef Qt3DRender::Render::VSyncFrameAdvanceService Service;
+        const qint64 msecs = 1000000;
+
+        // THEN nothing measured yet
+        QCOMPARE(Service::pacingDelay(0, 16 * msecs), qint64(0));
+        QCOMPARE(Service::pacingDelay(4 * msecs, 0), qint64(0));
+
+        // THEN aspect thread is the bottleneck
+        QCOMPARE(Service::pacingDelay(20 * msecs, 16 * msecs), qint64(0));
+        QCOMPARE(Service::pacingDelay(16 * msecs, 16 * msecs), qint64(0));
+
+        // THEN renderer is the bottleneck, keep a margin
+        QCOMPARE(Service::pacingDelay(4 * msecs, 16 * msecs), qint64(10 * msecs));
+        QCOMPARE(Service::pacingDelay(4 * msecs, 6 * msecs), qint64(1 * msecs));
+
+        // THEN delay is capped
+        QCOMPARE(Service::pacingDelay(1 * msecs, 200 * msecs), qint64(33 * msecs));
+    }
+
+    void checkPacingMeasurements()
+    {
+        // GIVEN
+        Qt3DRender::Render::VSyncFrameAdvanceService tickService;
+        tickService.setPacingEnabled(false);
+        tickService.start();
+
+        // THEN
+        QVERIFY(!tickService.isPacingEnabled());
+        QCOMPARE(tickService.framePacing().jobsDuration, qint64(0));
+        QCOMPARE(tickService.framePacing().submissionDuration, qint64(0));
+
+        // WHEN
+        tickService.proceedToNextFrame();
+        tickService.waitForNextFrame();
+        QThread::msleep(20); // Jobs
+        tickService.proceedToNextFrame();
+        QThread::msleep(40); // Submission
+        tickService.frameSubmitted();
+        tickService.waitForNextFrame();
+
+        // THEN
+        const Qt3DRender::Render::VSyncFrameAdvanceService::FramePacing pacing = tickService.framePacing();
+        QVERIFY(pacing.jobsDuration >= 15000000);
+        QVERIFY(pacing.submissionDuration >= 35000000);
+        QCOMPARE(pacing.delay, qint64(0));
+
+        // WHEN
+        tickService.frameSubmitted();
+
+        // THEN no release since the last submission, nothing recorded
+        QCOMPARE(tickService.framePacing().submissionDuration, pacing.submissionDuration);
+    }
+
+    void checkIdleTimeIsNotPartOfJobs()
+    {
+        // GIVEN
+        Qt3DRender::Render::VSyncFrameAdvanceService tickService;
+        tickService.setPacingEnabled(false);
+        tickService.start();
+        tickService.proceedToNextFrame();
+        tickService.waitForNextFrame();
+
+        // WHEN
+        QThread::msleep(100); // Idle
+        tickService.resume();
+        QThread::msleep(5); // Jobs
+        tickService.proceedToNextFrame();
+        tickService.waitForNextFrame();
+
+        // THEN
+        const Qt3DRender::Render::VSyncFrameAdvanceService::FramePacing pacing = tickService.framePacing();
+        QVERIFY(pacing.jobsDuration >= 4000000);
+        QVERIFY(pacing.jobsDuration < 100000000);
+    }
+
+    void checkPacingDelaysJobs()
+    {
+        // GIVEN
+        Qt3DRender::Render::VSyncFrameAdvanceService tickService;
+        tickService.setPacingEnabled(true);
+        tickService.start();
+        tickService.proceedToNextFrame();
+        QThread::msleep(30); // Submission
+        tickService.frameSubmitted();
+        tickService.waitForNextFrame();
+        QThread::msleep(2); // Jobs
+        tickService.proceedToNextFrame();
+        QElapsedTimer t;
+
+        // WHEN
+        t.start();
+        tickService.waitForNextFrame();
+
+        // THEN
+        const Qt3DRender::Render::VSyncFrameAdvanceService::FramePacing pacing = tickService.framePacing();
+        QVERIFY(pacing.delay > 0);
+        QCOMPARE(pacing.delay, Qt3DRender::Render::VSyncFrameAdvanceService::pacingDelay(pacing.jobsDuration,
+                                                                                          pacing.submissionDuration));
+        QVERIFY(t.nsecsElapsed() >= pacing.delay - 1000000);
+    }
 };
 
 QTEST_MAIN(tst_VSyncFrameAdvanceService)
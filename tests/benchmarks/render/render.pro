@@ -1,5 +1,7 @@
 TEMPLATE=subdirs
 
 qtConfig(private_tests) {
-    SUBDIRS += jobs
+    SUBDIRS += \
+        jobs \
+        stringtoint
 }
@@ -0,0 +1,6 @@
+TARGET = tst_bench_stringtoint
+CONFIG += release
+TEMPLATE = app
+QT += testlib concurrent 3dcore 3dcore-private 3drender 3drender-private
+
+SOURCES += tst_bench_stringtoint.cpp
@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 Klaralvdalens Datakonsult AB (KDAB).
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the Qt3D module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QFuture>
+
+#include <Qt3DRender/private/stringtoint_p.h>
+
+using namespace Qt3DRender::Render;
+
+namespace {
+
+const int NameCount = 1000;
+const int LookupsPerThread = 100000;
+
+QVector<QString> names(const QString &prefix, int count)
+{
+    QVector<QString> result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i)
+        result.push_back(prefix + QString::number(i));
+    return result;
+}
+
+// Returns the sum of the ids so that the lookups can't be optimized away
+int lookupNames(const QVector<QString> &names, int lookups, int offset)
+{
+    int sum = 0;
+    for (int i = 0; i < lookups; ++i)
+        sum += StringToInt::lookupId(names.at((i + offset) % names.size()));
+    return sum;
+}
+
+} // anonymous
+
+class tst_StringToInt : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void checkStandardNames();
+    void benchmarkLookupExisting();
+    void benchmarkLookupExistingLatin1();
+    void benchmarkContendedLookup_data();
+    void benchmarkContendedLookup();
+    void benchmarkContendedInsertion_data();
+    void benchmarkContendedInsertion();
+};
+
+void tst_StringToInt::checkStandardNames()
+{
+    QCOMPARE(StringToInt::lookupId(QLatin1String("modelMatrix")), int(StringToInt::ModelMatrixNameId));
+    QCOMPARE(StringToInt::lookupId(QStringLiteral("mvp")), int(StringToInt::MvpNameId));
+    QCOMPARE(StringToInt::lookupString(StringToInt::EyePositionNameId), QStringLiteral("eyePosition"));
+    QCOMPARE(StringToInt::lookupString(StringToInt::InstanceModelMatrixNameId), QStringLiteral("qt3d_InstanceModelMatrix"));
+}
+
+void tst_StringToInt::benchmarkLookupExisting()
+{
+    const QVector<QString> uniformNames = names(QStringLiteral("existing.uniform"), NameCount);
+    lookupNames(uniformNames, NameCount, 0);
+
+    int sum = 0;
+    QBENCHMARK {
+        sum += lookupNames(uniformNames, LookupsPerThread, 0);
+    }
+    QVERIFY(sum > 0);
+}
+
+void tst_StringToInt::benchmarkLookupExistingLatin1()
+{
+    const QVector<QString> uniformNames = names(QStringLiteral("existing.latin1"), NameCount);
+    QVector<QByteArray> latin1Names;
+    for (const QString &name : uniformNames)
+        latin1Names.push_back(name.toLatin1());
+    lookupNames(uniformNames, NameCount, 0);
+
+    int sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < LookupsPerThread; ++i) {
+            const QByteArray &name = latin1Names.at(i % NameCount);
+            sum += StringToInt::lookupId(QLatin1String(name.constData(), name.size()));
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+void tst_StringToInt::benchmarkContendedLookup_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("8 threads") << 8;
+}
+
+void tst_StringToInt::benchmarkContendedLookup()
+{
+    QFETCH(int, threadCount);
+
+    const QVector<QString> uniformNames = names(QStringLiteral("contended.uniform"), NameCount);
+    const int expectedSum = lookupNames(uniformNames, LookupsPerThread, 0);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+
+    QBENCHMARK {
+        QVector<QFuture<int>> futures;
+        for (int i = 0; i < threadCount; ++i)
+            futures.push_back(QtConcurrent::run(&pool, lookupNames, uniformNames, LookupsPerThread, 0));
+        for (QFuture<int> &future : futures)
+            QCOMPARE(future.result(), expectedSum);
+    }
+}
+
+void tst_StringToInt::benchmarkContendedInsertion_data()
+{
+    benchmarkContendedLookup_data();
+}
+
+void tst_StringToInt::benchmarkContendedInsertion()
+{
+    QFETCH(int, threadCount);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+    int run = 0;
+
+    QBENCHMARK {
+        // Every thread interns the same new names, in a different order
+        const QVector<QString> uniformNames = names(QStringLiteral("inserted%1.uniform").arg(run++), NameCount);
+        QVector<QFuture<int>> futures;
+        for (int i = 0; i < threadCount; ++i)
+            futures.push_back(QtConcurrent::run(&pool, lookupNames, uniformNames, NameCount, i * NameCount / threadCount));
+        for (QFuture<int> &future : futures)
+            future.waitForFinished();
+
+        for (int i = 0; i < NameCount; ++i)
+            QCOMPARE(StringToInt::lookupString(StringToInt::lookupId(uniformNames.at(i))), uniformNames.at(i));
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_StringToInt)
+
+#include "tst_bench_stringtoint.moc"
@@ -44,6 +44,7 @@
 #include <qjsonobject.h>
 #include <qjsonarray.h>
 #include <qmath.h>
+#include <qendian.h>
 
 #define GLT_UNSIGNED_SHORT 0x1403
 #define GLT_UNSIGNED_INT 0x1405
@@ -210,6 +211,7 @@ static inline QVector<float> ai2qt(const aiMatrix4x4 &matrix)
 struct Options {
     QString outDir;
     bool genBin;
+    bool genGlb;
     bool compact;
     bool compress;
     bool genTangents;
@@ -2284,7 +2286,21 @@ void GltfExporter::save(const QString &inputFilename)
     asset["premultipliedAlpha"] = true;
     m_obj["asset"] = asset;
 
-    for (int i = 0; i < bufList.count(); ++i) {
+    // With -B all buffers are concatenated into the body of the binary
+    // container, each one starting on a 4 byte boundary.
+    QByteArray glbBody;
+    QVector<uint> glbBufferOffsets;
+    if (opts.genGlb) {
+        glbBufferOffsets.reserve(bufList.count());
+        for (int i = 0; i < bufList.count(); ++i) {
+            glbBufferOffsets.append(uint(glbBody.size()));
+            glbBody.append(bufList[i].data);
+            while (glbBody.size() % 4)
+                glbBody.append('\0');
+        }
+    }
+
+    for (int i = 0; i < bufList.count() && !opts.genGlb; ++i) {
         QString bufName = bufNameTempl.arg(i + 1);
         f.setFileName(opts.outDir + bufName);
         if (opts.showLog)
@@ -2300,23 +2316,39 @@ void GltfExporter::save(const QString &inputFilename)
     }
 
     QJsonObject buffers;
-    for (int i = 0; i < bufList.count(); ++i) {
+    if (opts.genGlb) {
         QJsonObject buffer;
-        buffer["byteLength"] = bufList[i].data.size();
+        buffer["byteLength"] = glbBody.size();
         buffer["type"] = QStringLiteral("arraybuffer");
-        buffer["uri"] = bufNameTempl.arg(i + 1);
+        buffer["uri"] = QStringLiteral("data:,");
         if (opts.compress)
             buffer["compression"] = QStringLiteral("Qt");
-        buffers[bufList[i].name] = buffer;
+        buffers[QStringLiteral("binary_glTF")] = buffer;
+        m_obj["extensionsUsed"] = QJsonArray() << QStringLiteral("KHR_binary_glTF");
+    } else {
+        for (int i = 0; i < bufList.count(); ++i) {
+            QJsonObject buffer;
+            buffer["byteLength"] = bufList[i].data.size();
+            buffer["type"] = QStringLiteral("arraybuffer");
+            buffer["uri"] = bufNameTempl.arg(i + 1);
+            if (opts.compress)
+                buffer["compression"] = QStringLiteral("Qt");
+            buffers[bufList[i].name] = buffer;
+        }
     }
     m_obj["buffers"] = buffers;
 
     QJsonObject bufferViews;
     for (const Importer::MeshInfo::BufferView &bv : qAsConst(bvList)) {
         QJsonObject bufferView;
-        bufferView["buffer"] = bufList[bv.bufIndex].name;
+        if (opts.genGlb) {
+            bufferView["buffer"] = QStringLiteral("binary_glTF");
+            bufferView["byteOffset"] = int(glbBufferOffsets[bv.bufIndex] + bv.offset);
+        } else {
+            bufferView["buffer"] = bufList[bv.bufIndex].name;
+            bufferView["byteOffset"] = int(bv.offset);
+        }
         bufferView["byteLength"] = int(bv.length);
-        bufferView["byteOffset"] = int(bv.offset);
         if (bv.target)
             bufferView["target"] = int(bv.target);
         bufferViews[bv.name] = bufferView;
@@ -2441,12 +2473,35 @@ void GltfExporter::save(const QString &inputFilename)
 
     m_doc.setObject(m_obj);
 
-    QString gltfName = opts.outDir + basename + QStringLiteral(".qgltf");
+    QString gltfName = opts.outDir + basename + (opts.genGlb ? QStringLiteral(".glb") : QStringLiteral(".qgltf"));
     f.setFileName(gltfName);
     if (opts.showLog)
-        qDebug().noquote() << (opts.genBin ? "Writing (binary JSON)" : "Writing") << gltfName;
+        qDebug().noquote() << (opts.genGlb ? "Writing (binary glTF)" : opts.genBin ? "Writing (binary JSON)" : "Writing") << gltfName;
 
-    if (opts.genBin) {
+    if (opts.genGlb) {
+        if (f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            m_files.insert(QFileInfo(f.fileName()).fileName());
+            QByteArray content = m_doc.toJson(QJsonDocument::Compact);
+            // Keep the body 4 byte aligned
+            while (content.size() % 4)
+                content.append(' ');
+            if (opts.compress)
+                glbBody = qCompress(glbBody);
+
+            const quint32 headerSize = 20;
+            const quint32 header[5] = {
+                qToLittleEndian<quint32>(0x46546C67), // "glTF"
+                qToLittleEndian<quint32>(1), // version
+                qToLittleEndian<quint32>(headerSize + content.size() + glbBody.size()),
+                qToLittleEndian<quint32>(content.size()),
+                qToLittleEndian<quint32>(0) // JSON content
+            };
+            f.write(reinterpret_cast<const char *>(header), headerSize);
+            f.write(content);
+            f.write(glbBody);
+            f.close();
+        }
+    } else if (opts.genBin) {
         if (f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
             m_files.insert(QFileInfo(f.fileName()).fileName());
             QByteArray json = m_doc.toBinaryData();
@@ -2504,9 +2559,11 @@ int main(int argc, char **argv)
     cmdLine.addOption(outDirOpt);
     QCommandLineOption binOpt(QStringLiteral("b"), QStringLiteral("Store binary JSON data in the .qgltf file"));
     cmdLine.addOption(binOpt);
+    QCommandLineOption glbOpt(QStringLiteral("B"), QStringLiteral("Store the scene and its buffers in a single binary glTF (.glb) file"));
+    cmdLine.addOption(glbOpt);
     QCommandLineOption compactOpt(QStringLiteral("m"), QStringLiteral("Store compact JSON in the .qgltf file"));
     cmdLine.addOption(compactOpt);
-    QCommandLineOption compOpt(QStringLiteral("c"), QStringLiteral("qCompress() vertex/index data in the .bin file"));
+    QCommandLineOption compOpt(QStringLiteral("c"), QStringLiteral("qCompress() vertex/index data in the .bin (or .glb) file"));
     cmdLine.addOption(compOpt);
     QCommandLineOption tangentOpt(QStringLiteral("t"), QStringLiteral("Generate tangent vectors"));
     cmdLine.addOption(tangentOpt);
@@ -2527,6 +2584,7 @@ int main(int argc, char **argv)
     cmdLine.process(app);
     opts.outDir = cmdLine.value(outDirOpt);
     opts.genBin = cmdLine.isSet(binOpt);
+    opts.genGlb = cmdLine.isSet(glbOpt);
     opts.compact = cmdLine.isSet(compactOpt);
     opts.compress = cmdLine.isSet(compOpt);
     opts.genTangents = cmdLine.isSet(tangentOpt);